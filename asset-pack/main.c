@@ -0,0 +1,150 @@
+// asset-pack: compile the text assets into one binary pack (common/util/pack.h)
+// Headless: no InitWindow. Run from the project root, like the games:
+//
+//   asset-pack [-o assets.pack] [dir ...]
+//
+// Every .obj3d/.spr2d/.rig2d/.anim2d under the directories (default: objects,
+// fighter/sprites, pokemon/sprites) is parsed with the normal text loaders and
+// stored under the same relative path the games load it by. An .anim2d is
+// resolved against the .rig2d in its own directory. Games that mount the
+// pack read every asset in it from memory; anything missing from it still
+// loads from the text file, so rerun this after editing assets.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "raylib.h"
+
+#include "../common/objects3d.h"
+#include "../common/sprites2d.h"
+#include "../common/util/pack.h"
+
+#define PACK_SCAN_MAX_PARTS 256   // beyond any loader's limit, to catch oversized files
+
+static const char *defaultDirs[] = { "objects", "fighter/sprites", "pokemon/sprites" };
+static const char *typeNames[] = { "raw", "obj3d", "spr2d", "rig2d", "anim2d" };
+
+static PackBuilder pack;
+static PackBuffer blob;
+static int typeCounts[5];
+
+// Scratch for the loaders (too big for the stack)
+static Part objParts[PACK_SCAN_MAX_PARTS];
+static Sprite2DPart sprParts[PACK_SCAN_MAX_PARTS];
+static SpriteFrame frame;
+static PuppetRig rig;
+static PuppetAnim anim;
+
+// The rig an .anim2d poses: the first .rig2d next to it.
+static bool LoadRigBeside(const char *animPath, PuppetRig *out) {
+    FilePathList rigs = LoadDirectoryFilesEx(GetDirectoryPath(animPath), ".rig2d", false);
+    bool ok = rigs.count > 0 && LoadPuppetRig(rigs.paths[0], out) > 0;
+    if (rigs.count > 1) printf("  warning: %s: several rigs, using %s\n", animPath, rigs.paths[0]);
+    UnloadDirectoryFiles(rigs);
+    return ok;
+}
+
+// Encode one file into blob. Returns its entry type, or PACK_RAW to skip it.
+static PackEntryType EncodeAsset(const char *path) {
+    if (IsFileExtension(path, ".obj3d")) {
+        memset(objParts, 0, sizeof(objParts));
+        int count = LoadObject3D(path, objParts, PACK_SCAN_MAX_PARTS);
+        if (count == 0 || !WriteObject3DBinary(&blob, objParts, count)) return PACK_RAW;
+        return PACK_OBJ3D;
+    }
+    if (IsFileExtension(path, ".spr2d")) {
+        if (LoadSprite2D(path, sprParts, PACK_SCAN_MAX_PARTS) > MAX_FRAME_PARTS) {
+            printf("  skipped %s: more than %d parts, stays text-only\n", path, MAX_FRAME_PARTS);
+            return PACK_RAW;
+        }
+        memset(&frame, 0, sizeof(frame));
+        if (LoadSpriteFrame(path, &frame) == 0 || !WriteSpriteFrameBinary(&blob, &frame)) return PACK_RAW;
+        return PACK_SPR2D;
+    }
+    if (IsFileExtension(path, ".rig2d")) {
+        memset(&rig, 0, sizeof(rig));
+        if (LoadPuppetRig(path, &rig) == 0 || !WritePuppetRigBinary(&blob, &rig)) return PACK_RAW;
+        return PACK_RIG2D;
+    }
+    if (IsFileExtension(path, ".anim2d")) {
+        memset(&rig, 0, sizeof(rig));
+        memset(&anim, 0, sizeof(anim));
+        if (!LoadRigBeside(path, &rig)) {
+            printf("  skipped %s: no .rig2d beside it\n", path);
+            return PACK_RAW;
+        }
+        if (LoadPuppetAnim(path, &anim, &rig) == 0 || !WritePuppetAnimBinary(&blob, &anim, &rig)) return PACK_RAW;
+        return PACK_ANIM2D;
+    }
+    return PACK_RAW;
+}
+
+static int ComparePaths(const void *a, const void *b) {
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void AddDirectory(const char *dir) {
+    char root[PACK_PATH_MAX];
+    snprintf(root, sizeof(root), "%s", dir);
+    for (char *c = root; *c; c++) if (*c == '\\') *c = '/';
+    size_t len = strlen(root);
+    while (len > 1 && root[len - 1] == '/') root[--len] = '\0';
+    if (!DirectoryExists(root)) {
+        printf("  skipped %s: no such directory\n", root);
+        return;
+    }
+
+    FilePathList files = LoadDirectoryFilesEx(root, ".obj3d;.spr2d;.rig2d;.anim2d", true);
+    qsort(files.paths, files.count, sizeof(char *), ComparePaths);   // reproducible output
+    for (unsigned int i = 0; i < files.count; i++) {
+        char path[PACK_PATH_MAX + 1];
+        snprintf(path, sizeof(path), "%s", files.paths[i]);
+        for (char *c = path; *c; c++) if (*c == '\\') *c = '/';
+        if (strlen(path) >= PACK_PATH_MAX) {
+            printf("  skipped %s: path longer than %d\n", files.paths[i], PACK_PATH_MAX - 1);
+            continue;
+        }
+        blob.size = 0;
+        PackEntryType type = EncodeAsset(path);
+        if (type == PACK_RAW) continue;
+        if (!PackBuilderAdd(&pack, path, type, blob.data, blob.size)) {
+            printf("  skipped %s: duplicate path\n", path);
+            continue;
+        }
+        typeCounts[type]++;
+    }
+    UnloadDirectoryFiles(files);
+}
+
+int main(int argc, char **argv) {
+    const char *outPath = "assets.pack";
+    const char *dirs[64];
+    int dirCount = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) outPath = argv[++i];
+        else if (argv[i][0] == '-') {
+            printf("usage: %s [-o assets.pack] [dir ...]\n", argv[0]);
+            return 1;
+        } else if (dirCount < 64) dirs[dirCount++] = argv[i];
+    }
+    if (dirCount == 0) {
+        dirCount = (int)(sizeof(defaultDirs) / sizeof(defaultDirs[0]));
+        for (int i = 0; i < dirCount; i++) dirs[i] = defaultDirs[i];
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    for (int i = 0; i < dirCount; i++) AddDirectory(dirs[i]);
+
+    bool ok = PackBuilderSave(&pack, outPath);
+    if (ok) {
+        printf("%s: %d entries,", outPath, pack.count);
+        for (int t = PACK_OBJ3D; t <= PACK_ANIM2D; t++) printf(" %d %s", typeCounts[t], typeNames[t]);
+        printf(", %d bytes\n", GetFileLength(outPath));
+    } else {
+        printf("failed to write %s\n", outPath);
+    }
+    PackBufferFree(&blob);
+    PackBuilderFree(&pack);
+    return ok ? 0 : 1;
+}
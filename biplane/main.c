@@ -2,6 +2,7 @@
 #include "raymath.h"
 #include "rlgl.h"
 #include "../common/objects3d.h"
+#include "../common/util/noise.h"
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -138,12 +139,14 @@ typedef struct {
 typedef struct {
     Vector3 pos;
     float size;
+    int lod;            // prefab level of detail drawn last frame
 } TreeObj;
 
 typedef struct {
     Vector3 pos;
     float w, h, d;
     Color color;
+    int lod;
 } Building;
 
 // Object models loaded from files (with hardcoded fallback)
@@ -207,6 +210,10 @@ static TreeObj bushes[NUM_BUSHES];
 static Building buildings[NUM_BUILDINGS];
 static Building houses[NUM_HOUSES];
 
+// Scenery models compiled to meshes, drawn instanced through one batch
+static Prefab3D *treePrefab, *bushPrefab, *buildingPrefab, *housePrefab;
+static PrefabBatch sceneryBatch;
+
 // Bush model
 static Part bushParts[MAX_OBJ_PARTS];
 static int bushPartCount = 0;
@@ -255,12 +262,19 @@ typedef struct {
 static Road roads[MAX_ROADS];
 static int numRoads = 0;
 
+// Rolling hills, flattened to sea level where the waves dip below zero
+static const Heightfield terrainField = {
+    .waves = {
+        { .kx = 0.02f, .amp = 8.0f },
+        { .kz = 0.015f, .phase = PI / 2, .amp = 6.0f },
+        { .kx = 0.05f, .kz = 0.03f, .amp = 3.0f },
+    },
+    .waveCount = 3,
+    .clampFloor = true,
+};
+
 float TerrainHeight(float x, float z) {
-    // Rolling hills
-    float h = sinf(x * 0.02f) * 8.0f + cosf(z * 0.015f) * 6.0f;
-    h += sinf(x * 0.05f + z * 0.03f) * 3.0f;
-    if (h < 0) h = 0;
-    return h;
+    return HeightfieldSample(&terrainField, x, z);
 }
 
 void InitWorld(void) {
@@ -275,6 +289,10 @@ void InitWorld(void) {
         bushFallback, sizeof(bushFallback)/sizeof(Part));
     LoadOrCreate("objects/house.obj3d", houseParts, &housePartCount,
         houseFallback, sizeof(houseFallback)/sizeof(Part));
+    treePrefab     = GetPrefab3D("objects/pine_tree.obj3d", treeParts, treePartCount);
+    bushPrefab     = GetPrefab3D("objects/bush.obj3d", bushParts, bushPartCount);
+    buildingPrefab = GetPrefab3D("objects/building.obj3d", buildingParts, buildingPartCount);
+    housePrefab    = GetPrefab3D("objects/house.obj3d", houseParts, housePartCount);
 
     // Plane — start low, flying forward (+Z)
     plane = (Plane){
@@ -620,18 +638,29 @@ void DrawCloud(Cloud *c) {
         c->size * 0.6f, (Color){230, 230, 240, 150});
 }
 
+#define TERRAIN_MAX_ROW 128
+
 void DrawTerrain(Vector3 camPos) {
     float step = 10.0f;
     float range = 500.0f;
     float x0 = floorf((camPos.x - range) / step) * step;
     float z0 = floorf((camPos.z - range) / step) * step;
 
-    for (float z = z0; z < camPos.z + range; z += step) {
-        for (float x = x0; x < camPos.x + range; x += step) {
-            float h00 = TerrainHeight(x, z);
-            float h10 = TerrainHeight(x + step, z);
-            float h01 = TerrainHeight(x, z + step);
-            float h11 = TerrainHeight(x + step, z + step);
+    // One row of heights per grid line, each shared by the cells on both sides
+    int nx = (int)ceilf((camPos.x + range - x0) / step);
+    int nz = (int)ceilf((camPos.z + range - z0) / step);
+    float rows[2][TERRAIN_MAX_ROW];
+    if (nx + 1 > TERRAIN_MAX_ROW) nx = TERRAIN_MAX_ROW - 1;
+    HeightfieldRow(&terrainField, x0, step, z0, nx + 1, rows[0]);
+
+    for (int j = 0; j < nz; j++) {
+        float z = z0 + (float)j * step;
+        float *row0 = rows[j & 1], *row1 = rows[(j + 1) & 1];
+        HeightfieldRow(&terrainField, x0, step, z + step, nx + 1, row1);
+        for (int i = 0; i < nx; i++) {
+            float x = x0 + (float)i * step;
+            float h00 = row0[i], h10 = row0[i + 1];
+            float h01 = row1[i], h11 = row1[i + 1];
 
             // Green with height variation
             int g = 100 + (int)(h00 * 3);
@@ -652,9 +681,17 @@ void DrawTerrain(Vector3 camPos) {
     }
 }
 
-void DrawTree3D(TreeObj *t) {
+// Queue one scenery object at the level of detail its screen size calls for
+void AddScenery3D(Prefab3D *pf, Vector3 pos, Vector3 scale, int *lod, Camera3D cam) {
+    if (!pf) return;
+    float maxScale = fmaxf(scale.x, fmaxf(scale.y, scale.z));
+    *lod = SelectPrefabLOD(PrefabScreenSize(pf, cam, pos, maxScale), *lod);
+    AddPrefabInstanceLOD(&sceneryBatch, pf, *lod, pos, 0, scale, WHITE);
+}
+
+void AddTree3D(TreeObj *t, Camera3D cam) {
     Vector3 scale = { t->size, t->size, t->size };
-    DrawObject3DScaled(treeParts, treePartCount, t->pos, 0, scale);
+    AddScenery3D(treePrefab, t->pos, scale, &t->lod, cam);
 }
 
 int main(void) {
@@ -665,6 +702,7 @@ int main(void) {
     DisableCursor();
 
     InitWorld();
+    InitPrefabBatch(&sceneryBatch, NUM_TREES + NUM_BUSHES + NUM_BUILDINGS + NUM_HOUSES);
 
     Camera3D camera = { 0 };
     // Start camera behind the plane (plane faces +Z initially)
@@ -967,33 +1005,30 @@ int main(void) {
                 }
             }
 
-            // Trees
+            // Scenery: trees, bushes, buildings and houses, one instanced draw
+            // per model and level of detail
+            ClearPrefabBatch(&sceneryBatch);
             for (int i = 0; i < NUM_TREES; i++) {
                 if (Vector3Distance(trees[i].pos, camera.position) < 400)
-                    DrawTree3D(&trees[i]);
+                    AddTree3D(&trees[i], camera);
             }
-
-            // Bushes
             for (int i = 0; i < NUM_BUSHES; i++) {
                 if (Vector3Distance(bushes[i].pos, camera.position) < 200) {
                     Vector3 bs = { bushes[i].size, bushes[i].size, bushes[i].size };
-                    DrawObject3DScaled(bushParts, bushPartCount, bushes[i].pos, 0, bs);
+                    AddScenery3D(bushPrefab, bushes[i].pos, bs, &bushes[i].lod, camera);
                 }
             }
-
-            // Buildings
             for (int i = 0; i < NUM_BUILDINGS; i++) {
                 Building *b = &buildings[i];
                 Vector3 bScale = { b->w / 5.0f, b->h / 10.0f, b->d / 5.0f };
-                DrawObject3DScaled(buildingParts, buildingPartCount, b->pos, 0, bScale);
+                AddScenery3D(buildingPrefab, b->pos, bScale, &b->lod, camera);
             }
-
-            // Houses
             for (int i = 0; i < NUM_HOUSES; i++) {
                 Building *h = &houses[i];
                 Vector3 hScale = { h->w / 4.0f, h->h / 3.0f, h->d / 5.0f };
-                DrawObject3DScaled(houseParts, housePartCount, h->pos, 0, hScale);
+                AddScenery3D(housePrefab, h->pos, hScale, &h->lod, camera);
             }
+            DrawPrefabBatch(&sceneryBatch);
 
             // Rings
             for (int i = 0; i < NUM_RINGS; i++) DrawFlyRing(&rings[i]);
@@ -1260,6 +1295,8 @@ int main(void) {
         EndDrawing();
     }
 
+    FreePrefabBatch(&sceneryBatch);
+    UnloadPrefabs3D();
     EnableCursor();
     CloseWindow();
     return 0;
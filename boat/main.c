@@ -1,6 +1,8 @@
 #include "raylib.h"
 #include "raymath.h"
+#include "../common/util/sim.h"
 #include "../common/objects3d.h"
+#include "../common/util/noise.h"
 #include <math.h>
 #include <stdlib.h>
 
@@ -168,12 +170,20 @@ static bool raceStarted = false;
 static float countdownTimer = 4.0f;
 static float gameTime = 0;
 
+// Unit-height swell; WaterHeight scales it by the current wave height
+static Heightfield waterField = {
+    .waves = {
+        { .kx = 0.15f, .omega = WAVE_SPEED, .amp = 1.0f },
+        { .kz = 0.12f, .omega = WAVE_SPEED * 0.7f, .phase = PI / 2, .amp = 0.6f },
+        { .kx = 0.08f, .kz = 0.08f, .omega = 1.5f, .amp = 0.3f },
+    },
+    .waveCount = 3,
+};
+
 // Water wave height at a world position
 float WaterHeight(float x, float z, float t) {
-    float wh = BASE_WAVE_HEIGHT * waveIntensity;
-    return sinf(x * 0.15f + t * WAVE_SPEED) * wh +
-           cosf(z * 0.12f + t * WAVE_SPEED * 0.7f) * wh * 0.6f +
-           sinf((x + z) * 0.08f + t * 1.5f) * wh * 0.3f;
+    waterField.time = t;
+    return HeightfieldSample(&waterField, x, z) * BASE_WAVE_HEIGHT * waveIntensity;
 }
 
 void GenerateTrack(void) {
@@ -605,6 +615,8 @@ void DrawBoatModel(Boat *b) {
     }
 }
 
+#define WATER_MAX_ROW 72   // grid lines per row: 2 * range / 8 + 1 = 64 at the default range
+
 // Draw water surface as grid of quads
 void DrawWater(Vector3 camPos) {
     float cx = floorf(camPos.x / 8) * 8;
@@ -613,14 +625,26 @@ void DrawWater(Vector3 camPos) {
     Color deepWater = {20, 60, 120, 255};
     Color shallowWater = {40, 100, 160, 255};
 
-    for (float gx = cx - range; gx < cx + range; gx += 8) {
-        for (float gz = cz - range; gz < cz + range; gz += 8) {
+    // Heights per grid line along x, shared by the quads on both sides of it
+    int n = (int)ceilf(2.0f * range / 8.0f);
+    float rows[2][WATER_MAX_ROW];
+    if (n + 1 > WATER_MAX_ROW) n = WATER_MAX_ROW - 1;
+    float wh = BASE_WAVE_HEIGHT * waveIntensity;
+    waterField.time = gameTime;
+    HeightfieldRow(&waterField, cx - range, 8.0f, cz - range, n + 1, rows[0]);
+    for (int i = 0; i <= n; i++) rows[0][i] *= wh;
+
+    for (int j = 0; j < n; j++) {
+        float gz = cz - range + j * 8.0f;
+        float *row0 = rows[j & 1], *row1 = rows[(j + 1) & 1];
+        HeightfieldRow(&waterField, cx - range, 8.0f, gz + 8, n + 1, row1);
+        for (int i = 0; i <= n; i++) row1[i] *= wh;
+        for (int i = 0; i < n; i++) {
+            float gx = cx - range + i * 8.0f;
             float d = sqrtf((gx - camPos.x) * (gx - camPos.x) + (gz - camPos.z) * (gz - camPos.z));
             if (d > range) continue;
-            float h00 = WaterHeight(gx, gz, gameTime);
-            float h10 = WaterHeight(gx + 8, gz, gameTime);
-            float h01 = WaterHeight(gx, gz + 8, gameTime);
-            float h11 = WaterHeight(gx + 8, gz + 8, gameTime);
+            float h00 = row0[i], h10 = row0[i + 1];
+            float h01 = row1[i], h11 = row1[i + 1];
             // Color varies with height
             float avgH = (h00 + h10 + h01 + h11) * 0.25f;
             float t = (avgH + BASE_WAVE_HEIGHT) / (BASE_WAVE_HEIGHT * 2.0f);
@@ -943,6 +967,81 @@ void DrawBirds(void) {
     }
 }
 
+// One step of everything but the camera
+void UpdateGame(float dt) {
+    gameTime += dt;
+
+    // Countdown
+    if (!raceStarted) {
+        countdownTimer -= dt;
+        if (countdownTimer <= 0) raceStarted = true;
+    }
+
+    // Restart
+    if (boats[playerIdx].finished && IsKeyPressed(KEY_ENTER)) InitRace();
+
+    // Update boats
+    SIM_SECTION("boats")
+    for (int i = 0; i < NUM_BOATS; i++) UpdateBoat(&boats[i], i, dt);
+
+    // Update birds
+    SIM_SECTION("birds")
+    UpdateBirds(dt);
+
+    // Update spray
+    SIM_SECTION("spray")
+    for (int i = 0; i < MAX_SPRAY; i++) {
+        if (!spray[i].active) continue;
+        spray[i].pos = Vector3Add(spray[i].pos, Vector3Scale(spray[i].vel, dt));
+        spray[i].vel.y -= 8.0f * dt;
+        spray[i].life -= dt;
+        if (spray[i].life <= 0) spray[i].active = false;
+    }
+
+    // Reset boost buoys periodically
+    if ((int)(gameTime * 10) % 200 == 0) {
+        for (int i = 0; i < numBuoys; i++)
+            if (buoys[i].isBoost) buoys[i].collected = false;
+    }
+
+    // Screen shake decay
+    if (shakeAmount > 0) shakeAmount -= shakeDecay * dt * shakeAmount;
+    if (shakeAmount < 0.01f) shakeAmount = 0;
+}
+
+#ifdef SIM_HEADLESS
+// Scripted pilot: full throttle at the next waypoint, drifts the sharp turns,
+// boosts whenever the tank allows, and restarts each time it finishes.
+static void SimScript(int t) {
+    Boat *b = &boats[playerIdx];
+    Vector3 to = Vector3Subtract(trackPts[b->nextWP], b->pos);
+    float turn = atan2f(to.x, to.z) - b->rotation;
+    while (turn > PI) turn -= 2 * PI;
+    while (turn < -PI) turn += 2 * PI;
+    SimSetKey(KEY_W, true);
+    SimSetKey(KEY_A, turn >  0.05f);
+    SimSetKey(KEY_D, turn < -0.05f);
+    SimSetKey(KEY_Z, fabsf(turn) > 0.5f);
+    SimSetKey(KEY_SPACE, t % 120 == 0);
+    SimSetKey(KEY_ENTER, b->finished && !SimKeyDown(KEY_ENTER));
+}
+
+int main(int argc, char **argv) {
+    SimRun run = SimBegin("boat", argc, argv, 60 * 600);
+    InitRace();
+
+    int races = 0;
+    for (int t = 0; t < run.ticks; t++) {
+        SimInputNextTick();
+        SimScript(t);
+        if (SimKeyPressed(KEY_ENTER)) races++;
+        UpdateGame(1.0f / 60.0f);
+    }
+    int rc = SimEnd(&run);
+    printf("  %d races finished, player on lap %d\n", races, boats[playerIdx].lap);
+    return rc;
+}
+#else
 int main(void) {
     SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     InitWindow(1280, 720, "Boat Race");
@@ -959,41 +1058,7 @@ int main(void) {
     while (!WindowShouldClose()) {
         float dt = GetFrameTime();
         if (dt > 0.05f) dt = 0.05f;
-        gameTime += dt;
-
-        // Countdown
-        if (!raceStarted) {
-            countdownTimer -= dt;
-            if (countdownTimer <= 0) raceStarted = true;
-        }
-
-        // Restart
-        if (boats[playerIdx].finished && IsKeyPressed(KEY_ENTER)) InitRace();
-
-        // Update boats
-        for (int i = 0; i < NUM_BOATS; i++) UpdateBoat(&boats[i], i, dt);
-
-        // Update birds
-        UpdateBirds(dt);
-
-        // Update spray
-        for (int i = 0; i < MAX_SPRAY; i++) {
-            if (!spray[i].active) continue;
-            spray[i].pos = Vector3Add(spray[i].pos, Vector3Scale(spray[i].vel, dt));
-            spray[i].vel.y -= 8.0f * dt;
-            spray[i].life -= dt;
-            if (spray[i].life <= 0) spray[i].active = false;
-        }
-
-        // Reset boost buoys periodically
-        if ((int)(gameTime * 10) % 200 == 0) {
-            for (int i = 0; i < numBuoys; i++)
-                if (buoys[i].isBoost) buoys[i].collected = false;
-        }
-
-        // Screen shake decay
-        if (shakeAmount > 0) shakeAmount -= shakeDecay * dt * shakeAmount;
-        if (shakeAmount < 0.01f) shakeAmount = 0;
+        UpdateGame(dt);
 
         // FOV scales with speed + extra during boost
         Boat *pb = &boats[playerIdx];
@@ -1190,3 +1255,4 @@ int main(void) {
     CloseWindow();
     return 0;
 }
+#endif
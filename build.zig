@@ -1,10 +1,37 @@
 const std = @import("std");
 
-const projects = .{ "fps", "rally", "3rd-person", "rts", "soccer", "kart", "platformer", "zelda", "micromachines", "skate", "resi", "wipeout", "editor", "snowboard", "rpgbattle", "biplane", "goldensun", "starfox", "boat", "pokemon", "fighter", "util-tests" };
+const projects = .{ "fps", "rally", "3rd-person", "rts", "soccer", "kart", "platformer", "zelda", "micromachines", "skate", "resi", "wipeout", "editor", "snowboard", "rpgbattle", "biplane", "goldensun", "starfox", "boat", "pokemon", "fighter", "asset-pack", "util-tests", "util-bench" };
+
+// Games with a SIM_HEADLESS runner (common/util/sim.h): built as <name>-sim by `zig build bench`
+const sims = .{ "rally", "rts", "fps", "boat" };
+
+fn linkRaylib(mod: *std.Build.Module, target: std.Build.ResolvedTarget) void {
+    mod.linkSystemLibrary("raylib", .{});
+
+    // Platform-specific frameworks/libraries
+    if (target.result.os.tag == .macos) {
+        mod.linkFramework("OpenGL", .{});
+        mod.linkFramework("Cocoa", .{});
+        mod.linkFramework("IOKit", .{});
+        mod.linkFramework("CoreVideo", .{});
+    } else if (target.result.os.tag == .linux) {
+        mod.linkSystemLibrary("pthread", .{});   // common/util/jobs.h workers
+    } else if (target.result.os.tag == .windows) {
+        const vcpkg_root = "C:/Users/wjbr/scoop/apps/vcpkg/current/installed/x64-windows";
+        mod.addIncludePath(.{ .cwd_relative = vcpkg_root ++ "/include" });
+        mod.addLibraryPath(.{ .cwd_relative = vcpkg_root ++ "/lib" });
+        mod.linkSystemLibrary("gdi32", .{});
+        mod.linkSystemLibrary("winmm", .{});
+        mod.linkSystemLibrary("user32", .{});
+        mod.linkSystemLibrary("shell32", .{});
+    }
+}
 
 pub fn build(b: *std.Build) void {
     const target = b.standardTargetOptions(.{});
     const optimize = b.standardOptimizeOption(.{ .preferred_optimize_mode = .ReleaseFast });
+    const profile = b.option(bool, "profile", "Compile in the PROFILE_SCOPE profiler (common/util/debug.h)") orelse false;
+    const c_flags: []const []const u8 = if (profile) &.{ "-std=c99", "-DPROFILE_ENABLE" } else &.{"-std=c99"};
 
     const build_all_step = b.step("all", "Build all projects");
 
@@ -17,26 +44,10 @@ pub fn build(b: *std.Build) void {
 
         mod.addCSourceFile(.{
             .file = b.path(name ++ "/main.c"),
-            .flags = &.{"-std=c99"},
+            .flags = c_flags,
         });
 
-        mod.linkSystemLibrary("raylib", .{});
-
-        // Platform-specific frameworks/libraries
-        if (target.result.os.tag == .macos) {
-            mod.linkFramework("OpenGL", .{});
-            mod.linkFramework("Cocoa", .{});
-            mod.linkFramework("IOKit", .{});
-            mod.linkFramework("CoreVideo", .{});
-        } else if (target.result.os.tag == .windows) {
-            const vcpkg_root = "C:/Users/wjbr/scoop/apps/vcpkg/current/installed/x64-windows";
-            mod.addIncludePath(.{ .cwd_relative = vcpkg_root ++ "/include" });
-            mod.addLibraryPath(.{ .cwd_relative = vcpkg_root ++ "/lib" });
-            mod.linkSystemLibrary("gdi32", .{});
-            mod.linkSystemLibrary("winmm", .{});
-            mod.linkSystemLibrary("user32", .{});
-            mod.linkSystemLibrary("shell32", .{});
-        }
+        linkRaylib(mod, target);
 
         const exe = b.addExecutable(.{
             .name = name,
@@ -62,5 +73,41 @@ pub fn build(b: *std.Build) void {
         run_step.dependOn(&run_cmd.step);
     }
 
+    // Headless tick-throughput runners: zig build bench [-- <ticks> [seed]]
+    const bench_step = b.step("bench", "Build and run the headless simulation benchmarks");
+    var prev_run: ?*std.Build.Step = null;   // run one at a time so timings don't contend
+
+    inline for (sims) |name| {
+        const mod = b.createModule(.{
+            .target = target,
+            .optimize = optimize,
+            .link_libc = true,
+        });
+
+        mod.addCSourceFile(.{
+            .file = b.path(name ++ "/main.c"),
+            .flags = &.{ "-std=c99", "-D_POSIX_C_SOURCE=199309L", "-DSIM_HEADLESS" },   // sim.h needs clock_gettime
+        });
+
+        linkRaylib(mod, target);
+
+        const exe = b.addExecutable(.{
+            .name = name ++ "-sim",
+            .root_module = mod,
+        });
+
+        const install = b.addInstallArtifact(exe, .{});
+        const run_cmd = b.addRunArtifact(exe);
+        run_cmd.step.dependOn(&install.step);
+        if (target.result.os.tag == .windows) {
+            run_cmd.addPathDir("C:/Users/wjbr/scoop/apps/vcpkg/current/installed/x64-windows/bin");
+        }
+        if (b.args) |args| run_cmd.addArgs(args);
+        run_cmd.has_side_effects = true;   // always rerun; the output is the point
+        if (prev_run) |p| run_cmd.step.dependOn(p);
+        prev_run = &run_cmd.step;
+        bench_step.dependOn(&run_cmd.step);
+    }
+
     b.default_step = build_all_step;
 }
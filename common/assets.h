@@ -0,0 +1,550 @@
+// assets.h — asset registry with live reload for .obj3d/.spr2d/.rig2d/.anim2d
+// and numbered-frame sprite anims (base_0.spr2d, base_1.spr2d, ...)
+// Header-only: just #include this file
+//
+// The registry owns loaded assets by path and hands out pointers that stay
+// valid for the whole run. A loader thread parses files, watches them
+// (inotify on Linux, mtime polling elsewhere) and re-parses them when they
+// change on disk — saved from the editor, say. Re-parsed data waits until
+// the game calls AssetsUpdate at a frame boundary, which copies it into
+// place, so nothing changes under a frame in progress and the main thread
+// never parses.
+//
+// Usage:
+//   AssetsInit();                                   // start the loader thread
+//   PuppetRig *rig = AssetPuppetRig("fighter/sprites/ryu/ryu.rig2d");
+//   PuppetAnim *idle = AssetPuppetAnim("fighter/sprites/ryu/idle.anim2d",
+//                                      "fighter/sprites/ryu/ryu.rig2d");
+//   AssetsWaitLoaded();                             // rig and idle filled in
+//   while (!WindowShouldClose()) {
+//       AssetsUpdate();                             // swap in edited files
+//       ...
+//   }
+//   AssetsShutdown();
+//
+// An .anim2d is bound to its rig: editing the rig or any of the rig's
+// sub-sprites re-parses both, and they swap in on the same frame. The first
+// load goes through the mounted pack (util/pack.h) when there is one;
+// reloads always read the text file that changed.
+//
+// Without AssetsInit, or built with -DASSETS_SERIAL, assets parse inline
+// when first requested and AssetsUpdate polls file times every
+// ASSETS_POLL_FRAMES calls, so reloads still work, just on the calling thread.
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "objects3d.h"
+#include "sprites2d.h"
+
+// Same requirements as util/jobs.h: pthreads, which the Windows build does
+// not link.
+#if (defined(_WIN32) || (!defined(__GNUC__) && !defined(__clang__))) && !defined(ASSETS_SERIAL)
+#define ASSETS_SERIAL
+#endif
+
+#ifndef ASSETS_SERIAL
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__linux__) && !defined(ASSETS_NO_INOTIFY)
+#define ASSETS_INOTIFY 1
+#include <sys/inotify.h>
+#endif
+#endif
+#ifndef ASSETS_INOTIFY
+#define ASSETS_INOTIFY 0
+#endif
+
+#define ASSETS_MAX            128
+#define ASSET_PATH_MAX        96
+#define ASSET_MAX_DEPS        (MAX_RIG_PARTS + 2)   // anim: itself, its rig, the rig's sprites
+#define ASSET_OBJ3D_MAX_PARTS 64
+#define ASSETS_MAX_WATCHES    32                    // watched directories (inotify)
+#define ASSETS_POLL_MS        250                   // file-time polling without inotify
+#define ASSETS_POLL_FRAMES    15                    // ...and in serial mode, per AssetsUpdate call
+
+typedef enum { ASSET_OBJ3D, ASSET_SPR2D, ASSET_RIG2D, ASSET_ANIM2D, ASSET_SPRANIM } AssetType;
+
+typedef struct {
+    Part parts[ASSET_OBJ3D_MAX_PARTS];
+    int count;
+    Object3DBounds bounds;
+} Object3DAsset;
+
+typedef struct {
+    Sprite2DPart parts[MAX_FRAME_PARTS];
+    int count;
+    Sprite2DBounds bounds;
+} Sprite2DAsset;
+
+typedef struct {
+    AssetType type;
+    char path[ASSET_PATH_MAX];
+    char rigPath[ASSET_PATH_MAX];     // .anim2d: the rig it poses
+    bool loop;                        // sprite anim: SpriteAnim.loop
+    void *live;                       // what the game holds; changes only in AssetsUpdate
+    void *pending;                    // parsed, waiting for AssetsUpdate
+    size_t size;
+    bool dirty;                       // needs (re)parsing
+    bool published;                   // parsed at least once
+    int version;                      // bumped by every swap
+    int depCount;                     // files that trigger a re-parse
+    char deps[ASSET_MAX_DEPS][ASSET_PATH_MAX];
+    long long depStamps[ASSET_MAX_DEPS];  // AssetFileStamp_, when polling
+} AssetSlot;
+
+typedef struct {
+    AssetSlot slots[ASSETS_MAX];
+    int count;
+    int reloads;                      // swaps after the first load, for overlays/logs
+    int pollTick;
+#ifndef ASSETS_SERIAL
+    bool running;                     // loader thread started (cleared to stop it)
+    bool locking;                     // lock initialized; stays set until the thread is joined
+    pthread_t thread;
+    pthread_mutex_t lock;             // slots' dirty/pending/deps, count
+    pthread_cond_t published;         // signalled after each batch is published
+    int wakePipe[2];                  // pokes the loader out of poll()
+    int inotifyFd;
+    int watchCount;
+    int watchIds[ASSETS_MAX_WATCHES];
+    char watchDirs[ASSETS_MAX_WATCHES][ASSET_PATH_MAX];
+#endif
+} AssetRegistry;
+
+static AssetRegistry assetRegistry;
+
+// --- Parsing (loader thread, or inline in serial mode) ---
+
+// Directory part of path with its trailing '/', or "" (matches LoadPuppetRigText).
+static inline void AssetDir_(const char *path, char *dir, size_t size) {
+    snprintf(dir, size, "%s", path);
+    char *slash = strrchr(dir, '/');
+    if (slash) slash[1] = '\0';
+    else dir[0] = '\0';
+}
+
+// The .spr2d files a rig names, as LoadPuppetRigText resolves them.
+static inline int AssetRigDeps_(const char *rigPath, char (*deps)[ASSET_PATH_MAX], int max) {
+    FILE *f = fopen(rigPath, "r");
+    if (!f) return 0;
+    char dir[ASSET_PATH_MAX], line[256], name[16], sprFile[64];
+    AssetDir_(rigPath, dir, sizeof(dir));
+    int count = 0;
+    while (fgets(line, sizeof(line), f) && count < max)
+        if (line[0] != '#' && sscanf(line, "part %15s %63s", name, sprFile) == 2)
+            snprintf(deps[count++], ASSET_PATH_MAX, "%s%s", dir, sprFile);
+    fclose(f);
+    return count;
+}
+
+// mtime and size together: plain st_mtime is whole seconds, too coarse alone
+// for a save right after a load.
+static inline long long AssetFileStamp_(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long long)st.st_mtime * 1000003 + (long long)st.st_size : 0;
+}
+
+// Parse one asset into a fresh allocation of slot->size bytes and list the
+// files it was built from. fromPack: first load, where the pack may serve it.
+static inline void *AssetParse_(AssetType type, const char *path, const char *rigPath, bool loop, size_t size,
+                                bool fromPack, char (*deps)[ASSET_PATH_MAX], int *depCount) {
+    void *data = calloc(1, size);
+    if (!data) return NULL;
+    snprintf(deps[0], ASSET_PATH_MAX, "%s", path);
+    *depCount = 1;
+    switch (type) {
+        case ASSET_OBJ3D: {
+            Object3DAsset *a = (Object3DAsset *)data;
+            a->count = fromPack ? LoadObject3D(path, a->parts, ASSET_OBJ3D_MAX_PARTS)
+                                : LoadObject3DText(path, a->parts, ASSET_OBJ3D_MAX_PARTS);
+            a->bounds = ComputeObject3DBounds(a->parts, a->count);
+        } break;
+        case ASSET_SPR2D: {
+            Sprite2DAsset *a = (Sprite2DAsset *)data;
+            a->count = fromPack ? LoadSprite2D(path, a->parts, MAX_FRAME_PARTS)
+                                : LoadSprite2DText(path, a->parts, MAX_FRAME_PARTS);
+            a->bounds = ComputeSprite2DBounds(a->parts, a->count);
+        } break;
+        case ASSET_RIG2D:
+            if (fromPack) LoadPuppetRig(path, (PuppetRig *)data);
+            else LoadPuppetRigText(path, (PuppetRig *)data);
+            *depCount += AssetRigDeps_(path, deps + 1, ASSET_MAX_DEPS - 1);
+            break;
+        case ASSET_ANIM2D: {
+            PuppetRig *rig = (PuppetRig *)calloc(1, sizeof(PuppetRig));
+            if (!rig) break;
+            if (fromPack) { LoadPuppetRig(rigPath, rig); LoadPuppetAnim(path, (PuppetAnim *)data, rig); }
+            else { LoadPuppetRigText(rigPath, rig); LoadPuppetAnimText(path, (PuppetAnim *)data, rig); }
+            free(rig);
+            snprintf(deps[1], ASSET_PATH_MAX, "%s", rigPath);
+            *depCount = 2 + AssetRigDeps_(rigPath, deps + 2, ASSET_MAX_DEPS - 2);
+        } break;
+        case ASSET_SPRANIM: {
+            SpriteAnim *a = (SpriteAnim *)data;
+            if (fromPack) LoadSpriteAnim(path, a, loop);
+            else LoadSpriteAnimText(path, a, loop);
+            // Every frame file, plus the next one so adding a frame reloads too
+            *depCount = 0;
+            for (int i = 0; i <= a->frameCount && i < ASSET_MAX_DEPS; i++, (*depCount)++)
+                snprintf(deps[i], ASSET_PATH_MAX, "%.*s_%d.spr2d", ASSET_PATH_MAX - 16, path, i);
+        } break;
+    }
+    return data;
+}
+
+// Mark every asset built from path for re-parsing. Caller holds the lock.
+static inline int AssetsMarkChanged_(const char *path) {
+    int marked = 0;
+    for (int i = 0; i < assetRegistry.count; i++) {
+        AssetSlot *s = &assetRegistry.slots[i];
+        for (int d = 0; d < s->depCount; d++)
+            if (strcmp(s->deps[d], path) == 0) { s->dirty = true; marked++; break; }
+    }
+    return marked;
+}
+
+// Mark assets whose files changed stamp. Caller holds the lock.
+static inline void AssetsPollTimes_(void) {
+    for (int i = 0; i < assetRegistry.count; i++) {
+        AssetSlot *s = &assetRegistry.slots[i];
+        for (int d = 0; d < s->depCount; d++) {
+            long long t = AssetFileStamp_(s->deps[d]);
+            if (t != s->depStamps[d]) { s->depStamps[d] = t; s->dirty = true; }
+        }
+    }
+}
+
+static inline void AssetsRecordStamps_(AssetSlot *s) {
+    for (int d = 0; d < s->depCount; d++) s->depStamps[d] = AssetFileStamp_(s->deps[d]);
+}
+
+// --- Loader thread ---
+#ifndef ASSETS_SERIAL
+// The lock exists only between AssetsInit and AssetsShutdown.
+static inline void AssetsLock_(void) { if (assetRegistry.locking) pthread_mutex_lock(&assetRegistry.lock); }
+static inline void AssetsUnlock_(void) { if (assetRegistry.locking) pthread_mutex_unlock(&assetRegistry.lock); }
+
+static inline void AssetsWake_(void) {
+    char c = 1;
+    if (write(assetRegistry.wakePipe[1], &c, 1) < 0) { /* pipe full: already awake */ }
+}
+
+#if ASSETS_INOTIFY
+// Watch the directory (editors often save by rename, which a file watch misses).
+static inline void AssetsWatchDir_(const char *path) {
+    char dir[ASSET_PATH_MAX];
+    AssetDir_(path, dir, sizeof(dir));
+    for (int i = 0; i < assetRegistry.watchCount; i++)
+        if (strcmp(assetRegistry.watchDirs[i], dir) == 0) return;
+    if (assetRegistry.watchCount == ASSETS_MAX_WATCHES) return;
+    int wd = inotify_add_watch(assetRegistry.inotifyFd, dir[0] ? dir : ".", IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) return;
+    assetRegistry.watchIds[assetRegistry.watchCount] = wd;
+    strcpy(assetRegistry.watchDirs[assetRegistry.watchCount++], dir);
+}
+
+static inline void AssetsReadEvents_(void) {
+    union { struct inotify_event align; char buf[4096]; } u;
+    char *buf = u.buf;
+    ssize_t len;
+    while ((len = read(assetRegistry.inotifyFd, buf, sizeof(u.buf))) > 0) {
+        AssetsLock_();
+        for (char *at = buf; at < buf + len; ) {
+            const struct inotify_event *e = (const struct inotify_event *)at;
+            at += sizeof(*e) + e->len;
+            if (e->len == 0) continue;
+            for (int i = 0; i < assetRegistry.watchCount; i++) {
+                if (assetRegistry.watchIds[i] != e->wd) continue;
+                char path[ASSET_PATH_MAX * 2];
+                snprintf(path, sizeof(path), "%s%s", assetRegistry.watchDirs[i], e->name);
+                AssetsMarkChanged_(path);
+                break;
+            }
+        }
+        AssetsUnlock_();
+    }
+}
+#endif
+
+// Parse everything dirty, then publish the batch at once so a rig and its
+// anims change together.
+static inline void AssetsParseDirty_(void) {
+    static int todo[ASSETS_MAX];
+    static void *parsed[ASSETS_MAX];
+    static char deps[ASSETS_MAX][ASSET_MAX_DEPS][ASSET_PATH_MAX];
+    static int depCounts[ASSETS_MAX];
+    int n = 0;
+    AssetsLock_();
+    for (int i = 0; i < assetRegistry.count; i++)
+        if (assetRegistry.slots[i].dirty) { assetRegistry.slots[i].dirty = false; todo[n++] = i; }
+    AssetsUnlock_();
+    if (n == 0) return;
+
+    // Slots never move once registered, and only this thread writes path/type
+    for (int k = 0; k < n; k++) {
+        AssetSlot *s = &assetRegistry.slots[todo[k]];
+        parsed[k] = AssetParse_(s->type, s->path, s->rigPath, s->loop, s->size, !s->published, deps[k], &depCounts[k]);
+    }
+
+#if ASSETS_INOTIFY
+    // Before publishing, so no edit after AssetsWaitLoaded returns is missed
+    for (int k = 0; k < n; k++)
+        for (int d = 0; d < depCounts[k]; d++) AssetsWatchDir_(deps[k][d]);
+#endif
+
+    AssetsLock_();
+    for (int k = 0; k < n; k++) {
+        AssetSlot *s = &assetRegistry.slots[todo[k]];
+        if (!parsed[k]) {
+            // Out of memory: leave the live copy as it was, retry on the next
+            // pass, and don't keep AssetsWaitLoaded waiting for it
+            s->published = true;
+            s->dirty = true;
+            continue;
+        }
+        free(s->pending);
+        s->pending = parsed[k];
+        s->published = true;
+        s->depCount = depCounts[k];
+        memcpy(s->deps, deps[k], sizeof(s->deps));
+        AssetsRecordStamps_(s);
+    }
+    pthread_cond_broadcast(&assetRegistry.published);
+    AssetsUnlock_();
+}
+
+static inline void *AssetsLoaderMain_(void *arg) {
+    (void)arg;
+    while (__atomic_load_n(&assetRegistry.running, __ATOMIC_ACQUIRE)) {
+        AssetsParseDirty_();
+        struct pollfd fds[2] = { { assetRegistry.wakePipe[0], POLLIN, 0 }, { assetRegistry.inotifyFd, POLLIN, 0 } };
+        int ready = poll(fds, ASSETS_INOTIFY ? 2 : 1, ASSETS_INOTIFY ? -1 : ASSETS_POLL_MS);
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            char drain[64];
+            while (read(assetRegistry.wakePipe[0], drain, sizeof(drain)) > 0) {}
+        }
+#if ASSETS_INOTIFY
+        if (ready > 0 && (fds[1].revents & POLLIN)) AssetsReadEvents_();
+#else
+        if (ready == 0) { AssetsLock_(); AssetsPollTimes_(); AssetsUnlock_(); }
+#endif
+    }
+    return NULL;
+}
+#else
+static inline void AssetsLock_(void) {}
+static inline void AssetsUnlock_(void) {}
+#endif
+
+// --- API ---
+
+static inline bool AssetsRunning_(void) {
+#ifndef ASSETS_SERIAL
+    return assetRegistry.running;
+#else
+    return false;
+#endif
+}
+
+// Start the loader thread. Call before requesting assets; false (serial
+// fallback) if the thread or watcher could not be set up.
+static inline bool AssetsInit(void) {
+#ifndef ASSETS_SERIAL
+    if (assetRegistry.running) return true;
+    if (pipe(assetRegistry.wakePipe) != 0) return false;
+    fcntl(assetRegistry.wakePipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(assetRegistry.wakePipe[1], F_SETFL, O_NONBLOCK);
+#if ASSETS_INOTIFY
+    assetRegistry.inotifyFd = inotify_init();
+    if (assetRegistry.inotifyFd >= 0) fcntl(assetRegistry.inotifyFd, F_SETFL, O_NONBLOCK);
+#else
+    assetRegistry.inotifyFd = -1;
+#endif
+    pthread_mutex_init(&assetRegistry.lock, NULL);
+    pthread_cond_init(&assetRegistry.published, NULL);
+    assetRegistry.locking = true;
+    assetRegistry.running = true;
+    if (
+#if ASSETS_INOTIFY
+        assetRegistry.inotifyFd < 0 ||
+#endif
+        pthread_create(&assetRegistry.thread, NULL, AssetsLoaderMain_, NULL) != 0) {
+        assetRegistry.running = assetRegistry.locking = false;
+        pthread_mutex_destroy(&assetRegistry.lock);
+        pthread_cond_destroy(&assetRegistry.published);
+        if (assetRegistry.inotifyFd >= 0) close(assetRegistry.inotifyFd);
+        close(assetRegistry.wakePipe[0]);
+        close(assetRegistry.wakePipe[1]);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Register (or find) an asset. Live storage exists from here on; its
+// contents arrive with AssetsWaitLoaded/AssetsUpdate, or right away in
+// serial mode.
+static inline void *AssetAcquire_(AssetType type, const char *path, const char *rigPath, bool loop, size_t size) {
+    if (!rigPath) rigPath = "";
+    AssetsLock_();
+    for (int i = 0; i < assetRegistry.count; i++) {
+        AssetSlot *s = &assetRegistry.slots[i];
+        if (s->type == type && strcmp(s->path, path) == 0 && strcmp(s->rigPath, rigPath) == 0) {
+            AssetsUnlock_();
+            return s->live;
+        }
+    }
+    void *live = (assetRegistry.count < ASSETS_MAX && strlen(path) < ASSET_PATH_MAX
+                  && strlen(rigPath) < ASSET_PATH_MAX) ? calloc(1, size) : NULL;
+    if (!live) { AssetsUnlock_(); return NULL; }
+    AssetSlot *s = &assetRegistry.slots[assetRegistry.count];
+    memset(s, 0, sizeof(*s));
+    s->type = type;
+    strcpy(s->path, path);
+    strcpy(s->rigPath, rigPath);
+    s->loop = loop;
+    s->live = live;
+    s->size = size;
+    s->dirty = true;
+    assetRegistry.count++;
+    AssetsUnlock_();
+
+    if (AssetsRunning_()) {
+#ifndef ASSETS_SERIAL
+        AssetsWake_();
+#endif
+    } else {
+        void *data = AssetParse_(type, s->path, s->rigPath, loop, size, true, s->deps, &s->depCount);
+        if (data) { memcpy(s->live, data, size); free(data); }
+        s->dirty = false;
+        s->published = true;
+        s->version = 1;
+        AssetsRecordStamps_(s);
+    }
+    return live;
+}
+
+static inline Object3DAsset *AssetObject3D(const char *path) {
+    return (Object3DAsset *)AssetAcquire_(ASSET_OBJ3D, path, NULL, false, sizeof(Object3DAsset));
+}
+
+static inline Sprite2DAsset *AssetSprite2D(const char *path) {
+    return (Sprite2DAsset *)AssetAcquire_(ASSET_SPR2D, path, NULL, false, sizeof(Sprite2DAsset));
+}
+
+static inline PuppetRig *AssetPuppetRig(const char *path) {
+    return (PuppetRig *)AssetAcquire_(ASSET_RIG2D, path, NULL, false, sizeof(PuppetRig));
+}
+
+// Poses resolve against rigPath's part names; request the rig too to draw it.
+static inline PuppetAnim *AssetPuppetAnim(const char *path, const char *rigPath) {
+    return (PuppetAnim *)AssetAcquire_(ASSET_ANIM2D, path, rigPath, false, sizeof(PuppetAnim));
+}
+
+// Frame-by-frame anim from basePath_0.spr2d, basePath_1.spr2d, ... (as LoadSpriteAnim).
+static inline SpriteAnim *AssetSpriteAnim(const char *basePath, bool loop) {
+    return (SpriteAnim *)AssetAcquire_(ASSET_SPRANIM, basePath, NULL, loop, sizeof(SpriteAnim));
+}
+
+// Swap in whatever finished parsing. Call once per frame, before update and
+// draw. Never waits on the loader: if it is mid-publish the swap happens
+// next frame. Returns how many assets changed.
+static inline int AssetsUpdate(void) {
+    int swapped = 0;
+#ifndef ASSETS_SERIAL
+    if (assetRegistry.running) {
+        if (pthread_mutex_trylock(&assetRegistry.lock) != 0) return 0;
+        for (int i = 0; i < assetRegistry.count; i++) {
+            AssetSlot *s = &assetRegistry.slots[i];
+            if (!s->pending) continue;
+            memcpy(s->live, s->pending, s->size);
+            free(s->pending);
+            s->pending = NULL;
+            if (s->version++ > 0) assetRegistry.reloads++;
+            swapped++;
+        }
+        AssetsUnlock_();
+        return swapped;
+    }
+#endif
+    if (++assetRegistry.pollTick < ASSETS_POLL_FRAMES) return 0;
+    assetRegistry.pollTick = 0;
+    AssetsPollTimes_();
+    for (int i = 0; i < assetRegistry.count; i++) {
+        AssetSlot *s = &assetRegistry.slots[i];
+        if (!s->dirty) continue;
+        void *data = AssetParse_(s->type, s->path, s->rigPath, s->loop, s->size, false, s->deps, &s->depCount);
+        s->dirty = false;
+        if (!data) continue;
+        memcpy(s->live, data, s->size);
+        free(data);
+        AssetsRecordStamps_(s);
+        s->version++;
+        assetRegistry.reloads++;
+        swapped++;
+    }
+    return swapped;
+}
+
+// Block until every requested asset has been parsed once, then swap them in.
+// For startup, after the Asset* requests; returns at once in serial mode.
+static inline void AssetsWaitLoaded(void) {
+#ifndef ASSETS_SERIAL
+    if (!assetRegistry.running) return;
+    AssetsLock_();
+    for (;;) {
+        bool all = true;
+        for (int i = 0; i < assetRegistry.count && all; i++) all = assetRegistry.slots[i].published;
+        if (all) break;
+        pthread_cond_wait(&assetRegistry.published, &assetRegistry.lock);
+    }
+    AssetsUnlock_();
+    while (AssetsUpdate() == 0) {
+        bool pending = false;
+        AssetsLock_();
+        for (int i = 0; i < assetRegistry.count; i++) pending |= assetRegistry.slots[i].pending != NULL;
+        AssetsUnlock_();
+        if (!pending) break;
+    }
+#endif
+}
+
+// Times the asset holding data has been swapped in (0: not loaded yet), so
+// derived data (a compiled Prefab3D, say) knows to rebuild. -1 if unknown.
+static inline int AssetVersion(const void *data) {
+    for (int i = 0; i < assetRegistry.count; i++)
+        if (assetRegistry.slots[i].live == data) return assetRegistry.slots[i].version;
+    return -1;
+}
+
+// Stop the loader and free every asset; pointers handed out become invalid.
+static inline void AssetsShutdown(void) {
+#ifndef ASSETS_SERIAL
+    if (assetRegistry.running) {
+        __atomic_store_n(&assetRegistry.running, false, __ATOMIC_RELEASE);
+        AssetsWake_();
+        pthread_join(assetRegistry.thread, NULL);
+        assetRegistry.locking = false;
+        if (assetRegistry.inotifyFd >= 0) close(assetRegistry.inotifyFd);
+        close(assetRegistry.wakePipe[0]);
+        close(assetRegistry.wakePipe[1]);
+        pthread_mutex_destroy(&assetRegistry.lock);
+        pthread_cond_destroy(&assetRegistry.published);
+    }
+#endif
+    for (int i = 0; i < assetRegistry.count; i++) {
+        free(assetRegistry.slots[i].live);
+        free(assetRegistry.slots[i].pending);
+    }
+    memset(&assetRegistry, 0, sizeof(assetRegistry));
+}
+
+#endif // ASSETS_H
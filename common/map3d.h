@@ -19,22 +19,55 @@
 //       "1000000001"
 //       "1111111111";
 //   Map3DLoad(&map, layout, 10, 5, 2.0, defs, 4);
-//   Map3DDrawAll(&map);
+//   Map3DDrawAll(&map);          // baked chunk meshes + animated water
+//
+//   Map3DSet(&map, 3, 2, 1);     // edit: rebakes only the touched chunks
+//
+//   Map3DHit hit = Map3DRaycast(&map, eye, forward, 100.0f);   // hitscan
+//   if (hit.hit) SpawnSpark(hit.point, hit.normal);
+//   bool seen = Map3DLineOfSight(&map, guardEye, playerHead);
+//
+//   // Or only the chunks the camera sees, nearest first (VisibleList: util/camera.h)
+//   InitVisibleList(&vis, map.chunksX * map.chunksZ);
+//   Frustum view = CameraFrustumDefault(camera, (float)GetScreenWidth() / GetScreenHeight());
+//   Map3DDrawVisible(&map, &vis, &view, camera.position);
+//   UnloadMap3D(&map);           // before CloseWindow
+//
+//   // Large worlds: start blank (all defs[0]) and paint. Tiles are stored in
+//   // MAP3D_CHUNK-square chunks allocated on first paint, so memory follows
+//   // the painted area, not width * height.
+//   InitMap3D(&world, 4096, 4096, 2.0f, defs, 4);
+//   Map3DSet(&world, 2000, 1500, 1);
+//   SaveMap3DBinary("world.m3db", &world, true);
+//
+//   // Stream it back: the file is mapped, chunks are read as the camera nears
+//   OpenMap3D(&world, "world.m3db");
+//   Map3DStream(&world, camera.position, 120.0f, 8);   // every frame
 
 #ifndef MAP3D_H
 #define MAP3D_H
 
 #include "raylib.h"
 #include "raymath.h"
+#include <float.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include "util/camera.h"
+#include "util/pack.h"
 
 // --- Types ---
 
-#define MAP3D_MAX_W    64
-#define MAP3D_MAX_H    64
-#define MAP3D_MAX_DEFS 36   // '0'-'9' + 'a'-'z'
+#define MAP3D_MAX_DEFS    36   // '0'-'9' + 'a'-'z'
+#define MAP3D_CHUNK_SHIFT 4
+#define MAP3D_CHUNK       (1 << MAP3D_CHUNK_SHIFT)   // tiles per chunk side; each chunk bakes to one mesh
+#define MAP3D_CHUNK_MASK  (MAP3D_CHUNK - 1)
+#define MAP3D_PIT_DEPTH   1.0f   // how far pits drop below the floor
+#define MAP3D_WAVE        0.05f  // water's wave height
+#define MAP3D_TREE_LEVELS 32
+#define MAP3D_DIRTY_MAX   256  // chunks queued for Map3DBake before it falls back to checking them all
 
 typedef enum {
     TILE_EMPTY,     // nothing, void
@@ -56,12 +89,82 @@ typedef struct {
     Color sideColor;
 } TileDef;
 
+// A MAP3D_CHUNK square of tiles and its static geometry, rebuilt when they change
+typedef struct {
+    unsigned char tiles[MAP3D_CHUNK * MAP3D_CHUNK];   // index into defs, row-major
+    Mesh mesh;          // CPU arrays; GPU buffers once first drawn
+    bool built;         // mesh matches the tiles (false = rebake before drawing)
+    bool uploaded;
+    bool edited;        // changed since it was read from the file (never dropped)
+    bool filler;        // blank stand-in from Map3DBake to draw its own sides; file tiles unread
+    int waterCount;     // water tiles, drawn live on top of the mesh
+    float top;          // highest point drawn, -FLT_MAX if nothing (set when built)
+    int live;           // its index in Map3D.live
+} Map3DChunk;
+
+// Binary map file (.m3db), little-endian:
+//   Map3DFileHeader
+//   Map3DFileDef[defCount]
+//   chunk payloads: MAP3D_CHUNK^2 tile bytes, raw or LZ (util/pack.h)
+//   Map3DFileChunk[chunksX * chunksZ] at dirOffset, row-major
+#define MAP3D_BINARY_MAGIC   "RLM3"
+#define MAP3D_BINARY_VERSION 1
+
+typedef enum { MAP3D_CODEC_RAW = 0, MAP3D_CODEC_LZ = 1 } Map3DCodec;
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    int32_t width, height;   // tiles
+    float tileSize;
+    uint32_t defCount;
+    uint32_t chunkShift;     // MAP3D_CHUNK_SHIFT it was written with
+    uint32_t reserved;
+    uint64_t dirOffset;      // 8-aligned
+} Map3DFileHeader;
+
+typedef struct {
+    uint8_t type;            // TileType
+    uint8_t top[4], side[4]; // RGBA
+    uint8_t pad[3];
+    float height;
+} Map3DFileDef;
+
+typedef struct {
+    uint64_t offset;         // 0: never painted (all defs[0])
+    uint32_t size;           // stored bytes
+    uint32_t codec;          // Map3DCodec
+} Map3DFileChunk;
+
 typedef struct {
-    int tiles[MAP3D_MAX_H][MAP3D_MAX_W];   // index into defs array
+    Map3DChunk **chunks;     // chunksX * chunksZ, row-major; unpainted ones all
+                             // point at one shared, read-only chunk of defs[0]
+    int chunksX, chunksZ;
+    int chunkCount;          // chunks allocated (painted, or fillers)
+    int *live;               // their directory indices, chunkCount long, so
+    int liveCap;             // Map3DStream need not walk the whole directory
     int width, height;
     float tileSize;          // world units per tile
     TileDef defs[MAP3D_MAX_DEFS];
     int numDefs;
+    Map3DChunk background;   // mesh every unpainted chunk draws (tiles unused)
+    // Binary file opened with OpenMap3D: its chunks read as unpainted until
+    // Map3DStream (or an edit) reads them in
+    const unsigned char *file;
+    size_t fileSize;
+    const Map3DFileChunk *fileChunks;   // chunksX * chunksZ, inside file
+    // Quadtree over the chunks for culling, built by Map3DBake: level 0 is
+    // each chunk's top, every level above it the max of 2x2 nodes below,
+    // up to one root. -FLT_MAX marks a node with nothing to draw.
+    float *tree;
+    int treeLevels;
+    int treeOffset[MAP3D_TREE_LEVELS];   // first node of each level in tree
+    // Chunks the next Map3DBake looks at: queued by edits, reads and drops,
+    // so a frame where nothing changed bakes nothing. Past MAP3D_DIRTY_MAX,
+    // or after Map3DInvalidate, it checks every chunk instead.
+    int dirty[MAP3D_DIRTY_MAX];
+    int dirtyCount;
+    bool dirtyAll;
 } Map3D;
 
 // --- Shorthand macros for tile definitions ---
@@ -93,32 +196,192 @@ typedef struct {
 
 // --- API ---
 
-// Load map from string: chars '0'-'9' map to defs[0]-defs[9], 'a'-'z' to defs[10]-defs[35]
-static inline void Map3DLoad(Map3D *map, const char *layout, int w, int h,
-                             float tileSize, TileDef *defs, int numDefs) {
+static Map3DChunk map3DUnpainted_;   // all zero: defs[0] everywhere; never written
+
+static inline void UnloadMap3D(Map3D *map);
+
+// Start a blank map: every tile defs[0], nothing allocated past the chunk
+// directory (one pointer per chunk). A map being reused is freed first, so
+// map must be zeroed or hold a map. False if the directory can't be allocated.
+static inline bool InitMap3D(Map3D *map, int w, int h, float tileSize,
+                             const TileDef *defs, int numDefs) {
+    UnloadMap3D(map);
+    if (w <= 0 || h <= 0) return false;
+    int chunksX = (w + MAP3D_CHUNK_MASK) >> MAP3D_CHUNK_SHIFT;
+    int chunksZ = (h + MAP3D_CHUNK_MASK) >> MAP3D_CHUNK_SHIFT;
+    Map3DChunk **dir = (Map3DChunk **)malloc(sizeof(Map3DChunk *) * (size_t)chunksX * (size_t)chunksZ);
+    if (!dir) return false;
+    for (size_t i = 0; i < (size_t)chunksX * (size_t)chunksZ; i++) dir[i] = &map3DUnpainted_;
+    map->chunks = dir;
+    map->chunksX = chunksX;
+    map->chunksZ = chunksZ;
     map->width = w;
     map->height = h;
     map->tileSize = tileSize;
-    map->numDefs = numDefs;
-    for (int i = 0; i < numDefs && i < MAP3D_MAX_DEFS; i++) map->defs[i] = defs[i];
-
-    for (int y = 0; y < h && y < MAP3D_MAX_H; y++) {
-        for (int x = 0; x < w && x < MAP3D_MAX_W; x++) {
-            char c = layout[y * w + x];
-            int idx = 0;
-            if (c >= '0' && c <= '9') idx = c - '0';
-            else if (c >= 'a' && c <= 'z') idx = 10 + (c - 'a');
-            else if (c == ' ' || c == '.') idx = 0;
-            map->tiles[y][x] = idx;
-        }
+    map->numDefs = numDefs < MAP3D_MAX_DEFS ? numDefs : MAP3D_MAX_DEFS;
+    for (int i = 0; i < map->numDefs; i++) map->defs[i] = defs[i];
+    return true;
+}
+
+// Mark every chunk for rebaking, e.g. after changing defs
+static inline void Map3DInvalidate(Map3D *map) {
+    for (int i = 0; i < map->chunksX * map->chunksZ; i++)
+        if (map->chunks[i] != &map3DUnpainted_) map->chunks[i]->built = false;
+    map->background.built = false;
+    map->dirtyAll = true;
+}
+
+// Swap in a new def table (same indices, new looks or heights) and rebake
+static inline void Map3DSetDefs(Map3D *map, const TileDef *defs, int numDefs) {
+    map->numDefs = numDefs < MAP3D_MAX_DEFS ? numDefs : MAP3D_MAX_DEFS;
+    for (int i = 0; i < map->numDefs; i++) map->defs[i] = defs[i];
+    Map3DInvalidate(map);
+}
+
+// Layout char to def index: '0'-'9' -> 0-9, 'a'-'z' -> 10-35, anything else 0
+static inline int Map3DTileFromChar_(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'z') return 10 + (c - 'a');
+    return 0;
+}
+
+static inline char Map3DTileToChar_(int t) {
+    return (char)(t < 10 ? '0' + t : 'a' + (t - 10));
+}
+
+// Read chunk i's tiles from the open file. False if it is not in the file or
+// is corrupt (tiles then all 0). Ids past the def table also read as 0.
+static inline bool Map3DReadFileChunk_(const Map3D *map, int i, unsigned char *tiles) {
+    memset(tiles, 0, MAP3D_CHUNK * MAP3D_CHUNK);
+    if (!map->fileChunks || map->fileChunks[i].offset == 0) return false;
+    const Map3DFileChunk *e = &map->fileChunks[i];
+    if (e->offset > map->fileSize || e->size > map->fileSize - e->offset) return false;
+    const unsigned char *src = map->file + e->offset;
+    int n = MAP3D_CHUNK * MAP3D_CHUNK;
+    bool ok = (e->codec == MAP3D_CODEC_RAW && e->size == (uint32_t)n && (memcpy(tiles, src, (size_t)n), true))
+           || (e->codec == MAP3D_CODEC_LZ && PackLZDecompress(src, (int)e->size, tiles, n) == n);
+    if (!ok) { memset(tiles, 0, (size_t)n); return false; }
+    for (int t = 0; t < n; t++) if (tiles[t] >= MAP3D_MAX_DEFS) tiles[t] = 0;
+    return true;
+}
+
+// Queue chunk i for the next Map3DBake, and with rebake mark it stale if it
+// is allocated (an unpainted one is only checked for needing a filler).
+// Repeats of the last queued chunk, the common case while painting, are dropped.
+static inline void Map3DTouch_(Map3D *map, int i, bool rebake) {
+    Map3DChunk *c = map->chunks[i];
+    if (rebake && c != &map3DUnpainted_) c->built = false;
+    if (map->dirtyCount > 0 && map->dirty[map->dirtyCount - 1] == i) return;
+    if (map->dirtyCount == MAP3D_DIRTY_MAX) map->dirtyAll = true;
+    else map->dirty[map->dirtyCount++] = i;
+}
+
+// A chunk's faces on its edges depend on its neighbours: rebake them (or,
+// without rebake, only check whether they now need fillers)
+static inline void Map3DTouchNeighbours_(Map3D *map, int cx, int cz, bool rebake) {
+    static const int nbr[4][2] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+    for (int k = 0; k < 4; k++) {
+        int x = cx + nbr[k][0], z = cz + nbr[k][1];
+        if (x < 0 || x >= map->chunksX || z < 0 || z >= map->chunksZ) continue;
+        Map3DTouch_(map, z * map->chunksX + x, rebake);
     }
 }
 
+// A fresh blank chunk in unpainted slot i, added to map->live
+static inline Map3DChunk *Map3DNewChunk_(Map3D *map, int i) {
+    if (map->chunkCount == map->liveCap) {
+        int cap = map->liveCap ? 2 * map->liveCap : 64;
+        int *live = (int *)realloc(map->live, sizeof(int) * (size_t)cap);
+        if (!live) return NULL;
+        map->live = live;
+        map->liveCap = cap;
+    }
+    Map3DChunk *c = (Map3DChunk *)calloc(1, sizeof(Map3DChunk));
+    if (!c) return NULL;
+    c->live = map->chunkCount;
+    map->live[map->chunkCount++] = i;
+    map->chunks[i] = c;
+    return c;
+}
+
+// Free chunk i and put the unpainted one back in its slot
+static inline void Map3DFreeChunk_(Map3D *map, int i) {
+    Map3DChunk *c = map->chunks[i];
+    if (c->mesh.vertices || c->uploaded) UnloadMesh(c->mesh);
+    int last = map->live[--map->chunkCount];
+    map->live[c->live] = last;
+    map->chunks[last]->live = c->live;
+    free(c);
+    map->chunks[i] = &map3DUnpainted_;
+}
+
+// Give unpainted chunk i (or a filler, in place) its tiles: zeros, or the file's
+static inline Map3DChunk *Map3DAllocChunk_(Map3D *map, int i) {
+    Map3DChunk *c = map->chunks[i];
+    if (c == &map3DUnpainted_ && !(c = Map3DNewChunk_(map, i))) return NULL;
+    c->filler = false;
+    // Read, its edge faces change; blank, it still now counts as painted
+    // beside its neighbours (Map3DNeedsOwnChunk_)
+    bool read = Map3DReadFileChunk_(map, i, c->tiles);
+    Map3DTouch_(map, i, read);
+    Map3DTouchNeighbours_(map, i % map->chunksX, i / map->chunksX, read);
+    return c;
+}
+
+// Chunk holding a tile (on the map)
+static inline Map3DChunk *Map3DChunkAt_(Map3D *map, int tx, int tz) {
+    return map->chunks[(tz >> MAP3D_CHUNK_SHIFT) * map->chunksX + (tx >> MAP3D_CHUNK_SHIFT)];
+}
+
+// Def index at grid position (0 off the map)
+static inline int Map3DTile(Map3D *map, int tx, int tz) {
+    if (tx < 0 || tx >= map->width || tz < 0 || tz >= map->height) return 0;
+    return Map3DChunkAt_(map, tx, tz)->tiles[((tz & MAP3D_CHUNK_MASK) << MAP3D_CHUNK_SHIFT) | (tx & MAP3D_CHUNK_MASK)];
+}
+
 // Get tile def at grid position (bounds-checked)
 static inline TileDef *Map3DGet(Map3D *map, int tx, int tz) {
-    if (tx < 0 || tx >= map->width || tz < 0 || tz >= map->height)
-        return &map->defs[0];
-    return &map->defs[map->tiles[tz][tx]];
+    return &map->defs[Map3DTile(map, tx, tz)];
+}
+
+// Set one tile, allocating its chunk on the first paint. Rebakes the chunk
+// holding it, and the neighbouring chunk when it sits on a chunk edge (faces
+// against it may appear or vanish). False off the map or out of memory.
+static inline bool Map3DSet(Map3D *map, int tx, int tz, int idx) {
+    if (tx < 0 || tx >= map->width || tz < 0 || tz >= map->height) return false;
+    if (idx < 0 || idx >= MAP3D_MAX_DEFS) return false;
+    if (Map3DTile(map, tx, tz) == idx) return true;
+    int i = (tz >> MAP3D_CHUNK_SHIFT) * map->chunksX + (tx >> MAP3D_CHUNK_SHIFT);
+    Map3DChunk *chunk = map->chunks[i];
+    if (chunk == &map3DUnpainted_ || chunk->filler) {
+        chunk = Map3DAllocChunk_(map, i);   // an unread file chunk is read first
+        if (!chunk) return false;
+        if (Map3DTile(map, tx, tz) == idx) return true;
+    }
+    chunk->tiles[((tz & MAP3D_CHUNK_MASK) << MAP3D_CHUNK_SHIFT) | (tx & MAP3D_CHUNK_MASK)] = (unsigned char)idx;
+    chunk->edited = true;
+    chunk->filler = false;
+    // The chunks under the tile's 3x3 neighbourhood: one, or up to four at a corner
+    int cx0 = (tx > 0 ? tx - 1 : 0) >> MAP3D_CHUNK_SHIFT, cx1 = (tx + 1 < map->width ? tx + 1 : tx) >> MAP3D_CHUNK_SHIFT;
+    int cz0 = (tz > 0 ? tz - 1 : 0) >> MAP3D_CHUNK_SHIFT, cz1 = (tz + 1 < map->height ? tz + 1 : tz) >> MAP3D_CHUNK_SHIFT;
+    for (int cz = cz0; cz <= cz1; cz++)
+        for (int cx = cx0; cx <= cx1; cx++) Map3DTouch_(map, cz * map->chunksX + cx, true);
+    return true;
+}
+
+// Bytes held for tiles: the chunk directory plus painted chunks
+static inline size_t Map3DMemoryUsed(const Map3D *map) {
+    return sizeof(Map3DChunk *) * (size_t)map->chunksX * (size_t)map->chunksZ
+         + sizeof(Map3DChunk) * (size_t)map->chunkCount;
+}
+
+// Load map from string: chars '0'-'9' map to defs[0]-defs[9], 'a'-'z' to defs[10]-defs[35]
+static inline void Map3DLoad(Map3D *map, const char *layout, int w, int h,
+                             float tileSize, TileDef *defs, int numDefs) {
+    if (!InitMap3D(map, w, h, tileSize, defs, numDefs)) return;
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+            Map3DSet(map, x, y, Map3DTileFromChar_(layout[y * w + x]));
 }
 
 // Convert grid coords to world position (tile center, ground level)
@@ -133,7 +396,8 @@ static inline void Map3DFromWorld(Map3D *map, Vector3 pos, int *tx, int *tz) {
     *tz = (int)(pos.z / map->tileSize);
 }
 
-// Get the floor height at a world position (handles ramps)
+// Get the floor height at a world position (handles ramps). Like every tile
+// query, a chunk OpenMap3D has not streamed in yet reads as defs[0].
 static inline float Map3DHeightAt(Map3D *map, Vector3 pos) {
     int tx, tz;
     Map3DFromWorld(map, pos, &tx, &tz);
@@ -149,16 +413,17 @@ static inline float Map3DHeightAt(Map3D *map, Vector3 pos) {
     switch (td->type) {
         case TILE_WALL:     return td->height;
         case TILE_PLATFORM: return td->height;
-        case TILE_RAMP_N:   return td->height * fz;         // high at z=0, low at z=1
-        case TILE_RAMP_S:   return td->height * (1.0f - fz); // high at z=1
-        case TILE_RAMP_E:   return td->height * (1.0f - fx); // high at x=1
-        case TILE_RAMP_W:   return td->height * fx;          // high at x=0
-        case TILE_PIT:      return -1.0f;
+        case TILE_RAMP_N:   return td->height * (1.0f - fz); // high at z=0, low at z=1
+        case TILE_RAMP_S:   return td->height * fz;          // high at z=1
+        case TILE_RAMP_E:   return td->height * fx;          // high at x=1
+        case TILE_RAMP_W:   return td->height * (1.0f - fx); // high at x=0
+        case TILE_PIT:      return -MAP3D_PIT_DEPTH;
         default:            return 0;
     }
 }
 
-// Check if a world position collides with a solid tile (wall)
+// Check if a world position collides with a solid tile (wall); unstreamed
+// chunks are defs[0], as for Map3DHeightAt
 static inline bool Map3DSolid(Map3D *map, Vector3 pos, float radius) {
     float s = map->tileSize;
     // Check the 4 grid cells the radius could touch
@@ -180,6 +445,160 @@ static inline bool Map3DOutOfBounds(Map3D *map, Vector3 pos) {
            pos.z >= map->height * map->tileSize;
 }
 
+// --- Raycasting ---
+// Each tile is a solid column, all the way down, under its surface: 0 for
+// floor and water, the height for walls and platforms, the slope for ramps
+// (high edge as drawn), the pit floor for pits. Empty tiles and off the map
+// are open. Rays walk the grid a tile at a time (Amanatides & Woo), so a cast
+// costs the tiles it crosses. Inside a tile the surface is one plane, so the
+// test is exact: a ray entering a tile below its surface hits the side it
+// came through, one that dips under it on the way across hits the top.
+//
+// Queries see only the tiles in memory. On a map opened with OpenMap3D, a
+// chunk Map3DStream has not read yet is all defs[0], so rays and line of
+// sight pass through walls the file has there. Stream the area an agent
+// looks across (a radius of at least its maxDist), or LoadMap3DBinary.
+
+typedef struct {
+    bool hit;
+    float distance;     // from origin, along the (normalized) direction
+    Vector3 point;
+    Vector3 normal;     // face hit; -direction if the ray starts inside a tile
+    int tx, tz;         // tile hit
+} Map3DHit;
+
+// Surface of a tile as a plane: height h0 at its (x0, z0) corner, rising gx
+// per unit x and gz per unit z. False for tiles with nothing solid.
+static inline bool Map3DSurface_(const TileDef *td, float s, float *h0, float *gx, float *gz) {
+    float h = td->height;
+    *h0 = *gx = *gz = 0.0f;
+    switch (td->type) {
+        case TILE_FLOOR: case TILE_WATER: return true;
+        case TILE_WALL: case TILE_PLATFORM: *h0 = h; return true;
+        case TILE_RAMP_N: *h0 = h; *gz = -h / s; return true;   // high on z0
+        case TILE_RAMP_S: *gz = h / s; return true;
+        case TILE_RAMP_E: *gx = h / s; return true;             // high on x1
+        case TILE_RAMP_W: *h0 = h; *gx = -h / s; return true;
+        case TILE_PIT: *h0 = -MAP3D_PIT_DEPTH; return true;
+        default: return false;
+    }
+}
+
+// Highest any tile reaches: rays climbing past it can stop
+static inline float Map3DTopmost_(const Map3D *map) {
+    float top = 0.0f;
+    for (int i = 0; i < map->numDefs; i++) top = fmaxf(top, map->defs[i].height);
+    return top;
+}
+
+static inline Map3DHit Map3DRaycast_(Map3D *map, Vector3 origin, Vector3 dir, float maxDist, float topmost) {
+    Map3DHit out = { 0 };
+    float len = Vector3Length(dir);
+    if (len < 1e-12f || maxDist <= 0.0f || map->width <= 0) return out;
+    dir = Vector3Scale(dir, 1.0f / len);
+    float s = map->tileSize;
+
+    // Clip to the map's footprint, remembering which side the ray came in by
+    float o[2] = { origin.x, origin.z }, d[2] = { dir.x, dir.z };
+    float size[2] = { map->width * s, map->height * s };
+    float t0 = 0.0f, t1 = maxDist;
+    int entryAxis = -1;
+    for (int a = 0; a < 2; a++) {
+        if (fabsf(d[a]) < 1e-12f) {
+            if (o[a] < 0.0f || o[a] >= size[a]) return out;
+            continue;
+        }
+        float ta = (0.0f - o[a]) / d[a], tb = (size[a] - o[a]) / d[a];
+        if (ta > tb) { float t = ta; ta = tb; tb = t; }
+        if (ta > t0) { t0 = ta; entryAxis = a; }
+        if (tb < t1) t1 = tb;
+    }
+    if (t0 >= t1) return out;
+
+    int tx = (int)floorf((origin.x + dir.x * t0) / s), tz = (int)floorf((origin.z + dir.z * t0) / s);
+    tx = tx < 0 ? 0 : tx >= map->width ? map->width - 1 : tx;
+    tz = tz < 0 ? 0 : tz >= map->height ? map->height - 1 : tz;
+    int stepX = dir.x > 0.0f ? 1 : -1, stepZ = dir.z > 0.0f ? 1 : -1;
+    float deltaX = fabsf(dir.x) > 1e-12f ? s / fabsf(dir.x) : INFINITY;
+    float deltaZ = fabsf(dir.z) > 1e-12f ? s / fabsf(dir.z) : INFINITY;
+    float nextX = fabsf(dir.x) > 1e-12f ? ((tx + (stepX > 0)) * s - origin.x) / dir.x : INFINITY;
+    float nextZ = fabsf(dir.z) > 1e-12f ? ((tz + (stepZ > 0)) * s - origin.z) / dir.z : INFINITY;
+
+    float tEnter = t0;
+    for (;;) {
+        float tExit = fminf(fminf(nextX, nextZ), t1);
+        float yEnter = origin.y + dir.y * tEnter;
+        if (dir.y >= 0.0f && yEnter > topmost) break;   // climbing over everything
+
+        float h0, gx, gz;
+        if (tExit > tEnter && Map3DSurface_(Map3DGet(map, tx, tz), s, &h0, &gx, &gz)) {
+            // Height above the surface, linear in t across the tile
+            float x0 = tx * s, z0 = tz * s;
+            float g0 = yEnter - (h0 + gx * (origin.x + dir.x * tEnter - x0) + gz * (origin.z + dir.z * tEnter - z0));
+            float g1 = origin.y + dir.y * tExit - (h0 + gx * (origin.x + dir.x * tExit - x0) + gz * (origin.z + dir.z * tExit - z0));
+            float t = -1.0f;
+            if (g0 < 0.0f) {
+                t = tEnter;
+                out.normal = entryAxis == 0 ? (Vector3){ (float)-stepX, 0, 0 }
+                           : entryAxis == 1 ? (Vector3){ 0, 0, (float)-stepZ }
+                           : Vector3Negate(dir);
+            } else if (g1 < 0.0f) {
+                t = tEnter + (tExit - tEnter) * g0 / (g0 - g1);
+                out.normal = Vector3Normalize((Vector3){ -gx, 1.0f, -gz });
+            }
+            if (t >= 0.0f) {
+                out.hit = true;
+                out.distance = t;
+                out.point = Vector3Add(origin, Vector3Scale(dir, t));
+                out.tx = tx;
+                out.tz = tz;
+                return out;
+            }
+        }
+
+        if (tExit >= t1) break;
+        if (nextX < nextZ) {
+            tx += stepX;
+            tEnter = nextX;
+            nextX += deltaX;
+            entryAxis = 0;
+            if (tx < 0 || tx >= map->width) break;
+        } else {
+            tz += stepZ;
+            tEnter = nextZ;
+            nextZ += deltaZ;
+            entryAxis = 1;
+            if (tz < 0 || tz >= map->height) break;
+        }
+    }
+    return out;
+}
+
+// First solid tile face along a ray within maxDist (dir need not be unit)
+static inline Map3DHit Map3DRaycast(Map3D *map, Vector3 origin, Vector3 dir, float maxDist) {
+    return Map3DRaycast_(map, origin, dir, maxDist, Map3DTopmost_(map));
+}
+
+// Cast count rays (an AI's vision fan, a shotgun blast) in one call; hits[i]
+// answers rays[i]. Returns how many hit.
+static inline int Map3DRaycastBatch(Map3D *map, const Ray *rays, int count, float maxDist, Map3DHit *hits) {
+    float topmost = Map3DTopmost_(map);
+    int hitCount = 0;
+    for (int i = 0; i < count; i++) {
+        hits[i] = Map3DRaycast_(map, rays[i].position, rays[i].direction, maxDist, topmost);
+        hitCount += hits[i].hit;
+    }
+    return hitCount;
+}
+
+// True if nothing solid lies between two points (unstreamed chunks count
+// as defs[0]: see Raycasting above)
+static inline bool Map3DLineOfSight(Map3D *map, Vector3 from, Vector3 to) {
+    Vector3 d = Vector3Subtract(to, from);
+    float dist = Vector3Length(d);
+    return !Map3DRaycast(map, from, d, dist * 0.999f).hit;
+}
+
 // --- Rendering ---
 
 // Helper: draw a quad from 4 world-space points (auto-fix winding)
@@ -191,9 +610,8 @@ static inline void Map3DQuad(Vector3 a, Vector3 b, Vector3 c, Vector3 d, Color c
     DrawTriangle3D(a, d, c, col);
 }
 
-// Draw a single tile
-static inline void Map3DDrawTile(Map3D *map, int tx, int tz) {
-    TileDef *td = Map3DGet(map, tx, tz);
+// Draw a single tile as if it held def td (e.g. to preview an edit)
+static inline void Map3DDrawTileAs(Map3D *map, int tx, int tz, const TileDef *td) {
     if (td->type == TILE_EMPTY) return;
 
     float s = map->tileSize;
@@ -244,12 +662,12 @@ static inline void Map3DDrawTile(Map3D *map, int tx, int tz) {
             break;
         }
         case TILE_WATER: {
-            float wave = sinf((float)GetTime() * 2.0f + (float)(tx + tz)) * 0.05f;
+            float wave = sinf((float)GetTime() * 2.0f + (float)(tx + tz)) * MAP3D_WAVE;
             DrawPlane((Vector3){(x0+x1)/2, wave, (z0+z1)/2}, (Vector2){s, s}, td->topColor);
             break;
         }
         case TILE_PIT: {
-            float depth = -1.0f;
+            float depth = -MAP3D_PIT_DEPTH;
             DrawPlane((Vector3){(x0+x1)/2, depth, (z0+z1)/2}, (Vector2){s, s}, td->topColor);
             // Pit walls
             Map3DQuad((Vector3){x0,depth,z0}, (Vector3){x1,depth,z0}, (Vector3){x1,0,z0}, (Vector3){x0,0,z0}, td->sideColor);
@@ -272,22 +690,413 @@ static inline void Map3DDrawTile(Map3D *map, int tx, int tz) {
     }
 }
 
+// Draw a single tile
+static inline void Map3DDrawTile(Map3D *map, int tx, int tz) {
+    Map3DDrawTileAs(map, tx, tz, Map3DGet(map, tx, tz));
+}
+
+// --- Baked chunks ---
+// Map3DDrawTile rebuilds every face in immediate mode, both windings. Baking
+// turns a chunk's tiles into one indexed mesh instead: each face once, CCW
+// seen from where it is visible, and wall/platform sides only down to the
+// top of a solid neighbour (faces between equal walls vanish). Water is left
+// out and drawn live, as its surface animates. Shading matches
+// Map3DDrawTile: topColor on top, sideColor on the sides.
+
+typedef struct {
+    Mesh *m;
+    int v, i;   // next vertex, next index
+} Map3DMeshWriter_;
+
+static Material map3DMaterial;
+static bool map3DMaterialLoaded = false;
+
+// Convex polygon (3 or 4 corners), CCW from the side it faces, as a fan.
+// A writer without a mesh only counts.
+static inline void Map3DMeshPoly_(Map3DMeshWriter_ *w, const Vector3 *q, int n, Color col) {
+    if (w->m) {
+        Vector3 nrm = Vector3Normalize(Vector3CrossProduct(Vector3Subtract(q[1], q[0]), Vector3Subtract(q[2], q[0])));
+        for (int k = 0; k < n; k++) {
+            int v = w->v + k;
+            w->m->vertices[v*3] = q[k].x; w->m->vertices[v*3+1] = q[k].y; w->m->vertices[v*3+2] = q[k].z;
+            w->m->normals[v*3]  = nrm.x;  w->m->normals[v*3+1]  = nrm.y;  w->m->normals[v*3+2]  = nrm.z;
+            w->m->colors[v*4] = col.r; w->m->colors[v*4+1] = col.g; w->m->colors[v*4+2] = col.b; w->m->colors[v*4+3] = col.a;
+        }
+        for (int k = 1; k + 1 < n; k++) {
+            int i = w->i + (k - 1) * 3;
+            w->m->indices[i]     = (unsigned short)w->v;
+            w->m->indices[i + 1] = (unsigned short)(w->v + k);
+            w->m->indices[i + 2] = (unsigned short)(w->v + k + 1);
+        }
+    }
+    w->v += n;
+    w->i += (n - 2) * 3;
+}
+
+static inline void Map3DMeshQuad_(Map3DMeshWriter_ *w, Vector3 a, Vector3 b, Vector3 c, Vector3 d, Color col) {
+    Vector3 q[4] = { a, b, c, d };
+    Map3DMeshPoly_(w, q, 4, col);
+}
+
+// Height up to which a tile hides the sides of its neighbours
+static inline float Map3DSolidHeight_(Map3D *map, int tx, int tz) {
+    if (tx < 0 || tx >= map->width || tz < 0 || tz >= map->height) return 0.0f;
+    TileDef *td = Map3DGet(map, tx, tz);
+    return (td->type == TILE_WALL || td->type == TILE_PLATFORM) ? td->height : 0.0f;
+}
+
+// The side over floor edge a->b, rising from lo to hiA/hiB. It faces
+// up x (b - a): walking a tile's corners NW, NE, SE, SW faces outwards.
+static inline void Map3DMeshSide_(Map3DMeshWriter_ *w, float ax, float az, float bx, float bz,
+                                  float lo, float hiA, float hiB, Color col) {
+    if (hiA <= lo && hiB <= lo) return;
+    Vector3 q[4], *p = q;
+    *p++ = (Vector3){ ax, lo, az };
+    if (hiA > lo) *p++ = (Vector3){ ax, hiA, az };   // a ramp's low end: a triangle
+    if (hiB > lo) *p++ = (Vector3){ bx, hiB, bz };
+    *p++ = (Vector3){ bx, lo, bz };
+    Map3DMeshPoly_(w, q, (int)(p - q), col);
+}
+
+// Faces of one tile
+static inline void Map3DMeshTile_(Map3DMeshWriter_ *w, Map3D *map, int tx, int tz) {
+    TileDef *td = Map3DGet(map, tx, tz);
+    float s = map->tileSize;
+    float x0 = tx * s, z0 = tz * s;
+    float x1 = x0 + s, z1 = z0 + s;
+    // Corner heights of the top, and the neighbour across each edge (N, E, S, W)
+    float hNW = 0, hNE = 0, hSE = 0, hSW = 0;
+    static const int nbr[4][2] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+
+    switch (td->type) {
+        case TILE_FLOOR:
+            break;
+        case TILE_WALL: case TILE_PLATFORM:
+            hNW = hNE = hSE = hSW = td->height;
+            break;
+        case TILE_RAMP_N: hNW = hNE = td->height; break;
+        case TILE_RAMP_S: hSW = hSE = td->height; break;
+        case TILE_RAMP_E: hNE = hSE = td->height; break;
+        case TILE_RAMP_W: hNW = hSW = td->height; break;
+        case TILE_PIT: {
+            float depth = -MAP3D_PIT_DEPTH;
+            Map3DMeshQuad_(w, (Vector3){ x0, depth, z0 }, (Vector3){ x0, depth, z1 },
+                           (Vector3){ x1, depth, z1 }, (Vector3){ x1, depth, z0 }, td->topColor);
+            // Walls face into the pit: corners walked the other way round
+            float cx[5] = { x1, x0, x0, x1, x1 }, cz[5] = { z0, z0, z1, z1, z0 };
+            static const int across[4][2] = { { 0, -1 }, { -1, 0 }, { 0, 1 }, { 1, 0 } };   // N, W, S, E
+            for (int e = 0; e < 4; e++) {
+                int nx = tx + across[e][0], nz = tz + across[e][1];
+                bool pitBeside = nx >= 0 && nx < map->width && nz >= 0 && nz < map->height
+                              && Map3DGet(map, nx, nz)->type == TILE_PIT;
+                if (!pitBeside) Map3DMeshSide_(w, cx[e], cz[e], cx[e + 1], cz[e + 1], depth, 0.0f, 0.0f, td->sideColor);
+            }
+            return;
+        }
+        default:
+            return;   // empty, and water (drawn live)
+    }
+
+    Map3DMeshQuad_(w, (Vector3){ x0, hNW, z0 }, (Vector3){ x0, hSW, z1 },
+                   (Vector3){ x1, hSE, z1 }, (Vector3){ x1, hNE, z0 }, td->topColor);
+
+    float cx[5] = { x0, x1, x1, x0, x0 }, cz[5] = { z0, z0, z1, z1, z0 };
+    float ch[5] = { hNW, hNE, hSE, hSW, hNW };
+    for (int e = 0; e < 4; e++) {
+        float nh = Map3DSolidHeight_(map, tx + nbr[e][0], tz + nbr[e][1]);
+        float lo = 0.0f;
+        if (ch[e] == ch[e + 1]) lo = fmaxf(lo, nh);               // flat top: hide the covered part
+        else if (fmaxf(ch[e], ch[e + 1]) <= nh) continue;         // ramp side: all or nothing
+        Map3DMeshSide_(w, cx[e], cz[e], cx[e + 1], cz[e + 1], lo, ch[e], ch[e + 1], td->sideColor);
+    }
+}
+
+// Build one chunk's mesh, CPU side only (no window needed). Arrays come from
+// RL_MALLOC, so UnloadMesh frees them. Empty if the chunk has no static faces.
+static inline Mesh Map3DBuildChunkMesh(Map3D *map, int cx, int cz, int *waterCount) {
+    Mesh m = { 0 };
+    int tx0 = cx * MAP3D_CHUNK, tz0 = cz * MAP3D_CHUNK;
+    int tx1 = tx0 + MAP3D_CHUNK < map->width ? tx0 + MAP3D_CHUNK : map->width;
+    int tz1 = tz0 + MAP3D_CHUNK < map->height ? tz0 + MAP3D_CHUNK : map->height;
+
+    // Count, then fill
+    Map3DMeshWriter_ w = { NULL, 0, 0 };
+    int water = 0;
+    for (int z = tz0; z < tz1; z++) {
+        for (int x = tx0; x < tx1; x++) {
+            Map3DMeshTile_(&w, map, x, z);
+            water += Map3DGet(map, x, z)->type == TILE_WATER;
+        }
+    }
+    if (waterCount) *waterCount = water;
+    if (w.v == 0) return m;   // at most 20 vertices a tile: 16-bit indices always fit
+
+    m.vertices = (float *)RL_MALLOC(sizeof(float) * 3 * w.v);
+    m.normals  = (float *)RL_MALLOC(sizeof(float) * 3 * w.v);
+    m.colors   = (unsigned char *)RL_MALLOC(4 * w.v);
+    m.indices  = (unsigned short *)RL_MALLOC(sizeof(unsigned short) * w.i);
+    w = (Map3DMeshWriter_){ &m, 0, 0 };
+    for (int z = tz0; z < tz1; z++)
+        for (int x = tx0; x < tx1; x++)
+            Map3DMeshTile_(&w, map, x, z);
+    m.vertexCount = w.v;
+    m.triangleCount = w.i / 3;
+    return m;
+}
+
+// Highest point a chunk draws: its mesh, or a wave on its water
+static inline float Map3DChunkTop_(const Map3DChunk *c) {
+    float top = c->waterCount > 0 ? MAP3D_WAVE : -FLT_MAX;
+    for (int v = 0; v < c->mesh.vertexCount; v++) top = fmaxf(top, c->mesh.vertices[v*3 + 1]);
+    return top;
+}
+
+// Nodes of a tree level, per side
+static inline int Map3DTreeSide_(int chunks, int level) {
+    return (chunks + (1 << level) - 1) >> level;
+}
+
+// Node (x, z) of a level from the 2x2 below it (or chunk i at level 0)
+static inline void Map3DTreeNode_(Map3D *map, int level, int x, int z) {
+    float *node = &map->tree[map->treeOffset[level] + z * Map3DTreeSide_(map->chunksX, level) + x];
+    if (level == 0) {
+        Map3DChunk *c = map->chunks[z * map->chunksX + x];
+        *node = c == &map3DUnpainted_ ? map->background.top : c->top;
+        return;
+    }
+    int w = Map3DTreeSide_(map->chunksX, level - 1), h = Map3DTreeSide_(map->chunksZ, level - 1);
+    const float *below = &map->tree[map->treeOffset[level - 1]];
+    float top = -FLT_MAX;
+    for (int dz = 0; dz < 2 && 2 * z + dz < h; dz++)
+        for (int dx = 0; dx < 2 && 2 * x + dx < w; dx++) top = fmaxf(top, below[(2 * z + dz) * w + 2 * x + dx]);
+    *node = top;
+}
+
+// (Re)build the whole tree. False if out of memory (tree left NULL).
+static inline bool Map3DBuildTree_(Map3D *map) {
+    if (!map->tree) {
+        size_t nodes = 0;
+        int levels = 0;
+        for (; levels < MAP3D_TREE_LEVELS; levels++) {
+            int w = Map3DTreeSide_(map->chunksX, levels), h = Map3DTreeSide_(map->chunksZ, levels);
+            map->treeOffset[levels] = (int)nodes;
+            nodes += (size_t)w * (size_t)h;
+            if (w == 1 && h == 1) break;
+        }
+        map->tree = (float *)malloc(sizeof(float) * nodes);
+        if (!map->tree) return false;
+        map->treeLevels = levels + 1;
+    }
+    for (int level = 0; level < map->treeLevels; level++)
+        for (int z = 0; z < Map3DTreeSide_(map->chunksZ, level); z++)
+            for (int x = 0; x < Map3DTreeSide_(map->chunksX, level); x++) Map3DTreeNode_(map, level, x, z);
+    return true;
+}
+
+// Chunk (cx, cz) changed: refresh it and the nodes above it
+static inline void Map3DTreeUpdate_(Map3D *map, int cx, int cz) {
+    if (!map->tree) return;
+    for (int level = 0; level < map->treeLevels; level++, cx >>= 1, cz >>= 1) Map3DTreeNode_(map, level, cx, cz);
+}
+
+// Mesh of an unpainted chunk: the middle of a 3x3-chunk map of nothing but
+// defs[0], so in chunk (1, 1)'s place. Draw it offset by (cx-1, cz-1) chunks.
+static inline void Map3DBakeBackground_(Map3D *map) {
+    Map3DChunk *bg = &map->background;
+    if (bg->mesh.vertices || bg->uploaded) UnloadMesh(bg->mesh);
+    Map3DChunk *dir[9];
+    for (int i = 0; i < 9; i++) dir[i] = &map3DUnpainted_;
+    Map3D blank = *map;
+    blank.chunks = dir;
+    blank.chunksX = blank.chunksZ = 3;
+    blank.width = blank.height = 3 * MAP3D_CHUNK;
+    bg->mesh = Map3DBuildChunkMesh(&blank, 1, 1, &bg->waterCount);
+    bg->top = Map3DChunkTop_(bg);
+    bg->uploaded = false;
+    bg->built = true;
+}
+
+// Whether unpainted chunk (cx, cz) can't draw the shared background, which
+// assumes defs[0] all round it: the map edge cuts through it (the background
+// would draw past the edge), or defs[0] has sides (wall, platform, ramp, pit)
+// and the chunk is on the map's edge or beside a painted chunk, where other
+// sides show.
+static inline bool Map3DNeedsOwnChunk_(Map3D *map, int cx, int cz) {
+    if ((cx + 1) * MAP3D_CHUNK > map->width || (cz + 1) * MAP3D_CHUNK > map->height) return true;
+    TileType t = map->defs[0].type;
+    if (t == TILE_EMPTY || t == TILE_FLOOR || t == TILE_WATER) return false;
+    if (cx == 0 || cz == 0 || cx == map->chunksX - 1 || cz == map->chunksZ - 1) return true;
+    static const int nbr[4][2] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+    for (int k = 0; k < 4; k++) {
+        const Map3DChunk *c = map->chunks[(cz + nbr[k][1]) * map->chunksX + cx + nbr[k][0]];
+        if (c != &map3DUnpainted_ && !c->filler) return true;
+    }
+    return false;
+}
+
+// Bake chunk i if it is stale, first giving it a filler if it is unpainted
+// and can't use the background
+static inline void Map3DBakeChunk_(Map3D *map, int i, bool bgVisible, bool updateTree) {
+    int cx = i % map->chunksX, cz = i / map->chunksX;
+    Map3DChunk *c = map->chunks[i];
+    if (c == &map3DUnpainted_) {
+        if (!bgVisible || !Map3DNeedsOwnChunk_(map, cx, cz) || !(c = Map3DNewChunk_(map, i))) return;
+        c->filler = true;
+    }
+    if (c->built) return;
+    if (c->mesh.vertices || c->uploaded) UnloadMesh(c->mesh);
+    c->mesh = Map3DBuildChunkMesh(map, cx, cz, &c->waterCount);
+    c->top = Map3DChunkTop_(c);
+    c->uploaded = false;
+    c->built = true;
+    if (updateTree) Map3DTreeUpdate_(map, cx, cz);
+}
+
+// Rebake every chunk whose tiles changed. Map3DDrawAll/Near call this.
+// Unpainted chunks that can't use the background (Map3DNeedsOwnChunk_) get
+// a blank filler chunk first, if defs[0] is visible at all; the file is not
+// read for them, that is left to Map3DStream. Only queued chunks are looked
+// at, so an unchanged frame costs nothing.
+static inline void Map3DBake(Map3D *map) {
+    bool rebuildTree = !map->tree;
+    bool all = map->dirtyAll;
+    if (!map->background.built) {
+        Map3DBakeBackground_(map);
+        rebuildTree = all = true;   // every unpainted node's top, and filler, may have changed
+    }
+    bool bgVisible = map->background.mesh.vertexCount > 0 || map->background.waterCount > 0;
+    if (all) {
+        for (int i = 0; i < map->chunksX * map->chunksZ; i++) Map3DBakeChunk_(map, i, bgVisible, !rebuildTree);
+    } else {
+        for (int k = 0; k < map->dirtyCount; k++) Map3DBakeChunk_(map, map->dirty[k], bgVisible, !rebuildTree);
+    }
+    map->dirtyCount = 0;
+    map->dirtyAll = false;
+    if (rebuildTree) Map3DBuildTree_(map);
+}
+
+// Free the tiles and every chunk's mesh (CPU and GPU). Call before
+// CloseWindow; the map is left zeroed, ready for InitMap3D or Map3DLoad.
+static inline void UnloadMap3D(Map3D *map) {
+    for (int i = 0; map->chunks && i < map->chunksX * map->chunksZ; i++) {
+        Map3DChunk *c = map->chunks[i];
+        if (c == &map3DUnpainted_) continue;
+        if (c->mesh.vertices || c->uploaded) UnloadMesh(c->mesh);
+        free(c);
+    }
+    free(map->chunks);
+    free(map->live);
+    free(map->tree);
+    PackUnmapFile(map->file, map->fileSize);
+    Map3DChunk *bg = &map->background;
+    if (bg->mesh.vertices || bg->uploaded) UnloadMesh(bg->mesh);
+    *map = (Map3D){ 0 };
+}
+
+// Draw one chunk: its mesh (or the background's), then any water tiles on top
+static inline void Map3DDrawChunk_(Map3D *map, int cx, int cz) {
+    Map3DChunk *c = map->chunks[cz * map->chunksX + cx];
+    Matrix at = MatrixIdentity();
+    if (c == &map3DUnpainted_) {
+        c = &map->background;
+        float cs = map->tileSize * MAP3D_CHUNK;
+        at = MatrixTranslate((cx - 1) * cs, 0.0f, (cz - 1) * cs);
+    }
+    if (c->mesh.vertexCount > 0) {
+        if (!c->uploaded) {
+            UploadMesh(&c->mesh, false);
+            c->uploaded = true;
+        }
+        if (!map3DMaterialLoaded) {
+            map3DMaterial = LoadMaterialDefault();
+            map3DMaterialLoaded = true;
+        }
+        DrawMesh(c->mesh, map3DMaterial, at);
+    }
+    if (c->waterCount == 0) return;
+    int tx0 = cx * MAP3D_CHUNK, tz0 = cz * MAP3D_CHUNK;
+    for (int z = tz0; z < tz0 + MAP3D_CHUNK && z < map->height; z++)
+        for (int x = tx0; x < tx0 + MAP3D_CHUNK && x < map->width; x++)
+            if (Map3DGet(map, x, z)->type == TILE_WATER) Map3DDrawTile(map, x, z);
+}
+
 // Draw the entire map
 static inline void Map3DDrawAll(Map3D *map) {
-    for (int z = 0; z < map->height; z++)
-        for (int x = 0; x < map->width; x++)
-            Map3DDrawTile(map, x, z);
+    Map3DBake(map);
+    for (int cz = 0; cz < map->chunksZ; cz++)
+        for (int cx = 0; cx < map->chunksX; cx++)
+            Map3DDrawChunk_(map, cx, cz);
 }
 
-// Draw only tiles visible from a camera (frustum-approximated by range)
+// Draw only chunks within range of a camera (frustum-approximated by range)
 static inline void Map3DDrawNear(Map3D *map, Vector3 camPos, float range) {
-    int cx, cz;
-    Map3DFromWorld(map, camPos, &cx, &cz);
-    int r = (int)(range / map->tileSize) + 1;
-    for (int z = cz - r; z <= cz + r; z++)
-        for (int x = cx - r; x <= cx + r; x++)
-            if (x >= 0 && x < map->width && z >= 0 && z < map->height)
-                Map3DDrawTile(map, x, z);
+    Map3DBake(map);
+    float cs = map->tileSize * MAP3D_CHUNK;
+    int cx0 = (int)floorf((camPos.x - range) / cs), cx1 = (int)floorf((camPos.x + range) / cs);
+    int cz0 = (int)floorf((camPos.z - range) / cs), cz1 = (int)floorf((camPos.z + range) / cs);
+    for (int cz = cz0 < 0 ? 0 : cz0; cz <= cz1 && cz < map->chunksZ; cz++)
+        for (int cx = cx0 < 0 ? 0 : cx0; cx <= cx1 && cx < map->chunksX; cx++)
+            Map3DDrawChunk_(map, cx, cz);
+}
+
+// --- Culling ---
+// Map3DDrawNear draws a square around the camera, behind it included.
+// Map3DCull walks the chunk quadtree instead: a node's box runs from the pit
+// floors to the tallest thing under it, so nodes wholly outside the frustum,
+// or holding nothing to draw, are dropped with everything below them. The
+// eye's own quadrant is visited first and the opposite one last, which lists
+// the chunks front to back (early-z) at no extra cost.
+
+static inline void Map3DCullNode_(Map3D *map, VisibleList *vis, int level, int x, int z, float ex, float ez) {
+    float top = map->tree[map->treeOffset[level] + z * Map3DTreeSide_(map->chunksX, level) + x];
+    if (top == -FLT_MAX) return;
+    float cs = map->tileSize * MAP3D_CHUNK;
+    int cx0 = x << level, cz0 = z << level;
+    int cx1 = (x + 1) << level, cz1 = (z + 1) << level;
+    if (cx1 > map->chunksX) cx1 = map->chunksX;
+    if (cz1 > map->chunksZ) cz1 = map->chunksZ;
+    BoundingBox box = { { cx0 * cs, -MAP3D_PIT_DEPTH, cz0 * cs },
+                        { fminf(cx1 * cs, map->width * map->tileSize), top, fminf(cz1 * cs, map->height * map->tileSize) } };
+    vis->tested++;
+    if (!FrustumAABB(&vis->frustum, box)) return;
+    if (level == 0) {
+        VisibleListPush_(vis, z * map->chunksX + x);
+        return;
+    }
+    int w = Map3DTreeSide_(map->chunksX, level - 1), h = Map3DTreeSide_(map->chunksZ, level - 1);
+    int fx = ex >= (float)((2 * x + 1) << (level - 1)), fz = ez >= (float)((2 * z + 1) << (level - 1));
+    static const int order[4][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } };   // flips of the eye's quadrant
+    for (int k = 0; k < 4; k++) {
+        int nx = 2 * x + (fx ^ order[k][0]), nz = 2 * z + (fz ^ order[k][1]);
+        if (nx < w && nz < h) Map3DCullNode_(map, vis, level - 1, nx, nz, ex, ez);
+    }
+}
+
+// Collect the chunks inside view into vis (ids cz * chunksX + cx), nearest to
+// eye first; give vis room for chunksX * chunksZ. Bakes first. Returns the
+// count. Without the tree (out of memory) every chunk is listed.
+static inline int Map3DCull(Map3D *map, VisibleList *vis, const Frustum *view, Vector3 eye) {
+    Map3DBake(map);
+    VisibleListBegin(vis, view);
+    if (!map->tree) {
+        for (int i = 0; i < map->chunksX * map->chunksZ; i++) VisibleListPush_(vis, i);
+        return vis->count;
+    }
+    float cs = map->tileSize * MAP3D_CHUNK;
+    int root = map->treeLevels - 1;
+    Map3DCullNode_(map, vis, root, 0, 0, eye.x / cs, eye.z / cs);
+    return vis->count;
+}
+
+// Draw the chunks view sees. A NULL view (a top-down or 2D pass with no
+// frustum) draws them all, as Map3DDrawAll does.
+static inline void Map3DDrawVisible(Map3D *map, VisibleList *vis, const Frustum *view, Vector3 eye) {
+    if (!view) {
+        Map3DDrawAll(map);
+        return;
+    }
+    Map3DCull(map, vis, view, eye);
+    for (int i = 0; i < vis->count; i++) Map3DDrawChunk_(map, vis->ids[i] % map->chunksX, vis->ids[i] / map->chunksX);
 }
 
 // Draw grid lines on the map floor (useful for debugging)
@@ -335,11 +1144,8 @@ static inline bool SaveMap3D(const char *filename, Map3D *map) {
     if (!f) return false;
     fprintf(f, "%d %d %.1f\n", map->width, map->height, map->tileSize);
     for (int z = 0; z < map->height; z++) {
-        for (int x = 0; x < map->width; x++) {
-            int t = map->tiles[z][x];
-            fprintf(f, "%c", t < 10 ? '0' + t : 'a' + (t - 10));
-        }
-        fprintf(f, "\n");
+        for (int x = 0; x < map->width; x++) fputc(Map3DTileToChar_(Map3DTile(map, x, z)), f);
+        fputc('\n', f);
     }
     fclose(f);
     return true;
@@ -350,25 +1156,181 @@ static inline bool LoadMap3DFile(const char *filename, Map3D *map, TileDef *defs
     if (!f) return false;
     int w, h;
     float ts;
-    if (fscanf(f, "%d %d %f\n", &w, &h, &ts) != 3) { fclose(f); return false; }
-    map->width = (w < MAP3D_MAX_W) ? w : MAP3D_MAX_W;
-    map->height = (h < MAP3D_MAX_H) ? h : MAP3D_MAX_H;
-    map->tileSize = ts;
-    map->numDefs = numDefs;
-    for (int i = 0; i < numDefs && i < MAP3D_MAX_DEFS; i++) map->defs[i] = defs[i];
-    char line[MAP3D_MAX_W + 4];
-    for (int z = 0; z < map->height; z++) {
-        if (!fgets(line, sizeof(line), f)) break;
-        for (int x = 0; x < map->width; x++) {
-            char c = line[x];
-            int idx = 0;
-            if (c >= '0' && c <= '9') idx = c - '0';
-            else if (c >= 'a' && c <= 'z') idx = 10 + (c - 'a');
-            map->tiles[z][x] = idx;
-        }
+    if (fscanf(f, "%d %d %f\n", &w, &h, &ts) != 3 || !InitMap3D(map, w, h, ts, defs, numDefs)) {
+        fclose(f);
+        return false;
+    }
+    // Rows of any length; characters past the width are ignored
+    int c = 0;
+    for (int z = 0; z < h && c != EOF; z++) {
+        for (int x = 0; (c = fgetc(f)) != EOF && c != '\n'; x++)
+            if (x < w) Map3DSet(map, x, z, Map3DTileFromChar_((char)c));
     }
     fclose(f);
     return true;
 }
 
+// --- Binary I/O ---
+// The text format above stays for import/export and hand edits; .m3db is
+// what big maps load from. SaveMap3DBinary writes every painted chunk (LZ
+// compressed when that is smaller), then the chunk directory. OpenMap3D maps
+// the file and reads no chunks yet: Map3DStream brings in the ones near the
+// camera and drops far ones again; LoadMap3DBinary reads them all.
+
+// Write to filename.tmp, then rename over filename, so a map streaming from
+// the old file keeps its (still mapped) copy.
+static inline bool SaveMap3DBinary(const char *filename, Map3D *map, bool compress) {
+    int n = MAP3D_CHUNK * MAP3D_CHUNK, count = map->chunksX * map->chunksZ;
+    Map3DFileChunk *dir = (Map3DFileChunk *)calloc((size_t)(count > 0 ? count : 1), sizeof(Map3DFileChunk));
+    if (!dir) return false;
+    PackBuffer out = { 0 };
+    Map3DFileHeader h = { { 'R', 'L', 'M', '3' }, MAP3D_BINARY_VERSION, map->width, map->height,
+                          map->tileSize, (uint32_t)map->numDefs, MAP3D_CHUNK_SHIFT, 0, 0 };
+    bool ok = PackBufferPut(&out, &h, sizeof(h));
+    for (int i = 0; i < map->numDefs && ok; i++) {
+        const TileDef *d = &map->defs[i];
+        Map3DFileDef rec = { (uint8_t)d->type, { d->topColor.r, d->topColor.g, d->topColor.b, d->topColor.a },
+                             { d->sideColor.r, d->sideColor.g, d->sideColor.b, d->sideColor.a }, { 0 }, d->height };
+        ok = PackBufferPut(&out, &rec, sizeof(rec));
+    }
+    unsigned char packed[MAP3D_CHUNK * MAP3D_CHUNK];
+    for (int i = 0; i < count && ok; i++) {
+        const Map3DChunk *c = map->chunks[i];
+        if (c == &map3DUnpainted_ || c->filler) {
+            // Not read from the file (yet): copy its stored bytes over as they are
+            if (!map->fileChunks || map->fileChunks[i].offset == 0) continue;
+            const Map3DFileChunk *e = &map->fileChunks[i];
+            if (e->offset > map->fileSize || e->size > map->fileSize - e->offset) continue;
+            dir[i] = (Map3DFileChunk){ out.size, e->size, e->codec };
+            ok = PackBufferPut(&out, map->file + e->offset, e->size);
+            continue;
+        }
+        bool blank = true;
+        for (int t = 0; t < n && blank; t++) blank = c->tiles[t] == 0;
+        if (blank) continue;
+        int size = compress ? PackLZCompress(c->tiles, n, packed, n - 1) : 0;
+        if (size > 0) {
+            dir[i] = (Map3DFileChunk){ out.size, (uint32_t)size, MAP3D_CODEC_LZ };
+            ok = PackBufferPut(&out, packed, (size_t)size);
+        } else {
+            dir[i] = (Map3DFileChunk){ out.size, (uint32_t)n, MAP3D_CODEC_RAW };
+            ok = PackBufferPut(&out, c->tiles, (size_t)n);
+        }
+    }
+    static const unsigned char zeros[8] = { 0 };
+    ok = ok && PackBufferPut(&out, zeros, (8 - out.size % 8) % 8);
+    uint64_t dirOffset = out.size;
+    ok = ok && PackBufferPut(&out, dir, sizeof(Map3DFileChunk) * (size_t)count);
+    free(dir);
+    if (ok) memcpy(out.data + offsetof(Map3DFileHeader, dirOffset), &dirOffset, sizeof(dirOffset));
+
+    char tmp[512];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", filename);
+    FILE *f = ok ? fopen(tmp, "wb") : NULL;
+    ok = f && fwrite(out.data, 1, out.size, f) == out.size;
+    if (f) ok = (fclose(f) == 0) && ok;
+    PackBufferFree(&out);
+    if (ok) {
+        remove(filename);   // rename will not replace a file on Windows
+        ok = rename(tmp, filename) == 0;
+    }
+    if (!ok) remove(tmp);
+    return ok;
+}
+
+// Map a .m3db and read its header, defs and directory; no chunks are read
+// (they read as unpainted until streamed in). The defs come from the file;
+// Map3DSetDefs swaps in others. False (map zeroed) if missing or malformed.
+static inline bool OpenMap3D(Map3D *map, const char *filename) {
+    UnloadMap3D(map);
+    size_t size;
+    const unsigned char *data = PackMapFile(filename, sizeof(Map3DFileHeader), &size);
+    if (!data) return false;
+    Map3DFileHeader h;
+    memcpy(&h, data, sizeof(h));
+    int64_t chunksX = ((int64_t)h.width + MAP3D_CHUNK_MASK) >> MAP3D_CHUNK_SHIFT;
+    int64_t chunksZ = ((int64_t)h.height + MAP3D_CHUNK_MASK) >> MAP3D_CHUNK_SHIFT;
+    bool ok = memcmp(h.magic, MAP3D_BINARY_MAGIC, 4) == 0 && h.version == MAP3D_BINARY_VERSION
+           && h.chunkShift == MAP3D_CHUNK_SHIFT && h.width > 0 && h.height > 0
+           && h.defCount <= MAP3D_MAX_DEFS && sizeof(h) + h.defCount * sizeof(Map3DFileDef) <= size
+           && h.dirOffset % 8 == 0 && h.dirOffset <= size
+           && (size - h.dirOffset) / sizeof(Map3DFileChunk) >= (uint64_t)(chunksX * chunksZ);
+    TileDef defs[MAP3D_MAX_DEFS];
+    for (uint32_t i = 0; ok && i < h.defCount; i++) {
+        Map3DFileDef rec;
+        memcpy(&rec, data + sizeof(h) + i * sizeof(rec), sizeof(rec));
+        defs[i] = (TileDef){ (TileType)rec.type, rec.height,
+                             { rec.top[0], rec.top[1], rec.top[2], rec.top[3] },
+                             { rec.side[0], rec.side[1], rec.side[2], rec.side[3] } };
+    }
+    if (!ok || !InitMap3D(map, h.width, h.height, h.tileSize, defs, (int)h.defCount)) {
+        PackUnmapFile(data, size);
+        return false;
+    }
+    map->file = data;
+    map->fileSize = size;
+    map->fileChunks = (const Map3DFileChunk *)(data + h.dirOffset);
+    return true;
+}
+
+// Nearest distance on the ground from pos to chunk (cx, cz)
+static inline float Map3DChunkDistance_(Map3D *map, int cx, int cz, Vector3 pos) {
+    float cs = map->tileSize * MAP3D_CHUNK;
+    float dx = fmaxf(fmaxf(cx * cs - pos.x, pos.x - (cx + 1) * cs), 0.0f);
+    float dz = fmaxf(fmaxf(cz * cs - pos.z, pos.z - (cz + 1) * cs), 0.0f);
+    return sqrtf(dx * dx + dz * dz);
+}
+
+// Read in the file's chunks within radius of pos, nearest rings first and at
+// most maxLoads per call so a fast camera spreads its reads over frames.
+// Chunks read earlier that are now past twice the radius and unedited are
+// dropped again, as are fillers Map3DBake would not make again. Returns the
+// chunks read. Does nothing without an open file.
+static inline int Map3DStream(Map3D *map, Vector3 pos, float radius, int maxLoads) {
+    if (!map->fileChunks) return 0;
+    float cs = map->tileSize * MAP3D_CHUNK;
+    for (int k = map->chunkCount - 1; k >= 0; k--) {   // backwards: a drop moves the last one into k
+        int i = map->live[k];
+        Map3DChunk *c = map->chunks[i];
+        if (c->edited || (!c->filler && map->fileChunks[i].offset == 0)) continue;
+        int cx = i % map->chunksX, cz = i / map->chunksX;
+        if (Map3DChunkDistance_(map, cx, cz, pos) <= 2.0f * radius) continue;
+        if (c->filler && Map3DNeedsOwnChunk_(map, cx, cz)) continue;
+        bool filler = c->filler;
+        Map3DFreeChunk_(map, i);
+        Map3DTouch_(map, i, false);   // may need a filler of its own now
+        if (!filler) Map3DTouchNeighbours_(map, cx, cz, true);   // a filler's tiles are defs[0] already
+        Map3DTreeUpdate_(map, cx, cz);
+    }
+
+    int loads = 0;
+    int ccx = (int)floorf(pos.x / cs), ccz = (int)floorf(pos.z / cs);
+    int rings = (int)ceilf(radius / cs) + 1;
+    for (int r = 0; r <= rings && loads < maxLoads; r++) {
+        for (int cz = ccz - r; cz <= ccz + r && loads < maxLoads; cz++) {
+            for (int cx = ccx - r; cx <= ccx + r && loads < maxLoads; cx++) {
+                if (abs(cx - ccx) != r && abs(cz - ccz) != r) continue;   // ring r only
+                if (cx < 0 || cx >= map->chunksX || cz < 0 || cz >= map->chunksZ) continue;
+                int i = cz * map->chunksX + cx;
+                if ((map->chunks[i] != &map3DUnpainted_ && !map->chunks[i]->filler) || map->fileChunks[i].offset == 0) continue;
+                if (Map3DChunkDistance_(map, cx, cz, pos) > radius) continue;
+                if (Map3DAllocChunk_(map, i)) loads++;
+            }
+        }
+    }
+    return loads;
+}
+
+// Read a whole .m3db into memory and let the file go
+static inline bool LoadMap3DBinary(const char *filename, Map3D *map) {
+    if (!OpenMap3D(map, filename)) return false;
+    for (int i = 0; i < map->chunksX * map->chunksZ; i++)
+        if (map->chunks[i] == &map3DUnpainted_ && map->fileChunks[i].offset != 0) Map3DAllocChunk_(map, i);
+    PackUnmapFile(map->file, map->fileSize);
+    map->file = NULL;
+    map->fileSize = 0;
+    map->fileChunks = NULL;
+    return true;
+}
+
 #endif // MAP3D_H
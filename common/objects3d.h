@@ -15,10 +15,13 @@
 
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "util/fx.h"
+#include "util/pack.h"
 
 // --- Types ---
 
@@ -353,6 +356,79 @@ static inline void DrawObject3DShadow(Object3D *obj, float groundY) {
     SPHERE(0.15f, 3.5f, 0, 0.12f, COL(255,255,0,255)),          /* light */ \
 }
 
+// --- Bounds ---
+// Object-space extents of a part array: compute once when the parts are
+// loaded or built and keep the result beside them (Prefab3D, Object3DAsset)
+// for culling and picking. Object rotation is not applied — rotate the
+// sphere's center (RotateY) rather than the box when placing it.
+typedef struct {
+    BoundingBox box;   // tight axis-aligned box
+    Vector3 center;    // bounding sphere
+    float radius;
+} Object3DBounds;
+
+// A part's box as drawn: cubes and spheres centered on the offset,
+// cylinders and cones standing on it.
+static inline BoundingBox PartBox(const Part *p) {
+    Vector3 o = p->offset;
+    switch (p->type) {
+        case PART_CUBE: {
+            Vector3 h = Vector3Scale(p->size, 0.5f);
+            return (BoundingBox){ Vector3Subtract(o, h), Vector3Add(o, h) };
+        }
+        case PART_SPHERE: {
+            Vector3 r = { p->size.x, p->size.x, p->size.x };
+            return (BoundingBox){ Vector3Subtract(o, r), Vector3Add(o, r) };
+        }
+        case PART_CYLINDER:
+        case PART_CONE: {
+            float r = (p->type == PART_CONE) ? fmaxf(p->size.x, p->size.z) : p->size.x;
+            float y0 = fminf(o.y, o.y + p->size.y), y1 = fmaxf(o.y, o.y + p->size.y);
+            return (BoundingBox){ { o.x - r, y0, o.z - r }, { o.x + r, y1, o.z + r } };
+        }
+    }
+    return (BoundingBox){ o, o };
+}
+
+// Distance from c to the part's farthest point.
+static inline float PartReach_(const Part *p, Vector3 c) {
+    Vector3 o = p->offset;
+    switch (p->type) {
+        case PART_CUBE: {
+            Vector3 h = Vector3Scale(p->size, 0.5f);
+            Vector3 d = { fabsf(o.x - c.x) + fabsf(h.x), fabsf(o.y - c.y) + fabsf(h.y), fabsf(o.z - c.z) + fabsf(h.z) };
+            return Vector3Length(d);
+        }
+        case PART_SPHERE:
+            return Vector3Distance(o, c) + p->size.x;
+        case PART_CYLINDER:
+        case PART_CONE: {
+            // Farthest point is on the rim of one of the two end circles
+            float topR = (p->type == PART_CONE) ? p->size.z : p->size.x;
+            float axis = sqrtf((o.x - c.x) * (o.x - c.x) + (o.z - c.z) * (o.z - c.z));
+            float b = axis + p->size.x, t = axis + topR;
+            float yb = o.y - c.y, yt = o.y + p->size.y - c.y;
+            return fmaxf(sqrtf(b * b + yb * yb), sqrtf(t * t + yt * yt));
+        }
+    }
+    return Vector3Distance(o, c);
+}
+
+// Box over every part; sphere centered on the box. All zero for no parts.
+static inline Object3DBounds ComputeObject3DBounds(const Part *parts, int count) {
+    Object3DBounds b = { 0 };
+    if (count <= 0) return b;
+    b.box = PartBox(&parts[0]);
+    for (int i = 1; i < count; i++) {
+        BoundingBox pb = PartBox(&parts[i]);
+        b.box.min = Vector3Min(b.box.min, pb.min);
+        b.box.max = Vector3Max(b.box.max, pb.max);
+    }
+    b.center = Vector3Scale(Vector3Add(b.box.min, b.box.max), 0.5f);
+    for (int i = 0; i < count; i++) b.radius = fmaxf(b.radius, PartReach_(&parts[i], b.center));
+    return b;
+}
+
 // --- File I/O ---
 // Text format (one part per line):
 //   # comment or object name
@@ -398,8 +474,46 @@ static inline bool SaveObject3D(const char *filename, Part *parts, int count) {
     return true;
 }
 
-// Load parts from a text file. Returns number of parts loaded.
-static inline int LoadObject3D(const char *filename, Part *parts, int maxParts) {
+// Binary form, as stored in asset packs (util/pack.h): a bare Object3DRecord
+// array. The asset-pack tool writes it from the text file.
+typedef struct {
+    float offset[3];
+    float size[3];
+    uint8_t type;       // PartType
+    uint8_t r, g, b, a;
+    uint8_t wireframe;
+    uint8_t pad[2];
+} Object3DRecord;
+
+static inline bool WriteObject3DBinary(PackBuffer *out, const Part *parts, int count) {
+    for (int i = 0; i < count; i++) {
+        const Part *p = &parts[i];
+        Object3DRecord rec = {
+            { p->offset.x, p->offset.y, p->offset.z }, { p->size.x, p->size.y, p->size.z },
+            (uint8_t)p->type, p->color.r, p->color.g, p->color.b, p->color.a, p->wireframe, { 0 },
+        };
+        if (!PackBufferPut(out, &rec, sizeof(rec))) return false;
+    }
+    return true;
+}
+
+static inline int ReadObject3DBinary(const void *data, uint32_t size, Part *parts, int maxParts) {
+    const Object3DRecord *recs = (const Object3DRecord *)data;
+    int count = (int)(size / sizeof(Object3DRecord));
+    if (count > maxParts) count = maxParts;
+    for (int i = 0; i < count; i++) {
+        const Object3DRecord *r = &recs[i];
+        parts[i] = (Part){
+            (PartType)r->type,
+            { r->offset[0], r->offset[1], r->offset[2] }, { r->size[0], r->size[1], r->size[2] },
+            { r->r, r->g, r->b, r->a }, r->wireframe != 0,
+        };
+    }
+    return count;
+}
+
+// Load parts from a text file (never the pack). Returns number of parts loaded.
+static inline int LoadObject3DText(const char *filename, Part *parts, int maxParts) {
     FILE *f = fopen(filename, "r");
     if (!f) return 0;
     int count = 0;
@@ -453,6 +567,14 @@ static inline int LoadObject3D(const char *filename, Part *parts, int maxParts)
     return count;
 }
 
+// Load parts from the mounted pack, else the text file. Returns number of parts loaded.
+static inline int LoadObject3D(const char *filename, Part *parts, int maxParts) {
+    uint32_t blobSize;
+    const void *blob = PackLookup(filename, PACK_OBJ3D, &blobSize);
+    if (blob) return ReadObject3DBinary(blob, blobSize, parts, maxParts);
+    return LoadObject3DText(filename, parts, maxParts);
+}
+
 // Load object from file, falling back to hardcoded defaults if missing.
 // Saves the defaults to disk on first run so they can be edited.
 static inline void LoadOrCreateObject(const char *path, Part *dest, int *destCount,
@@ -466,4 +588,573 @@ static inline void LoadOrCreateObject(const char *path, Part *dest, int *destCou
     }
 }
 
+// --- Compiled prefabs ---
+// DrawObject3D rebuilds every primitive in immediate mode each frame. A
+// prefab is the same parts compiled once into a single indexed mesh (per-
+// vertex colors, one CCW winding facing out) and drawn with one DrawMesh.
+// Shading matches DrawPart: cube top/bottom/sides at 0.7 brightness, spheres
+// and cylinders flat. Wireframe overlays are not compiled.
+//
+// Each prefab carries PREFAB3D_LODS levels of detail:
+//   0  full tessellation
+//   1  coarse spheres and cylinders, parts under PREFAB3D_LOD1_MIN_PART of
+//      the object's size dropped
+//   2  one box over the bounds, in the parts' average color
+// Pick a level per object with SelectPrefabLOD on its PrefabScreenSize.
+//
+// Usage:  Prefab3D *crate = LoadPrefab3D("objects/Crate.obj3d");       // cached by path
+//         Prefab3D *grunt = GetPrefab3D("grunt", gruntParts, count);  // cached by key
+//         DrawPrefab3D(crate, pos, rotY);
+//         obj->lod = SelectPrefabLOD(PrefabScreenSize(crate, camera, pos, 1.0f), obj->lod);
+//         DrawPrefab3DLOD(crate, obj->lod, pos, rotY, (Vector3){ 1, 1, 1 });
+//         UnloadPrefabs3D();                                          // before CloseWindow
+#define PREFAB3D_CYL_SIDES     8    // as DrawPart's DrawCylinderEx
+#define PREFAB3D_CACHE_MAX     64
+#define PREFAB3D_MAX_PARTS     64
+#define PREFAB3D_LODS          3
+#define PREFAB3D_LOD1_MIN_PART 0.15f   // fraction of the object's largest extent
+#define PREFAB3D_LOD1_SIZE     0.08f   // PrefabScreenSize below which LOD 1 takes over
+#define PREFAB3D_LOD2_SIZE     0.02f   // ... and below which the box proxy does
+#define PREFAB3D_LOD_HYSTERESIS 0.2f   // a level only changes this far past its threshold
+#define PREFAB3D_CPU_CHUNK_TRIS 1024   // triangles per rlBegin on the CPU path, well inside any rlgl batch
+
+// Tessellation of round parts, and the smallest part kept (largest extent).
+typedef struct {
+    int sphereRings, sphereSlices;
+    int cylSides;
+    float minPartSize;
+} PartMeshDetail;
+
+#define PART_DETAIL_FULL   ((PartMeshDetail){ 12, 16, PREFAB3D_CYL_SIDES, 0.0f })
+#define PART_DETAIL_COARSE ((PartMeshDetail){ 4, 6, 5, 0.0f })
+
+typedef struct {
+    char key[128];                  // source path, or the name given to GetPrefab3D
+    Mesh lods[PREFAB3D_LODS];       // CPU arrays; GPU buffers once first drawn
+    bool uploaded[PREFAB3D_LODS];
+    BoundingBox bounds;             // object space, from LOD 0
+    Object3DBounds extent;          // from the parts (exact for round ones)
+} Prefab3D;
+
+static Prefab3D prefab3DCache[PREFAB3D_CACHE_MAX];
+static int prefab3DCount = 0;
+static Material prefab3DMaterial;
+static bool prefab3DMaterialLoaded = false;
+
+// Largest extent of a part, for dropping small parts from coarse levels.
+static inline float PartExtent(const Part *p) {
+    switch (p->type) {
+        case PART_CUBE:   return fmaxf(p->size.x, fmaxf(p->size.y, p->size.z));
+        case PART_SPHERE: return 2.0f * p->size.x;
+        case PART_CYLINDER:
+        case PART_CONE:   return fmaxf(2.0f * fmaxf(p->size.x, p->size.z), p->size.y);
+    }
+    return 0.0f;
+}
+
+// Vertex/index counts one part compiles to (0 if detail drops it).
+static inline void PartMeshCounts(const Part *p, PartMeshDetail d, int *verts, int *indices) {
+    const int R = d.sphereRings, S = d.sphereSlices, C = d.cylSides;
+    if (PartExtent(p) < d.minPartSize) { *verts = 0; *indices = 0; return; }
+    switch (p->type) {
+        case PART_CUBE:   *verts = 24; *indices = 36; break;
+        case PART_SPHERE: *verts = (R + 1) * (S + 1); *indices = S * (R - 1) * 6; break;
+        case PART_CYLINDER:
+        case PART_CONE: {
+            float topR = (p->type == PART_CONE) ? p->size.z : p->size.x;
+            int caps = (p->size.x > 0.0f) + (topR > 0.0f);
+            *verts = 2 * (C + 1) + caps * (C + 2);
+            *indices = C * 6 + caps * C * 3;
+            break;
+        }
+        default: *verts = 0; *indices = 0; break;
+    }
+}
+
+typedef struct {
+    Mesh *m;
+    int v, i;   // next vertex, next index
+    PartMeshDetail d;
+} PartMeshWriter_;
+
+static inline void PartMeshVertex_(PartMeshWriter_ *w, Vector3 pos, Vector3 n, Color c) {
+    int v = w->v++;
+    w->m->vertices[v*3] = pos.x; w->m->vertices[v*3+1] = pos.y; w->m->vertices[v*3+2] = pos.z;
+    w->m->normals[v*3]  = n.x;   w->m->normals[v*3+1]  = n.y;   w->m->normals[v*3+2]  = n.z;
+    w->m->colors[v*4] = c.r; w->m->colors[v*4+1] = c.g; w->m->colors[v*4+2] = c.b; w->m->colors[v*4+3] = c.a;
+}
+
+static inline void PartMeshTri_(PartMeshWriter_ *w, int a, int b, int c) {
+    w->m->indices[w->i++] = (unsigned short)a;
+    w->m->indices[w->i++] = (unsigned short)b;
+    w->m->indices[w->i++] = (unsigned short)c;
+}
+
+static inline void PartMeshCube_(PartMeshWriter_ *w, const Part *p) {
+    Vector3 h = Vector3Scale(p->size, 0.5f);
+    Color dark = {(unsigned char)(p->color.r*0.7f),(unsigned char)(p->color.g*0.7f),(unsigned char)(p->color.b*0.7f),p->color.a};
+    // Face normal and one in-face axis; the other is n x u, so u x v = n and
+    // the quad below winds CCW seen from outside.
+    static const Vector3 faces[6][2] = {
+        {{ 0, 0, 1}, {1, 0, 0}}, {{ 0, 0,-1}, {1, 0, 0}},
+        {{ 0, 1, 0}, {1, 0, 0}}, {{ 0,-1, 0}, {1, 0, 0}},
+        {{ 1, 0, 0}, {0, 1, 0}}, {{-1, 0, 0}, {0, 1, 0}},
+    };
+    for (int f = 0; f < 6; f++) {
+        Vector3 n = faces[f][0], u = faces[f][1], v = Vector3CrossProduct(n, u);
+        Vector3 c = Vector3Add(p->offset, Vector3Multiply(n, h));
+        Vector3 du = Vector3Multiply(u, h), dv = Vector3Multiply(v, h);
+        Color col = (n.z != 0.0f) ? p->color : dark;
+        int base = w->v;
+        PartMeshVertex_(w, Vector3Subtract(Vector3Subtract(c, du), dv), n, col);
+        PartMeshVertex_(w, Vector3Subtract(Vector3Add(c, du), dv), n, col);
+        PartMeshVertex_(w, Vector3Add(Vector3Add(c, du), dv), n, col);
+        PartMeshVertex_(w, Vector3Add(Vector3Subtract(c, du), dv), n, col);
+        PartMeshTri_(w, base, base + 1, base + 2);
+        PartMeshTri_(w, base, base + 2, base + 3);
+    }
+}
+
+static inline void PartMeshSphere_(PartMeshWriter_ *w, const Part *p) {
+    const int R = w->d.sphereRings, S = w->d.sphereSlices;
+    float r = p->size.x;
+    int base = w->v;
+    for (int i = 0; i <= R; i++) {
+        float th = PI * (float)i / R;   // from the top pole down
+        for (int j = 0; j <= S; j++) {
+            float ph = 2.0f * PI * (float)j / S;
+            Vector3 n = { sinf(th) * cosf(ph), cosf(th), sinf(th) * sinf(ph) };
+            PartMeshVertex_(w, Vector3Add(p->offset, Vector3Scale(n, r)), n, p->color);
+        }
+    }
+    for (int i = 0; i < R; i++) {
+        for (int j = 0; j < S; j++) {
+            int a = base + i * (S + 1) + j, b = a + S + 1;   // a above b
+            if (i > 0)     PartMeshTri_(w, a, a + 1, b + 1);
+            if (i < R - 1) PartMeshTri_(w, a, b + 1, b);
+        }
+    }
+}
+
+// Cylinder and cone: upright from offset, as DrawPart draws them.
+static inline void PartMeshCylinder_(PartMeshWriter_ *w, const Part *p) {
+    const int C = w->d.cylSides;
+    float r0 = p->size.x, r1 = (p->type == PART_CONE) ? p->size.z : p->size.x;
+    float y0 = p->offset.y, y1 = p->offset.y + p->size.y;
+    int base = w->v;
+    for (int j = 0; j <= C; j++) {
+        float ph = 2.0f * PI * (float)j / C, cs = cosf(ph), sn = sinf(ph);
+        Vector3 n = { cs, 0.0f, sn };
+        PartMeshVertex_(w, (Vector3){ p->offset.x + cs * r0, y0, p->offset.z + sn * r0 }, n, p->color);
+        PartMeshVertex_(w, (Vector3){ p->offset.x + cs * r1, y1, p->offset.z + sn * r1 }, n, p->color);
+    }
+    for (int j = 0; j < C; j++) {
+        int a = base + j * 2;   // a bottom, a+1 top, a+2/a+3 the next side
+        PartMeshTri_(w, a, a + 1, a + 3);
+        PartMeshTri_(w, a, a + 3, a + 2);
+    }
+    for (int cap = 0; cap < 2; cap++) {
+        float r = cap ? r1 : r0, y = cap ? y1 : y0;
+        if (r <= 0.0f) continue;
+        Vector3 n = { 0.0f, cap ? 1.0f : -1.0f, 0.0f };
+        int centre = w->v;
+        PartMeshVertex_(w, (Vector3){ p->offset.x, y, p->offset.z }, n, p->color);
+        for (int j = 0; j <= C; j++) {
+            float ph = 2.0f * PI * (float)j / C;
+            PartMeshVertex_(w, (Vector3){ p->offset.x + cosf(ph) * r, y, p->offset.z + sinf(ph) * r }, n, p->color);
+        }
+        for (int j = 0; j < C; j++) {
+            if (cap) PartMeshTri_(w, centre, centre + j + 2, centre + j + 1);
+            else     PartMeshTri_(w, centre, centre + j + 1, centre + j + 2);
+        }
+    }
+}
+
+// Build one mesh from a part list at the given detail, CPU side only (no
+// window needed). Arrays come from RL_MALLOC, so UnloadMesh frees them.
+// Returns an empty mesh if nothing is left or the parts need more than 16-bit
+// indices can address. bounds may be NULL.
+static inline Mesh CompileObject3DDetail(const Part *parts, int count, PartMeshDetail detail,
+                                         BoundingBox *bounds) {
+    Mesh m = { 0 };
+    int verts = 0, indices = 0;
+    for (int i = 0; i < count; i++) {
+        int pv, pi;
+        PartMeshCounts(&parts[i], detail, &pv, &pi);
+        verts += pv; indices += pi;
+    }
+    if (bounds) *bounds = (BoundingBox){ 0 };
+    if (verts == 0 || verts > 65535) return m;
+
+    m.vertices = (float *)RL_MALLOC(sizeof(float) * 3 * verts);
+    m.normals  = (float *)RL_MALLOC(sizeof(float) * 3 * verts);
+    m.colors   = (unsigned char *)RL_MALLOC(4 * verts);
+    m.indices  = (unsigned short *)RL_MALLOC(sizeof(unsigned short) * indices);
+    PartMeshWriter_ w = { &m, 0, 0, detail };
+    for (int i = 0; i < count; i++) {
+        if (PartExtent(&parts[i]) < detail.minPartSize) continue;
+        switch (parts[i].type) {
+            case PART_CUBE:     PartMeshCube_(&w, &parts[i]); break;
+            case PART_SPHERE:   PartMeshSphere_(&w, &parts[i]); break;
+            case PART_CYLINDER:
+            case PART_CONE:     PartMeshCylinder_(&w, &parts[i]); break;
+        }
+    }
+    m.vertexCount = w.v;
+    m.triangleCount = w.i / 3;
+
+    if (bounds) {
+        Vector3 lo = { m.vertices[0], m.vertices[1], m.vertices[2] }, hi = lo;
+        for (int v = 1; v < m.vertexCount; v++) {
+            Vector3 q = { m.vertices[v*3], m.vertices[v*3+1], m.vertices[v*3+2] };
+            lo = Vector3Min(lo, q);
+            hi = Vector3Max(hi, q);
+        }
+        *bounds = (BoundingBox){ lo, hi };
+    }
+    return m;
+}
+
+static inline Mesh CompileObject3D(const Part *parts, int count, BoundingBox *bounds) {
+    return CompileObject3DDetail(parts, count, PART_DETAIL_FULL, bounds);
+}
+
+// Parts' colors averaged by each part's rough surface area (extent squared).
+static inline Color Object3DAverageColor(const Part *parts, int count) {
+    float r = 0, g = 0, b = 0, a = 0, wsum = 0;
+    for (int i = 0; i < count; i++) {
+        float e = PartExtent(&parts[i]), wt = e * e;
+        r += parts[i].color.r * wt; g += parts[i].color.g * wt;
+        b += parts[i].color.b * wt; a += parts[i].color.a * wt;
+        wsum += wt;
+    }
+    if (wsum <= 0.0f) return (Color){ 255, 255, 255, 255 };
+    return (Color){ (unsigned char)(r / wsum + 0.5f), (unsigned char)(g / wsum + 0.5f),
+                    (unsigned char)(b / wsum + 0.5f), (unsigned char)(a / wsum + 0.5f) };
+}
+
+// The last level: one 12-triangle box filling the bounds.
+static inline Mesh CompileBoxProxy(BoundingBox bounds, Color color) {
+    Vector3 size = Vector3Subtract(bounds.max, bounds.min);
+    Part box = { PART_CUBE, Vector3Scale(Vector3Add(bounds.min, bounds.max), 0.5f), size, color, false };
+    return CompileObject3D(&box, 1, NULL);
+}
+
+static inline Prefab3D *FindPrefab3D(const char *key) {
+    for (int i = 0; i < prefab3DCount; i++)
+        if (strcmp(prefab3DCache[i].key, key) == 0) return &prefab3DCache[i];
+    return NULL;
+}
+
+// Compile parts (all levels) under a key, or return what is already cached
+// under it. NULL if the cache is full or the parts compile to nothing.
+static inline Prefab3D *GetPrefab3D(const char *key, const Part *parts, int count) {
+    Prefab3D *pf = FindPrefab3D(key);
+    if (pf) return pf;
+    if (prefab3DCount == PREFAB3D_CACHE_MAX) return NULL;
+    pf = &prefab3DCache[prefab3DCount];
+    *pf = (Prefab3D){ 0 };
+    pf->lods[0] = CompileObject3D(parts, count, &pf->bounds);
+    if (pf->lods[0].vertexCount == 0) return NULL;
+    pf->extent = ComputeObject3DBounds(parts, count);
+
+    // Drop small parts, but never the largest one
+    Vector3 ext = Vector3Subtract(pf->bounds.max, pf->bounds.min);
+    float largestPart = 0.0f;
+    for (int i = 0; i < count; i++) largestPart = fmaxf(largestPart, PartExtent(&parts[i]));
+    PartMeshDetail coarse = PART_DETAIL_COARSE;
+    coarse.minPartSize = fminf(PREFAB3D_LOD1_MIN_PART * fmaxf(ext.x, fmaxf(ext.y, ext.z)), largestPart);
+    pf->lods[1] = CompileObject3DDetail(parts, count, coarse, NULL);
+    pf->lods[2] = CompileBoxProxy(pf->bounds, Object3DAverageColor(parts, count));
+
+    snprintf(pf->key, sizeof(pf->key), "%s", key);
+    prefab3DCount++;
+    return pf;
+}
+
+// Compile an .obj3d file once; later calls with the same path hit the cache.
+static inline Prefab3D *LoadPrefab3D(const char *path) {
+    Prefab3D *pf = FindPrefab3D(path);
+    if (pf) return pf;
+    Part parts[PREFAB3D_MAX_PARTS];
+    int count = LoadObject3D(path, parts, PREFAB3D_MAX_PARTS);
+    return count > 0 ? GetPrefab3D(path, parts, count) : NULL;
+}
+
+// GPU side on first use: one level's mesh buffers and the shared default material.
+static inline void Prefab3DUpload_(Prefab3D *pf, int lod) {
+    if (!pf->uploaded[lod]) {
+        UploadMesh(&pf->lods[lod], false);
+        pf->uploaded[lod] = true;
+    }
+    if (!prefab3DMaterialLoaded) {
+        prefab3DMaterial = LoadMaterialDefault();
+        prefab3DMaterialLoaded = true;
+    }
+}
+
+static inline int ClampPrefabLOD_(int lod) {
+    return lod < 0 ? 0 : (lod >= PREFAB3D_LODS ? PREFAB3D_LODS - 1 : lod);
+}
+
+// Draw one level with any transform.
+static inline void DrawPrefab3DTransformLOD(Prefab3D *pf, int lod, Matrix transform) {
+    if (!pf) return;
+    lod = ClampPrefabLOD_(lod);
+    Prefab3DUpload_(pf, lod);
+    DrawMesh(pf->lods[lod], prefab3DMaterial, transform);
+}
+
+static inline void DrawPrefab3DTransform(Prefab3D *pf, Matrix transform) {
+    DrawPrefab3DTransformLOD(pf, 0, transform);
+}
+
+// Transform DrawPart uses: rotate about Y by rotY (RotateY's sense), then move to pos.
+static inline Matrix Prefab3DTransform(Vector3 pos, float rotY, Vector3 scale) {
+    Matrix m = MatrixMultiply(MatrixScale(scale.x, scale.y, scale.z), MatrixRotateY(-rotY));
+    return MatrixMultiply(m, MatrixTranslate(pos.x, pos.y, pos.z));
+}
+
+// Same placement as DrawObject3DAt
+static inline void DrawPrefab3D(Prefab3D *pf, Vector3 pos, float rotY) {
+    DrawPrefab3DTransform(pf, Prefab3DTransform(pos, rotY, (Vector3){ 1, 1, 1 }));
+}
+
+// Per-axis scale, as DrawObject3DScaled (spheres stretch rather than averaging)
+static inline void DrawPrefab3DScaled(Prefab3D *pf, Vector3 pos, float rotY, Vector3 scale) {
+    DrawPrefab3DTransform(pf, Prefab3DTransform(pos, rotY, scale));
+}
+
+static inline void DrawPrefab3DLOD(Prefab3D *pf, int lod, Vector3 pos, float rotY, Vector3 scale) {
+    DrawPrefab3DTransformLOD(pf, lod, Prefab3DTransform(pos, rotY, scale));
+}
+
+// Projected size of the prefab's bounding sphere: its radius as a fraction of
+// half the viewport height (1 fills the screen). scale is the largest axis scale.
+static inline float PrefabScreenSize(const Prefab3D *pf, Camera3D cam, Vector3 pos, float scale) {
+    Vector3 centre = Vector3Add(pos, Vector3Scale(pf->extent.center, scale));
+    float radius = pf->extent.radius * scale;
+    if (cam.projection == CAMERA_ORTHOGRAPHIC) return radius / (0.5f * cam.fovy);
+    float dist = Vector3Distance(cam.position, centre);
+    if (dist <= radius) return 1.0f;
+    return radius / (dist * tanf(cam.fovy * 0.5f * DEG2RAD));
+}
+
+// Level for a screen size, moving from `current` only once the size is
+// PREFAB3D_LOD_HYSTERESIS past a threshold, so objects near one do not flicker.
+static inline int SelectPrefabLOD(float screenSize, int current) {
+    static const float limit[PREFAB3D_LODS - 1] = { PREFAB3D_LOD1_SIZE, PREFAB3D_LOD2_SIZE };
+    int lod = ClampPrefabLOD_(current);
+    while (lod < PREFAB3D_LODS - 1 && screenSize < limit[lod] * (1.0f - PREFAB3D_LOD_HYSTERESIS)) lod++;
+    while (lod > 0 && screenSize > limit[lod - 1] * (1.0f + PREFAB3D_LOD_HYSTERESIS)) lod--;
+    return lod;
+}
+
+// --- Instanced prefab batches ---
+// For scenery: every placed object is added to the batch during the frame,
+// and DrawPrefabBatch groups them by (prefab, lod, tint) and submits each group
+// as one DrawMeshInstanced. Draw calls scale with distinct prefabs, not with
+// placed objects. Tint multiplies the vertex colors (WHITE leaves them).
+//
+// If the instancing shader does not compile (no GLSL 330) or cpuOnly is
+// set, each group is instead expanded on the CPU into one rlBegin(RL_TRIANGLES)
+// stream, which rlgl merges into a draw call per internal buffer fill.
+//
+// Usage:  PrefabBatch scenery;  InitPrefabBatch(&scenery, 512);
+//         ClearPrefabBatch(&scenery);
+//         for (...) AddPrefabInstance(&scenery, treePrefab, pos, 0, scale, WHITE);
+//         DrawPrefabBatch(&scenery);                // inside BeginMode3D
+typedef struct {
+    Prefab3D *prefab;
+    int lod;
+    Color tint;
+    Matrix transform;
+} PrefabInstance;
+
+typedef struct {
+    PrefabInstance *items;
+    Matrix *groupTransforms;   // one group's transforms, contiguous for DrawMeshInstanced
+    int count;
+    int capacity;
+    int groupCount;            // distinct (prefab, lod, tint) at the last GroupPrefabBatch
+    bool cpuOnly;              // force the CPU stream path
+} PrefabBatch;
+
+static Shader prefab3DInstanceShader;
+static Material prefab3DInstanceMaterial;
+static int prefab3DInstanceState = 0;   // 0 not tried, 1 ready, -1 unavailable
+
+static const char *PREFAB3D_INSTANCE_VS =
+    "#version 330\n"
+    "in vec3 vertexPosition;\n"
+    "in vec4 vertexColor;\n"
+    "in mat4 instanceTransform;\n"
+    "uniform mat4 mvp;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    fragColor = vertexColor;\n"
+    "    gl_Position = mvp * instanceTransform * vec4(vertexPosition, 1.0);\n"
+    "}\n";
+
+static const char *PREFAB3D_INSTANCE_FS =
+    "#version 330\n"
+    "in vec4 fragColor;\n"
+    "uniform vec4 colDiffuse;\n"
+    "out vec4 finalColor;\n"
+    "void main() { finalColor = fragColor * colDiffuse; }\n";
+
+static inline bool InitPrefabBatch(PrefabBatch *b, int maxInstances) {
+    memset(b, 0, sizeof(*b));
+    if (maxInstances < 1) maxInstances = 1;
+    b->items = (PrefabInstance *)malloc((size_t)maxInstances * sizeof(PrefabInstance));
+    b->groupTransforms = (Matrix *)malloc((size_t)maxInstances * sizeof(Matrix));
+    if (!b->items || !b->groupTransforms) {
+        free(b->items); free(b->groupTransforms);
+        memset(b, 0, sizeof(*b));
+        return false;
+    }
+    b->capacity = maxInstances;
+    return true;
+}
+
+static inline void FreePrefabBatch(PrefabBatch *b) {
+    free(b->items);
+    free(b->groupTransforms);
+    memset(b, 0, sizeof(*b));
+}
+
+static inline void ClearPrefabBatch(PrefabBatch *b) { b->count = 0; }
+
+// Returns false when the batch is full (or pf is NULL).
+static inline bool AddPrefabInstanceTransformLOD(PrefabBatch *b, Prefab3D *pf, int lod,
+                                                 Matrix transform, Color tint) {
+    if (!pf || b->count >= b->capacity) return false;
+    b->items[b->count++] = (PrefabInstance){ pf, ClampPrefabLOD_(lod), tint, transform };
+    return true;
+}
+
+static inline bool AddPrefabInstanceTransform(PrefabBatch *b, Prefab3D *pf, Matrix transform, Color tint) {
+    return AddPrefabInstanceTransformLOD(b, pf, 0, transform, tint);
+}
+
+// Placed as DrawPrefab3DScaled
+static inline bool AddPrefabInstance(PrefabBatch *b, Prefab3D *pf, Vector3 pos, float rotY,
+                                     Vector3 scale, Color tint) {
+    return AddPrefabInstanceTransformLOD(b, pf, 0, Prefab3DTransform(pos, rotY, scale), tint);
+}
+
+static inline bool AddPrefabInstanceLOD(PrefabBatch *b, Prefab3D *pf, int lod, Vector3 pos, float rotY,
+                                        Vector3 scale, Color tint) {
+    return AddPrefabInstanceTransformLOD(b, pf, lod, Prefab3DTransform(pos, rotY, scale), tint);
+}
+
+static inline int PrefabInstanceCompare_(const void *pa, const void *pb) {
+    const PrefabInstance *a = (const PrefabInstance *)pa, *b = (const PrefabInstance *)pb;
+    if (a->prefab != b->prefab) return ((uintptr_t)a->prefab < (uintptr_t)b->prefab) ? -1 : 1;
+    if (a->lod != b->lod) return a->lod - b->lod;
+    uint32_t ta = ((uint32_t)a->tint.r << 24) | ((uint32_t)a->tint.g << 16) | ((uint32_t)a->tint.b << 8) | a->tint.a;
+    uint32_t tb = ((uint32_t)b->tint.r << 24) | ((uint32_t)b->tint.g << 16) | ((uint32_t)b->tint.b << 8) | b->tint.a;
+    return (ta > tb) - (ta < tb);
+}
+
+static inline bool PrefabInstanceSameGroup_(const PrefabInstance *a, const PrefabInstance *b) {
+    return a->prefab == b->prefab && a->lod == b->lod && a->tint.r == b->tint.r && a->tint.g == b->tint.g
+        && a->tint.b == b->tint.b && a->tint.a == b->tint.a;
+}
+
+// Sort the instances so each (prefab, lod, tint) group is contiguous; returns the
+// number of groups. Pure CPU, so it runs without a window.
+static inline int GroupPrefabBatch(PrefabBatch *b) {
+    qsort(b->items, (size_t)b->count, sizeof(PrefabInstance), PrefabInstanceCompare_);
+    b->groupCount = 0;
+    for (int i = 0; i < b->count; i++)
+        if (i == 0 || !PrefabInstanceSameGroup_(&b->items[i], &b->items[i - 1])) b->groupCount++;
+    return b->groupCount;
+}
+
+static inline bool PrefabInstancingReady_(void) {
+    if (prefab3DInstanceState == 0) {
+        prefab3DInstanceShader = LoadShaderFromMemory(PREFAB3D_INSTANCE_VS, PREFAB3D_INSTANCE_FS);
+        if (prefab3DInstanceShader.id == 0 || prefab3DInstanceShader.id == rlGetShaderIdDefault()) {
+            UnloadShader(prefab3DInstanceShader);   // frees its locs; leaves the default shader alone
+            prefab3DInstanceShader = (Shader){ 0 };
+            prefab3DInstanceState = -1;
+        } else {
+            prefab3DInstanceShader.locs[SHADER_LOC_MATRIX_MODEL] =
+                GetShaderLocationAttrib(prefab3DInstanceShader, "instanceTransform");
+            prefab3DInstanceMaterial = LoadMaterialDefault();
+            prefab3DInstanceMaterial.shader = prefab3DInstanceShader;
+            prefab3DInstanceState = 1;
+        }
+    }
+    return prefab3DInstanceState == 1;
+}
+
+// CPU path: every instance's triangles through rlgl's own vertex batch, in
+// slices of PREFAB3D_CPU_CHUNK_TRIS so a mesh bigger than the batch still fits.
+static inline void DrawPrefabGroupCPU_(const PrefabInstance *items, int n) {
+    const Mesh *m = &items[0].prefab->lods[items[0].lod];
+    Color t = items[0].tint;
+    rlSetTexture(0);
+    for (int k = 0; k < n; k++) {
+        Matrix x = items[k].transform;
+        for (int tri = 0; tri < m->triangleCount; tri += PREFAB3D_CPU_CHUNK_TRIS) {
+            int end = tri + PREFAB3D_CPU_CHUNK_TRIS < m->triangleCount ? tri + PREFAB3D_CPU_CHUNK_TRIS : m->triangleCount;
+            rlCheckRenderBatchLimit((end - tri) * 3);
+            rlBegin(RL_TRIANGLES);
+            for (int i = tri * 3; i < end * 3; i++) {
+                int v = m->indices[i];
+                const unsigned char *c = m->colors + v * 4;
+                rlColor4ub((unsigned char)(c[0] * t.r / 255), (unsigned char)(c[1] * t.g / 255),
+                           (unsigned char)(c[2] * t.b / 255), (unsigned char)(c[3] * t.a / 255));
+                Vector3 p = Vector3Transform((Vector3){ m->vertices[v*3], m->vertices[v*3+1], m->vertices[v*3+2] }, x);
+                rlVertex3f(p.x, p.y, p.z);
+            }
+            rlEnd();
+        }
+    }
+}
+
+// Submit everything added since the last Clear, one call per group.
+// Call inside BeginMode3D. Leaves the instances in the batch (sorted).
+static inline void DrawPrefabBatch(PrefabBatch *b) {
+    GroupPrefabBatch(b);
+    bool instanced = !b->cpuOnly && PrefabInstancingReady_();
+    for (int g0 = 0; g0 < b->count; ) {
+        int g1 = g0 + 1;
+        while (g1 < b->count && PrefabInstanceSameGroup_(&b->items[g1], &b->items[g0])) g1++;
+        Prefab3D *pf = b->items[g0].prefab;
+        int lod = b->items[g0].lod;
+        Prefab3DUpload_(pf, lod);
+        if (instanced) {
+            for (int i = g0; i < g1; i++) b->groupTransforms[i - g0] = b->items[i].transform;
+            prefab3DInstanceMaterial.maps[MATERIAL_MAP_DIFFUSE].color = b->items[g0].tint;
+            DrawMeshInstanced(pf->lods[lod], prefab3DInstanceMaterial, b->groupTransforms, g1 - g0);
+        } else {
+            DrawPrefabGroupCPU_(&b->items[g0], g1 - g0);
+        }
+        g0 = g1;
+    }
+}
+
+// Free every cached mesh (CPU and GPU) and the shared material.
+static inline void UnloadPrefabs3D(void) {
+    for (int i = 0; i < prefab3DCount; i++) {
+        for (int l = 0; l < PREFAB3D_LODS; l++) {
+            Mesh *m = &prefab3DCache[i].lods[l];
+            if (prefab3DCache[i].uploaded[l]) {
+                UnloadMesh(*m);
+            } else {
+                RL_FREE(m->vertices); RL_FREE(m->normals);
+                RL_FREE(m->colors);   RL_FREE(m->indices);
+            }
+        }
+    }
+    prefab3DCount = 0;
+    if (prefab3DMaterialLoaded) UnloadMaterial(prefab3DMaterial);
+    prefab3DMaterialLoaded = false;
+    if (prefab3DInstanceState == 1) UnloadMaterial(prefab3DInstanceMaterial);   // also unloads its shader
+    prefab3DInstanceState = 0;
+}
+
 #endif // OBJECTS3D_H
@@ -13,10 +13,12 @@
 #define SPRITES2D_H
 
 #include "raylib.h"
+#include "raymath.h"
 #include "rlgl.h"
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include "util/pack.h"
 
 // --- Types ---
 
@@ -168,6 +170,93 @@ static inline void DrawSprite2DPartOutline(Sprite2DPart *p, float ox, float oy,
     }
 }
 
+// --- Bounds ---
+// Extents relative to the sprite origin, at scale 1. The loaders fill them
+// in (SpriteFrame, RigPart, each PuppetKeyframe) so drawing, picking and
+// culling read a cached value instead of rescanning the parts.
+typedef struct {
+    Rectangle box;     // tight axis-aligned box (y down)
+    Vector2 center;    // bounding circle
+    float radius;
+} Sprite2DBounds;
+
+// A part's box as drawn. Lines include half their thickness either side.
+static inline Rectangle Sprite2DPartBox(const Sprite2DPart *p) {
+    float l, r, t, b;
+    switch (p->type) {
+        case SP_RECT:
+            l = p->x - fabsf(p->w) / 2; r = p->x + fabsf(p->w) / 2;
+            t = p->y - fabsf(p->h) / 2; b = p->y + fabsf(p->h) / 2;
+            break;
+        case SP_CIRCLE:
+        case SP_POLYGON:
+            l = p->x - p->w; r = p->x + p->w;
+            t = p->y - p->w; b = p->y + p->w;
+            break;
+        case SP_ELLIPSE:
+            l = p->x - p->w; r = p->x + p->w;
+            t = p->y - p->extra2; b = p->y + p->extra2;
+            break;
+        case SP_TRIANGLE:
+            l = fminf(fminf(p->x, p->w), p->extra1); r = fmaxf(fmaxf(p->x, p->w), p->extra1);
+            t = fminf(fminf(p->y, p->h), p->extra2); b = fmaxf(fmaxf(p->y, p->h), p->extra2);
+            break;
+        case SP_LINE: {
+            float half = fabsf(p->extra1) / 2;
+            l = fminf(p->x, p->w) - half; r = fmaxf(p->x, p->w) + half;
+            t = fminf(p->y, p->h) - half; b = fmaxf(p->y, p->h) + half;
+            break;
+        }
+        default: l = r = p->x; t = b = p->y; break;
+    }
+    return (Rectangle){ l, t, r - l, b - t };
+}
+
+// Distance from c to the part's farthest point.
+static inline float Sprite2DPartReach_(const Sprite2DPart *p, Vector2 c) {
+    switch (p->type) {
+        case SP_CIRCLE:
+        case SP_POLYGON: return Vector2Distance((Vector2){ p->x, p->y }, c) + p->w;
+        case SP_ELLIPSE: return Vector2Distance((Vector2){ p->x, p->y }, c) + fmaxf(p->w, p->extra2);
+        case SP_TRIANGLE:
+            return fmaxf(Vector2Distance((Vector2){ p->x, p->y }, c),
+                   fmaxf(Vector2Distance((Vector2){ p->w, p->h }, c),
+                         Vector2Distance((Vector2){ p->extra1, p->extra2 }, c)));
+        case SP_LINE:
+            return fmaxf(Vector2Distance((Vector2){ p->x, p->y }, c),
+                         Vector2Distance((Vector2){ p->w, p->h }, c)) + fabsf(p->extra1) / 2;
+        default: {
+            Rectangle r = Sprite2DPartBox(p);
+            float dx = fmaxf(fabsf(r.x - c.x), fabsf(r.x + r.width - c.x));
+            float dy = fmaxf(fabsf(r.y - c.y), fabsf(r.y + r.height - c.y));
+            return sqrtf(dx * dx + dy * dy);
+        }
+    }
+}
+
+static inline Rectangle Sprite2DBoxUnion_(Rectangle a, Rectangle b) {
+    float l = fminf(a.x, b.x), t = fminf(a.y, b.y);
+    float r = fmaxf(a.x + a.width, b.x + b.width), btm = fmaxf(a.y + a.height, b.y + b.height);
+    return (Rectangle){ l, t, r - l, btm - t };
+}
+
+// Box over every part; circle centered on the box. All zero for no parts.
+static inline Sprite2DBounds ComputeSprite2DBounds(const Sprite2DPart *parts, int count) {
+    Sprite2DBounds b = { 0 };
+    if (count <= 0) return b;
+    b.box = Sprite2DPartBox(&parts[0]);
+    for (int i = 1; i < count; i++) b.box = Sprite2DBoxUnion_(b.box, Sprite2DPartBox(&parts[i]));
+    b.center = (Vector2){ b.box.x + b.box.width / 2, b.box.y + b.box.height / 2 };
+    for (int i = 0; i < count; i++) b.radius = fmaxf(b.radius, Sprite2DPartReach_(&parts[i], b.center));
+    return b;
+}
+
+// How far below the origin the sprite reaches (0 if it is all above):
+// billboards lift by this so the origin sits at the feet.
+static inline float Sprite2DBoundsBottom(const Sprite2DBounds *b) {
+    return fmaxf(0.0f, b->box.y + b->box.height);
+}
+
 // --- File I/O ---
 // Text format:
 //   # sprite
@@ -217,7 +306,58 @@ static inline bool SaveSprite2D(const char *filename, Sprite2DPart *parts, int c
     return true;
 }
 
-static inline int LoadSprite2D(const char *filename, Sprite2DPart *parts, int maxParts) {
+// Binary form, as stored in asset packs (util/pack.h). A spr2d blob is
+// Sprite2DBlobHeader, SpriteBox[hitboxCount], SpriteBox[hurtboxCount],
+// Sprite2DRecord[partCount] — the frame extras ride along so LoadSprite2D and
+// LoadSpriteFrame read the same blob.
+typedef struct {
+    float x, y, w, h, extra1, extra2;
+    uint8_t type;       // Sprite2DType
+    uint8_t r, g, b, a;
+    uint8_t pad[3];
+} Sprite2DRecord;
+
+typedef struct {
+    uint32_t partCount, hitboxCount, hurtboxCount;
+    float duration;
+} Sprite2DBlobHeader;
+
+#define SPRITE_BOX_BYTES_ (4 * sizeof(float))   // sizeof(SpriteBox), declared below
+
+static inline Sprite2DRecord Sprite2DToRecord(const Sprite2DPart *p) {
+    return (Sprite2DRecord){ p->x, p->y, p->w, p->h, p->extra1, p->extra2,
+                             (uint8_t)p->type, p->color.r, p->color.g, p->color.b, p->color.a, { 0 } };
+}
+
+static inline Sprite2DPart Sprite2DFromRecord(const Sprite2DRecord *r) {
+    return (Sprite2DPart){ (Sprite2DType)r->type, r->x, r->y, r->w, r->h, r->extra1, r->extra2,
+                           { r->r, r->g, r->b, r->a } };
+}
+
+// The blob's header if its counts fit in size, else NULL.
+static inline const Sprite2DBlobHeader *Sprite2DBlobCheck_(const void *data, uint32_t size) {
+    const Sprite2DBlobHeader *h = (const Sprite2DBlobHeader *)data;
+    if (size < sizeof(*h)) return NULL;
+    uint64_t need = sizeof(*h) + (uint64_t)(h->hitboxCount + (uint64_t)h->hurtboxCount) * SPRITE_BOX_BYTES_
+                  + (uint64_t)h->partCount * sizeof(Sprite2DRecord);
+    return need <= size ? h : NULL;
+}
+
+static inline const Sprite2DRecord *Sprite2DBlobParts_(const Sprite2DBlobHeader *h) {
+    return (const Sprite2DRecord *)((const unsigned char *)(h + 1) + (size_t)(h->hitboxCount + h->hurtboxCount) * SPRITE_BOX_BYTES_);
+}
+
+static inline int ReadSprite2DBinary(const void *data, uint32_t size, Sprite2DPart *parts, int maxParts) {
+    const Sprite2DBlobHeader *h = Sprite2DBlobCheck_(data, size);
+    if (!h) return 0;
+    const Sprite2DRecord *recs = Sprite2DBlobParts_(h);
+    int count = (int)h->partCount < maxParts ? (int)h->partCount : maxParts;
+    for (int i = 0; i < count; i++) parts[i] = Sprite2DFromRecord(&recs[i]);
+    return count;
+}
+
+// Text file only; hot reload (assets.h) uses these *Text loaders to bypass the pack.
+static inline int LoadSprite2DText(const char *filename, Sprite2DPart *parts, int maxParts) {
     FILE *f = fopen(filename, "r");
     if (!f) return 0;
     int count = 0;
@@ -265,6 +405,14 @@ static inline int LoadSprite2D(const char *filename, Sprite2DPart *parts, int ma
     return count;
 }
 
+// Parts from the mounted pack, else the text file.
+static inline int LoadSprite2D(const char *filename, Sprite2DPart *parts, int maxParts) {
+    uint32_t blobSize;
+    const void *blob = PackLookup(filename, PACK_SPR2D, &blobSize);
+    if (blob) return ReadSprite2DBinary(blob, blobSize, parts, maxParts);
+    return LoadSprite2DText(filename, parts, maxParts);
+}
+
 // --- Fighting game animation system ---
 
 // Collision box (hitbox or hurtbox) attached to an animation frame
@@ -284,6 +432,7 @@ typedef struct {
     SpriteBox hurtboxes[MAX_FRAME_BOXES];   // vulnerable areas
     int hurtboxCount;
     float duration;   // how long this frame lasts (seconds)
+    Sprite2DBounds bounds;   // of parts, filled in by the loaders
 } SpriteFrame;
 
 // An animation: sequence of frames
@@ -323,7 +472,7 @@ static inline void SpriteAnimForcePlay(SpriteAnimState *s, SpriteAnim *anim, boo
 }
 
 static inline void SpriteAnimUpdate(SpriteAnimState *s, float dt) {
-    if (!s->anim || s->finished) return;
+    if (!s->anim || s->finished || s->anim->frameCount == 0) return;
     s->timer += dt;
     SpriteFrame *f = &s->anim->frames[s->currentFrame];
     while (s->timer >= f->duration && !s->finished) {
@@ -372,12 +521,43 @@ static inline SpriteBox SpriteBoxTransform(SpriteBox b, float x, float y, float
     return r;
 }
 
+// Frame blobs are the spr2d layout above, boxes and duration included.
+static inline bool WriteSpriteFrameBinary(PackBuffer *out, const SpriteFrame *frame) {
+    Sprite2DBlobHeader h = { (uint32_t)frame->partCount, (uint32_t)frame->hitboxCount,
+                             (uint32_t)frame->hurtboxCount, frame->duration };
+    bool ok = PackBufferPut(out, &h, sizeof(h))
+           && PackBufferPut(out, frame->hitboxes, sizeof(SpriteBox) * (size_t)frame->hitboxCount)
+           && PackBufferPut(out, frame->hurtboxes, sizeof(SpriteBox) * (size_t)frame->hurtboxCount);
+    for (int i = 0; i < frame->partCount && ok; i++) {
+        Sprite2DRecord rec = Sprite2DToRecord(&frame->parts[i]);
+        ok = PackBufferPut(out, &rec, sizeof(rec));
+    }
+    return ok;
+}
+
+static inline int ReadSpriteFrameBinary(const void *data, uint32_t size, SpriteFrame *frame) {
+    const Sprite2DBlobHeader *h = Sprite2DBlobCheck_(data, size);
+    frame->partCount = frame->hitboxCount = frame->hurtboxCount = 0;
+    frame->duration = 0.1f;
+    frame->bounds = (Sprite2DBounds){ 0 };
+    if (!h) return 0;
+    const SpriteBox *boxes = (const SpriteBox *)(h + 1);
+    frame->hitboxCount = h->hitboxCount < MAX_FRAME_BOXES ? (int)h->hitboxCount : MAX_FRAME_BOXES;
+    frame->hurtboxCount = h->hurtboxCount < MAX_FRAME_BOXES ? (int)h->hurtboxCount : MAX_FRAME_BOXES;
+    memcpy(frame->hitboxes, boxes, sizeof(SpriteBox) * (size_t)frame->hitboxCount);
+    memcpy(frame->hurtboxes, boxes + h->hitboxCount, sizeof(SpriteBox) * (size_t)frame->hurtboxCount);
+    frame->partCount = ReadSprite2DBinary(data, size, frame->parts, MAX_FRAME_PARTS);
+    frame->duration = h->duration;
+    frame->bounds = ComputeSprite2DBounds(frame->parts, frame->partCount);
+    return frame->partCount + frame->hitboxCount + frame->hurtboxCount;
+}
+
 // Load a single animation frame from a .spr2d file (extended with hitbox/hurtbox lines)
 // Format additions:
 //   hitbox x y w h
 //   hurtbox x y w h
 //   duration 0.1
-static inline int LoadSpriteFrame(const char *filename, SpriteFrame *frame) {
+static inline int LoadSpriteFrameText(const char *filename, SpriteFrame *frame) {
     FILE *f = fopen(filename, "r");
     if (!f) return 0;
     frame->partCount = 0;
@@ -402,6 +582,7 @@ static inline int LoadSpriteFrame(const char *filename, SpriteFrame *frame) {
             sscanf(line + 9, "%f", &frame->duration);
         } else {
             // Try parsing as a normal sprite part
+            if (frame->partCount >= MAX_FRAME_PARTS) continue;
             Sprite2DPart *p = &frame->parts[frame->partCount];
             int r, g, b, a;
             if (strncmp(line, "rect ", 5) == 0 &&
@@ -426,9 +607,18 @@ static inline int LoadSpriteFrame(const char *filename, SpriteFrame *frame) {
         }
     }
     fclose(f);
+    frame->bounds = ComputeSprite2DBounds(frame->parts, frame->partCount);
     return frame->partCount + frame->hitboxCount + frame->hurtboxCount;
 }
 
+// From the mounted pack, else the text file.
+static inline int LoadSpriteFrame(const char *filename, SpriteFrame *frame) {
+    uint32_t blobSize;
+    const void *blob = PackLookup(filename, PACK_SPR2D, &blobSize);
+    if (blob) return ReadSpriteFrameBinary(blob, blobSize, frame);
+    return LoadSpriteFrameText(filename, frame);
+}
+
 // Load an animation from numbered frame files: base_0.spr2d, base_1.spr2d, ...
 static inline int LoadSpriteAnim(const char *basePath, SpriteAnim *anim, bool loop) {
     anim->frameCount = 0;
@@ -445,6 +635,22 @@ static inline int LoadSpriteAnim(const char *basePath, SpriteAnim *anim, bool lo
     return anim->frameCount;
 }
 
+// Text files only, skipping the pack (used by asset reloads).
+static inline int LoadSpriteAnimText(const char *basePath, SpriteAnim *anim, bool loop) {
+    anim->frameCount = 0;
+    anim->loop = loop;
+    for (int i = 0; i < MAX_ANIM_FRAMES; i++) {
+        char path[128];
+        snprintf(path, sizeof(path), "%s_%d.spr2d", basePath, i);
+        if (LoadSpriteFrameText(path, &anim->frames[anim->frameCount]) > 0) {
+            anim->frameCount++;
+        } else {
+            break;
+        }
+    }
+    return anim->frameCount;
+}
+
 // Debug: draw hitboxes/hurtboxes
 static inline void SpriteAnimDrawBoxes(SpriteAnimState *s, float x, float y, float scale) {
     if (!s->anim || s->anim->frameCount == 0) return;
@@ -472,6 +678,7 @@ typedef struct {
     char name[16];
     Sprite2DPart parts[MAX_RIG_SPRITE_PARTS];  // the sub-sprite
     int partCount;
+    Sprite2DBounds bounds;   // of the sub-sprite, unposed
 } RigPart;
 
 typedef struct {
@@ -488,6 +695,7 @@ typedef struct {
     SpriteBox hurtboxes[MAX_FRAME_BOXES];
     int hurtboxCount;
     float duration;
+    Sprite2DBounds bounds;   // visible parts as posed, unflipped (ComputePuppetAnimBounds)
 } PuppetKeyframe;
 
 typedef struct {
@@ -513,12 +721,133 @@ typedef struct {
     PartPose resolved[MAX_RIG_PARTS];
 } PuppetState;
 
+// A sub-sprite primitive as DrawSubSpriteRotated draws it: mirrored if
+// flipped, then its offset (not its shape) turned by the pose rotation.
+static inline Sprite2DPart PuppetPosePart_(Sprite2DPart p, float cs, float sn, bool rotate, bool flip) {
+    if (flip) {
+        p.x = -p.x;
+        if (p.type == SP_TRIANGLE) { p.w = -p.w; p.extra1 = -p.extra1; }
+        if (p.type == SP_LINE) p.w = -p.w;
+    }
+    if (rotate) {
+        float rx = p.x * cs - p.y * sn;
+        float ry = p.x * sn + p.y * cs;
+        p.x = rx; p.y = ry;
+    }
+    return p;
+}
+
+// The part as DrawSprite2DPart would draw it at (dx, dy) and scale s, in
+// the parent's coordinates.
+static inline Sprite2DPart Sprite2DPartPlace_(Sprite2DPart p, float dx, float dy, float s) {
+    p.x = dx + p.x * s;
+    p.y = dy + p.y * s;
+    switch (p.type) {
+        case SP_TRIANGLE:
+            p.w = dx + p.w * s; p.h = dy + p.h * s;
+            p.extra1 = dx + p.extra1 * s; p.extra2 = dy + p.extra2 * s;
+            break;
+        case SP_LINE:    p.w = dx + p.w * s; p.h = dy + p.h * s; p.extra1 *= s; break;
+        case SP_RECT:    p.w *= s; p.h *= s; break;
+        case SP_ELLIPSE: p.w *= s; p.extra2 *= s; break;
+        default:         p.w *= s; break;   // circle, polygon radius
+    }
+    return p;
+}
+
+// Primitive j of rig part i, posed as in kf, in puppet coordinates at scale 1.
+static inline Sprite2DPart PuppetPlacedPart_(const PuppetRig *rig, const PuppetKeyframe *kf, int i, int j) {
+    const PartPose *pose = &kf->poses[i];
+    float rad = pose->rot * PI / 180.0f;
+    Sprite2DPart p = PuppetPosePart_(rig->parts[i].parts[j], cosf(rad), sinf(rad), pose->rot != 0, false);
+    return Sprite2DPartPlace_(p, pose->x, pose->y, pose->scale);
+}
+
+// Fill in every keyframe's bounds from its poses. The loaders call this;
+// call it again after editing poses or the rig.
+static inline void ComputePuppetAnimBounds(PuppetAnim *anim, const PuppetRig *rig) {
+    int frames = anim->frameCount < MAX_PUPPET_FRAMES ? anim->frameCount : MAX_PUPPET_FRAMES;
+    for (int f = 0; f < frames; f++) {
+        PuppetKeyframe *kf = &anim->frames[f];
+        Sprite2DBounds b = { 0 };
+        bool any = false;
+        for (int i = 0; i < rig->partCount; i++) {
+            if (!kf->poses[i].visible) continue;
+            for (int j = 0; j < rig->parts[i].partCount; j++) {
+                Sprite2DPart p = PuppetPlacedPart_(rig, kf, i, j);
+                Rectangle r = Sprite2DPartBox(&p);
+                b.box = any ? Sprite2DBoxUnion_(b.box, r) : r;
+                any = true;
+            }
+        }
+        b.center = (Vector2){ b.box.x + b.box.width / 2, b.box.y + b.box.height / 2 };
+        for (int i = 0; i < rig->partCount && any; i++) {
+            if (!kf->poses[i].visible) continue;
+            for (int j = 0; j < rig->parts[i].partCount; j++) {
+                Sprite2DPart p = PuppetPlacedPart_(rig, kf, i, j);
+                b.radius = fmaxf(b.radius, Sprite2DPartReach_(&p, b.center));
+            }
+        }
+        kf->bounds = b;
+    }
+}
+
+// Binary form, as stored in asset packs (util/pack.h), sub-sprites inlined:
+// Rig2DBlobHeader, Rig2DPartRecord[partCount], Sprite2DRecord[recordCount],
+// each part naming its run of records.
+typedef struct {
+    uint32_t partCount, recordCount;
+} Rig2DBlobHeader;
+
+typedef struct {
+    char name[16];
+    uint32_t first, count;
+} Rig2DPartRecord;
+
+static inline bool WritePuppetRigBinary(PackBuffer *out, const PuppetRig *rig) {
+    Rig2DBlobHeader h = { (uint32_t)rig->partCount, 0 };
+    for (int i = 0; i < rig->partCount; i++) h.recordCount += (uint32_t)rig->parts[i].partCount;
+    bool ok = PackBufferPut(out, &h, sizeof(h));
+    uint32_t first = 0;
+    for (int i = 0; i < rig->partCount && ok; i++) {
+        Rig2DPartRecord pr = { { 0 }, first, (uint32_t)rig->parts[i].partCount };
+        strncpy(pr.name, rig->parts[i].name, sizeof(pr.name) - 1);
+        first += pr.count;
+        ok = PackBufferPut(out, &pr, sizeof(pr));
+    }
+    for (int i = 0; i < rig->partCount && ok; i++)
+        for (int j = 0; j < rig->parts[i].partCount && ok; j++) {
+            Sprite2DRecord rec = Sprite2DToRecord(&rig->parts[i].parts[j]);
+            ok = PackBufferPut(out, &rec, sizeof(rec));
+        }
+    return ok;
+}
+
+static inline int ReadPuppetRigBinary(const void *data, uint32_t size, PuppetRig *rig) {
+    const Rig2DBlobHeader *h = (const Rig2DBlobHeader *)data;
+    rig->partCount = 0;
+    if (size < sizeof(*h) || size - sizeof(*h) < (uint64_t)h->partCount * sizeof(Rig2DPartRecord)
+        + (uint64_t)h->recordCount * sizeof(Sprite2DRecord)) return 0;
+    const Rig2DPartRecord *prs = (const Rig2DPartRecord *)(h + 1);
+    const Sprite2DRecord *recs = (const Sprite2DRecord *)(prs + h->partCount);
+    for (uint32_t i = 0; i < h->partCount && rig->partCount < MAX_RIG_PARTS; i++) {
+        if (prs[i].first > h->recordCount || prs[i].count > h->recordCount - prs[i].first) continue;
+        RigPart *p = &rig->parts[rig->partCount++];
+        memcpy(p->name, prs[i].name, sizeof(p->name));
+        p->name[sizeof(p->name) - 1] = '\0';
+        p->partCount = prs[i].count < MAX_RIG_SPRITE_PARTS ? (int)prs[i].count : MAX_RIG_SPRITE_PARTS;
+        for (int j = 0; j < p->partCount; j++) p->parts[j] = Sprite2DFromRecord(&recs[prs[i].first + j]);
+        p->bounds = ComputeSprite2DBounds(p->parts, p->partCount);
+    }
+    return rig->partCount;
+}
+
 // Load a rig from file. Each part references a .spr2d file:
 //   part head head.spr2d
 //   part torso torso.spr2d
 //   part arm_l arm.spr2d
 // Paths are relative to the rig file's directory.
-static inline int LoadPuppetRig(const char *filename, PuppetRig *rig) {
+static inline int LoadPuppetRigText(const char *filename, PuppetRig *rig) {
     FILE *f = fopen(filename, "r");
     if (!f) return 0;
     rig->partCount = 0;
@@ -538,7 +867,8 @@ static inline int LoadPuppetRig(const char *filename, PuppetRig *rig) {
             strncpy(p->name, name, 15);
             char fullPath[192];
             snprintf(fullPath, sizeof(fullPath), "%s%s", dir, sprFile);
-            p->partCount = LoadSprite2D(fullPath, p->parts, MAX_RIG_SPRITE_PARTS);
+            p->partCount = LoadSprite2DText(fullPath, p->parts, MAX_RIG_SPRITE_PARTS);
+            p->bounds = ComputeSprite2DBounds(p->parts, p->partCount);
             if (p->partCount > 0) rig->partCount++;
         }
     }
@@ -546,6 +876,14 @@ static inline int LoadPuppetRig(const char *filename, PuppetRig *rig) {
     return rig->partCount;
 }
 
+// From the mounted pack, else the text file.
+static inline int LoadPuppetRig(const char *filename, PuppetRig *rig) {
+    uint32_t blobSize;
+    const void *blob = PackLookup(filename, PACK_RIG2D, &blobSize);
+    if (blob) return ReadPuppetRigBinary(blob, blobSize, rig);
+    return LoadPuppetRigText(filename, rig);
+}
+
 // Find part index by name
 static inline int PuppetFindPart(PuppetRig *rig, const char *name) {
     for (int i = 0; i < rig->partCount; i++)
@@ -553,6 +891,81 @@ static inline int PuppetFindPart(PuppetRig *rig, const char *name) {
     return -1;
 }
 
+// Binary form, as stored in asset packs, deltas resolved: Anim2DBlobHeader,
+// then per frame an Anim2DFrameRecord and poseCount Anim2DPoseRecords. Poses
+// keep the part name, so the blob binds to whichever rig it is loaded against.
+typedef struct {
+    uint32_t frameCount, poseCount, loop, pad;
+} Anim2DBlobHeader;
+
+typedef struct {
+    float duration;
+    uint32_t hitboxCount, hurtboxCount, pad;
+    SpriteBox hitboxes[MAX_FRAME_BOXES];
+    SpriteBox hurtboxes[MAX_FRAME_BOXES];
+} Anim2DFrameRecord;
+
+typedef struct {
+    char part[16];
+    float x, y, rot, scale;
+    uint32_t visible;
+} Anim2DPoseRecord;
+
+// rig is the one anim was loaded against; its part names go into the blob.
+static inline bool WritePuppetAnimBinary(PackBuffer *out, const PuppetAnim *anim, const PuppetRig *rig) {
+    int frames = anim->frameCount < MAX_PUPPET_FRAMES ? anim->frameCount : MAX_PUPPET_FRAMES;
+    Anim2DBlobHeader h = { (uint32_t)frames, (uint32_t)rig->partCount, anim->loop, 0 };
+    bool ok = PackBufferPut(out, &h, sizeof(h));
+    for (int i = 0; i < frames && ok; i++) {
+        const PuppetKeyframe *kf = &anim->frames[i];
+        Anim2DFrameRecord fr = { .duration = kf->duration, .hitboxCount = (uint32_t)kf->hitboxCount,
+                                 .hurtboxCount = (uint32_t)kf->hurtboxCount };
+        memcpy(fr.hitboxes, kf->hitboxes, sizeof(fr.hitboxes));
+        memcpy(fr.hurtboxes, kf->hurtboxes, sizeof(fr.hurtboxes));
+        ok = PackBufferPut(out, &fr, sizeof(fr));
+        for (int j = 0; j < rig->partCount && ok; j++) {
+            const PartPose *pp = &kf->poses[j];
+            Anim2DPoseRecord rec = { { 0 }, pp->x, pp->y, pp->rot, pp->scale, pp->visible };
+            strncpy(rec.part, rig->parts[j].name, sizeof(rec.part) - 1);
+            ok = PackBufferPut(out, &rec, sizeof(rec));
+        }
+    }
+    return ok;
+}
+
+static inline int ReadPuppetAnimBinary(const void *data, uint32_t size, PuppetAnim *anim, PuppetRig *rig) {
+    const Anim2DBlobHeader *h = (const Anim2DBlobHeader *)data;
+    anim->frameCount = 0;
+    anim->loop = false;
+    if (size < sizeof(*h)) return 0;
+    uint64_t stride = sizeof(Anim2DFrameRecord) + (uint64_t)h->poseCount * sizeof(Anim2DPoseRecord);
+    if ((size - sizeof(*h)) / stride < h->frameCount) return 0;
+    anim->loop = h->loop != 0;
+    const unsigned char *at = (const unsigned char *)(h + 1);
+    for (uint32_t i = 0; i < h->frameCount && anim->frameCount < MAX_PUPPET_FRAMES; i++, at += stride) {
+        const Anim2DFrameRecord *fr = (const Anim2DFrameRecord *)at;
+        const Anim2DPoseRecord *poses = (const Anim2DPoseRecord *)(fr + 1);
+        PuppetKeyframe *kf = &anim->frames[anim->frameCount++];
+        kf->duration = fr->duration;
+        kf->hitboxCount = fr->hitboxCount < MAX_FRAME_BOXES ? (int)fr->hitboxCount : MAX_FRAME_BOXES;
+        kf->hurtboxCount = fr->hurtboxCount < MAX_FRAME_BOXES ? (int)fr->hurtboxCount : MAX_FRAME_BOXES;
+        memcpy(kf->hitboxes, fr->hitboxes, sizeof(kf->hitboxes));
+        memcpy(kf->hurtboxes, fr->hurtboxes, sizeof(kf->hurtboxes));
+        for (int j = 0; j < rig->partCount; j++) kf->poses[j] = (PartPose){0, 0, 0, 1.0f, true};
+        for (uint32_t j = 0; j < h->poseCount; j++) {
+            char name[16];
+            memcpy(name, poses[j].part, sizeof(name));
+            name[sizeof(name) - 1] = '\0';
+            int idx = PuppetFindPart(rig, name);
+            if (idx >= 0)
+                kf->poses[idx] = (PartPose){ poses[j].x, poses[j].y, poses[j].rot, poses[j].scale,
+                                             poses[j].visible != 0 };
+        }
+    }
+    ComputePuppetAnimBounds(anim, rig);
+    return anim->frameCount;
+}
+
 // Load animation from file:
 //   loop true
 //   frame 0.15
@@ -563,7 +976,7 @@ static inline int PuppetFindPart(PuppetRig *rig, const char *name) {
 //     hitbox 25 -50 24 14
 //   frame 0.15
 //     head 0 -68
-static inline int LoadPuppetAnim(const char *filename, PuppetAnim *anim, PuppetRig *rig) {
+static inline int LoadPuppetAnimText(const char *filename, PuppetAnim *anim, PuppetRig *rig) {
     FILE *f = fopen(filename, "r");
     if (!f) return 0;
     anim->frameCount = 0;
@@ -631,9 +1044,22 @@ static inline int LoadPuppetAnim(const char *filename, PuppetAnim *anim, PuppetR
     }
     fclose(f);
     strncpy(anim->name, filename, 31);
+    ComputePuppetAnimBounds(anim, rig);
     return anim->frameCount;
 }
 
+// From the mounted pack, else the text file.
+static inline int LoadPuppetAnim(const char *filename, PuppetAnim *anim, PuppetRig *rig) {
+    uint32_t blobSize;
+    const void *blob = PackLookup(filename, PACK_ANIM2D, &blobSize);
+    if (blob) {
+        ReadPuppetAnimBinary(blob, blobSize, anim, rig);
+        strncpy(anim->name, filename, 31);
+        return anim->frameCount;
+    }
+    return LoadPuppetAnimText(filename, anim, rig);
+}
+
 // Play/update/draw a puppet
 
 static inline void PuppetPlay(PuppetState *s, PuppetRig *rig, PuppetAnim *anim, bool flipped) {
@@ -680,19 +1106,7 @@ static inline void DrawSubSpriteRotated(Sprite2DPart *parts, int count,
     if (flip) rad = -rad;
     float cs = cosf(rad), sn = sinf(rad);
     for (int i = 0; i < count; i++) {
-        Sprite2DPart p = parts[i];
-        // Flip X if needed
-        if (flip) {
-            p.x = -p.x;
-            if (p.type == SP_TRIANGLE) { p.w = -p.w; p.extra1 = -p.extra1; }
-            if (p.type == SP_LINE) p.w = -p.w;
-        }
-        // Rotate the part's offset around origin
-        if (rotDeg != 0) {
-            float rx = p.x * cs - p.y * sn;
-            float ry = p.x * sn + p.y * cs;
-            p.x = rx; p.y = ry;
-        }
+        Sprite2DPart p = PuppetPosePart_(parts[i], cs, sn, rotDeg != 0, flip);
         DrawSprite2DPart(&p, cx, cy, scale);
     }
 }
@@ -710,6 +1124,15 @@ static inline void PuppetDraw(PuppetState *s, float x, float y, float scale) {
     }
 }
 
+// Screen box of the current keyframe as PuppetDraw places it, mirrored when
+// flipped. Empty if nothing is playing.
+static inline Rectangle PuppetBounds(const PuppetState *s, float x, float y, float scale) {
+    if (!s->anim || s->anim->frameCount <= 0) return (Rectangle){ x, y, 0, 0 };
+    Rectangle b = s->anim->frames[s->currentFrame].bounds.box;
+    if (s->flipped) b.x = -(b.x + b.width);
+    return (Rectangle){ x + b.x * scale, y + b.y * scale, b.width * scale, b.height * scale };
+}
+
 static inline void PuppetDrawBoxes(PuppetState *s, float x, float y, float scale) {
     if (!s->anim) return;
     PuppetKeyframe *kf = &s->anim->frames[s->currentFrame];
@@ -773,15 +1196,17 @@ typedef struct {
     float rotY;
     Sprite2DPart parts[32];
     int partCount;
+    Sprite2DBounds bounds;   // of parts: set with them
     char filename[32];
     bool active;
     SpriteDisplayMode displayMode;  // billboard or flat plane
 } PlacedSprite2D;
 
 // Draw a 2D sprite at a 3D position (call between BeginMode3D/EndMode3D)
-// Projects to screen space and draws there — simple billboard effect
-static inline void DrawSprite2DAt3D(Sprite2DPart *parts, int count, Vector3 worldPos,
-                                     float scale, Camera3D cam) {
+// Projects to screen space and draws there — simple billboard effect.
+// bounds are the parts' (ComputeSprite2DBounds), for anchoring at the feet.
+static inline void DrawSprite2DAt3DEx(Sprite2DPart *parts, int count, const Sprite2DBounds *bounds,
+                                       Vector3 worldPos, float scale, Camera3D cam) {
     Vector2 screen = GetWorldToScreen(worldPos, cam);
     // Distance-based scale
     float dist = Vector3Distance(worldPos, cam.position);
@@ -789,33 +1214,21 @@ static inline void DrawSprite2DAt3D(Sprite2DPart *parts, int count, Vector3 worl
     float finalScale = scale * distScale;
     if (finalScale < 0.1f) return;  // too far, skip
 
-    // Find bottom extent of sprite so origin is at the feet
-    float maxY = 0;
-    for (int i = 0; i < count; i++) {
-        float bottom = 0;
-        switch (parts[i].type) {
-            case SP_RECT:    bottom = parts[i].y + parts[i].h / 2; break;
-            case SP_CIRCLE:  bottom = parts[i].y + parts[i].w; break;
-            case SP_ELLIPSE: bottom = parts[i].y + parts[i].extra2; break;
-            case SP_TRIANGLE: {
-                bottom = parts[i].y;
-                if (parts[i].h > bottom) bottom = parts[i].h;
-                if (parts[i].extra2 > bottom) bottom = parts[i].extra2;
-                break;
-            }
-            case SP_LINE:    bottom = parts[i].y > parts[i].h ? parts[i].y : parts[i].h; break;
-            case SP_POLYGON: bottom = parts[i].y + parts[i].w; break;
-        }
-        if (bottom > maxY) maxY = bottom;
-    }
-
+    // Origin at the feet
+    float maxY = Sprite2DBoundsBottom(bounds);
     DrawSprite2D(parts, count, screen.x, screen.y - maxY * finalScale, finalScale);
 }
 
+static inline void DrawSprite2DAt3D(Sprite2DPart *parts, int count, Vector3 worldPos,
+                                     float scale, Camera3D cam) {
+    Sprite2DBounds bounds = ComputeSprite2DBounds(parts, count);
+    DrawSprite2DAt3DEx(parts, count, &bounds, worldPos, scale, cam);
+}
+
 // Draw a 2D sprite as a flat plane on the ground (call inside BeginMode3D)
 // Maps sprite X to world X, sprite Y to world -Z (so "up" in sprite = "forward")
-static inline void DrawSprite2DAsPlane(Sprite2DPart *parts, int count, Vector3 worldPos,
-                                        float scale, float rotY, Camera3D cam) {
+static inline void DrawSprite2DAsPlaneEx(Sprite2DPart *parts, int count, const Sprite2DBounds *bounds,
+                                          Vector3 worldPos, float scale, float rotY, Camera3D cam) {
     // Match billboard size: compute screen pixels per world unit at this position,
     // then derive world units per sprite pixel
     float dist = Vector3Distance(worldPos, cam.position);
@@ -827,26 +1240,8 @@ static inline void DrawSprite2DAsPlane(Sprite2DPart *parts, int count, Vector3 w
     float pixToWorld = billboardScale / screenPerWorld;  // world units per sprite px
     float cosR = cosf(rotY), sinR = sinf(rotY);
 
-    // Find bottom extent so origin is at feet (same as billboard)
-    float maxY = 0;
-    for (int i = 0; i < count; i++) {
-        float bottom = 0;
-        switch (parts[i].type) {
-            case SP_RECT:    bottom = parts[i].y + parts[i].h / 2; break;
-            case SP_CIRCLE:  bottom = parts[i].y + parts[i].w; break;
-            case SP_ELLIPSE: bottom = parts[i].y + parts[i].extra2; break;
-            case SP_TRIANGLE: {
-                bottom = parts[i].y;
-                if (parts[i].h > bottom) bottom = parts[i].h;
-                if (parts[i].extra2 > bottom) bottom = parts[i].extra2;
-                break;
-            }
-            case SP_LINE:    bottom = parts[i].y > parts[i].h ? parts[i].y : parts[i].h; break;
-            case SP_POLYGON: bottom = parts[i].y + parts[i].w; break;
-        }
-        if (bottom > maxY) maxY = bottom;
-    }
-    float yOff = maxY * pixToWorld;  // shift up so feet are at worldPos
+    // Origin at the feet (same as billboard)
+    float yOff = Sprite2DBoundsBottom(bounds) * pixToWorld;  // shift up so feet are at worldPos
 
     // Vertical plane: sprite X -> world XZ (rotated by rotY), sprite Y -> world Y
     #define S2W_X(sx, sy) (worldPos.x + (sx) * pixToWorld * cosR)
@@ -939,58 +1334,34 @@ static inline void DrawSprite2DAsPlane(Sprite2DPart *parts, int count, Vector3 w
     #undef S2W_Z
 }
 
-// Get screen-space bounding box of a billboard sprite at a 3D position
-static inline Rectangle GetSprite2DScreenRect(Sprite2DPart *parts, int count, Vector3 worldPos,
-                                               float scale, Camera3D cam) {
+static inline void DrawSprite2DAsPlane(Sprite2DPart *parts, int count, Vector3 worldPos,
+                                        float scale, float rotY, Camera3D cam) {
+    Sprite2DBounds bounds = ComputeSprite2DBounds(parts, count);
+    DrawSprite2DAsPlaneEx(parts, count, &bounds, worldPos, scale, rotY, cam);
+}
+
+// Screen-space box of a billboard sprite at a 3D position, from its bounds
+static inline Rectangle GetSprite2DScreenRectEx(const Sprite2DBounds *bounds, Vector3 worldPos,
+                                                 float scale, Camera3D cam) {
     Vector2 screen = GetWorldToScreen(worldPos, cam);
     float dist = Vector3Distance(worldPos, cam.position);
     float distScale = 20.0f / (dist + 1.0f);
     float finalScale = scale * distScale;
 
-    float minX = 1e9f, minY = 1e9f, maxX = -1e9f, maxY = -1e9f, bottomY = 0;
-    for (int i = 0; i < count; i++) {
-        float l, r, t, b;
-        switch (parts[i].type) {
-            case SP_RECT:
-                l = parts[i].x - parts[i].w/2; r = parts[i].x + parts[i].w/2;
-                t = parts[i].y - parts[i].h/2; b = parts[i].y + parts[i].h/2;
-                break;
-            case SP_CIRCLE:
-                l = parts[i].x - parts[i].w; r = parts[i].x + parts[i].w;
-                t = parts[i].y - parts[i].w; b = parts[i].y + parts[i].w;
-                break;
-            case SP_ELLIPSE:
-                l = parts[i].x - parts[i].w; r = parts[i].x + parts[i].w;
-                t = parts[i].y - parts[i].extra2; b = parts[i].y + parts[i].extra2;
-                break;
-            case SP_TRIANGLE:
-                l = fminf(fminf(parts[i].x, parts[i].w), parts[i].extra1);
-                r = fmaxf(fmaxf(parts[i].x, parts[i].w), parts[i].extra1);
-                t = fminf(fminf(parts[i].y, parts[i].h), parts[i].extra2);
-                b = fmaxf(fmaxf(parts[i].y, parts[i].h), parts[i].extra2);
-                break;
-            case SP_LINE:
-                l = fminf(parts[i].x, parts[i].w); r = fmaxf(parts[i].x, parts[i].w);
-                t = fminf(parts[i].y, parts[i].h); b = fmaxf(parts[i].y, parts[i].h);
-                break;
-            case SP_POLYGON:
-                l = parts[i].x - parts[i].w; r = parts[i].x + parts[i].w;
-                t = parts[i].y - parts[i].w; b = parts[i].y + parts[i].w;
-                break;
-            default: l = r = t = b = 0; break;
-        }
-        if (l < minX) minX = l; if (r > maxX) maxX = r;
-        if (t < minY) minY = t; if (b > maxY) maxY = b;
-        if (b > bottomY) bottomY = b;
-    }
-
-    float offY = -bottomY * finalScale;
+    const Rectangle b = bounds->box;
+    float offY = -Sprite2DBoundsBottom(bounds) * finalScale;
     return (Rectangle){
-        screen.x + minX * finalScale,
-        screen.y + offY + minY * finalScale,
-        (maxX - minX) * finalScale,
-        (maxY - minY) * finalScale
+        screen.x + b.x * finalScale,
+        screen.y + offY + b.y * finalScale,
+        b.width * finalScale,
+        b.height * finalScale
     };
 }
 
+static inline Rectangle GetSprite2DScreenRect(Sprite2DPart *parts, int count, Vector3 worldPos,
+                                               float scale, Camera3D cam) {
+    Sprite2DBounds bounds = ComputeSprite2DBounds(parts, count);
+    return GetSprite2DScreenRectEx(&bounds, worldPos, scale, cam);
+}
+
 #endif // SPRITES2D_H
@@ -0,0 +1,186 @@
+// arena.h — linear (bump) allocator, per-frame arena, nested scratch scopes.
+// Pure logic (no window needed).
+//
+// Allocating is a pointer bump; nothing is freed individually. Memory comes
+// back all at once: ArenaPopTo rewinds to a mark, ArenaClear empties the
+// arena. Use it for data that lives for one frame or one function call —
+// temporary copies, candidate lists, formatted strings — never for anything
+// kept across frames.
+#ifndef UTIL_ARENA_H
+#define UTIL_ARENA_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Released bytes are overwritten with ARENA_POISON_BYTE, so a pointer kept
+// past its scope reads obvious garbage instead of plausible stale values.
+// On unless NDEBUG; force with -DARENA_POISON=0 or 1.
+#ifndef ARENA_POISON
+#ifdef NDEBUG
+#define ARENA_POISON 0
+#else
+#define ARENA_POISON 1
+#endif
+#endif
+#define ARENA_POISON_BYTE 0xCD
+#define ARENA_ALIGN       16     // every allocation, enough for SIMD loads
+
+typedef struct {
+    unsigned char *base;
+    size_t size;
+    size_t used;
+    size_t highWater;       // most ever in use
+    size_t cycleHigh;       // most in use since the last ArenaClear
+    size_t lastCycleHigh;   // cycleHigh as of the last ArenaClear (last frame's peak)
+    int failed;             // allocations refused for lack of space
+    bool owned;             // base came from ArenaCreate's malloc
+} Arena;
+
+typedef struct {
+    Arena *arena;
+    size_t used;
+} ArenaMark;
+
+// Use caller-owned storage (a static array, say).
+static inline void ArenaInit(Arena *a, void *buffer, size_t size) {
+    *a = (Arena){ .base = (unsigned char *)buffer, .size = size };
+#if ARENA_POISON
+    memset(a->base, ARENA_POISON_BYTE, size);
+#endif
+}
+
+// Allocate the backing store once, up front.
+static inline bool ArenaCreate(Arena *a, size_t size) {
+    void *buffer = malloc(size);
+    if (!buffer) { *a = (Arena){0}; return false; }
+    ArenaInit(a, buffer, size);
+    a->owned = true;
+    return true;
+}
+
+static inline void ArenaDestroy(Arena *a) {
+    if (a->owned) free(a->base);
+    *a = (Arena){0};
+}
+
+// ARENA_ALIGN-aligned, uninitialized. NULL (and failed++) if it does not fit.
+static inline void *ArenaAlloc(Arena *a, size_t size) {
+    uintptr_t start = ((uintptr_t)a->base + a->used + (ARENA_ALIGN - 1)) & ~(uintptr_t)(ARENA_ALIGN - 1);
+    size_t offset = (size_t)(start - (uintptr_t)a->base);
+    if (!a->base || offset > a->size || size > a->size - offset) {
+        a->failed++;
+        return NULL;
+    }
+    a->used = offset + size;
+    if (a->used > a->cycleHigh) a->cycleHigh = a->used;
+    if (a->used > a->highWater) a->highWater = a->used;
+    return a->base + offset;
+}
+
+static inline void *ArenaAllocZero(Arena *a, size_t size) {
+    void *p = ArenaAlloc(a, size);
+    if (p) memset(p, 0, size);
+    return p;
+}
+
+// Usage:  Vector3 *tmp = ARENA_NEW(&arena, Vector3, count);
+#define ARENA_NEW(a, T, n) ((T *)ArenaAlloc((a), sizeof(T) * (size_t)(n)))
+
+// printf into the arena. Unlike raylib's TextFormat (a small ring of shared
+// buffers), every result stays valid until its memory is released.
+static inline char *ArenaVPrintf(Arena *a, const char *fmt, va_list args) {
+    va_list copy;
+    va_copy(copy, args);
+    int len = vsnprintf(NULL, 0, fmt, copy);
+    va_end(copy);
+    char *s = (len >= 0) ? (char *)ArenaAlloc(a, (size_t)len + 1) : NULL;
+    if (s) vsnprintf(s, (size_t)len + 1, fmt, args);
+    return s;
+}
+
+static inline char *ArenaPrintf(Arena *a, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    char *s = ArenaVPrintf(a, fmt, args);
+    va_end(args);
+    return s;
+}
+
+static inline ArenaMark ArenaGetMark(Arena *a) { return (ArenaMark){ a, a->used }; }
+
+// Release everything allocated since the mark.
+static inline void ArenaPopTo(ArenaMark m) {
+    Arena *a = m.arena;
+    if (m.used >= a->used) return;
+#if ARENA_POISON
+    memset(a->base + m.used, ARENA_POISON_BYTE, a->used - m.used);
+#endif
+    a->used = m.used;
+}
+
+// Release everything; the current peak becomes lastCycleHigh.
+static inline void ArenaClear(Arena *a) {
+    ArenaPopTo((ArenaMark){ a, 0 });
+    a->lastCycleHigh = a->cycleHigh;
+    a->cycleHigh = 0;
+}
+
+// --- Frame arena ---
+// One arena for the main thread, cleared once per frame. Created on first
+// use at FRAME_ARENA_DEFAULT_SIZE unless FrameArenaInit picked a size.
+// Not thread-safe: jobs (jobs.h) need arenas of their own.
+//
+// Usage:  FrameArenaInit(256 * 1024);                 // at startup (optional)
+//         while (!WindowShouldClose()) {
+//             FrameArenaReset();
+//             const char *s = FrameFormat("Wave %d", wave);
+//             ...
+//         }
+#ifndef FRAME_ARENA_DEFAULT_SIZE
+#define FRAME_ARENA_DEFAULT_SIZE (1024 * 1024)
+#endif
+
+static Arena frameArena;
+
+static inline bool FrameArenaInit(size_t size) {
+    if (frameArena.base) ArenaDestroy(&frameArena);
+    return ArenaCreate(&frameArena, size);
+}
+
+static inline Arena *FrameArena(void) {
+    if (!frameArena.base) ArenaCreate(&frameArena, FRAME_ARENA_DEFAULT_SIZE);
+    return &frameArena;
+}
+
+static inline void FrameArenaReset(void) { ArenaClear(FrameArena()); }
+
+static inline void *FrameAlloc(size_t size) { return ArenaAlloc(FrameArena(), size); }
+
+#define FRAME_NEW(T, n) ARENA_NEW(FrameArena(), T, n)
+
+static inline char *FrameFormat(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    char *s = ArenaVPrintf(FrameArena(), fmt, args);
+    va_end(args);
+    return s;
+}
+
+// --- Scratch scopes ---
+// Temporary memory for the span of one function, on top of the frame arena.
+// Scopes nest (each End releases only what its own Begin covered), and the
+// memory is reusable right away instead of at the end of the frame.
+//
+// Usage:  ArenaMark scratch = ScratchBegin();
+//         Vector3 *tmp = FRAME_NEW(Vector3, n);
+//         ...
+//         ScratchEnd(scratch);
+static inline ArenaMark ScratchBegin(void) { return ArenaGetMark(FrameArena()); }
+static inline void ScratchEnd(ArenaMark m) { ArenaPopTo(m); }
+
+#endif // UTIL_ARENA_H
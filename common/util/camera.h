@@ -1,10 +1,13 @@
-// camera.h — four raylib-camera rigs: FPS, ThirdPerson, Chase, TopDown.
+// camera.h — four raylib-camera rigs: FPS, ThirdPerson, Chase, TopDown,
+// plus view-frustum culling for any Camera3D.
 #ifndef UTIL_CAMERA_H
 #define UTIL_CAMERA_H
 
 #include "raylib.h"
 #include "raymath.h"
 #include <math.h>
+#include <stdlib.h>
+#include "collide.h"   // SphereSoA/AABBSoA and the SIMD batch helpers
 
 typedef struct { Vector3 pos; float yaw, pitch; float fov; } CamFPS;
 typedef struct {
@@ -131,4 +134,225 @@ static inline Camera3D CamTopDownToCamera3D(const CamTopDown *c) {
     };
 }
 
+// --- Frustum culling ---
+// Six planes from a camera's view-projection; anything wholly outside one of
+// them is off screen. Tests are conservative: a few objects just outside a
+// corner pass, nothing on screen fails. Feed them cached bounds (Prefab3D's
+// extent, Object3DBounds, ...) moved to the object's world position.
+//
+// Usage:  Frustum view = CameraFrustumDefault(camera, (float)GetScreenWidth() / GetScreenHeight());
+//         for (...) if (FrustumSphere(&view, center, radius)) Draw...;
+//
+// Static scenery culls in bulk from a SphereSoA/AABBSoA (collide.h layout,
+// same mask convention as SphereOverlapBatch), or through a VisibleList.
+
+typedef struct {
+    Vector3 normal;   // unit, pointing into the frustum
+    float d;          // inside when Vector3DotProduct(normal, p) + d >= 0
+} FrustumPlane;
+
+typedef enum { FRUSTUM_LEFT, FRUSTUM_RIGHT, FRUSTUM_BOTTOM, FRUSTUM_TOP, FRUSTUM_NEAR, FRUSTUM_FAR } FrustumSide;
+
+typedef struct { FrustumPlane planes[6]; } Frustum;
+
+// BeginMode3D's clip distances (rlgl RL_CULL_DISTANCE_NEAR/FAR)
+#define FRUSTUM_DEFAULT_NEAR 0.01f
+#define FRUSTUM_DEFAULT_FAR  1000.0f
+
+// Planes of clip space -w <= x,y,z <= w pulled back through viewProj
+// (MatrixMultiply(view, projection), raymath order).
+static inline Frustum FrustumFromMatrix(Matrix m) {
+    const float r0[4] = { m.m0, m.m4, m.m8,  m.m12 };
+    const float r1[4] = { m.m1, m.m5, m.m9,  m.m13 };
+    const float r2[4] = { m.m2, m.m6, m.m10, m.m14 };
+    const float r3[4] = { m.m3, m.m7, m.m11, m.m15 };
+    const float *rows[3] = { r0, r1, r2 };
+    Frustum f;
+    for (int i = 0; i < 6; i++) {
+        const float *r = rows[i / 2];
+        float sign = (i % 2 == 0) ? 1.0f : -1.0f;   // left/bottom/near add, the others subtract
+        Vector3 n = { r3[0] + sign * r[0], r3[1] + sign * r[1], r3[2] + sign * r[2] };
+        float d = r3[3] + sign * r[3];
+        float len = Vector3Length(n);
+        if (len > 0.0f) { n = Vector3Scale(n, 1.0f / len); d /= len; }
+        f.planes[i] = (FrustumPlane){ n, d };
+    }
+    return f;
+}
+
+// The frustum BeginMode3D would draw into, for a viewport of the given
+// aspect (width / height) and clip distances.
+static inline Frustum CameraFrustum(Camera3D cam, float aspect, float zNear, float zFar) {
+    Matrix view = MatrixLookAt(cam.position, cam.target, cam.up);
+    Matrix proj;
+    if (cam.projection == CAMERA_ORTHOGRAPHIC) {
+        double top = cam.fovy / 2.0, right = top * aspect;
+        proj = MatrixOrtho(-right, right, -top, top, zNear, zFar);
+    } else {
+        proj = MatrixPerspective(cam.fovy * DEG2RAD, aspect, zNear, zFar);
+    }
+    return FrustumFromMatrix(MatrixMultiply(view, proj));
+}
+
+static inline Frustum CameraFrustumDefault(Camera3D cam, float aspect) {
+    return CameraFrustum(cam, aspect, FRUSTUM_DEFAULT_NEAR, FRUSTUM_DEFAULT_FAR);
+}
+
+static inline bool FrustumSphere(const Frustum *f, Vector3 center, float radius) {
+    for (int i = 0; i < 6; i++) {
+        const FrustumPlane *p = &f->planes[i];
+        if (Vector3DotProduct(p->normal, center) + p->d < -radius) return false;
+    }
+    return true;
+}
+
+// Box against each plane through its corner farthest along the normal.
+static inline bool FrustumAABB(const Frustum *f, BoundingBox box) {
+    Vector3 c = Vector3Scale(Vector3Add(box.min, box.max), 0.5f);
+    Vector3 h = Vector3Scale(Vector3Subtract(box.max, box.min), 0.5f);
+    for (int i = 0; i < 6; i++) {
+        const FrustumPlane *p = &f->planes[i];
+        float reach = fabsf(p->normal.x) * h.x + fabsf(p->normal.y) * h.y + fabsf(p->normal.z) * h.z;
+        if (Vector3DotProduct(p->normal, c) + p->d < -reach) return false;
+    }
+    return true;
+}
+
+// Batched: bit i of mask set for each sphere at least partly inside.
+// Returns how many are.
+static inline int FrustumSphereBatch(const Frustum *f, const SphereSoA *s, uint64_t *mask) {
+    int n = s->count, i = 0;
+    memset(mask, 0, COLLIDE_MASK_WORDS(n) * sizeof(uint64_t));
+#ifdef COLLIDE_SIMD
+    CollideF32xW nx[6], ny[6], nz[6], nd[6], zero = {0};
+    for (int k = 0; k < 6; k++) {
+        COLLIDE_SPLATW(nx[k], f->planes[k].normal.x); COLLIDE_SPLATW(ny[k], f->planes[k].normal.y);
+        COLLIDE_SPLATW(nz[k], f->planes[k].normal.z); COLLIDE_SPLATW(nd[k], f->planes[k].d);
+    }
+    for (; i + COLLIDE_SIMD_W <= n; i += COLLIDE_SIMD_W) {
+        CollideF32xW x, y, z, r;
+        COLLIDE_LOADW(x, s->x + i); COLLIDE_LOADW(y, s->y + i);
+        COLLIDE_LOADW(z, s->z + i); COLLIDE_LOADW(r, s->r + i);
+        CollideI32xW in;
+        COLLIDE_SPLATW(in, -1);
+        for (int k = 0; k < 6; k++)
+            in &= (nx[k]*x + ny[k]*y + nz[k]*z + nd[k] + r) >= zero;
+        mask[i >> 6] |= CollideLaneBits(in) << (i & 63);
+    }
+#endif
+    for (; i < n; i++)
+        if (FrustumSphere(f, (Vector3){ s->x[i], s->y[i], s->z[i] }, s->r[i]))
+            mask[i >> 6] |= (uint64_t)1 << (i & 63);
+    return CollideFinishMask_(mask, n);
+}
+
+static inline int FrustumAABBBatch(const Frustum *f, const AABBSoA *b, uint64_t *mask) {
+    int n = b->count, i = 0;
+    memset(mask, 0, COLLIDE_MASK_WORDS(n) * sizeof(uint64_t));
+#ifdef COLLIDE_SIMD
+    CollideF32xW nx[6], ny[6], nz[6], ax[6], ay[6], az[6], nd[6], zero = {0};
+    for (int k = 0; k < 6; k++) {
+        const FrustumPlane *p = &f->planes[k];
+        COLLIDE_SPLATW(nx[k], p->normal.x); COLLIDE_SPLATW(ny[k], p->normal.y); COLLIDE_SPLATW(nz[k], p->normal.z);
+        COLLIDE_SPLATW(ax[k], fabsf(p->normal.x)); COLLIDE_SPLATW(ay[k], fabsf(p->normal.y));
+        COLLIDE_SPLATW(az[k], fabsf(p->normal.z)); COLLIDE_SPLATW(nd[k], p->d);
+    }
+    for (; i + COLLIDE_SIMD_W <= n; i += COLLIDE_SIMD_W) {
+        CollideF32xW cx, cy, cz, hx, hy, hz;
+        COLLIDE_LOADW(cx, b->cx + i); COLLIDE_LOADW(cy, b->cy + i); COLLIDE_LOADW(cz, b->cz + i);
+        COLLIDE_LOADW(hx, b->hx + i); COLLIDE_LOADW(hy, b->hy + i); COLLIDE_LOADW(hz, b->hz + i);
+        CollideI32xW in;
+        COLLIDE_SPLATW(in, -1);
+        for (int k = 0; k < 6; k++)
+            in &= (nx[k]*cx + ny[k]*cy + nz[k]*cz + nd[k] + ax[k]*hx + ay[k]*hy + az[k]*hz) >= zero;
+        mask[i >> 6] |= CollideLaneBits(in) << (i & 63);
+    }
+#endif
+    for (; i < n; i++) {
+        Vector3 c = { b->cx[i], b->cy[i], b->cz[i] }, h = { b->hx[i], b->hy[i], b->hz[i] };
+        if (FrustumAABB(f, (BoundingBox){ Vector3Subtract(c, h), Vector3Add(c, h) }))
+            mask[i >> 6] |= (uint64_t)1 << (i & 63);
+    }
+    return CollideFinishMask_(mask, n);
+}
+
+// --- Visibility list ---
+// Collects the ids of visible objects for one view; draw from ids after.
+// One list per view (main camera, mirror, shadow map, ...).
+//
+// Usage:  VisibleList vis;                        // InitVisibleList(&vis, MAX_TREES) once
+//         VisibleListBegin(&vis, &view);
+//         VisibleListAddSpheres(&vis, 0, &treeSpheres);
+//         for (int i = 0; i < vis.count; i++) DrawTree(vis.ids[i]);
+#define VISIBLE_LIST_CHUNK 256   // spheres tested per batch call (mask on the stack)
+
+typedef struct {
+    Frustum frustum;
+    int *ids;        // visible, in the order offered
+    int count, cap;
+    int tested;      // offered since VisibleListBegin
+    int overflow;    // visible but past cap, dropped
+} VisibleList;
+
+static inline bool InitVisibleList(VisibleList *v, int cap) {
+    *v = (VisibleList){ 0 };
+    v->ids = (int *)malloc(sizeof(int) * (size_t)(cap > 0 ? cap : 1));
+    if (!v->ids) return false;
+    v->cap = cap;
+    return true;
+}
+
+static inline void FreeVisibleList(VisibleList *v) {
+    free(v->ids);
+    *v = (VisibleList){ 0 };
+}
+
+static inline void VisibleListBegin(VisibleList *v, const Frustum *f) {
+    v->frustum = *f;
+    v->count = v->tested = v->overflow = 0;
+}
+
+static inline void VisibleListPush_(VisibleList *v, int id) {
+    if (v->count < v->cap) v->ids[v->count++] = id;
+    else v->overflow++;
+}
+
+// Each returns whether the object is visible (and so was added).
+static inline bool VisibleListAddSphere(VisibleList *v, int id, Vector3 center, float radius) {
+    v->tested++;
+    if (!FrustumSphere(&v->frustum, center, radius)) return false;
+    VisibleListPush_(v, id);
+    return true;
+}
+
+static inline bool VisibleListAddAABB(VisibleList *v, int id, BoundingBox box) {
+    v->tested++;
+    if (!FrustumAABB(&v->frustum, box)) return false;
+    VisibleListPush_(v, id);
+    return true;
+}
+
+// Every sphere of s, ids firstId + index. Returns how many were visible.
+static inline int VisibleListAddSpheres(VisibleList *v, int firstId, const SphereSoA *s) {
+    uint64_t mask[COLLIDE_MASK_WORDS(VISIBLE_LIST_CHUNK)];
+    int visible = 0;
+    for (int base = 0; base < s->count; base += VISIBLE_LIST_CHUNK) {
+        int n = s->count - base < VISIBLE_LIST_CHUNK ? s->count - base : VISIBLE_LIST_CHUNK;
+        SphereSoA chunk = { s->x + base, s->y + base, s->z + base, s->r + base, n };
+        visible += FrustumSphereBatch(&v->frustum, &chunk, mask);
+        for (int w = 0; w < COLLIDE_MASK_WORDS(n); w++)
+            for (uint64_t m = mask[w]; m; m &= m - 1) {
+#ifdef COLLIDE_SIMD
+                int bit = __builtin_ctzll(m);
+#else
+                int bit = 0;
+                while (!((m >> bit) & 1u)) bit++;
+#endif
+                VisibleListPush_(v, firstId + base + w * 64 + bit);
+            }
+    }
+    v->tested += s->count;
+    return visible;
+}
+
 #endif // UTIL_CAMERA_H
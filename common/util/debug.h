@@ -1,9 +1,12 @@
-// debug.h — opt-in runtime debug overlay and wireframe collision shapes.
+// debug.h — opt-in runtime debug overlay, arena usage, wireframe collision shapes, scoped CPU profiler.
 #ifndef UTIL_DEBUG_H
 #define UTIL_DEBUG_H
 
 #include "raylib.h"
 #include "collide.h"
+#include "arena.h"
+#include <stdint.h>
+#include <stdio.h>
 
 typedef struct {
     bool   visible;
@@ -41,6 +44,19 @@ static inline void DebugOverlayDraw(const DebugOverlay *d,
     if (gameStateLine) DrawText(gameStateLine, 10, y + 40, 18, YELLOW);
 }
 
+// One line just above the DebugOverlayDraw panel: an arena's use right now,
+// last cycle's peak (the frame arena clears once per frame) and its all-time
+// high-water mark, in KB. Red if any allocation has been refused.
+static inline void DebugOverlayDrawArena(const DebugOverlay *d, const Arena *a, const char *label) {
+    if (!d->visible) return;
+    int y = GetScreenHeight() - 105;
+    DrawRectangle(5, y - 5, 300, 25, (Color){0, 0, 0, 180});
+    DrawText(TextFormat("%s: %.0f / %.0f / %.0f of %.0f KB", label,
+                        (double)a->used / 1024.0, (double)a->lastCycleHigh / 1024.0,
+                        (double)a->highWater / 1024.0, (double)a->size / 1024.0),
+             10, y, 16, a->failed ? RED : SKYBLUE);
+}
+
 static inline void DebugDrawAABB(AABB a, Color col) {
     DrawCubeWires(a.center, a.half.x * 2.0f, a.half.y * 2.0f, a.half.z * 2.0f, col);
 }
@@ -49,4 +65,295 @@ static inline void DebugDrawSphere(Sphere s, Color col) {
     DrawSphereWires(s.center, s.radius, 8, 8, col);
 }
 
+// --- Scoped CPU profiler ---
+// Compiled in only with -DPROFILE_ENABLE (zig build -Dprofile=true); otherwise
+// every marker below expands to nothing and the frame/overlay calls are empty.
+//
+// Each thread writes begin/end timestamps into its own fixed ring buffer (no
+// allocation, no locks). At ProfileFrameEnd the main thread's events for the
+// frame are folded into per-scope self/total times; the overlay lists the top
+// scopes for the last frame and for the worst frame since the last reset, and
+// ProfileWriteChromeTrace dumps the last N frames for chrome://tracing or
+// ui.perfetto.dev.
+//
+// Usage:  ProfileFrameBegin();                       // top of frame, main thread
+//         { PROFILE_SCOPE("enemies"); ... }          // ends at the closing brace
+//         PROFILE_BEGIN("ai"); ...; PROFILE_END();   // explicit pair
+//         ProfileFrameEnd();                         // after EndDrawing
+//         ProfilerDrawOverlay(10, 10, 8);            // inside BeginDrawing
+//
+// Scope names are matched by pointer: pass string literals. Call
+// ProfileWriteChromeTrace only while other threads are not inside scopes.
+#ifdef PROFILE_ENABLE
+
+#ifndef PROFILE_RING_EVENTS
+#define PROFILE_RING_EVENTS   16384   // per thread; power of two
+#endif
+#define PROFILE_MAX_THREADS   16
+#define PROFILE_MAX_SCOPES    64      // distinct names folded per frame
+#define PROFILE_MAX_DEPTH     32
+#define PROFILE_FRAME_HISTORY 256     // frame start times kept for trace export
+
+// Nanosecond clock. raylib's GetTime needs a window; headless builds and tests
+// can define their own before including this header.
+#ifndef PROFILE_NOW_NS
+#define PROFILE_NOW_NS() ((uint64_t)(GetTime() * 1e9))
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PROFILE_TLS __thread
+#else
+#define PROFILE_TLS
+#endif
+
+typedef struct {
+    uint64_t ns;
+    const char *name;   // NULL marks an end event
+} ProfileEvent;
+
+typedef struct {
+    ProfileEvent events[PROFILE_RING_EVENTS];
+    uint64_t head;      // events ever written; slot is head & (RING - 1)
+    int tid;
+} ProfileRing;
+
+typedef struct {
+    const char *name;
+    uint64_t selfNs, totalNs;
+    int calls;
+} ProfileScopeStat;
+
+typedef struct {
+    ProfileScopeStat scopes[PROFILE_MAX_SCOPES];
+    int count;
+    uint64_t frameNs;
+    uint64_t index;     // which frame these are
+    bool truncated;     // ring wrapped inside the frame; times are partial
+} ProfileFrameStats;
+
+typedef struct {
+    bool visible;
+    uint64_t frames;                                  // frames completed
+    uint64_t frameStartNs[PROFILE_FRAME_HISTORY];     // by frame index
+    uint64_t frameStartHead;                          // main ring head at frame start
+    ProfileFrameStats last, worst;
+} Profiler;
+
+static ProfileRing profileRings[PROFILE_MAX_THREADS];
+static ProfileRing profileSinkRing;   // threads past PROFILE_MAX_THREADS; never exported
+static int profileRingCount = 0;
+static PROFILE_TLS ProfileRing *profileRing = NULL;
+static Profiler profiler;
+
+static inline ProfileRing *ProfileThreadRing(void) {
+    if (!profileRing) {
+#if defined(__GNUC__) || defined(__clang__)
+        int i = __atomic_fetch_add(&profileRingCount, 1, __ATOMIC_RELAXED);
+#else
+        int i = profileRingCount++;
+#endif
+        if (i < PROFILE_MAX_THREADS) {
+            profileRings[i].tid = i;
+            profileRing = &profileRings[i];
+        } else {
+            profileRing = &profileSinkRing;
+        }
+    }
+    return profileRing;
+}
+
+static inline void ProfileBegin(const char *name) {
+    ProfileRing *r = ProfileThreadRing();
+    r->events[r->head & (PROFILE_RING_EVENTS - 1)] = (ProfileEvent){ PROFILE_NOW_NS(), name };
+    r->head++;
+}
+
+static inline void ProfileEnd(void) {
+    ProfileRing *r = ProfileThreadRing();
+    r->events[r->head & (PROFILE_RING_EVENTS - 1)] = (ProfileEvent){ PROFILE_NOW_NS(), NULL };
+    r->head++;
+}
+
+#define PROFILE_BEGIN(name) ProfileBegin(name)
+#define PROFILE_END()       ProfileEnd()
+
+#if defined(__GNUC__) || defined(__clang__)
+static inline void ProfileScopeCleanup_(const char **unused) { (void)unused; ProfileEnd(); }
+#define PROFILE_CAT2_(a, b) a##b
+#define PROFILE_CAT_(a, b)  PROFILE_CAT2_(a, b)
+// Times the rest of the enclosing block. Don't goto into a block past one.
+#define PROFILE_SCOPE(name) \
+    const char *PROFILE_CAT_(profileScope_, __LINE__) __attribute__((cleanup(ProfileScopeCleanup_))) = \
+        (ProfileBegin(name), (name))
+#else
+#define PROFILE_SCOPE(name)   // needs the cleanup attribute; use PROFILE_BEGIN/END
+#endif
+
+static inline ProfileScopeStat *ProfileStatFor_(ProfileFrameStats *f, const char *name) {
+    for (int i = 0; i < f->count; i++)
+        if (f->scopes[i].name == name) return &f->scopes[i];
+    if (f->count == PROFILE_MAX_SCOPES) return NULL;
+    f->scopes[f->count] = (ProfileScopeStat){ name, 0, 0, 0 };
+    return &f->scopes[f->count++];
+}
+
+// Fold ring events [from, to) into per-scope self/total times. Self time is a
+// scope's duration minus that of the scopes directly inside it.
+static inline void ProfileFold_(const ProfileRing *r, uint64_t from, uint64_t to, ProfileFrameStats *out) {
+    struct { const char *name; uint64_t start, childNs; } stack[PROFILE_MAX_DEPTH];
+    int depth = 0, skipped = 0;   // skipped: begins nested past PROFILE_MAX_DEPTH
+    out->count = 0;
+    for (uint64_t k = from; k < to; k++) {
+        const ProfileEvent *e = &r->events[k & (PROFILE_RING_EVENTS - 1)];
+        if (e->name) {
+            if (depth == PROFILE_MAX_DEPTH) { skipped++; continue; }
+            stack[depth].name = e->name;
+            stack[depth].start = e->ns;
+            stack[depth].childNs = 0;
+            depth++;
+        } else if (skipped > 0) {
+            skipped--;
+        } else if (depth > 0) {
+            depth--;
+            uint64_t total = e->ns - stack[depth].start;
+            if (depth > 0) stack[depth - 1].childNs += total;
+            ProfileScopeStat *s = ProfileStatFor_(out, stack[depth].name);
+            if (!s) continue;
+            s->totalNs += total;
+            s->selfNs += total - stack[depth].childNs;
+            s->calls++;
+        }
+    }
+}
+
+// Opens the implicit "frame" scope on the calling (main) thread.
+static inline void ProfileFrameBegin(void) {
+    ProfileRing *r = ProfileThreadRing();
+    profiler.frameStartHead = r->head;
+    profiler.frameStartNs[profiler.frames % PROFILE_FRAME_HISTORY] = PROFILE_NOW_NS();
+    ProfileBegin("frame");
+}
+
+static inline void ProfileFrameEnd(void) {
+    ProfileEnd();
+    ProfileRing *r = ProfileThreadRing();
+    ProfileFrameStats *f = &profiler.last;
+    uint64_t from = profiler.frameStartHead;
+    f->truncated = (r->head - from) > PROFILE_RING_EVENTS;
+    if (f->truncated) from = r->head - PROFILE_RING_EVENTS;
+    ProfileFold_(r, from, r->head, f);
+    f->frameNs = PROFILE_NOW_NS() - profiler.frameStartNs[profiler.frames % PROFILE_FRAME_HISTORY];
+    f->index = profiler.frames++;
+    if (f->frameNs > profiler.worst.frameNs) profiler.worst = *f;
+}
+
+static inline void ProfileResetWorst(void) { profiler.worst = (ProfileFrameStats){0}; }
+
+static inline void ProfilerToggleOnKey(int key) {
+    if (IsKeyPressed(key)) profiler.visible = !profiler.visible;
+}
+
+// Indices of f's scopes, highest self time first.
+static inline int ProfileTopScopes_(const ProfileFrameStats *f, int *order, int maxRows) {
+    int n = 0;
+    for (int i = 0; i < f->count; i++) {
+        uint64_t v = f->scopes[i].selfNs;
+        int j = n;
+        if (n < maxRows) n++;
+        else if (v <= f->scopes[order[maxRows - 1]].selfNs) continue;
+        else j = maxRows - 1;
+        while (j > 0 && f->scopes[order[j - 1]].selfNs < v) { order[j] = order[j - 1]; j--; }
+        order[j] = i;
+    }
+    return n;
+}
+
+static inline int ProfileDrawFrame_(const ProfileFrameStats *f, const char *title, int x, int y, int maxRows) {
+    int order[PROFILE_MAX_SCOPES];
+    if (maxRows > PROFILE_MAX_SCOPES) maxRows = PROFILE_MAX_SCOPES;
+    int n = ProfileTopScopes_(f, order, maxRows);
+    DrawText(TextFormat("%s #%llu: %.2f ms%s", title, (unsigned long long)f->index,
+                        (double)f->frameNs / 1e6, f->truncated ? " (truncated)" : ""),
+             x, y, 16, YELLOW);
+    y += 18;
+    for (int i = 0; i < n; i++) {
+        const ProfileScopeStat *s = &f->scopes[order[i]];
+        DrawText(TextFormat("%-16s %6.2f self %6.2f total x%d", s->name,
+                            (double)s->selfNs / 1e6, (double)s->totalNs / 1e6, s->calls),
+                 x, y, 14, WHITE);
+        y += 16;
+    }
+    return y;
+}
+
+// Top scopes by self time (ms) for the last frame and the worst frame.
+static inline void ProfilerDrawOverlay(int x, int y, int maxRows) {
+    if (!profiler.visible) return;
+    int h = 2 * (18 + 16 * maxRows) + 14;
+    DrawRectangle(x - 5, y - 5, 360, h, (Color){0, 0, 0, 180});
+    y = ProfileDrawFrame_(&profiler.last, "last", x, y, maxRows);
+    ProfileDrawFrame_(&profiler.worst, "worst", x, y + 6, maxRows);
+}
+
+// Write every complete scope that began in the last `frames` frames, from all
+// threads, as Chrome trace "X" events (microseconds). Returns false if the
+// file could not be opened.
+static inline bool ProfileWriteChromeTrace(const char *path, int frames) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) return false;
+    uint64_t n = profiler.frames;
+    if (frames < 1) frames = 1;
+    if ((uint64_t)frames > n) frames = (int)n;
+    if (frames > PROFILE_FRAME_HISTORY) frames = PROFILE_FRAME_HISTORY;
+    uint64_t since = (n > 0) ? profiler.frameStartNs[(n - (uint64_t)frames) % PROFILE_FRAME_HISTORY] : 0;
+
+    fprintf(fp, "{\"traceEvents\":[");
+    bool first = true;
+    int threads = profileRingCount < PROFILE_MAX_THREADS ? profileRingCount : PROFILE_MAX_THREADS;
+    for (int t = 0; t < threads; t++) {
+        const ProfileRing *r = &profileRings[t];
+        fprintf(fp, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+                first ? "" : ",", r->tid, r->tid == 0 ? "main" : "worker", r->tid);
+        first = false;
+        struct { const char *name; uint64_t start; } stack[PROFILE_MAX_DEPTH];
+        int depth = 0, skipped = 0;
+        uint64_t from = (r->head > PROFILE_RING_EVENTS) ? r->head - PROFILE_RING_EVENTS : 0;
+        for (uint64_t k = from; k < r->head; k++) {
+            const ProfileEvent *e = &r->events[k & (PROFILE_RING_EVENTS - 1)];
+            if (e->name) {
+                if (depth == PROFILE_MAX_DEPTH) { skipped++; continue; }
+                stack[depth].name = e->name;
+                stack[depth].start = e->ns;
+                depth++;
+            } else if (skipped > 0) {
+                skipped--;
+            } else if (depth > 0) {   // an end whose begin was overwritten is dropped
+                depth--;
+                if (stack[depth].start < since) continue;
+                fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                        stack[depth].name, r->tid,
+                        (double)(stack[depth].start - since) / 1e3,
+                        (double)(e->ns - stack[depth].start) / 1e3);
+            }
+        }
+    }
+    fprintf(fp, "\n]}\n");
+    return fclose(fp) == 0;
+}
+
+#else
+
+#define PROFILE_BEGIN(name) ((void)0)
+#define PROFILE_END()       ((void)0)
+#define PROFILE_SCOPE(name)
+
+static inline void ProfileFrameBegin(void) {}
+static inline void ProfileFrameEnd(void) {}
+static inline void ProfileResetWorst(void) {}
+static inline void ProfilerToggleOnKey(int key) { (void)key; }
+static inline void ProfilerDrawOverlay(int x, int y, int maxRows) { (void)x; (void)y; (void)maxRows; }
+static inline bool ProfileWriteChromeTrace(const char *path, int frames) { (void)path; (void)frames; return false; }
+
+#endif // PROFILE_ENABLE
+
 #endif // UTIL_DEBUG_H
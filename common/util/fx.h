@@ -1,4 +1,5 @@
-// fx.h — 2D + 3D particle pools and screen shake.
+// fx.h — 2D + 3D particle pools, SoA particle store, batched particle
+// renderer, and screen shake.
 // The 3D particle API (SpawnParticleBurst / UpdateParticles3D / DrawParticles3D)
 // and ScreenShake originated in common/objects3d.h; this header is now their
 // canonical home. objects3d.h re-includes this file so legacy callers are
@@ -8,9 +9,21 @@
 
 #include "raylib.h"
 #include "raymath.h"
+#include "rlgl.h"
+#include "math.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
+// Particle spawns and shake draw from their own stream, not raylib's global
+// RNG, so effects never shift gameplay or world-gen sequences. Reseed for
+// reproducible effects (replays, headless runs).
+static Rng fxRng = {{ 0x9E3779B9u, 0x243F6A88u, 0xB7E15162u, 0x6A09E667u }};
+
+static inline void FxSeedRng(uint64_t seed) { fxRng = RngStream(seed, RNG_STREAM_FX); }
+
 // ---- 3D particles ---------------------------------------------------------
 
 typedef struct {
@@ -30,22 +43,22 @@ static inline void SpawnParticleBurst(Particle3D *particles, int maxParticles,
                                       float sizeMin,  float sizeMax) {
     for (int i = 0; i < maxParticles && count > 0; i++) {
         if (particles[i].active) continue;
-        float a1 = (float)GetRandomValue(0, 628) / 100.0f;
-        float a2 = (float)GetRandomValue(-314, 314) / 200.0f;
-        float spd = speedMin + (float)GetRandomValue(0, 100) / 100.0f * (speedMax - speedMin);
+        float a1 = RngFloat(&fxRng, 0.0f, 6.28f);
+        float a2 = RngFloat(&fxRng, -1.57f, 1.57f);
+        float spd = speedMin + RngFloat01(&fxRng) * (speedMax - speedMin);
         particles[i].pos = pos;
         particles[i].vel = (Vector3){
             cosf(a1) * cosf(a2) * spd,
             fabsf(sinf(a2)) * spd + 2.0f,
             sinf(a1) * cosf(a2) * spd,
         };
-        int roll = GetRandomValue(0, 2);
+        int roll = RngInt(&fxRng, 0, 2);
         if (roll == 0)      particles[i].color = (Color){255, 200,  50, 255};
         else if (roll == 1) particles[i].color = (Color){255, 100,   0, 255};
         else                particles[i].color = (Color){ 80,  80,  80, 200};
-        particles[i].life    = lifeMin + (float)GetRandomValue(0, 100) / 100.0f * (lifeMax - lifeMin);
+        particles[i].life    = lifeMin + RngFloat01(&fxRng) * (lifeMax - lifeMin);
         particles[i].maxLife = particles[i].life;
-        particles[i].size    = sizeMin + (float)GetRandomValue(0, 100) / 100.0f * (sizeMax - sizeMin);
+        particles[i].size    = sizeMin + RngFloat01(&fxRng) * (sizeMax - sizeMin);
         particles[i].active  = true;
         count--;
     }
@@ -90,14 +103,14 @@ static inline void SpawnParticleBurst2D(Particle2D *particles, int maxParticles,
                                         float sizeMin,  float sizeMax) {
     for (int i = 0; i < maxParticles && count > 0; i++) {
         if (particles[i].active) continue;
-        float a   = (float)GetRandomValue(0, 628) / 100.0f;
-        float spd = speedMin + (float)GetRandomValue(0, 100) / 100.0f * (speedMax - speedMin);
+        float a   = RngFloat(&fxRng, 0.0f, 6.28f);
+        float spd = speedMin + RngFloat01(&fxRng) * (speedMax - speedMin);
         particles[i].pos = pos;
         particles[i].vel = (Vector2){ cosf(a) * spd, sinf(a) * spd };
         particles[i].color   = color;
-        particles[i].life    = lifeMin + (float)GetRandomValue(0, 100) / 100.0f * (lifeMax - lifeMin);
+        particles[i].life    = lifeMin + RngFloat01(&fxRng) * (lifeMax - lifeMin);
         particles[i].maxLife = particles[i].life;
-        particles[i].size    = sizeMin + (float)GetRandomValue(0, 100) / 100.0f * (sizeMax - sizeMin);
+        particles[i].size    = sizeMin + RngFloat01(&fxRng) * (sizeMax - sizeMin);
         particles[i].active  = true;
         count--;
     }
@@ -132,6 +145,397 @@ static inline void DrawParticles2D(Particle2D *particles, int maxParticles) {
     }
 }
 
+// ---- SoA particle store ---------------------------------------------------
+// Structure-of-arrays store for large particle counts. Live particles are
+// kept dense in [0, count): spawning appends at the tail, and dead particles
+// are swap-removed with the last live one, so there is no `active` flag and
+// no scan for free slots. The integration kernel uses GCC/Clang vector
+// extensions — 8 particles per instruction with AVX, 4 with SSE/NEON — with
+// a scalar fallback for other compilers.
+//
+// Integration is semi-implicit Euler (velocity first, like UpdateParticles2D).
+// The same store serves 2D use: spawn with SpawnParticleBurstSoA2D, pass a
+// gravity with z = 0, and draw with DrawParticlesSoA2D.
+//
+// Usage:  ParticleSoA sparks;
+//         InitParticlesSoA(&sparks, 4096);
+//         SpawnParticleBurstSoA(&sparks, pos, 12, 2, 8, 0.3f, 1.0f, 0.05f, 0.2f);
+//         UpdateParticlesSoA(&sparks, dt, (Vector3){0, -10.0f, 0});
+//         DrawParticlesSoA3D(&sparks);
+//         FreeParticlesSoA(&sparks);
+
+#define FX_SOA_LANES 8
+
+typedef struct {
+    float *px, *py, *pz;
+    float *vx, *vy, *vz;
+    float *life, *invMaxLife;   // alpha = life * invMaxLife
+    float *size;
+    Color *color;
+    int count;                  // live particles occupy [0, count)
+    int capacity;               // requested capacity rounded up to FX_SOA_LANES
+    void *_block;               // single allocation backing every array
+} ParticleSoA;
+
+// Allocates one zeroed block for all arrays. Returns false on allocation
+// failure (the store is then empty with capacity 0).
+static inline bool InitParticlesSoA(ParticleSoA *ps, int capacity) {
+    memset(ps, 0, sizeof(*ps));
+    if (capacity < 1) capacity = 1;
+    int cap = (capacity + FX_SOA_LANES - 1) & ~(FX_SOA_LANES - 1);
+    size_t bytes = (size_t)cap * (9 * sizeof(float) + sizeof(Color)) + 64;
+    unsigned char *block = (unsigned char *)calloc(1, bytes);
+    if (!block) return false;
+    // Each array is cap * 4 bytes, a multiple of 32, so every array starts
+    // 32-byte aligned once the first one is.
+    float *f = (float *)(((uintptr_t)block + 63) & ~(uintptr_t)63);
+    ps->px = f; f += cap;  ps->py = f; f += cap;  ps->pz = f; f += cap;
+    ps->vx = f; f += cap;  ps->vy = f; f += cap;  ps->vz = f; f += cap;
+    ps->life = f; f += cap;  ps->invMaxLife = f; f += cap;
+    ps->size = f; f += cap;
+    ps->color = (Color *)f;
+    ps->capacity = cap;
+    ps->_block = block;
+    return true;
+}
+
+static inline void FreeParticlesSoA(ParticleSoA *ps) {
+    free(ps->_block);
+    memset(ps, 0, sizeof(*ps));
+}
+
+// Kill every particle. O(1).
+static inline void ClearParticlesSoA(ParticleSoA *ps) { ps->count = 0; }
+
+// Append one particle. Returns its index, or -1 if the store is full.
+static inline int PushParticleSoA(ParticleSoA *ps, Vector3 pos, Vector3 vel,
+                                  float life, float size, Color color) {
+    if (ps->count >= ps->capacity) return -1;
+    int i = ps->count++;
+    ps->px[i] = pos.x;  ps->py[i] = pos.y;  ps->pz[i] = pos.z;
+    ps->vx[i] = vel.x;  ps->vy[i] = vel.y;  ps->vz[i] = vel.z;
+    ps->life[i] = life;
+    ps->invMaxLife[i] = (life > 0.0f) ? 1.0f / life : 0.0f;
+    ps->size[i] = size;
+    ps->color[i] = color;
+    return i;
+}
+
+// Same distribution and palette as SpawnParticleBurst; appends at the tail.
+// Spawns fewer than `count` if the store runs out of room.
+static inline void SpawnParticleBurstSoA(ParticleSoA *ps, Vector3 pos, int count,
+                                         float speedMin, float speedMax,
+                                         float lifeMin,  float lifeMax,
+                                         float sizeMin,  float sizeMax) {
+    for (; count > 0 && ps->count < ps->capacity; count--) {
+        float a1 = RngFloat(&fxRng, 0.0f, 6.28f);
+        float a2 = RngFloat(&fxRng, -1.57f, 1.57f);
+        float spd = speedMin + RngFloat01(&fxRng) * (speedMax - speedMin);
+        Vector3 vel = {
+            cosf(a1) * cosf(a2) * spd,
+            fabsf(sinf(a2)) * spd + 2.0f,
+            sinf(a1) * cosf(a2) * spd,
+        };
+        int roll = RngInt(&fxRng, 0, 2);
+        Color c;
+        if (roll == 0)      c = (Color){255, 200,  50, 255};
+        else if (roll == 1) c = (Color){255, 100,   0, 255};
+        else                c = (Color){ 80,  80,  80, 200};
+        float life = lifeMin + RngFloat01(&fxRng) * (lifeMax - lifeMin);
+        float size = sizeMin + RngFloat01(&fxRng) * (sizeMax - sizeMin);
+        PushParticleSoA(ps, pos, vel, life, size, c);
+    }
+}
+
+// Same distribution as SpawnParticleBurst2D; particles live in the XY plane.
+static inline void SpawnParticleBurstSoA2D(ParticleSoA *ps, Vector2 pos, Color color, int count,
+                                           float speedMin, float speedMax,
+                                           float lifeMin,  float lifeMax,
+                                           float sizeMin,  float sizeMax) {
+    for (; count > 0 && ps->count < ps->capacity; count--) {
+        float a   = RngFloat(&fxRng, 0.0f, 6.28f);
+        float spd = speedMin + RngFloat01(&fxRng) * (speedMax - speedMin);
+        float life = lifeMin + RngFloat01(&fxRng) * (lifeMax - lifeMin);
+        float size = sizeMin + RngFloat01(&fxRng) * (sizeMax - sizeMin);
+        PushParticleSoA(ps, (Vector3){ pos.x, pos.y, 0.0f },
+                        (Vector3){ cosf(a) * spd, sinf(a) * spd, 0.0f }, life, size, color);
+    }
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FX_SOA_SIMD 1
+// Native register width: 8 lanes with AVX, 4 with SSE/NEON. Wider generic
+// vectors than the target supports are split badly by GCC, so don't.
+#if defined(__AVX__)
+#define FX_SIMD_W 8
+#else
+#define FX_SIMD_W 4
+#endif
+typedef float   FxF32xW __attribute__((vector_size(FX_SIMD_W * 4)));
+typedef int32_t FxI32xW __attribute__((vector_size(FX_SIMD_W * 4)));
+// memcpy keeps the loads/stores alias-safe; compilers lower them to single
+// vector moves. Macros rather than functions so no vector crosses a call
+// boundary (GCC warns about the AVX ABI otherwise).
+#define FX_LOADW(v, p)  memcpy(&(v), (p), sizeof(FxF32xW))
+#define FX_STOREW(p, v) memcpy((p), &(v), sizeof(FxF32xW))
+// Nonzero if any lane of a comparison mask is set.
+#define FX_ANYW(m) __extension__ ({ \
+    uint64_t _w_[FX_SIMD_W / 2]; memcpy(_w_, &(m), sizeof(_w_)); \
+    uint64_t _o_ = 0; \
+    for (int _k_ = 0; _k_ < FX_SIMD_W / 2; _k_++) _o_ |= _w_[_k_]; \
+    _o_ != 0; \
+})
+#endif
+
+// Integrate every live particle, then swap-remove the ones whose life ran
+// out. The kernel processes whole vector blocks; lanes past `count` are
+// scratch storage, integrated harmlessly and left out of the expiry test.
+// `gravity` is an acceleration, e.g. (0, -10, 0) in 3D or (0, 200, 0) for
+// y-down 2D.
+static inline void UpdateParticlesSoA(ParticleSoA *ps, float dt, Vector3 gravity) {
+    float gx = gravity.x * dt, gy = gravity.y * dt, gz = gravity.z * dt;
+    // Locals so the stores below cannot force the array pointers to be
+    // reloaded through `ps` on every block.
+    float *pX = ps->px, *pY = ps->py, *pZ = ps->pz;
+    float *vX = ps->vx, *vY = ps->vy, *vZ = ps->vz, *lf = ps->life;
+    bool anyDead = false;
+#ifdef FX_SOA_SIMD
+    int n = (ps->count + FX_SOA_LANES - 1) & ~(FX_SOA_LANES - 1);
+    const FxF32xW zero = {0};
+    FxI32xW deadAcc = {0}, lane;
+    static const int32_t laneIndex[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    memcpy(&lane, laneIndex, sizeof(lane));
+    for (int i = 0; i < n; i += FX_SIMD_W) {
+        FxF32xW vx, vy, vz, px, py, pz, life;
+        FX_LOADW(vx, vX + i);  FX_LOADW(vy, vY + i);  FX_LOADW(vz, vZ + i);
+        FX_LOADW(px, pX + i);  FX_LOADW(py, pY + i);  FX_LOADW(pz, pZ + i);
+        FX_LOADW(life, lf + i);
+        vx += gx;  vy += gy;  vz += gz;
+        px += vx * dt;  py += vy * dt;  pz += vz * dt;
+        life -= dt;
+        deadAcc |= (life <= zero) & (lane < (FxI32xW){0} + (ps->count - i));   // live lanes only
+        FX_STOREW(vX + i, vx);  FX_STOREW(vY + i, vy);  FX_STOREW(vZ + i, vz);
+        FX_STOREW(pX + i, px);  FX_STOREW(pY + i, py);  FX_STOREW(pZ + i, pz);
+        FX_STOREW(lf + i, life);
+    }
+    anyDead = FX_ANYW(deadAcc);
+#else
+    for (int i = 0; i < ps->count; i++) {
+        vX[i] += gx;  vY[i] += gy;  vZ[i] += gz;
+        pX[i] += vX[i] * dt;
+        pY[i] += vY[i] * dt;
+        pZ[i] += vZ[i] * dt;
+        lf[i] -= dt;
+        anyDead |= (lf[i] <= 0.0f);
+    }
+#endif
+    if (!anyDead) return;   // nothing expired
+
+    // Compact: move the last live particle into each dead slot. The moved
+    // particle was already integrated this frame, so re-test the same index.
+    // Runs of live particles are skipped one vector compare at a time.
+    int count = ps->count;
+    int i = 0;
+    while (i < count) {
+#ifdef FX_SOA_SIMD
+        if (i + FX_SIMD_W <= count) {
+            FxF32xW life;
+            FX_LOADW(life, lf + i);
+            FxI32xW dead = (life <= zero);
+            if (!FX_ANYW(dead)) { i += FX_SIMD_W; continue; }
+        }
+#endif
+        if (lf[i] > 0.0f) { i++; continue; }
+        int last = --count;
+        pX[i] = pX[last];  pY[i] = pY[last];  pZ[i] = pZ[last];
+        vX[i] = vX[last];  vY[i] = vY[last];  vZ[i] = vZ[last];
+        lf[i] = lf[last];
+        ps->invMaxLife[i] = ps->invMaxLife[last];
+        ps->size[i] = ps->size[last];
+        ps->color[i] = ps->color[last];
+    }
+    ps->count = count;
+}
+
+// Alpha-faded, shrinking spheres — same look as DrawParticles3D.
+static inline void DrawParticlesSoA3D(const ParticleSoA *ps) {
+    for (int i = 0; i < ps->count; i++) {
+        float a = ps->life[i] * ps->invMaxLife[i];
+        Color c = ps->color[i];
+        c.a = (unsigned char)(a * c.a);
+        DrawSphere((Vector3){ ps->px[i], ps->py[i], ps->pz[i] }, ps->size[i] * a, c);
+    }
+}
+
+// Alpha-faded, constant-radius circles — same look as DrawParticles2D.
+static inline void DrawParticlesSoA2D(const ParticleSoA *ps) {
+    for (int i = 0; i < ps->count; i++) {
+        float a = ps->life[i] * ps->invMaxLife[i];
+        Color c = ps->color[i];
+        c.a = (unsigned char)(a * c.a);
+        DrawCircleV((Vector2){ ps->px[i], ps->py[i] }, ps->size[i], c);
+    }
+}
+
+// ---- Batched particle renderer ---------------------------------------------
+// DrawParticles3D/2D issue one DrawSphere/DrawCircleV per particle, each
+// tessellated from scratch. The batch path instead expands every live
+// particle into one camera-facing quad in a CPU-side vertex stream (alpha
+// fade baked into the vertex colors) and submits the whole stream inside a
+// single rlBegin(RL_QUADS) — rlgl merges it into one draw call, split only
+// when its internal vertex buffer fills.
+//
+// The Batch* builders touch no GPU state, so they can run (and be tested)
+// without a window. Only DrawParticleBatch needs an active context.
+//
+// Usage:  ParticleBatch batch;  InitParticleBatch(&batch, MAX_PARTICLES);
+//         Vector3 right, up;  ParticleBillboardAxes(camera, &right, &up);
+//         ClearParticleBatch(&batch);
+//         BatchParticles3D(&batch, particles, MAX_PARTICLES, right, up);
+//         DrawParticleBatch(&batch);            // inside BeginMode3D
+
+#define FX_BATCH_CHUNK_QUADS 1024   // quads per rlBegin/rlEnd block
+
+typedef struct {
+    float *positions;           // 3 floats per vertex, 4 vertices per quad
+    unsigned char *colors;      // RGBA per vertex
+    int quadCount;
+    int quadCapacity;
+} ParticleBatch;
+
+static inline bool InitParticleBatch(ParticleBatch *b, int maxQuads) {
+    memset(b, 0, sizeof(*b));
+    if (maxQuads < 1) maxQuads = 1;
+    b->positions = (float *)malloc((size_t)maxQuads * 4 * 3 * sizeof(float));
+    b->colors = (unsigned char *)malloc((size_t)maxQuads * 4 * 4);
+    if (!b->positions || !b->colors) {
+        free(b->positions); free(b->colors);
+        memset(b, 0, sizeof(*b));
+        return false;
+    }
+    b->quadCapacity = maxQuads;
+    return true;
+}
+
+static inline void FreeParticleBatch(ParticleBatch *b) {
+    free(b->positions);
+    free(b->colors);
+    memset(b, 0, sizeof(*b));
+}
+
+static inline void ClearParticleBatch(ParticleBatch *b) { b->quadCount = 0; }
+
+// Unit right/up vectors of the camera's view plane. Quads built on these
+// face the camera (spherical billboards).
+static inline void ParticleBillboardAxes(Camera3D cam, Vector3 *right, Vector3 *up) {
+    Vector3 fwd = Vector3Normalize(Vector3Subtract(cam.target, cam.position));
+    *right = Vector3Normalize(Vector3CrossProduct(fwd, cam.up));
+    *up    = Vector3CrossProduct(*right, fwd);
+}
+
+// Append one quad centred on `c` with half-extent `r`. Corners go
+// bottom-left, bottom-right, top-right, top-left in view space, which is
+// counter-clockwise from the camera (raylib's front face). Returns false
+// when the batch is full.
+static inline bool BatchQuad3D(ParticleBatch *b, Vector3 c, float r,
+                               Vector3 right, Vector3 up, Color col) {
+    if (b->quadCount >= b->quadCapacity) return false;
+    float rx = right.x * r, ry = right.y * r, rz = right.z * r;
+    float ux = up.x * r,    uy = up.y * r,    uz = up.z * r;
+    float *v = b->positions + (size_t)b->quadCount * 12;
+    v[0] = c.x - rx - ux;  v[1]  = c.y - ry - uy;  v[2]  = c.z - rz - uz;
+    v[3] = c.x + rx - ux;  v[4]  = c.y + ry - uy;  v[5]  = c.z + rz - uz;
+    v[6] = c.x + rx + ux;  v[7]  = c.y + ry + uy;  v[8]  = c.z + rz + uz;
+    v[9] = c.x - rx + ux;  v[10] = c.y - ry + uy;  v[11] = c.z - rz + uz;
+    unsigned char *k = b->colors + (size_t)b->quadCount * 16;
+    for (int i = 0; i < 4; i++) {
+        k[i*4 + 0] = col.r;  k[i*4 + 1] = col.g;  k[i*4 + 2] = col.b;  k[i*4 + 3] = col.a;
+    }
+    b->quadCount++;
+    return true;
+}
+
+// Same fade as DrawParticles3D: half-size and alpha both scale with life.
+static inline void BatchParticles3D(ParticleBatch *b, const Particle3D *particles,
+                                    int maxParticles, Vector3 right, Vector3 up) {
+    for (int i = 0; i < maxParticles; i++) {
+        if (!particles[i].active) continue;
+        float a = particles[i].life / particles[i].maxLife;
+        Color c = particles[i].color;
+        c.a = (unsigned char)(a * c.a);
+        if (!BatchQuad3D(b, particles[i].pos, particles[i].size * a, right, up, c)) return;
+    }
+}
+
+static inline void BatchParticlesSoA3D(ParticleBatch *b, const ParticleSoA *ps,
+                                       Vector3 right, Vector3 up) {
+    for (int i = 0; i < ps->count; i++) {
+        float a = ps->life[i] * ps->invMaxLife[i];
+        Color c = ps->color[i];
+        c.a = (unsigned char)(a * c.a);
+        Vector3 p = { ps->px[i], ps->py[i], ps->pz[i] };
+        if (!BatchQuad3D(b, p, ps->size[i] * a, right, up, c)) return;
+    }
+}
+
+// 2D quads live in screen space (z = 0, y down). Same fade as
+// DrawParticles2D: alpha fades, size holds constant. Corner order matches
+// raylib's own rectangles (top-left, bottom-left, bottom-right, top-right).
+static inline bool BatchQuad2D(ParticleBatch *b, Vector2 c, float r, Color col) {
+    if (b->quadCount >= b->quadCapacity) return false;
+    float *v = b->positions + (size_t)b->quadCount * 12;
+    v[0] = c.x - r;  v[1]  = c.y - r;  v[2]  = 0.0f;
+    v[3] = c.x - r;  v[4]  = c.y + r;  v[5]  = 0.0f;
+    v[6] = c.x + r;  v[7]  = c.y + r;  v[8]  = 0.0f;
+    v[9] = c.x + r;  v[10] = c.y - r;  v[11] = 0.0f;
+    unsigned char *k = b->colors + (size_t)b->quadCount * 16;
+    for (int i = 0; i < 4; i++) {
+        k[i*4 + 0] = col.r;  k[i*4 + 1] = col.g;  k[i*4 + 2] = col.b;  k[i*4 + 3] = col.a;
+    }
+    b->quadCount++;
+    return true;
+}
+
+static inline void BatchParticles2D(ParticleBatch *b, const Particle2D *particles, int maxParticles) {
+    for (int i = 0; i < maxParticles; i++) {
+        if (!particles[i].active) continue;
+        float a = particles[i].life / particles[i].maxLife;
+        Color c = particles[i].color;
+        c.a = (unsigned char)(a * c.a);
+        if (!BatchQuad2D(b, particles[i].pos, particles[i].size, c)) return;
+    }
+}
+
+static inline void BatchParticlesSoA2D(ParticleBatch *b, const ParticleSoA *ps) {
+    for (int i = 0; i < ps->count; i++) {
+        float a = ps->life[i] * ps->invMaxLife[i];
+        Color c = ps->color[i];
+        c.a = (unsigned char)(a * c.a);
+        if (!BatchQuad2D(b, (Vector2){ ps->px[i], ps->py[i] }, ps->size[i], c)) return;
+    }
+}
+
+// Submit the stream. Call inside BeginMode3D for 3D batches, or in plain
+// 2D drawing for 2D batches — the vertex data is the same either way.
+static inline void DrawParticleBatch(const ParticleBatch *b) {
+    rlSetTexture(0);   // rlgl's default white texture: flat vertex colour
+    for (int q0 = 0; q0 < b->quadCount; q0 += FX_BATCH_CHUNK_QUADS) {
+        int q1 = q0 + FX_BATCH_CHUNK_QUADS;
+        if (q1 > b->quadCount) q1 = b->quadCount;
+        rlCheckRenderBatchLimit((q1 - q0) * 4);
+        rlBegin(RL_QUADS);
+        for (int q = q0; q < q1; q++) {
+            const float *v = b->positions + (size_t)q * 12;
+            const unsigned char *k = b->colors + (size_t)q * 16;
+            for (int i = 0; i < 4; i++) {
+                rlColor4ub(k[i*4 + 0], k[i*4 + 1], k[i*4 + 2], k[i*4 + 3]);
+                rlVertex3f(v[i*3 + 0], v[i*3 + 1], v[i*3 + 2]);
+            }
+        }
+        rlEnd();
+    }
+}
+
 // ---- Screen shake ---------------------------------------------------------
 
 typedef struct {
@@ -156,8 +560,8 @@ static inline Vector2 ShakeOffset(ScreenShake *s) {
     if (s->timer <= 0.0f) return (Vector2){0, 0};
     float intensity = s->timer / s->amount;
     return (Vector2){
-        (float)GetRandomValue(-100, 100) / 100.0f * s->amount * intensity,
-        (float)GetRandomValue(-100, 100) / 100.0f * s->amount * intensity,
+        RngFloat(&fxRng, -1.0f, 1.0f) * s->amount * intensity,
+        RngFloat(&fxRng, -1.0f, 1.0f) * s->amount * intensity,
     };
 }
 
@@ -0,0 +1,296 @@
+// jobs.h — fixed worker pool with work stealing: ParallelFor, jobs, counters.
+// Workers are pthreads. The thread that calls JobsInit counts as worker 0 and
+// runs jobs itself whenever it waits, so no core sits idle behind a join.
+//
+// Without JobsInit, after JobsShutdown, or built with -DJOBS_SERIAL, every
+// job runs inline on the submitting thread: code written against this header
+// behaves the same single-threaded (handy for headless runs and debugging).
+//
+// Jobs must not touch raylib drawing or window state, and must only write
+// data no other job in flight reads or writes. A typical split is a parallel
+// "think" pass that reads shared state and writes per-entity results, then a
+// serial pass that applies anything touching shared state.
+#ifndef UTIL_JOBS_H
+#define UTIL_JOBS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Needs pthreads plus GCC/Clang __thread and __atomic builtins; the Windows
+// build links no pthread library, so it stays inline there.
+#if (defined(_WIN32) || (!defined(__GNUC__) && !defined(__clang__))) && !defined(JOBS_SERIAL)
+#define JOBS_SERIAL
+#endif
+
+#ifndef JOBS_SERIAL
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#define JOBS_MAX_WORKERS   16      // including the calling thread
+#define JOBS_DEQUE_SIZE    1024    // per worker, power of two; overflow runs inline
+#define JOB_MAX_DEPENDENTS 16      // jobs queued behind one counter
+
+// Runs items [begin, end) of whatever ctx describes.
+typedef void (*JobFn)(void *ctx, int begin, int end);
+
+struct JobCounter;
+
+typedef struct {
+    JobFn fn;
+    void *ctx;
+    int begin, end;
+    struct JobCounter *counter;   // decremented when the job finishes; may be NULL
+} Job;
+
+// Counts unfinished jobs. Zero-initialize, pass to JobSubmit, then JobWait.
+// Jobs submitted with JobSubmitAfter start once it reaches zero.
+typedef struct JobCounter {
+    int pending;
+    int lock;
+    int dependentCount;
+    Job dependents[JOB_MAX_DEPENDENTS];
+} JobCounter;
+
+#ifndef JOBS_SERIAL
+typedef struct {
+    pthread_mutex_t lock;
+    int top, bottom;              // thieves take from top, the owner works at bottom
+    Job jobs[JOBS_DEQUE_SIZE];
+} JobDeque;
+
+typedef struct {
+    int workerCount;              // 0 until JobsInit
+    int running;
+    int queued;                   // jobs sitting in deques
+    int sleepers;
+    pthread_t threads[JOBS_MAX_WORKERS];
+    JobDeque deques[JOBS_MAX_WORKERS];
+    pthread_mutex_t sleepLock;
+    pthread_cond_t wake;
+} JobSystem;
+
+static JobSystem jobSystem;
+static __thread int jobsWorkerIndex = 0;
+
+static inline void JobsRun_(Job j);
+static inline void JobWait(JobCounter *counter);
+
+static inline void JobCounterLock_(JobCounter *c) {
+    while (__atomic_exchange_n(&c->lock, 1, __ATOMIC_ACQUIRE)) sched_yield();
+}
+
+static inline void JobCounterUnlock_(JobCounter *c) {
+    __atomic_store_n(&c->lock, 0, __ATOMIC_RELEASE);
+}
+
+static inline void JobsPush_(Job j) {
+    JobDeque *d = &jobSystem.deques[jobsWorkerIndex];
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom - d->top == JOBS_DEQUE_SIZE) {
+        pthread_mutex_unlock(&d->lock);
+        JobsRun_(j);
+        return;
+    }
+    d->jobs[d->bottom++ & (JOBS_DEQUE_SIZE - 1)] = j;
+    pthread_mutex_unlock(&d->lock);
+    __atomic_add_fetch(&jobSystem.queued, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&jobSystem.sleepers, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&jobSystem.sleepLock);
+        pthread_cond_signal(&jobSystem.wake);
+        pthread_mutex_unlock(&jobSystem.sleepLock);
+    }
+}
+
+// Own deque newest-first (cache-warm), then steal oldest-first from the others.
+static inline bool JobsTake_(Job *out) {
+    int n = __atomic_load_n(&jobSystem.workerCount, __ATOMIC_ACQUIRE), self = jobsWorkerIndex;
+    for (int k = 0; k < n; k++) {
+        int w = (self + k) % n;
+        JobDeque *d = &jobSystem.deques[w];
+        pthread_mutex_lock(&d->lock);
+        bool got = d->bottom > d->top;
+        if (got) {
+            *out = (k == 0) ? d->jobs[--d->bottom & (JOBS_DEQUE_SIZE - 1)]
+                            : d->jobs[d->top++ & (JOBS_DEQUE_SIZE - 1)];
+            if (d->top == d->bottom) d->top = d->bottom = 0;
+        }
+        pthread_mutex_unlock(&d->lock);
+        if (got) {
+            __atomic_sub_fetch(&jobSystem.queued, 1, __ATOMIC_SEQ_CST);
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline bool JobsRunOne_(void) {
+    Job j;
+    if (!JobsTake_(&j)) return false;
+    JobsRun_(j);
+    return true;
+}
+
+static inline void *JobsWorkerMain_(void *arg) {
+    jobsWorkerIndex = (int)(intptr_t)arg;
+    while (__atomic_load_n(&jobSystem.running, __ATOMIC_ACQUIRE)) {
+        if (JobsRunOne_()) continue;
+        pthread_mutex_lock(&jobSystem.sleepLock);
+        __atomic_add_fetch(&jobSystem.sleepers, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&jobSystem.queued, __ATOMIC_SEQ_CST) == 0 &&
+               __atomic_load_n(&jobSystem.running, __ATOMIC_ACQUIRE))
+            pthread_cond_wait(&jobSystem.wake, &jobSystem.sleepLock);
+        __atomic_sub_fetch(&jobSystem.sleepers, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&jobSystem.sleepLock);
+    }
+    return NULL;
+}
+
+// Starts `threads` workers besides the caller; <= 0 picks one per remaining
+// core. Returns the total worker count (1 means everything runs inline).
+static inline int JobsInit(int threads) {
+    if (jobSystem.workerCount > 0) return jobSystem.workerCount;
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN) - 1;
+    if (threads > JOBS_MAX_WORKERS - 1) threads = JOBS_MAX_WORKERS - 1;
+    if (threads < 0) threads = 0;
+    memset(&jobSystem, 0, sizeof(jobSystem));
+    for (int i = 0; i <= threads; i++) pthread_mutex_init(&jobSystem.deques[i].lock, NULL);
+    pthread_mutex_init(&jobSystem.sleepLock, NULL);
+    pthread_cond_init(&jobSystem.wake, NULL);
+    jobsWorkerIndex = 0;
+    jobSystem.running = 1;
+    jobSystem.workerCount = threads + 1;
+    for (int i = 1; i <= threads; i++) {
+        if (pthread_create(&jobSystem.threads[i], NULL, JobsWorkerMain_, (void *)(intptr_t)i) != 0) {
+            __atomic_store_n(&jobSystem.workerCount, i, __ATOMIC_RELEASE);   // run with what started
+            break;
+        }
+    }
+    return jobSystem.workerCount;
+}
+
+// Stops and joins the workers. Wait on outstanding counters first.
+static inline void JobsShutdown(void) {
+    int n = jobSystem.workerCount;
+    if (n == 0) return;
+    pthread_mutex_lock(&jobSystem.sleepLock);
+    __atomic_store_n(&jobSystem.running, 0, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&jobSystem.wake);
+    pthread_mutex_unlock(&jobSystem.sleepLock);
+    for (int i = 1; i < n; i++) pthread_join(jobSystem.threads[i], NULL);
+    for (int i = 0; i < n; i++) pthread_mutex_destroy(&jobSystem.deques[i].lock);
+    pthread_mutex_destroy(&jobSystem.sleepLock);
+    pthread_cond_destroy(&jobSystem.wake);
+    jobSystem.workerCount = 0;
+}
+
+static inline int JobsWorkerCount(void) { return jobSystem.workerCount > 0 ? jobSystem.workerCount : 1; }
+
+// 0 for the thread that called JobsInit (and any non-worker thread), else
+// 1..JobsWorkerCount()-1. Index per-thread scratch with it.
+static inline int JobsThreadIndex(void) { return jobsWorkerIndex; }
+
+static inline void JobCounterAdd_(JobCounter *c) {
+    if (!c) return;
+    JobCounterLock_(c);
+    __atomic_add_fetch(&c->pending, 1, __ATOMIC_RELEASE);
+    JobCounterUnlock_(c);
+}
+
+// The unlock is the last touch: JobWait also waits for it, so the counter
+// may live on the waiter's stack.
+static inline void JobCounterDone_(JobCounter *c) {
+    if (!c) return;
+    Job ready[JOB_MAX_DEPENDENTS];
+    int readyCount = 0;
+    JobCounterLock_(c);
+    if (__atomic_sub_fetch(&c->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+        readyCount = c->dependentCount;
+        memcpy(ready, c->dependents, sizeof(Job) * (size_t)readyCount);
+        c->dependentCount = 0;
+    }
+    JobCounterUnlock_(c);
+    for (int i = 0; i < readyCount; i++) JobsPush_(ready[i]);
+}
+
+static inline void JobsRun_(Job j) {
+    j.fn(j.ctx, j.begin, j.end);
+    JobCounterDone_(j.counter);
+}
+
+static inline void JobSubmit(JobFn fn, void *ctx, int begin, int end, JobCounter *counter) {
+    Job j = { fn, ctx, begin, end, counter };
+    JobCounterAdd_(counter);
+    if (jobSystem.workerCount > 1) JobsPush_(j);
+    else JobsRun_(j);
+}
+
+// Queues a job to start once `after` reaches zero (immediately if it already
+// has). `counter` covers it from now, so waiting on it waits for both.
+// Falls back to waiting on `after` inline if its dependent list is full.
+static inline void JobSubmitAfter(JobCounter *after, JobFn fn, void *ctx, int begin, int end, JobCounter *counter) {
+    Job j = { fn, ctx, begin, end, counter };
+    JobCounterAdd_(counter);
+    JobCounterLock_(after);
+    bool queued = after->pending > 0 && after->dependentCount < JOB_MAX_DEPENDENTS;
+    if (queued) after->dependents[after->dependentCount++] = j;
+    JobCounterUnlock_(after);
+    if (queued) return;
+    JobWait(after);
+    if (jobSystem.workerCount > 1) JobsPush_(j);
+    else JobsRun_(j);
+}
+
+// Returns once every job counted by `counter` has finished, running queued
+// jobs (anyone's) on this thread in the meantime.
+static inline void JobWait(JobCounter *counter) {
+    while (__atomic_load_n(&counter->pending, __ATOMIC_ACQUIRE) != 0 ||
+           __atomic_load_n(&counter->lock, __ATOMIC_ACQUIRE) != 0) {
+        if (!JobsRunOne_()) sched_yield();
+    }
+}
+#else
+static inline int  JobsInit(int threads) { (void)threads; return 1; }
+static inline void JobsShutdown(void) {}
+static inline int  JobsWorkerCount(void) { return 1; }
+static inline int  JobsThreadIndex(void) { return 0; }
+
+static inline void JobSubmit(JobFn fn, void *ctx, int begin, int end, JobCounter *counter) {
+    (void)counter;
+    fn(ctx, begin, end);
+}
+
+static inline void JobSubmitAfter(JobCounter *after, JobFn fn, void *ctx, int begin, int end, JobCounter *counter) {
+    (void)after; (void)counter;
+    fn(ctx, begin, end);
+}
+
+static inline void JobWait(JobCounter *counter) { (void)counter; }
+#endif // JOBS_SERIAL
+
+// Calls fn over [0, count) in chunks of grainSize items, spread across the
+// workers, and returns when all chunks are done. grainSize <= 0 picks about
+// four chunks per worker. Safe to call from inside a job.
+//
+// Usage:  static void ThinkRange(void *ctx, int begin, int end) {
+//             for (int i = begin; i < end; i++) Think(&units[order[i]]);
+//         }
+//         ParallelFor(liveCount, 64, ThinkRange, NULL);
+static inline void ParallelFor(int count, int grainSize, JobFn fn, void *ctx) {
+    if (count <= 0) return;
+    int workers = JobsWorkerCount();
+    if (grainSize <= 0) grainSize = count / (workers * 4);
+    if (grainSize < 1) grainSize = 1;
+    if (workers <= 1 || count <= grainSize) {
+        fn(ctx, 0, count);
+        return;
+    }
+    JobCounter counter = {0};
+    for (int b = 0; b < count; b += grainSize)
+        JobSubmit(fn, ctx, b, (count - b > grainSize) ? b + grainSize : count, &counter);
+    JobWait(&counter);
+}
+
+#endif // UTIL_JOBS_H
@@ -0,0 +1,83 @@
+// loop.h — fixed-timestep accumulator, render interpolation, tick-safe input latch.
+// Pure logic (no window needed) except where a caller feeds it GetFrameTime().
+#ifndef UTIL_LOOP_H
+#define UTIL_LOOP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Game logic runs in ticks of exactly `dt` seconds; rendering runs at
+// whatever rate the monitor/SetTargetFPS gives. Each frame, feed the real
+// frame time in and run the returned number of ticks. `alpha` is then how
+// far the current moment sits between the last two ticks — lerp the
+// previous and current simulated state by it when drawing.
+//
+// A frame slower than maxSteps ticks drops the excess time instead of
+// trying to catch up (which would make the next frame slower still).
+//
+// Usage:  FixedStep loop = FixedStepInit(60.0f, 5);
+//         while (!WindowShouldClose()) {
+//             int n = FixedStepAdvance(&loop, GetFrameTime());
+//             for (int i = 0; i < n; i++) { prevPos = pos; Update(loop.dt); }
+//             Vector3 drawPos = Vector3Lerp(prevPos, pos, loop.alpha);
+//             ...
+//         }
+typedef struct {
+    float dt;           // tick length in seconds
+    float accumulator;  // unsimulated time carried into the next frame
+    float alpha;        // interpolation factor in [0, 1) after Advance
+    int maxSteps;       // cap on ticks per frame
+    int steps;          // ticks requested by the last Advance
+    uint64_t tick;      // ticks requested since init
+} FixedStep;
+
+static inline FixedStep FixedStepInit(float hz, int maxSteps) {
+    return (FixedStep){
+        .dt = 1.0f / hz,
+        .maxSteps = (maxSteps > 0) ? maxSteps : 1,
+    };
+}
+
+// Returns how many ticks of loop->dt to run this frame.
+static inline int FixedStepAdvance(FixedStep *loop, float frameTime) {
+    if (frameTime < 0.0f) frameTime = 0.0f;
+    loop->accumulator += frameTime;
+    int n = (int)(loop->accumulator / loop->dt);
+    if (n > loop->maxSteps) {
+        n = loop->maxSteps;
+        loop->accumulator = loop->dt * (float)n;   // drop the backlog
+    }
+    loop->accumulator -= loop->dt * (float)n;
+    if (loop->accumulator < 0.0f) loop->accumulator = 0.0f;
+    loop->alpha = loop->accumulator / loop->dt;
+    if (loop->alpha >= 1.0f) loop->alpha = 0.999999f;
+    loop->steps = n;
+    loop->tick += (uint64_t)n;
+    return n;
+}
+
+// IsKeyPressed is true for exactly one frame, but a frame may run zero or
+// several ticks. Poll edge-triggered actions every frame into the latch;
+// ticks Take them, so each press is seen by exactly one tick. Clear after a
+// frame that ran ticks, so a press no tick wanted cannot fire much later.
+//
+// Usage:  enum { ACT_JUMP, ACT_RELOAD };
+//         PressLatchPoll(&latch, ACT_JUMP, IsKeyPressed(KEY_SPACE));  // per frame
+//         if (PressLatchTake(&latch, ACT_JUMP)) ...                    // per tick
+//         if (n > 0) PressLatchClear(&latch);                          // after ticks
+typedef struct { uint32_t bits; } PressLatch;   // up to 32 actions
+
+static inline void PressLatchPoll(PressLatch *l, int action, bool pressed) {
+    if (pressed) l->bits |= (uint32_t)1 << action;
+}
+
+static inline bool PressLatchTake(PressLatch *l, int action) {
+    uint32_t bit = (uint32_t)1 << action;
+    bool was = (l->bits & bit) != 0;
+    l->bits &= ~bit;
+    return was;
+}
+
+static inline void PressLatchClear(PressLatch *l) { l->bits = 0; }
+
+#endif // UTIL_LOOP_H
@@ -1,10 +1,12 @@
-// math.h — angle wrap, sign, approach, easing, random helpers
+// math.h — angle wrap, sign, approach, easing, random helpers, seedable RNG streams
 #ifndef UTIL_MATH_H
 #define UTIL_MATH_H
 
 #include "raylib.h"
 #include "raymath.h"
 #include <math.h>
+#include <stdint.h>
+#include <string.h>
 
 #ifndef TAU
 #define TAU (6.283185307179586f)
@@ -90,4 +92,200 @@ static inline Vector3 RandInUnitSphere(void) {
     return (Vector3){ p.x * r, p.y * r, p.z * r };
 }
 
+// --- Seedable RNG streams ---
+// RandF and friends above share raylib's global GetRandomValue. An Rng is an
+// explicit xoshiro128** state instead: cheap, reproducible from a seed, and
+// safe to use from several threads as long as each owns its own state.
+//
+// Give each system its own stream of one seed so they don't perturb each
+// other: adding a particle burst must not change the next track layout.
+//
+// Usage:  Rng world = RngStream(seed, RNG_STREAM_WORLD);
+//         float h = RngFloat(&world, 5.0f, 20.0f);
+//         int   k = RngInt(&world, 0, 2);        // inclusive, like GetRandomValue
+typedef struct { uint32_t s[4]; } Rng;
+
+// Conventional stream ids; games may use any others.
+enum { RNG_STREAM_FX = 1, RNG_STREAM_AI, RNG_STREAM_WORLD, RNG_STREAM_GAMEPLAY };
+
+static inline uint64_t SplitMix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline uint32_t RngRotl_(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+static inline uint32_t RngNext(Rng *r) {
+    uint32_t *s = r->s;
+    uint32_t result = RngRotl_(s[1] * 5u, 7) * 9u;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = RngRotl_(s[3], 11);
+    return result;
+}
+
+static inline Rng RngSeed(uint64_t seed) {
+    uint64_t x = seed;
+    uint64_t a = SplitMix64(&x), b = SplitMix64(&x);
+    Rng r = {{ (uint32_t)a, (uint32_t)(a >> 32), (uint32_t)b, (uint32_t)(b >> 32) }};
+    if (!(r.s[0] | r.s[1] | r.s[2] | r.s[3])) r.s[0] = 1;   // all-zero is a fixed point
+    return r;
+}
+
+// Advance by one of the xoshiro jump polynomials.
+static inline void RngJumpBy_(Rng *r, const uint32_t poly[4]) {
+    uint32_t t[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++)
+        for (int b = 0; b < 32; b++) {
+            if (poly[i] & (1u << b)) {
+                t[0] ^= r->s[0]; t[1] ^= r->s[1]; t[2] ^= r->s[2]; t[3] ^= r->s[3];
+            }
+            RngNext(r);
+        }
+    memcpy(r->s, t, sizeof(t));
+}
+
+// Skip 2^64 outputs: hands out non-overlapping sub-sequences (SIMD lanes).
+static inline void RngJump(Rng *r) {
+    static const uint32_t poly[4] = { 0x8764000Bu, 0xF542D2D3u, 0x6FA035C3u, 0x77F2DB5Bu };
+    RngJumpBy_(r, poly);
+}
+
+// Skip 2^96 outputs: one per stream, so each stream has room for 2^32 lanes.
+static inline void RngLongJump(Rng *r) {
+    static const uint32_t poly[4] = { 0xB523952Eu, 0x0B6F099Fu, 0xCCF5A0EFu, 0x1C580662u };
+    RngJumpBy_(r, poly);
+}
+
+// Stream `id` of `seed`; distinct ids never overlap. Cost grows with id, so
+// keep ids small (the RNG_STREAM_* values, a per-entity index is too many).
+static inline Rng RngStream(uint64_t seed, uint32_t id) {
+    Rng r = RngSeed(seed);
+    for (uint32_t i = 0; i < id; i++) RngLongJump(&r);
+    return r;
+}
+
+// Uniform in [0, 1): the top 24 bits, exact in a float.
+static inline float RngFloat01(Rng *r) {
+    return (float)(RngNext(r) >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline float RngFloat(Rng *r, float a, float b) {
+    return a + RngFloat01(r) * (b - a);
+}
+
+// Uniform integer in [lo, hi], inclusive (either order, as GetRandomValue).
+static inline int RngInt(Rng *r, int lo, int hi) {
+    if (lo > hi) { int t = lo; lo = hi; hi = t; }
+    uint32_t range = (uint32_t)((int64_t)hi - lo) + 1u;
+    if (range == 0) return (int)RngNext(r);   // full 32-bit span
+    return lo + (int)(((uint64_t)RngNext(r) * range) >> 32);
+}
+
+static inline Vector2 RngOnUnitCircle(Rng *r) {
+    float a = RngFloat(r, 0.0f, TAU);
+    return (Vector2){ cosf(a), sinf(a) };
+}
+
+// Same construction as RandOnUnitSphere.
+static inline Vector3 RngOnUnitSphere(Rng *r) {
+    float z = RngFloat(r, -1.0f, 1.0f);
+    float t = RngFloat(r, 0.0f, TAU);
+    float rr = sqrtf(1.0f - z * z);
+    return (Vector3){ rr * cosf(t), z, rr * sinf(t) };
+}
+
+static inline Vector3 RngInUnitSphere(Rng *r) {
+    Vector3 p = RngOnUnitSphere(r);
+    float k = cbrtf(RngFloat01(r));
+    return (Vector3){ p.x * k, p.y * k, p.z * k };
+}
+
+// n uniform floats in [a, b).
+static inline void RngFillFloats(Rng *r, float *out, int n, float a, float b) {
+    for (int i = 0; i < n; i++) out[i] = RngFloat(r, a, b);
+}
+
+// --- Batch sampling ---
+// RNG_LANES independent xoshiro128+ generators held lane-wise, so one step
+// advances every lane with a handful of vector ops. The + scrambler's weak
+// low bits are discarded by the float conversion. Lane i is RngStream(seed,
+// id) jumped i times, so lanes never overlap each other or other streams.
+// Output order differs from a scalar Rng on the same stream.
+//
+// Usage:  RngWide w = RngWideStream(seed, RNG_STREAM_FX);
+//         RngWideFillFloats(&w, sizes, count, 0.1f, 0.3f);
+#if defined(__AVX__)
+#define RNG_LANES 8
+#else
+#define RNG_LANES 4
+#endif
+
+typedef struct { uint32_t s[4][RNG_LANES]; } RngWide;
+
+static inline RngWide RngWideStream(uint64_t seed, uint32_t id) {
+    RngWide w;
+    Rng r = RngStream(seed, id);
+    for (int lane = 0; lane < RNG_LANES; lane++) {
+        for (int k = 0; k < 4; k++) w.s[k][lane] = r.s[k];
+        RngJump(&r);
+    }
+    return w;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+typedef uint32_t RngU32xL __attribute__((vector_size(RNG_LANES * 4)));
+typedef int32_t  RngI32xL __attribute__((vector_size(RNG_LANES * 4)));
+typedef float    RngF32xL __attribute__((vector_size(RNG_LANES * 4)));
+
+// One step of every lane: RNG_LANES floats in [0, 1).
+static inline RngF32xL RngWideNext01_(RngU32xL s[4]) {
+    RngU32xL result = s[0] + s[3];
+    RngU32xL t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 11) | (s[3] >> 21);
+    return __builtin_convertvector((RngI32xL)(result >> 8), RngF32xL) * (1.0f / 16777216.0f);
+}
+
+static inline void RngWideFillFloats(RngWide *w, float *out, int n, float a, float b) {
+    RngU32xL s[4];
+    memcpy(s, w->s, sizeof(s));
+    float span = b - a;
+    int i = 0;
+    for (; i + RNG_LANES <= n; i += RNG_LANES) {
+        RngF32xL f = RngWideNext01_(s) * span + a;
+        memcpy(out + i, &f, sizeof(f));
+    }
+    if (i < n) {
+        RngF32xL f = RngWideNext01_(s) * span + a;
+        memcpy(out + i, &f, sizeof(float) * (size_t)(n - i));
+    }
+    memcpy(w->s, s, sizeof(s));
+}
+#else
+static inline void RngWideFillFloats(RngWide *w, float *out, int n, float a, float b) {
+    float span = b - a;
+    for (int i = 0; i < n; i += RNG_LANES) {
+        for (int lane = 0; lane < RNG_LANES; lane++) {
+            uint32_t *s0 = &w->s[0][lane], *s1 = &w->s[1][lane], *s2 = &w->s[2][lane], *s3 = &w->s[3][lane];
+            uint32_t result = *s0 + *s3;
+            uint32_t t = *s1 << 9;
+            *s2 ^= *s0; *s3 ^= *s1; *s1 ^= *s2; *s0 ^= *s3; *s2 ^= t;
+            *s3 = RngRotl_(*s3, 11);
+            if (i + lane < n) out[i + lane] = a + (float)(result >> 8) * (1.0f / 16777216.0f) * span;
+        }
+    }
+}
+#endif
+
 #endif // UTIL_MATH_H
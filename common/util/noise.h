@@ -0,0 +1,370 @@
+// noise.h — polynomial sin/cos, value/gradient noise, wave-sum heightfields
+// evaluated per point, per grid row, or per batch, with analytic derivatives.
+// Pure logic (no window needed).
+#ifndef UTIL_NOISE_H
+#define UTIL_NOISE_H
+
+#include "raylib.h"
+#include "raymath.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// --- Polynomial sin/cos ---
+// Reduce by the nearest multiple of π (three-part split, so arguments that
+// grow with time stay accurate), then Taylor polynomials on [-π/2, π/2].
+// Error is within a few float ulps for |x| up to ~1e5; the batch paths below
+// run the same arithmetic lane-wise, so a row and a point sample agree.
+#define NOISE_INV_PI 0.318309886183790671f
+#define NOISE_PI_A   3.140625f
+#define NOISE_PI_B   9.67502593994140625e-4f
+#define NOISE_PI_C   1.509957990978376432e-7f
+
+static inline void NoiseSinCos(float x, float *s, float *c) {
+    int q = (int)(x * NOISE_INV_PI + (x >= 0.0f ? 0.5f : -0.5f));
+    float qf = (float)q;
+    float r = ((x - qf * NOISE_PI_A) - qf * NOISE_PI_B) - qf * NOISE_PI_C;
+    float r2 = r * r;
+    float sp = r + r * r2 * (-1.0f / 6.0f + r2 * (1.0f / 120.0f + r2 * (-1.0f / 5040.0f
+             + r2 * (1.0f / 362880.0f + r2 * (-1.0f / 39916800.0f)))));
+    float cp = 1.0f + r2 * (-0.5f + r2 * (1.0f / 24.0f + r2 * (-1.0f / 720.0f
+             + r2 * (1.0f / 40320.0f + r2 * (-1.0f / 3628800.0f + r2 * (1.0f / 479001600.0f))))));
+    if (q & 1) { sp = -sp; cp = -cp; }
+    *s = sp;
+    *c = cp;
+}
+
+static inline float NoiseSin(float x) { float s, c; NoiseSinCos(x, &s, &c); return s; }
+static inline float NoiseCos(float x) { float s, c; NoiseSinCos(x, &s, &c); return c; }
+
+// --- Lattice noise ---
+// Hash-based (no permutation table), so any seed is free and the same code
+// vectorizes. Quintic fade keeps the second derivative continuous; ddx/ddz
+// receive the analytic gradient and may be NULL.
+static inline uint32_t NoiseHash2(int32_t ix, int32_t iz, uint32_t seed) {
+    uint32_t h = ((uint32_t)ix * 0x8DA6B343u) ^ ((uint32_t)iz * 0xD8163841u) ^ (seed * 0xCB1AB31Fu);
+    h ^= h >> 15; h *= 0x2C1B3C6Du;
+    h ^= h >> 12; h *= 0x297A2D39u;
+    h ^= h >> 15;
+    return h;
+}
+
+static inline float NoiseFade_(float t)  { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+static inline float NoiseFadeD_(float t) { return 30.0f * t * t * (t * (t - 2.0f) + 1.0f); }
+
+// Lattice value in [-1, 1]; gradient components in [-1, 1].
+static inline float NoiseLatticeValue_(uint32_t h) { return (float)(int32_t)(h >> 8) * (2.0f / 16777215.0f) - 1.0f; }
+static inline void NoiseLatticeGrad_(uint32_t h, float *gx, float *gz) {
+    *gx = (float)(int32_t)(h & 0xFFFFu) * (2.0f / 65535.0f) - 1.0f;
+    *gz = (float)(int32_t)(h >> 16) * (2.0f / 65535.0f) - 1.0f;
+}
+
+// Smoothly interpolated random values; range [-1, 1].
+static inline float NoiseValue2D(float x, float z, uint32_t seed, float *ddx, float *ddz) {
+    float x0 = floorf(x), z0 = floorf(z);
+    int32_t ix = (int32_t)x0, iz = (int32_t)z0;
+    float fx = x - x0, fz = z - z0;
+    float a = NoiseLatticeValue_(NoiseHash2(ix, iz, seed));
+    float b = NoiseLatticeValue_(NoiseHash2(ix + 1, iz, seed));
+    float c = NoiseLatticeValue_(NoiseHash2(ix, iz + 1, seed));
+    float d = NoiseLatticeValue_(NoiseHash2(ix + 1, iz + 1, seed));
+    float u = NoiseFade_(fx), v = NoiseFade_(fz), k = a - b - c + d;
+    if (ddx) *ddx = NoiseFadeD_(fx) * ((b - a) + v * k);
+    if (ddz) *ddz = NoiseFadeD_(fz) * ((c - a) + u * k);
+    return a + u * (b - a) + v * (c - a) + u * v * k;
+}
+
+// Perlin-style gradient noise: zero on lattice points, roughly [-1, 1].
+static inline float NoiseGradient2D(float x, float z, uint32_t seed, float *ddx, float *ddz) {
+    float x0 = floorf(x), z0 = floorf(z);
+    int32_t ix = (int32_t)x0, iz = (int32_t)z0;
+    float fx = x - x0, fz = z - z0;
+    float g00x, g00z, g10x, g10z, g01x, g01z, g11x, g11z;
+    NoiseLatticeGrad_(NoiseHash2(ix, iz, seed), &g00x, &g00z);
+    NoiseLatticeGrad_(NoiseHash2(ix + 1, iz, seed), &g10x, &g10z);
+    NoiseLatticeGrad_(NoiseHash2(ix, iz + 1, seed), &g01x, &g01z);
+    NoiseLatticeGrad_(NoiseHash2(ix + 1, iz + 1, seed), &g11x, &g11z);
+    float a = g00x * fx + g00z * fz;
+    float b = g10x * (fx - 1.0f) + g10z * fz;
+    float c = g01x * fx + g01z * (fz - 1.0f);
+    float d = g11x * (fx - 1.0f) + g11z * (fz - 1.0f);
+    float u = NoiseFade_(fx), v = NoiseFade_(fz), k = a - b - c + d;
+    if (ddx) *ddx = g00x + u * (g10x - g00x) + v * (g01x - g00x) + u * v * (g00x - g10x - g01x + g11x)
+                  + NoiseFadeD_(fx) * ((b - a) + v * k);
+    if (ddz) *ddz = g00z + u * (g10z - g00z) + v * (g01z - g00z) + u * v * (g00z - g10z - g01z + g11z)
+                  + NoiseFadeD_(fz) * ((c - a) + u * k);
+    return a + u * (b - a) + v * (c - a) + u * v * k;
+}
+
+// Fractal sum of gradient noise: each octave doubles frequency and halves
+// amplitude, seeded seed, seed+1, ...
+static inline float NoiseFbm2D(float x, float z, uint32_t seed, int octaves, float *ddx, float *ddz) {
+    float sum = 0.0f, amp = 1.0f, freq = 1.0f, gx = 0.0f, gz = 0.0f;
+    for (int o = 0; o < octaves; o++) {
+        float nx, nz;
+        sum += amp * NoiseGradient2D(x * freq, z * freq, seed + (uint32_t)o, &nx, &nz);
+        gx += amp * freq * nx;
+        gz += amp * freq * nz;
+        amp *= 0.5f;
+        freq *= 2.0f;
+    }
+    if (ddx) *ddx = gx;
+    if (ddz) *ddz = gz;
+    return sum;
+}
+
+// --- Heightfields ---
+// h(x, z) = base + slopeX*x + slopeZ*z
+//         + Σ amp * sin(kx*x + kz*z + omega*time + phase)
+//         + noiseAmp * NoiseFbm2D(x*noiseFreq, z*noiseFreq)
+// optionally clamped from below. A cos term is a sin with phase PI/2.
+// Gradients are exact (zero where the floor clamp is active), so normals
+// need no extra samples.
+//
+// Usage:  static const Heightfield hills = {
+//             .waves = { { .kx = 0.02f, .amp = 8.0f }, { .kz = 0.015f, .phase = PI/2, .amp = 6.0f } },
+//             .waveCount = 2, .clampFloor = true,
+//         };
+//         float h = HeightfieldSample(&hills, x, z);
+//         HeightfieldRow(&hills, x0, step, z, n, row);     // n heights at x0 + i*step
+#define HEIGHTFIELD_MAX_WAVES 8
+
+typedef struct {
+    float kx, kz;     // spatial frequency (radians per unit)
+    float omega;      // radians per second of Heightfield.time
+    float phase;
+    float amp;
+} HeightWave;
+
+typedef struct {
+    HeightWave waves[HEIGHTFIELD_MAX_WAVES];
+    int waveCount;
+    float base, slopeX, slopeZ;
+    float noiseAmp, noiseFreq;    // fBm layer, off while noiseAmp or noiseOctaves is 0
+    int noiseOctaves;
+    uint32_t noiseSeed;
+    bool clampFloor;              // h = max(h, floorY)
+    float floorY;
+    float time;                   // animates waves with omega != 0
+} Heightfield;
+
+// ddx/ddz may be NULL.
+static inline float HeightfieldSampleD(const Heightfield *hf, float x, float z, float *ddx, float *ddz) {
+    float h = hf->base + x * hf->slopeX + z * hf->slopeZ;
+    float gx = hf->slopeX, gz = hf->slopeZ;
+    for (int i = 0; i < hf->waveCount; i++) {
+        const HeightWave *w = &hf->waves[i];
+        float s, c;
+        NoiseSinCos(x * w->kx + z * w->kz + (w->omega * hf->time + w->phase), &s, &c);
+        h += s * w->amp;
+        gx += c * (w->amp * w->kx);
+        gz += c * (w->amp * w->kz);
+    }
+    if (hf->noiseAmp != 0.0f && hf->noiseOctaves > 0) {
+        float nx, nz;
+        float n = NoiseFbm2D(x * hf->noiseFreq, z * hf->noiseFreq, hf->noiseSeed, hf->noiseOctaves, &nx, &nz);
+        h += n * hf->noiseAmp;
+        gx += nx * (hf->noiseAmp * hf->noiseFreq);
+        gz += nz * (hf->noiseAmp * hf->noiseFreq);
+    }
+    if (hf->clampFloor && h < hf->floorY) { h = hf->floorY; gx = 0.0f; gz = 0.0f; }
+    if (ddx) *ddx = gx;
+    if (ddz) *ddz = gz;
+    return h;
+}
+
+static inline float HeightfieldSample(const Heightfield *hf, float x, float z) {
+    return HeightfieldSampleD(hf, x, z, NULL, NULL);
+}
+
+// Upward unit normal from the analytic gradient.
+static inline Vector3 HeightfieldNormal(const Heightfield *hf, float x, float z) {
+    float gx, gz;
+    HeightfieldSampleD(hf, x, z, &gx, &gz);
+    return Vector3Normalize((Vector3){ -gx, 1.0f, -gz });
+}
+
+// --- Batch evaluation ---
+// NOISE_LANES points per step through GCC/Clang vector extensions (8 lanes
+// under AVX, else 4); other compilers loop over HeightfieldSampleD.
+#if defined(__AVX__)
+#define NOISE_LANES 8
+#else
+#define NOISE_LANES 4
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+typedef float    NoiseF32xL __attribute__((vector_size(NOISE_LANES * 4)));
+typedef int32_t  NoiseI32xL __attribute__((vector_size(NOISE_LANES * 4)));
+typedef uint32_t NoiseU32xL __attribute__((vector_size(NOISE_LANES * 4)));
+
+static inline void NoiseSinCosLanes_(NoiseF32xL x, NoiseF32xL *s, NoiseF32xL *c) {
+    NoiseU32xL half = ((NoiseU32xL)x & 0x80000000u) | 0x3F000000u;   // ±0.5 with x's sign
+    NoiseI32xL q = __builtin_convertvector(x * NOISE_INV_PI + (NoiseF32xL)half, NoiseI32xL);
+    NoiseF32xL qf = __builtin_convertvector(q, NoiseF32xL);
+    NoiseF32xL r = ((x - qf * NOISE_PI_A) - qf * NOISE_PI_B) - qf * NOISE_PI_C;
+    NoiseF32xL r2 = r * r;
+    NoiseF32xL sp = r + r * r2 * (-1.0f / 6.0f + r2 * (1.0f / 120.0f + r2 * (-1.0f / 5040.0f
+                  + r2 * (1.0f / 362880.0f + r2 * (-1.0f / 39916800.0f)))));
+    NoiseF32xL cp = 1.0f + r2 * (-0.5f + r2 * (1.0f / 24.0f + r2 * (-1.0f / 720.0f
+                  + r2 * (1.0f / 40320.0f + r2 * (-1.0f / 3628800.0f + r2 * (1.0f / 479001600.0f))))));
+    NoiseU32xL flip = (NoiseU32xL)(q << 31);
+    *s = (NoiseF32xL)((NoiseU32xL)sp ^ flip);
+    *c = (NoiseF32xL)((NoiseU32xL)cp ^ flip);
+}
+
+static inline NoiseU32xL NoiseHash2Lanes_(NoiseI32xL ix, NoiseI32xL iz, uint32_t seed) {
+    NoiseU32xL h = ((NoiseU32xL)ix * 0x8DA6B343u) ^ ((NoiseU32xL)iz * 0xD8163841u) ^ (seed * 0xCB1AB31Fu);
+    h ^= h >> 15; h *= 0x2C1B3C6Du;
+    h ^= h >> 12; h *= 0x297A2D39u;
+    h ^= h >> 15;
+    return h;
+}
+
+static inline void NoiseLatticeGradLanes_(NoiseU32xL h, NoiseF32xL *gx, NoiseF32xL *gz) {
+    *gx = __builtin_convertvector((NoiseI32xL)(h & 0xFFFFu), NoiseF32xL) * (2.0f / 65535.0f) - 1.0f;
+    *gz = __builtin_convertvector((NoiseI32xL)(h >> 16), NoiseF32xL) * (2.0f / 65535.0f) - 1.0f;
+}
+
+static inline NoiseF32xL NoiseGradient2DLanes_(NoiseF32xL x, NoiseF32xL z, uint32_t seed,
+                                               NoiseF32xL *ddx, NoiseF32xL *ddz) {
+    // Truncation rounds toward zero; step negative non-integers down to floor.
+    NoiseI32xL ix = __builtin_convertvector(x, NoiseI32xL);
+    NoiseI32xL iz = __builtin_convertvector(z, NoiseI32xL);
+    ix += (NoiseI32xL)(__builtin_convertvector(ix, NoiseF32xL) > x);
+    iz += (NoiseI32xL)(__builtin_convertvector(iz, NoiseF32xL) > z);
+    NoiseF32xL fx = x - __builtin_convertvector(ix, NoiseF32xL);
+    NoiseF32xL fz = z - __builtin_convertvector(iz, NoiseF32xL);
+    NoiseF32xL g00x, g00z, g10x, g10z, g01x, g01z, g11x, g11z;
+    NoiseLatticeGradLanes_(NoiseHash2Lanes_(ix, iz, seed), &g00x, &g00z);
+    NoiseLatticeGradLanes_(NoiseHash2Lanes_(ix + 1, iz, seed), &g10x, &g10z);
+    NoiseLatticeGradLanes_(NoiseHash2Lanes_(ix, iz + 1, seed), &g01x, &g01z);
+    NoiseLatticeGradLanes_(NoiseHash2Lanes_(ix + 1, iz + 1, seed), &g11x, &g11z);
+    NoiseF32xL a = g00x * fx + g00z * fz;
+    NoiseF32xL b = g10x * (fx - 1.0f) + g10z * fz;
+    NoiseF32xL c = g01x * fx + g01z * (fz - 1.0f);
+    NoiseF32xL d = g11x * (fx - 1.0f) + g11z * (fz - 1.0f);
+    NoiseF32xL u = fx * fx * fx * (fx * (fx * 6.0f - 15.0f) + 10.0f);
+    NoiseF32xL v = fz * fz * fz * (fz * (fz * 6.0f - 15.0f) + 10.0f);
+    NoiseF32xL du = 30.0f * fx * fx * (fx * (fx - 2.0f) + 1.0f);
+    NoiseF32xL dv = 30.0f * fz * fz * (fz * (fz - 2.0f) + 1.0f);
+    NoiseF32xL k = a - b - c + d;
+    *ddx = g00x + u * (g10x - g00x) + v * (g01x - g00x) + u * v * (g00x - g10x - g01x + g11x)
+         + du * ((b - a) + v * k);
+    *ddz = g00z + u * (g10z - g00z) + v * (g01z - g00z) + u * v * (g00z - g10z - g01z + g11z)
+         + dv * ((c - a) + u * k);
+    return a + u * (b - a) + v * (c - a) + u * v * k;
+}
+
+static inline void HeightfieldLanes_(const Heightfield *hf, NoiseF32xL x, NoiseF32xL z,
+                                     NoiseF32xL *hOut, NoiseF32xL *dxOut, NoiseF32xL *dzOut) {
+    NoiseF32xL h = hf->base + x * hf->slopeX + z * hf->slopeZ;
+    NoiseF32xL gx = (NoiseF32xL){0} + hf->slopeX, gz = (NoiseF32xL){0} + hf->slopeZ;
+    for (int i = 0; i < hf->waveCount; i++) {
+        const HeightWave *w = &hf->waves[i];
+        NoiseF32xL s, c;
+        NoiseSinCosLanes_(x * w->kx + z * w->kz + (w->omega * hf->time + w->phase), &s, &c);
+        h += s * w->amp;
+        gx += c * (w->amp * w->kx);
+        gz += c * (w->amp * w->kz);
+    }
+    if (hf->noiseAmp != 0.0f && hf->noiseOctaves > 0) {
+        float amp = 1.0f, freq = 1.0f;
+        for (int o = 0; o < hf->noiseOctaves; o++) {
+            NoiseF32xL nx, nz;
+            NoiseF32xL n = NoiseGradient2DLanes_(x * (hf->noiseFreq * freq), z * (hf->noiseFreq * freq),
+                                                 hf->noiseSeed + (uint32_t)o, &nx, &nz);
+            h += n * (amp * hf->noiseAmp);
+            gx += nx * (amp * freq * hf->noiseAmp * hf->noiseFreq);
+            gz += nz * (amp * freq * hf->noiseAmp * hf->noiseFreq);
+            amp *= 0.5f;
+            freq *= 2.0f;
+        }
+    }
+    if (hf->clampFloor) {
+        NoiseI32xL below = (NoiseI32xL)(h < hf->floorY);
+        NoiseF32xL floorV = (NoiseF32xL){0} + hf->floorY;
+        h  = (NoiseF32xL)(((NoiseI32xL)h & ~below) | ((NoiseI32xL)floorV & below));
+        gx = (NoiseF32xL)((NoiseI32xL)gx & ~below);
+        gz = (NoiseF32xL)((NoiseI32xL)gz & ~below);
+    }
+    *hOut = h;
+    *dxOut = gx;
+    *dzOut = gz;
+}
+
+static inline void NoiseStoreLanes_(float *dst, NoiseF32xL v, int count) {
+    if (dst) memcpy(dst, &v, sizeof(float) * (size_t)count);
+}
+
+// n samples at (x0 + i*dx, z). ddx/ddz may be NULL.
+static inline void HeightfieldRowD(const Heightfield *hf, float x0, float dx, float z, int n,
+                                   float *h, float *ddx, float *ddz) {
+    NoiseF32xL lane;
+    for (int l = 0; l < NOISE_LANES; l++) lane[l] = (float)l;
+    NoiseF32xL zv = (NoiseF32xL){0} + z;
+    for (int i = 0; i < n; i += NOISE_LANES) {
+        NoiseF32xL xv = x0 + (lane + (float)i) * dx;
+        NoiseF32xL hv, gx, gz;
+        HeightfieldLanes_(hf, xv, zv, &hv, &gx, &gz);
+        int m = (n - i < NOISE_LANES) ? n - i : NOISE_LANES;
+        NoiseStoreLanes_(h + i, hv, m);
+        NoiseStoreLanes_(ddx ? ddx + i : NULL, gx, m);
+        NoiseStoreLanes_(ddz ? ddz + i : NULL, gz, m);
+    }
+}
+
+// n scattered points. ddx/ddz may be NULL.
+static inline void HeightfieldPointsD(const Heightfield *hf, const float *xs, const float *zs, int n,
+                                      float *h, float *ddx, float *ddz) {
+    for (int i = 0; i < n; i += NOISE_LANES) {
+        int m = (n - i < NOISE_LANES) ? n - i : NOISE_LANES;
+        NoiseF32xL xv = {0}, zv = {0};
+        memcpy(&xv, xs + i, sizeof(float) * (size_t)m);
+        memcpy(&zv, zs + i, sizeof(float) * (size_t)m);
+        NoiseF32xL hv, gx, gz;
+        HeightfieldLanes_(hf, xv, zv, &hv, &gx, &gz);
+        NoiseStoreLanes_(h + i, hv, m);
+        NoiseStoreLanes_(ddx ? ddx + i : NULL, gx, m);
+        NoiseStoreLanes_(ddz ? ddz + i : NULL, gz, m);
+    }
+}
+#else
+static inline void HeightfieldRowD(const Heightfield *hf, float x0, float dx, float z, int n,
+                                   float *h, float *ddx, float *ddz) {
+    for (int i = 0; i < n; i++) {
+        float gx, gz;
+        h[i] = HeightfieldSampleD(hf, x0 + (float)i * dx, z, &gx, &gz);
+        if (ddx) ddx[i] = gx;
+        if (ddz) ddz[i] = gz;
+    }
+}
+
+static inline void HeightfieldPointsD(const Heightfield *hf, const float *xs, const float *zs, int n,
+                                      float *h, float *ddx, float *ddz) {
+    for (int i = 0; i < n; i++) {
+        float gx, gz;
+        h[i] = HeightfieldSampleD(hf, xs[i], zs[i], &gx, &gz);
+        if (ddx) ddx[i] = gx;
+        if (ddz) ddz[i] = gz;
+    }
+}
+#endif
+
+static inline void HeightfieldRow(const Heightfield *hf, float x0, float dx, float z, int n, float *h) {
+    HeightfieldRowD(hf, x0, dx, z, n, h, NULL, NULL);
+}
+
+static inline void HeightfieldPoints(const Heightfield *hf, const float *xs, const float *zs, int n, float *h) {
+    HeightfieldPointsD(hf, xs, zs, n, h, NULL, NULL);
+}
+
+// nz rows of nx samples, row-major: out[j*nx + i] = h(x0 + i*step, z0 + j*step).
+static inline void HeightfieldGrid(const Heightfield *hf, float x0, float z0, float step,
+                                   int nx, int nz, float *out) {
+    for (int j = 0; j < nz; j++)
+        HeightfieldRowD(hf, x0, step, z0 + (float)j * step, nx, out + (size_t)j * nx, NULL, NULL);
+}
+
+#endif // UTIL_NOISE_H
@@ -0,0 +1,352 @@
+// pack.h — read-only asset pack: many small files in one, mapped with one open.
+// Pure logic (no window needed).
+//
+// Text files stay the authoring format. The asset-pack tool compiles them
+// into binary blobs (record layouts live next to each loader: objects3d.h,
+// sprites2d.h) and writes one pack:
+//
+//   PackHeader                 magic "RLPK", version, entry count, TOC offset
+//   blob, blob, ...            each PACK_ALIGN-aligned, read in place
+//   PackEntry[entryCount]      sorted by path for binary search
+//
+// A game mounts the pack once at startup. LoadObject3D, LoadSprite2D,
+// LoadSpriteFrame, LoadPuppetRig and LoadPuppetAnim then look their path up
+// in it first and only fall back to the text file when it is missing.
+//
+// Usage:  PackMount("assets.pack");       // before loading; harmless if absent
+//         ... LoadSprite2D("pokemon/sprites/pikachu.spr2d", ...) ...
+//         PackUnmount();
+//
+// The file mapping (PackMapFile) and the LZ block codec (PackLZCompress) are
+// shared with other binary formats, e.g. map3d.h's .m3db maps.
+//
+// Little-endian only (every target this repo builds for).
+#ifndef UTIL_PACK_H
+#define UTIL_PACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// POSIX maps the file; elsewhere it is read whole into memory (still one open).
+#if !defined(_WIN32) && !defined(PACK_NO_MMAP)
+#define PACK_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define PACK_MMAP 0
+#endif
+
+#define PACK_MAGIC    "RLPK"
+#define PACK_VERSION  1
+#define PACK_PATH_MAX 64
+#define PACK_ALIGN    16
+
+typedef enum {
+    PACK_RAW = 0,
+    PACK_OBJ3D,      // Object3DRecord[] (objects3d.h)
+    PACK_SPR2D,      // Sprite2DBlobHeader + boxes + Sprite2DRecord[] (sprites2d.h)
+    PACK_RIG2D,      // rig with its sub-sprites inlined (sprites2d.h)
+    PACK_ANIM2D,     // keyframes with poses by part name (sprites2d.h)
+} PackEntryType;
+
+typedef struct {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t tocOffset;
+} PackHeader;
+
+typedef struct {
+    char path[PACK_PATH_MAX];   // as passed to the loaders, '/' separated
+    uint32_t type;              // PackEntryType
+    uint32_t offset;            // from the start of the file
+    uint32_t size;
+    uint32_t reserved;
+} PackEntry;
+
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    const PackEntry *toc;
+    uint32_t count;
+} Pack;
+
+// --- Reading ---
+
+// Whole file, read-only: mapped, or read into memory without PACK_MMAP.
+// NULL if it can't be opened or is shorter than minSize.
+static inline const unsigned char *PackMapFile(const char *filename, size_t minSize, size_t *size) {
+#if PACK_MMAP
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0 || (size_t)st.st_size < minSize) { close(fd); return NULL; }
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+    *size = (size_t)st.st_size;
+    return (const unsigned char *)map;
+#else
+    FILE *f = fopen(filename, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    unsigned char *buf = (len > 0 && (size_t)len >= minSize) ? (unsigned char *)malloc((size_t)len) : NULL;
+    if (!buf || fread(buf, 1, (size_t)len, f) != (size_t)len) { free(buf); fclose(f); return NULL; }
+    fclose(f);
+    *size = (size_t)len;
+    return buf;
+#endif
+}
+
+static inline void PackUnmapFile(const unsigned char *data, size_t size) {
+    if (!data) return;
+#if PACK_MMAP
+    munmap((void *)data, size);
+#else
+    (void)size;
+    free((void *)data);
+#endif
+}
+
+static inline void PackClose(Pack *p) {
+    PackUnmapFile(p->data, p->size);
+    *p = (Pack){ 0 };
+}
+
+// Map a pack and check its header and table. false (p zeroed) on any error.
+static inline bool PackOpen(Pack *p, const char *filename) {
+    *p = (Pack){ 0 };
+    p->data = PackMapFile(filename, sizeof(PackHeader), &p->size);
+    if (!p->data) return false;
+    const PackHeader *h = (const PackHeader *)p->data;
+    bool ok = memcmp(h->magic, PACK_MAGIC, 4) == 0 && h->version == PACK_VERSION
+           && h->tocOffset % 4 == 0 && h->tocOffset <= p->size
+           && (p->size - h->tocOffset) / sizeof(PackEntry) >= h->entryCount;
+    if (ok) {
+        p->toc = (const PackEntry *)(p->data + h->tocOffset);
+        p->count = h->entryCount;
+        for (uint32_t i = 0; i < p->count && ok; i++)
+            ok = p->toc[i].offset <= p->size && p->toc[i].size <= p->size - p->toc[i].offset
+              && memchr(p->toc[i].path, 0, PACK_PATH_MAX) != NULL;
+    }
+    if (!ok) PackClose(p);
+    return ok;
+}
+
+// Binary search the table. Returns the blob in place, or NULL if the path is
+// absent or stored as another type.
+static inline const void *PackFind(const Pack *p, const char *path, PackEntryType type, uint32_t *size) {
+    if (!p->data || !path) return NULL;
+    if (path[0] == '.' && path[1] == '/') path += 2;
+    uint32_t lo = 0, hi = p->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int c = strncmp(path, p->toc[mid].path, PACK_PATH_MAX);
+        if (c == 0) {
+            if (p->toc[mid].type != (uint32_t)type) return NULL;
+            if (size) *size = p->toc[mid].size;
+            return p->data + p->toc[mid].offset;
+        }
+        if (c < 0) hi = mid; else lo = mid + 1;
+    }
+    return NULL;
+}
+
+// --- Mounted pack ---
+// The one the asset loaders consult.
+static Pack packMounted;
+
+static inline bool PackMount(const char *filename) {
+    PackClose(&packMounted);
+    return PackOpen(&packMounted, filename);
+}
+
+static inline void PackUnmount(void) { PackClose(&packMounted); }
+
+static inline const void *PackLookup(const char *path, PackEntryType type, uint32_t *size) {
+    return PackFind(&packMounted, path, type, size);
+}
+
+// --- Writing ---
+// Growable byte buffer for the blob encoders.
+typedef struct {
+    unsigned char *data;
+    size_t size, cap;
+} PackBuffer;
+
+static inline bool PackBufferPut(PackBuffer *b, const void *src, size_t n) {
+    if (b->size + n > b->cap) {
+        size_t cap = b->cap ? b->cap : 256;
+        while (cap < b->size + n) cap *= 2;
+        unsigned char *grown = (unsigned char *)realloc(b->data, cap);
+        if (!grown) return false;
+        b->data = grown;
+        b->cap = cap;
+    }
+    if (n) memcpy(b->data + b->size, src, n);
+    b->size += n;
+    return true;
+}
+
+static inline void PackBufferFree(PackBuffer *b) {
+    free(b->data);
+    *b = (PackBuffer){ 0 };
+}
+
+typedef struct {
+    PackEntry *entries;
+    int count, cap;
+    PackBuffer blobs;   // laid out as in the file, starting after the header
+} PackBuilder;
+
+static inline void PackBuilderFree(PackBuilder *b) {
+    free(b->entries);
+    PackBufferFree(&b->blobs);
+    *b = (PackBuilder){ 0 };
+}
+
+// Copy a blob in under path. false if the path is too long or already added.
+static inline bool PackBuilderAdd(PackBuilder *b, const char *path, PackEntryType type,
+                                  const void *data, size_t size) {
+    if (path[0] == '.' && path[1] == '/') path += 2;
+    if (strlen(path) >= PACK_PATH_MAX) return false;
+    for (int i = 0; i < b->count; i++)
+        if (strcmp(b->entries[i].path, path) == 0) return false;
+    if (b->count == b->cap) {
+        int cap = b->cap ? b->cap * 2 : 64;
+        PackEntry *grown = (PackEntry *)realloc(b->entries, (size_t)cap * sizeof(PackEntry));
+        if (!grown) return false;
+        b->entries = grown;
+        b->cap = cap;
+    }
+    static const unsigned char zeros[PACK_ALIGN] = { 0 };
+    size_t pad = (PACK_ALIGN - (sizeof(PackHeader) + b->blobs.size) % PACK_ALIGN) % PACK_ALIGN;
+    if (!PackBufferPut(&b->blobs, zeros, pad)) return false;
+    PackEntry *e = &b->entries[b->count];
+    memset(e, 0, sizeof(*e));
+    strcpy(e->path, path);
+    e->type = (uint32_t)type;
+    e->offset = (uint32_t)(sizeof(PackHeader) + b->blobs.size);
+    e->size = (uint32_t)size;
+    if (!PackBufferPut(&b->blobs, data, size)) return false;
+    b->count++;
+    return true;
+}
+
+// --- LZ block codec ---
+// LZ4's block format (token, literals, 16-bit offset, match length), for
+// blocks up to PACK_LZ_MAX_INPUT bytes. Greedy single-probe matching: fast and
+// small rather than tight, which suits runs of repeated tile or part bytes.
+#define PACK_LZ_MAX_INPUT  65535
+#define PACK_LZ_MIN_MATCH  4
+#define PACK_LZ_HASH_BITS  12
+
+// One sequence: literals, then a match (none for the last sequence).
+static inline bool PackLZEmit_(unsigned char **op, const unsigned char *end, const unsigned char *lit,
+                               int litLen, int offset, int matchLen) {
+    unsigned char *p = *op;
+    int ml = matchLen ? matchLen - PACK_LZ_MIN_MATCH : 0;
+    if (end - p < 1 + litLen + litLen / 255 + 1 + 2 + ml / 255 + 1) return false;
+    unsigned char *token = p++;
+    *token = (unsigned char)((litLen < 15 ? litLen : 15) << 4);
+    if (litLen >= 15) {
+        int r = litLen - 15;
+        for (; r >= 255; r -= 255) *p++ = 255;
+        *p++ = (unsigned char)r;
+    }
+    memcpy(p, lit, (size_t)litLen);
+    p += litLen;
+    if (matchLen) {
+        *p++ = (unsigned char)(offset & 255);
+        *p++ = (unsigned char)(offset >> 8);
+        *token |= (unsigned char)(ml < 15 ? ml : 15);
+        if (ml >= 15) {
+            int r = ml - 15;
+            for (; r >= 255; r -= 255) *p++ = 255;
+            *p++ = (unsigned char)r;
+        }
+    }
+    *op = p;
+    return true;
+}
+
+// Compress n bytes into dst. Returns the compressed size, or 0 if it does not
+// fit in cap or n is out of range (store the block raw then).
+static inline int PackLZCompress(const void *srcData, int n, void *dstData, int cap) {
+    const unsigned char *src = (const unsigned char *)srcData;
+    unsigned char *dst = (unsigned char *)dstData, *op = dst, *end = dst + cap;
+    if (n <= 0 || n > PACK_LZ_MAX_INPUT) return 0;
+    uint16_t table[1 << PACK_LZ_HASH_BITS] = { 0 };   // last position + 1 per hash
+    int anchor = 0, i = 0;
+    while (i + PACK_LZ_MIN_MATCH <= n) {
+        uint32_t seq;
+        memcpy(&seq, src + i, 4);
+        uint32_t h = (seq * 2654435761u) >> (32 - PACK_LZ_HASH_BITS);
+        int cand = (int)table[h] - 1;
+        table[h] = (uint16_t)(i + 1);
+        if (cand < 0 || memcmp(src + cand, src + i, 4) != 0) { i++; continue; }
+        int len = PACK_LZ_MIN_MATCH;
+        while (i + len < n && src[cand + len] == src[i + len]) len++;   // may overlap: runs
+        if (!PackLZEmit_(&op, end, src + anchor, i - anchor, i - cand, len)) return 0;
+        i += len;
+        anchor = i;
+    }
+    if (!PackLZEmit_(&op, end, src + anchor, n - anchor, 0, 0)) return 0;
+    return (int)(op - dst);
+}
+
+// Decompress n bytes into dst. Returns the bytes written, or -1 if the block
+// is malformed or would overrun cap.
+static inline int PackLZDecompress(const void *srcData, int n, void *dstData, int cap) {
+    const unsigned char *ip = (const unsigned char *)srcData, *iend = ip + n;
+    unsigned char *dst = (unsigned char *)dstData, *op = dst, *oend = dst + cap;
+    while (ip < iend) {
+        int token = *ip++;
+        int lit = token >> 4, b;
+        if (lit == 15) do { if (ip == iend) return -1; b = *ip++; lit += b; } while (b == 255);
+        if (lit > iend - ip || lit > oend - op) return -1;
+        memcpy(op, ip, (size_t)lit);
+        op += lit;
+        ip += lit;
+        if (ip == iend) break;   // the last sequence has no match
+        if (iend - ip < 2) return -1;
+        int offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        int ml = token & 15;
+        if (ml == 15) do { if (ip == iend) return -1; b = *ip++; ml += b; } while (b == 255);
+        ml += PACK_LZ_MIN_MATCH;
+        if (offset == 0 || offset > op - dst || ml > oend - op) return -1;
+        for (int k = 0; k < ml; k++) op[k] = op[k - offset];   // byte by byte: overlapping runs
+        op += ml;
+    }
+    return (int)(op - dst);
+}
+
+static inline int PackEntryCompare_(const void *a, const void *b) {
+    return strncmp(((const PackEntry *)a)->path, ((const PackEntry *)b)->path, PACK_PATH_MAX);
+}
+
+static inline bool PackBuilderSave(PackBuilder *b, const char *filename) {
+    qsort(b->entries, (size_t)b->count, sizeof(PackEntry), PackEntryCompare_);
+    size_t tocOffset = sizeof(PackHeader) + b->blobs.size;
+    size_t pad = (PACK_ALIGN - tocOffset % PACK_ALIGN) % PACK_ALIGN;
+    PackHeader h = { { 'R', 'L', 'P', 'K' }, PACK_VERSION, (uint32_t)b->count, (uint32_t)(tocOffset + pad) };
+    static const unsigned char zeros[PACK_ALIGN] = { 0 };
+    FILE *f = fopen(filename, "wb");
+    if (!f) return false;
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1
+           && fwrite(b->blobs.data, 1, b->blobs.size, f) == b->blobs.size
+           && fwrite(zeros, 1, pad, f) == pad
+           && fwrite(b->entries, sizeof(PackEntry), (size_t)b->count, f) == (size_t)b->count;
+    return (fclose(f) == 0) && ok;
+}
+
+#endif // UTIL_PACK_H
@@ -1,9 +1,11 @@
-// pool.h — entity-pool helpers built on a `.active` bool convention.
+// pool.h — entity-pool helpers built on a `.active` bool convention, plus a
+// HandlePool with O(1) spawn/free and generational handles.
 // Caller owns the storage; macros iterate / spawn / count.
 #ifndef UTIL_POOL_H
 #define UTIL_POOL_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 // Find first inactive slot in (arr, N), mark active=true, return its index.
 // Returns -1 if pool is full. GNU statement expression (supported by Zig cc / Clang / GCC).
@@ -47,4 +49,160 @@
     _c_; \
 })
 
+// ---- Handle pool -----------------------------------------------------------
+// O(1) spawn and free via an intrusive free list, O(1) count, and iteration
+// that skips dead slots 64 at a time by walking a live bitset with
+// count-trailing-zeros. The entity array itself stays caller-owned and
+// indexed exactly as before; the pool only tracks which indices are in use.
+//
+// A PoolHandle packs (generation << 20 | index). Freeing a slot bumps its
+// generation, so a handle kept past its entity's death (e.g. an rts
+// `targetUnit`) resolves to -1 instead of silently aliasing whatever was
+// respawned into the same slot. Handle 0 is never issued: use
+// POOL_HANDLE_NONE as the "no entity" value.
+//
+// Usage:  static uint32_t bulletSlots[MAX_BULLETS];
+//         static uint64_t bulletLive[POOL_BITSET_WORDS(MAX_BULLETS)];
+//         static HandlePool bulletPool;
+//         HandlePoolInit(&bulletPool, bulletSlots, bulletLive, MAX_BULLETS);
+//         PoolHandle h = HandlePoolSpawn(&bulletPool);
+//         if (h) { bullets[PoolHandleIndex(h)].pos = ...; }
+//         HANDLE_POOL_FOREACH(&bulletPool, i) { bullets[i].pos = ...; }
+
+typedef uint32_t PoolHandle;
+
+#define POOL_INDEX_BITS      20
+#define POOL_INDEX_MASK      ((1u << POOL_INDEX_BITS) - 1u)
+#define POOL_GEN_MASK        (0xFFFu)             // 12-bit generation, never 0
+#define POOL_NIL             POOL_INDEX_MASK      // free-list terminator
+#define POOL_MAX_CAPACITY    ((int)POOL_INDEX_MASK)
+#define POOL_HANDLE_NONE     ((PoolHandle)0)
+#define POOL_BITSET_WORDS(N) (((N) + 63) / 64)
+
+#if defined(__GNUC__) || defined(__clang__)
+#define POOL_CTZ64(x) __builtin_ctzll(x)
+#else
+static inline int POOL_CTZ64(uint64_t x) {
+    int n = 0;
+    while (!(x & 1u)) { x >>= 1; n++; }
+    return n;
+}
+#endif
+
+typedef struct {
+    uint32_t *slots;    // per slot: generation << POOL_INDEX_BITS | next free index
+    uint64_t *live;     // bit i set while slot i is spawned
+    int capacity;       // <= POOL_MAX_CAPACITY
+    int count;          // live slots
+    uint32_t freeHead;  // first free index, POOL_NIL when full
+} HandlePool;
+
+static inline int PoolHandleIndex(PoolHandle h) { return (int)(h & POOL_INDEX_MASK); }
+static inline uint32_t PoolHandleGen(PoolHandle h) { return h >> POOL_INDEX_BITS; }
+
+// Mark every slot free. Free-list order is 0, 1, 2, ... so a fresh pool hands
+// out indices in the same order POOL_SPAWN would. Generations survive a reset,
+// so handles issued before it stay stale.
+static inline void HandlePoolReset(HandlePool *p) {
+    for (int i = 0; i < p->capacity; i++) {
+        uint32_t gen = p->slots[i] >> POOL_INDEX_BITS;
+        if (gen == 0) gen = 1;
+        uint32_t next = (i + 1 < p->capacity) ? (uint32_t)(i + 1) : POOL_NIL;
+        p->slots[i] = (gen << POOL_INDEX_BITS) | next;
+    }
+    for (int w = 0; w < POOL_BITSET_WORDS(p->capacity); w++) p->live[w] = 0;
+    p->count = 0;
+    p->freeHead = (p->capacity > 0) ? 0u : POOL_NIL;
+}
+
+// `slots` needs `capacity` entries, `live` needs POOL_BITSET_WORDS(capacity).
+static inline void HandlePoolInit(HandlePool *p, uint32_t *slots, uint64_t *live, int capacity) {
+    if (capacity > POOL_MAX_CAPACITY) capacity = POOL_MAX_CAPACITY;
+    p->slots = slots;
+    p->live = live;
+    p->capacity = capacity;
+    for (int i = 0; i < capacity; i++) slots[i] = 0;
+    HandlePoolReset(p);
+}
+
+// Pop the free-list head. Returns POOL_HANDLE_NONE when the pool is full.
+static inline PoolHandle HandlePoolSpawn(HandlePool *p) {
+    uint32_t i = p->freeHead;
+    if (i == POOL_NIL) return POOL_HANDLE_NONE;
+    uint32_t s = p->slots[i];
+    p->freeHead = s & POOL_INDEX_MASK;
+    p->live[i >> 6] |= (uint64_t)1 << (i & 63);
+    p->count++;
+    return (s & ~POOL_INDEX_MASK) | i;
+}
+
+static inline bool HandlePoolActive(const HandlePool *p, int i) {
+    if (i < 0 || i >= p->capacity) return false;
+    return (p->live[i >> 6] >> (i & 63)) & 1u;
+}
+
+// Current handle for a live index, or POOL_HANDLE_NONE if the slot is free.
+static inline PoolHandle HandlePoolHandleOf(const HandlePool *p, int i) {
+    if (!HandlePoolActive(p, i)) return POOL_HANDLE_NONE;
+    return (p->slots[i] & ~POOL_INDEX_MASK) | (uint32_t)i;
+}
+
+// Index the handle refers to, or -1 if it is NONE, out of range or stale.
+static inline int HandlePoolResolve(const HandlePool *p, PoolHandle h) {
+    int i = PoolHandleIndex(h);
+    if (h == POOL_HANDLE_NONE || !HandlePoolActive(p, i)) return -1;
+    if ((p->slots[i] >> POOL_INDEX_BITS) != PoolHandleGen(h)) return -1;
+    return i;
+}
+
+static inline bool HandlePoolValid(const HandlePool *p, PoolHandle h) {
+    return HandlePoolResolve(p, h) >= 0;
+}
+
+// Free by index. Bumps the slot's generation (skipping 0) and pushes it on
+// the free list. Freeing an already-free slot is a no-op.
+static inline void HandlePoolFreeIndex(HandlePool *p, int i) {
+    if (!HandlePoolActive(p, i)) return;
+    uint32_t gen = ((p->slots[i] >> POOL_INDEX_BITS) + 1u) & POOL_GEN_MASK;
+    if (gen == 0) gen = 1;
+    p->slots[i] = (gen << POOL_INDEX_BITS) | p->freeHead;
+    p->freeHead = (uint32_t)i;
+    p->live[i >> 6] &= ~((uint64_t)1 << (i & 63));
+    p->count--;
+}
+
+// Free by handle. Returns false (and frees nothing) if the handle is stale.
+static inline bool HandlePoolFree(HandlePool *p, PoolHandle h) {
+    int i = HandlePoolResolve(p, h);
+    if (i < 0) return false;
+    HandlePoolFreeIndex(p, i);
+    return true;
+}
+
+static inline int HandlePoolCount(const HandlePool *p) { return p->count; }
+
+// Advance *i to the next live index after it. Start with *i = -1. Returns
+// false once no live slot remains. Reads the bitset fresh on every call, so
+// freeing the current slot (or spawning) mid-iteration is safe.
+static inline bool HandlePoolNext(const HandlePool *p, int *i) {
+    int n = *i + 1;
+    if (n >= p->capacity) return false;
+    int w = n >> 6;
+    uint64_t bits = p->live[w] & (~(uint64_t)0 << (n & 63));
+    int words = POOL_BITSET_WORDS(p->capacity);
+    while (!bits) {
+        if (++w >= words) return false;
+        bits = p->live[w];
+    }
+    *i = (w << 6) + POOL_CTZ64(bits);
+    return true;
+}
+
+// Iterate every live index. Single `for`, so `break` and `continue` behave
+// exactly as written.
+//
+// Usage:  HANDLE_POOL_FOREACH(&unitPool, i) { UpdateUnit(&units[i], i, dt); }
+#define HANDLE_POOL_FOREACH(pool, i) \
+    for (int i = -1; HandlePoolNext((pool), &i); )
+
 #endif // UTIL_POOL_H
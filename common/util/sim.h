@@ -0,0 +1,180 @@
+// sim.h — headless simulation runner: scripted input, per-system timers, tick-rate report.
+// Build a game with -DSIM_HEADLESS (zig build bench) to run its update step
+// with no window: input comes from a script, the game ticks N times, and the
+// runner prints ticks/sec plus where the time went.
+//
+// Include right after raylib.h/raymath.h and BEFORE the other util headers,
+// so input.h etc. pick up the scripted input macros below.
+#ifndef UTIL_SIM_H
+#define UTIL_SIM_H
+
+#include "raylib.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef SIM_HEADLESS
+
+// --- Scripted input ---
+// The script sets what is held this tick; pressed/released fall out of the
+// difference with the previous tick, as raylib's own edge queries do.
+#define SIM_MAX_KEYS    512
+#define SIM_MAX_BUTTONS 8
+
+typedef struct {
+    bool keys[SIM_MAX_KEYS], prevKeys[SIM_MAX_KEYS];
+    bool buttons[SIM_MAX_BUTTONS], prevButtons[SIM_MAX_BUTTONS];
+    Vector2 mouse;
+    Vector2 mouseDelta;   // cleared every tick
+    float wheel;          // cleared every tick
+} SimInput;
+
+static SimInput simInput;
+
+// Call once at the top of each tick, before the script sets this tick's state.
+static inline void SimInputNextTick(void) {
+    for (int i = 0; i < SIM_MAX_KEYS; i++)    simInput.prevKeys[i] = simInput.keys[i];
+    for (int i = 0; i < SIM_MAX_BUTTONS; i++) simInput.prevButtons[i] = simInput.buttons[i];
+    simInput.mouseDelta = (Vector2){ 0, 0 };
+    simInput.wheel = 0.0f;
+}
+
+static inline void SimSetKey(int key, bool down) {
+    if (key >= 0 && key < SIM_MAX_KEYS) simInput.keys[key] = down;
+}
+
+static inline void SimSetButton(int button, bool down) {
+    if (button >= 0 && button < SIM_MAX_BUTTONS) simInput.buttons[button] = down;
+}
+
+static inline bool SimKeyDown(int key)     { return key >= 0 && key < SIM_MAX_KEYS && simInput.keys[key]; }
+static inline bool SimKeyPressed(int key)  { return SimKeyDown(key) && !simInput.prevKeys[key]; }
+static inline bool SimKeyReleased(int key) { return key >= 0 && key < SIM_MAX_KEYS && !simInput.keys[key] && simInput.prevKeys[key]; }
+
+static inline bool SimButtonDown(int b)     { return b >= 0 && b < SIM_MAX_BUTTONS && simInput.buttons[b]; }
+static inline bool SimButtonPressed(int b)  { return SimButtonDown(b) && !simInput.prevButtons[b]; }
+static inline bool SimButtonReleased(int b) { return b >= 0 && b < SIM_MAX_BUTTONS && !simInput.buttons[b] && simInput.prevButtons[b]; }
+
+// Route the game's input queries to the script. raylib's prototypes are
+// already declared above, so these only affect the calls that follow.
+#define IsKeyDown(k)              SimKeyDown(k)
+#define IsKeyUp(k)                (!SimKeyDown(k))
+#define IsKeyPressed(k)           SimKeyPressed(k)
+#define IsKeyReleased(k)          SimKeyReleased(k)
+#define IsMouseButtonDown(b)      SimButtonDown(b)
+#define IsMouseButtonUp(b)        (!SimButtonDown(b))
+#define IsMouseButtonPressed(b)   SimButtonPressed(b)
+#define IsMouseButtonReleased(b)  SimButtonReleased(b)
+#define GetMousePosition()        (simInput.mouse)
+#define GetMouseDelta()           (simInput.mouseDelta)
+#define GetMouseWheelMove()       (simInput.wheel)
+#define IsGamepadAvailable(g)     ((void)(g), false)
+#define DisableCursor()           ((void)0)
+#define EnableCursor()            ((void)0)
+
+// --- Per-system timers ---
+// Wrap a block to charge its time to a named section:
+//     SIM_SECTION("enemies") { ...update enemies... }
+// Names are compared by pointer first, so pass string literals. Compiles to
+// nothing without SIM_HEADLESS. Do not `break` out of the wrapped block.
+#define SIM_MAX_SECTIONS 16
+
+// Monotonic wall-clock seconds. Not clock(): that is CPU time summed over all
+// threads, so a tick spread across job workers would never look any faster.
+// Under -std=c99 glibc hides clock_gettime unless _POSIX_C_SOURCE is set
+// before the first system header; zig build bench passes it.
+#if defined(_WIN32)
+// windows.h clashes with raylib's names; these two prototypes are all we need
+__declspec(dllimport) int __stdcall QueryPerformanceCounter(long long *count);
+__declspec(dllimport) int __stdcall QueryPerformanceFrequency(long long *freq);
+static inline double SimNow(void) {
+    long long count, freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    return (double)count / (double)freq;
+}
+#else
+static inline double SimNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+#endif
+
+typedef struct {
+    const char *name;
+    double total;   // seconds
+    uint64_t calls;
+} SimSection;
+
+static SimSection simSections[SIM_MAX_SECTIONS];
+static int simSectionCount = 0;
+
+static inline void SimSectionAdd(const char *name, double start) {
+    double elapsed = SimNow() - start;
+    int i = 0;
+    while (i < simSectionCount && simSections[i].name != name) i++;
+    if (i == simSectionCount) {
+        if (simSectionCount == SIM_MAX_SECTIONS) return;
+        simSections[simSectionCount++] = (SimSection){ name, 0, 0 };
+    }
+    simSections[i].total += elapsed;
+    simSections[i].calls++;
+}
+
+#define SIM_SECTION(name) \
+    for (double simT0_ = SimNow(), simOnce_ = 1; simOnce_; simOnce_ = 0, SimSectionAdd(name, simT0_))
+
+// --- Runner ---
+// Usage:  int main(int argc, char **argv) {
+//             SimRun run = SimBegin("rally", argc, argv, 100000);
+//             InitGame();
+//             for (int t = 0; t < run.ticks; t++) {
+//                 SimInputNextTick();
+//                 Script(t);            // SimSetKey(...) etc.
+//                 UpdateGame(1.0f / SIM_HZ);
+//             }
+//             return SimEnd(&run);
+//         }
+// Command line: <ticks> [seed]. The seed feeds SetRandomSeed so runs repeat.
+typedef struct {
+    const char *name;
+    int ticks;
+    unsigned int seed;
+    double start;   // SimNow() at SimBegin
+} SimRun;
+
+static inline SimRun SimBegin(const char *name, int argc, char **argv, int defaultTicks) {
+    SimRun r = { name, defaultTicks, 1u, 0 };
+    if (argc > 1) r.ticks = atoi(argv[1]);
+    if (argc > 2) r.seed = (unsigned int)strtoul(argv[2], NULL, 10);
+    if (r.ticks < 1) r.ticks = 1;
+    SetRandomSeed(r.seed);
+    simSectionCount = 0;
+    r.start = SimNow();
+    return r;
+}
+
+// Prints the report; returns a process exit code.
+static inline int SimEnd(const SimRun *r) {
+    double secs = SimNow() - r->start;
+    if (secs <= 0.0) secs = 1e-9;
+    printf("%s: %d ticks in %.3f s  (%.0f ticks/s, %.2f us/tick, seed %u)\n",
+           r->name, r->ticks, secs, r->ticks / secs, secs * 1e6 / r->ticks, r->seed);
+    for (int i = 0; i < simSectionCount; i++) {
+        double s = simSections[i].total;
+        printf("  %-12s %8.3f s  %5.1f%%  %8.2f us/tick\n",
+               simSections[i].name, s, 100.0 * s / secs, s * 1e6 / r->ticks);
+    }
+    return 0;
+}
+
+#else
+
+#define SIM_SECTION(name)
+
+#endif // SIM_HEADLESS
+
+#endif // UTIL_SIM_H
@@ -36,6 +36,7 @@ typedef struct {
     char filename[32];
     Sprite2DPart parts[32];
     int partCount;
+    Sprite2DBounds bounds;
     SpriteDisplayMode displayMode;
 } AttachedSprite;
 
@@ -70,6 +71,7 @@ static const char *builtinNames[] = { "Human", "Car", "Tree", "Crate", "Barrel",
 
 // Editor state
 static Map3D map;
+static VisibleList mapVis;   // chunks the camera sees this frame
 static PlacedObject placed[MAX_PLACED];
 static int numPlaced = 0;
 
@@ -83,6 +85,7 @@ static int selectedSprite = -1;
 #define MAX_SPRITE_FILES 10
 static Sprite2DPart spriteParts[MAX_SPRITE_FILES][32];
 static int spritePartCounts[MAX_SPRITE_FILES];
+static Sprite2DBounds spriteBounds[MAX_SPRITE_FILES];
 static char spriteNames[MAX_SPRITE_FILES][32];
 static int numSpriteFiles = 0;
 static int selectedSpriteFile = -1;
@@ -98,6 +101,7 @@ void LoadSpriteFiles(void) {
             int count = LoadSprite2D(path, spriteParts[numSpriteFiles], 32);
             if (count > 0) {
                 spritePartCounts[numSpriteFiles] = count;
+                spriteBounds[numSpriteFiles] = ComputeSprite2DBounds(spriteParts[numSpriteFiles], count);
                 const char *name = GetFileNameWithoutExt(path);
                 strncpy(spriteNames[numSpriteFiles], name, 31);
                 numSpriteFiles++;
@@ -530,6 +534,7 @@ void LoadPrefabSprites(int idx) {
                         as->partCount = spritePartCounts[s];
                         for (int p = 0; p < as->partCount; p++)
                             as->parts[p] = spriteParts[s][p];
+                        as->bounds = spriteBounds[s];
                         break;
                     }
                 }
@@ -598,6 +603,7 @@ void LoadPlacedObjects(void) {
                         ps->partCount = spritePartCounts[s];
                         for (int p = 0; p < ps->partCount; p++)
                             ps->parts[p] = spriteParts[s][p];
+                        ps->bounds = spriteBounds[s];
                         break;
                     }
                 }
@@ -714,12 +720,16 @@ void InitEditor(void) {
         }
     }
 
-    // Try loading the map from file, otherwise start with grass
-    if (!LoadMap3DFile("map.m3d", &map, tileDefs, NUM_TILEDEFS)) {
+    // Load the binary map, else import a text one, otherwise start with grass.
+    // The editor's palette wins over the defs stored in the file.
+    if (LoadMap3DBinary("map.m3db", &map)) {
+        Map3DSetDefs(&map, tileDefs, NUM_TILEDEFS);
+    } else if (!LoadMap3DFile("map.m3d", &map, tileDefs, NUM_TILEDEFS)) {
         char layout[EDITOR_MAP_W * EDITOR_MAP_H];
         memset(layout, '1', sizeof(layout));
         Map3DLoad(&map, layout, EDITOR_MAP_W, EDITOR_MAP_H, TILE_SZ, tileDefs, NUM_TILEDEFS);
     }
+    InitVisibleList(&mapVis, map.chunksX * map.chunksZ);
     camFocus = (Vector3){ EDITOR_MAP_W * TILE_SZ / 2, 0, EDITOR_MAP_H * TILE_SZ / 2 };
     LoadSpriteFiles();
 
@@ -751,7 +761,7 @@ void ExportMapToConsole(void) {
     for (int z = 0; z < map.height; z++) {
         printf("    \"");
         for (int x = 0; x < map.width; x++) {
-            int t = map.tiles[z][x];
+            int t = Map3DTile(&map, x, z);
             if (t < 10) printf("%c", '0' + t);
             else printf("%c", 'a' + (t - 10));
         }
@@ -937,7 +947,7 @@ int main(void) {
 
         // Save map (Ctrl+S)
         if ((IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_LEFT_SUPER)) && IsKeyPressed(KEY_S)) {
-            SaveMap3D("map.m3d", &map);
+            SaveMap3DBinary("map.m3db", &map, true);
             SavePlacedObjects();
             ExportMapToConsole();
             showExport = true;
@@ -951,6 +961,13 @@ int main(void) {
         Vector3 groundHit = MouseToGround(camera);
         int hoverTX, hoverTZ;
         Map3DFromWorld(&map, groundHit, &hoverTX, &hoverTZ);
+        // A wall or ramp in front of the ground is the tile under the cursor
+        Ray mouseRay = GetMouseRay(mouse, camera);
+        Map3DHit mapHit = Map3DRaycast(&map, mouseRay.position, mouseRay.direction, 1000.0f);
+        if (mapHit.hit) {
+            hoverTX = mapHit.tx;
+            hoverTZ = mapHit.tz;
+        }
         bool hoverValid = !overUI && hoverTX >= 0 && hoverTX < map.width &&
                           hoverTZ >= 0 && hoverTZ < map.height;
 
@@ -961,12 +978,12 @@ int main(void) {
 
             // Paint tiles with left click
             if (IsMouseButtonDown(MOUSE_LEFT_BUTTON) && hoverValid && !overUI) {
-                map.tiles[hoverTZ][hoverTX] = selectedTile;
+                Map3DSet(&map, hoverTX, hoverTZ, selectedTile);
             }
 
             // Eyedropper: pick tile under cursor
             if (IsKeyPressed(KEY_Q) && hoverValid) {
-                selectedTile = map.tiles[hoverTZ][hoverTX];
+                selectedTile = Map3DTile(&map, hoverTX, hoverTZ);
             }
         } else if (mode == MODE_OBJECTS && !textActive) {
             // Object mode
@@ -1050,7 +1067,7 @@ int main(void) {
                 float bestSpriteDist = 1e9f;
                 for (int i = 0; i < numPlacedSprites; i++) {
                     if (!placedSprites[i].active) continue;
-                    Rectangle sr = GetSprite2DScreenRect(placedSprites[i].parts, placedSprites[i].partCount,
+                    Rectangle sr = GetSprite2DScreenRectEx(&placedSprites[i].bounds,
                         placedSprites[i].pos, placedSprites[i].scale, camera);
                     if (CheckCollisionPointRec(mouse, sr)) {
                         float d = Vector3Length(Vector3Subtract(placedSprites[i].pos, camera.position));
@@ -1082,6 +1099,7 @@ int main(void) {
                     ps->partCount = spritePartCounts[selectedSpriteFile];
                     for (int p = 0; p < ps->partCount; p++)
                         ps->parts[p] = spriteParts[selectedSpriteFile][p];
+                    ps->bounds = spriteBounds[selectedSpriteFile];
                     strncpy(ps->filename, spriteNames[selectedSpriteFile], 31);
                     ps->active = true;
                     selectedSprite = numPlacedSprites;
@@ -1264,6 +1282,7 @@ int main(void) {
                 as->partCount = spritePartCounts[selectedSpriteFile];
                 for (int p = 0; p < as->partCount; p++)
                     as->parts[p] = spriteParts[selectedSpriteFile][p];
+                as->bounds = spriteBounds[selectedSpriteFile];
                 strncpy(as->filename, spriteNames[selectedSpriteFile], 31);
                 buildObj.selectedSprite = buildObj.spriteCount;
                 buildObj.spriteCount++;
@@ -1326,7 +1345,7 @@ int main(void) {
                     float bestSpriteD = 1e9f;
                     int bestSpriteIdx = -1;
                     for (int i = 0; i < buildObj.spriteCount; i++) {
-                        Rectangle sr = GetSprite2DScreenRect(buildObj.sprites[i].parts, buildObj.sprites[i].partCount,
+                        Rectangle sr = GetSprite2DScreenRectEx(&buildObj.sprites[i].bounds,
                             buildObj.sprites[i].offset, buildObj.sprites[i].scale, camera);
                         if (CheckCollisionPointRec(mouse, sr)) {
                             float d = Vector3Length(Vector3Subtract(buildObj.sprites[i].offset, camera.position));
@@ -1835,9 +1854,13 @@ int main(void) {
                     SaveSprite2D(puppetEditPath, build2d.parts, build2d.count);
                     // Update the rig part in memory
                     RigPart *rp = &puppetRig.parts[puppetEditingPart];
-                    rp->partCount = build2d.count;
-                    for (int pi = 0; pi < build2d.count && pi < MAX_RIG_SPRITE_PARTS; pi++)
+                    rp->partCount = build2d.count < MAX_RIG_SPRITE_PARTS ? build2d.count : MAX_RIG_SPRITE_PARTS;
+                    for (int pi = 0; pi < rp->partCount; pi++)
                         rp->parts[pi] = build2d.parts[pi];
+                    rp->bounds = ComputeSprite2DBounds(rp->parts, rp->partCount);
+                    // Every anim poses this part, so all their keyframe bounds move
+                    for (int ai = 0; ai < numPuppetAnims; ai++)
+                        ComputePuppetAnimBounds(&puppetAnims[ai], &puppetRig);
                     puppetEditingPart = -1;
                     mode = MODE_PUPPET;
                 } else {
@@ -2086,11 +2109,12 @@ int main(void) {
                     float rotY2 = (as->displayMode == SPRITE_BILLBOARD)
                         ? atan2f(camera.position.z - as->offset.z, camera.position.x - as->offset.x) - PI * 0.5f
                         : 0;
-                    DrawSprite2DAsPlane(as->parts, as->partCount, as->offset, as->scale, rotY2, camera);
+                    DrawSprite2DAsPlaneEx(as->parts, as->partCount, &as->bounds, as->offset, as->scale, rotY2, camera);
                 }
             } else {
-                // Draw map
-                Map3DDrawAll(&map);
+                // Draw map: only the chunks in view
+                Frustum view = CameraFrustumDefault(camera, (float)sw / (sh > 0 ? sh : 1));
+                Map3DDrawVisible(&map, &mapVis, &view, camera.position);
                 if (showGrid) Map3DDrawGrid(&map, (Color){60,60,70,80});
 
                 // Draw placed objects and their attached sprites
@@ -2116,7 +2140,7 @@ int main(void) {
                         float rotY2 = (as->displayMode == SPRITE_BILLBOARD)
                             ? atan2f(camera.position.z - sprPos.z, camera.position.x - sprPos.x) - PI * 0.5f
                             : placed[i].rotY;
-                        DrawSprite2DAsPlane(as->parts, as->partCount, sprPos, as->scale * avgScale, rotY2, camera);
+                        DrawSprite2DAsPlaneEx(as->parts, as->partCount, &as->bounds, sprPos, as->scale * avgScale, rotY2, camera);
                     }
                 }
             }
@@ -2130,7 +2154,7 @@ int main(void) {
                     float dz = camera.position.z - placedSprites[i].pos.z;
                     rotY2 = atan2f(dz, dx) - PI * 0.5f;
                 }
-                DrawSprite2DAsPlane(placedSprites[i].parts, placedSprites[i].partCount,
+                DrawSprite2DAsPlaneEx(placedSprites[i].parts, placedSprites[i].partCount, &placedSprites[i].bounds,
                     placedSprites[i].pos, placedSprites[i].scale, rotY2, camera);
                 DrawCircle3D(placedSprites[i].pos, 0.5f, (Vector3){1,0,0}, 90, (Color){0,0,0,30});
             }
@@ -2141,10 +2165,7 @@ int main(void) {
                 float hz = hoverTZ * TILE_SZ + TILE_SZ/2;
 
                 if (mode == MODE_TILES) {
-                    int origTile = map.tiles[hoverTZ][hoverTX];
-                    map.tiles[hoverTZ][hoverTX] = selectedTile;
-                    Map3DDrawTile(&map, hoverTX, hoverTZ);
-                    map.tiles[hoverTZ][hoverTX] = origTile;
+                    Map3DDrawTileAs(&map, hoverTX, hoverTZ, &map.defs[selectedTile]);
                     float hy = 0.05f;
                     TileDef *preview = &map.defs[selectedTile];
                     if (preview->type == TILE_WALL || preview->type == TILE_PLATFORM)
@@ -2173,7 +2194,7 @@ int main(void) {
                             float rotY2 = (as->displayMode == SPRITE_BILLBOARD)
                                 ? atan2f(camera.position.z - sprPos.z, camera.position.x - sprPos.x) - PI * 0.5f
                                 : 0;
-                            DrawSprite2DAsPlane(as->parts, as->partCount, sprPos, as->scale, rotY2, camera);
+                            DrawSprite2DAsPlaneEx(as->parts, as->partCount, &as->bounds, sprPos, as->scale, rotY2, camera);
                         }
                         DrawCircle3D((Vector3){groundHit.x, hy + 0.05f, groundHit.z}, 0.5f,
                             (Vector3){1,0,0}, 90, (Color){255,255,0,150});
@@ -2190,7 +2211,8 @@ int main(void) {
             hoverValid && !overUI) {
             float hy = Map3DHeightAt(&map, groundHit) + 1.0f;
             Vector3 previewPos = {groundHit.x, hy, groundHit.z};
-            DrawSprite2DAt3D(spriteParts[selectedSpriteFile], spritePartCounts[selectedSpriteFile],
+            DrawSprite2DAt3DEx(spriteParts[selectedSpriteFile], spritePartCounts[selectedSpriteFile],
+                &spriteBounds[selectedSpriteFile],
                 previewPos, 1.0f, camera);
         }
 
@@ -2664,7 +2686,7 @@ int main(void) {
 
         // Hover info
         if (hoverValid && mode == MODE_TILES) {
-            int tileIdx = map.tiles[hoverTZ][hoverTX];
+            int tileIdx = Map3DTile(&map, hoverTX, hoverTZ);
             DrawText(TextFormat("(%d,%d) %s", hoverTX, hoverTZ, tileNames[tileIdx]),
                      185, 10, 14, WHITE);
         }
@@ -2756,7 +2778,10 @@ int main(void) {
                         kf->poses[puppetDragging].x += delta.x / puppetZoom;
                         kf->poses[puppetDragging].y += delta.y / puppetZoom;
                     }
-                    if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON)) puppetDragging = -1;
+                    if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON) && puppetDragging >= 0) {
+                        puppetDragging = -1;
+                        ComputePuppetAnimBounds(ca, &puppetRig);
+                    }
 
                     // Scroll to zoom
                     float wheel = GetMouseWheelMove();
@@ -2794,8 +2819,10 @@ int main(void) {
                     }
 
                     // Toggle part visibility
-                    if (IsKeyPressed(KEY_H) && selectedPuppetPart >= 0)
+                    if (IsKeyPressed(KEY_H) && selectedPuppetPart >= 0) {
                         kf->poses[selectedPuppetPart].visible = !kf->poses[selectedPuppetPart].visible;
+                        ComputePuppetAnimBounds(ca, &puppetRig);
+                    }
 
                     // Edit selected part's sprite in Build 2D mode
                     if (IsKeyPressed(KEY_E) && selectedPuppetPart >= 0) {
@@ -3067,8 +3094,10 @@ int main(void) {
     }
 
     SaveEditorState();
-    SaveMap3D("map.m3d", &map);
+    SaveMap3DBinary("map.m3db", &map, true);
     SavePlacedObjects();
+    FreeVisibleList(&mapVis);
+    UnloadMap3D(&map);
     CloseWindow();
     return 0;
 }
@@ -1,6 +1,7 @@
 #include "raylib.h"
 #include "raymath.h"
 #include "../common/sprites2d.h"
+#include "../common/assets.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -47,18 +48,19 @@ typedef struct {
     bool hitConnected;  // prevent multi-hit per attack
     int wins;
 
-    // Puppet animations (new system)
-    PuppetRig rig;
-    PuppetAnim pIdle, pWalk, pPunch, pKick;
-    PuppetAnim pCrouch, pJump, pHit, pBlock;
-    PuppetAnim pHadouken;
+    // Puppet animations (new system), owned by the asset registry: edits to
+    // the rig, its sprites or the anims show up live
+    PuppetRig *rig;
+    PuppetAnim *pIdle, *pWalk, *pPunch, *pKick;
+    PuppetAnim *pCrouch, *pJump, *pHit, *pBlock;
+    PuppetAnim *pHadouken;
     PuppetState puppet;
     bool usePuppet;  // true if rig loaded successfully
 
     // Frame-based animations (fallback)
-    SpriteAnim animIdle, animWalk, animPunch, animKick;
-    SpriteAnim animCrouch, animJump, animHit, animBlock;
-    SpriteAnim animHadouken;
+    SpriteAnim *animIdle, *animWalk, *animPunch, *animKick;
+    SpriteAnim *animCrouch, *animJump, *animHit, *animBlock;
+    SpriteAnim *animHadouken;
     SpriteAnimState animState;
 
     AttackInfo currentAttack;
@@ -109,54 +111,56 @@ static bool showHitboxes;
 static float gameTime;
 
 // Hadouken sprite (shared)
-static SpriteAnim hadoukenBall;
+static SpriteAnim *hadoukenBall;
 
 void LoadFighterAnims(Fighter *f, const char *name) {
-    char path[128];
-
-    // Try puppet system first
-    snprintf(path, sizeof(path), "fighter/sprites/%s/%s.rig2d", name, name);
-    f->usePuppet = (LoadPuppetRig(path, &f->rig) > 0);
-    if (f->usePuppet) {
-        snprintf(path, sizeof(path), "fighter/sprites/%s/idle.anim2d", name);
-        LoadPuppetAnim(path, &f->pIdle, &f->rig);
-        snprintf(path, sizeof(path), "fighter/sprites/%s/walk.anim2d", name);
-        LoadPuppetAnim(path, &f->pWalk, &f->rig);
-        snprintf(path, sizeof(path), "fighter/sprites/%s/punch.anim2d", name);
-        LoadPuppetAnim(path, &f->pPunch, &f->rig);
-        snprintf(path, sizeof(path), "fighter/sprites/%s/kick.anim2d", name);
-        LoadPuppetAnim(path, &f->pKick, &f->rig);
-        snprintf(path, sizeof(path), "fighter/sprites/%s/crouch.anim2d", name);
-        LoadPuppetAnim(path, &f->pCrouch, &f->rig);
-        snprintf(path, sizeof(path), "fighter/sprites/%s/jump.anim2d", name);
-        LoadPuppetAnim(path, &f->pJump, &f->rig);
-        snprintf(path, sizeof(path), "fighter/sprites/%s/hit.anim2d", name);
-        LoadPuppetAnim(path, &f->pHit, &f->rig);
-        snprintf(path, sizeof(path), "fighter/sprites/%s/block.anim2d", name);
-        LoadPuppetAnim(path, &f->pBlock, &f->rig);
-        snprintf(path, sizeof(path), "fighter/sprites/%s/hadouken.anim2d", name);
-        LoadPuppetAnim(path, &f->pHadouken, &f->rig);
+    char path[128], rigPath[128];
+
+    // Try puppet system first (usePuppet is decided once loaded, in main)
+    snprintf(rigPath, sizeof(rigPath), "fighter/sprites/%s/%s.rig2d", name, name);
+    f->rig = AssetPuppetRig(rigPath);
+    PuppetAnim **anims[] = { &f->pIdle, &f->pWalk, &f->pPunch, &f->pKick, &f->pCrouch,
+                             &f->pJump, &f->pHit, &f->pBlock, &f->pHadouken };
+    const char *animNames[] = { "idle", "walk", "punch", "kick", "crouch", "jump", "hit", "block", "hadouken" };
+    for (int i = 0; i < 9; i++) {
+        snprintf(path, sizeof(path), "fighter/sprites/%s/%s.anim2d", name, animNames[i]);
+        *anims[i] = AssetPuppetAnim(path, rigPath);
     }
 
     // Also load frame-based as fallback
     snprintf(path, sizeof(path), "fighter/sprites/%s/idle", name);
-    LoadSpriteAnim(path, &f->animIdle, true);
+    f->animIdle = AssetSpriteAnim(path, true);
     snprintf(path, sizeof(path), "fighter/sprites/%s/walk", name);
-    LoadSpriteAnim(path, &f->animWalk, true);
+    f->animWalk = AssetSpriteAnim(path, true);
     snprintf(path, sizeof(path), "fighter/sprites/%s/punch", name);
-    LoadSpriteAnim(path, &f->animPunch, false);
+    f->animPunch = AssetSpriteAnim(path, false);
     snprintf(path, sizeof(path), "fighter/sprites/%s/kick", name);
-    LoadSpriteAnim(path, &f->animKick, false);
+    f->animKick = AssetSpriteAnim(path, false);
     snprintf(path, sizeof(path), "fighter/sprites/%s/crouch", name);
-    LoadSpriteAnim(path, &f->animCrouch, false);
+    f->animCrouch = AssetSpriteAnim(path, false);
     snprintf(path, sizeof(path), "fighter/sprites/%s/jump", name);
-    LoadSpriteAnim(path, &f->animJump, false);
+    f->animJump = AssetSpriteAnim(path, false);
     snprintf(path, sizeof(path), "fighter/sprites/%s/hit", name);
-    LoadSpriteAnim(path, &f->animHit, false);
+    f->animHit = AssetSpriteAnim(path, false);
     snprintf(path, sizeof(path), "fighter/sprites/%s/block", name);
-    LoadSpriteAnim(path, &f->animBlock, false);
+    f->animBlock = AssetSpriteAnim(path, false);
     snprintf(path, sizeof(path), "fighter/sprites/%s/hadouken", name);
-    LoadSpriteAnim(path, &f->animHadouken, false);
+    f->animHadouken = AssetSpriteAnim(path, false);
+}
+
+// A live edit (AssetsUpdate) can shorten or empty the playing anim
+void RefreshSpriteAnimAfterReload(SpriteAnimState *s) {
+    if (!s->anim) return;
+    if (s->anim->frameCount == 0) { s->currentFrame = 0; s->finished = true; }   // let the move end
+    else if (s->currentFrame >= s->anim->frameCount) { s->currentFrame = 0; s->timer = 0; }
+}
+
+void RefreshPuppetAfterReload(Fighter *f) {
+    PuppetState *p = &f->puppet;
+    RefreshSpriteAnimAfterReload(&f->animState);
+    if (!p->anim) return;
+    if (p->anim->frameCount == 0) p->anim = NULL;
+    else if (p->currentFrame >= p->anim->frameCount) { p->currentFrame = 0; p->timer = 0; }
 }
 
 void SpawnSpark(float x, float y) {
@@ -183,9 +187,9 @@ void InitFighter(Fighter *f, float x, bool facingRight) {
     f->comboCount = 0;
     f->comboTimer = 0;
     memset(&f->currentAttack, 0, sizeof(AttackInfo));
-    SpriteAnimForcePlay(&f->animState, &f->animIdle, !facingRight);
-    if (f->usePuppet && f->pIdle.frameCount > 0)
-        PuppetForcePlay(&f->puppet, &f->rig, &f->pIdle, !facingRight);
+    SpriteAnimForcePlay(&f->animState, f->animIdle, !facingRight);
+    if (f->usePuppet && f->pIdle->frameCount > 0)
+        PuppetForcePlay(&f->puppet, f->rig, f->pIdle, !facingRight);
 }
 
 void InitRound(void) {
@@ -211,31 +215,31 @@ void SetFighterState(Fighter *f, FighterState newState) {
     PuppetAnim *panim = NULL;
     SpriteAnim *anim = NULL;
     switch (newState) {
-        case FS_IDLE:      panim = &f->pIdle;     anim = &f->animIdle; break;
+        case FS_IDLE:      panim = f->pIdle;     anim = f->animIdle; break;
         case FS_WALK_FWD:
-        case FS_WALK_BACK: panim = &f->pWalk;     anim = &f->animWalk; break;
-        case FS_CROUCH:    panim = &f->pCrouch;   anim = &f->animCrouch; break;
-        case FS_JUMP:      panim = &f->pJump;     anim = &f->animJump; break;
+        case FS_WALK_BACK: panim = f->pWalk;     anim = f->animWalk; break;
+        case FS_CROUCH:    panim = f->pCrouch;   anim = f->animCrouch; break;
+        case FS_JUMP:      panim = f->pJump;     anim = f->animJump; break;
         case FS_PUNCH:
-            panim = &f->pPunch; anim = &f->animPunch;
+            panim = f->pPunch; anim = f->animPunch;
             f->currentAttack = (AttackInfo){10, 0.3f, PUSHBACK, false};
             break;
         case FS_KICK:
-            panim = &f->pKick; anim = &f->animKick;
+            panim = f->pKick; anim = f->animKick;
             f->currentAttack = (AttackInfo){15, 0.4f, PUSHBACK * 1.3f, false};
             break;
         case FS_HADOUKEN:
-            panim = &f->pHadouken; anim = &f->animHadouken;
+            panim = f->pHadouken; anim = f->animHadouken;
             f->currentAttack = (AttackInfo){0, 0, 0, false};
             break;
-        case FS_BLOCK:     panim = &f->pBlock;    anim = &f->animBlock; break;
-        case FS_HIT:       panim = &f->pHit;      anim = &f->animHit; break;
-        case FS_KNOCKDOWN: panim = &f->pHit;      anim = &f->animHit; break;
-        case FS_WIN:       panim = &f->pIdle;     anim = &f->animIdle; break;
+        case FS_BLOCK:     panim = f->pBlock;    anim = f->animBlock; break;
+        case FS_HIT:       panim = f->pHit;      anim = f->animHit; break;
+        case FS_KNOCKDOWN: panim = f->pHit;      anim = f->animHit; break;
+        case FS_WIN:       panim = f->pIdle;     anim = f->animIdle; break;
     }
 
     if (f->usePuppet && panim && panim->frameCount > 0)
-        PuppetForcePlay(&f->puppet, &f->rig, panim, !f->facingRight);
+        PuppetForcePlay(&f->puppet, f->rig, panim, !f->facingRight);
     if (anim) SpriteAnimForcePlay(&f->animState, anim, !f->facingRight);
 }
 
@@ -356,8 +360,8 @@ void UpdateFighter(Fighter *f, Fighter *other, int idx, float dt) {
                             f->x + dir * 40.0f, f->y - 30.0f,
                             dir * 400.0f, 12, true, idx, 2.0f
                         };
-                        if (hadoukenBall.frameCount > 0)
-                            SpriteAnimForcePlay(&projectiles[i].animState, &hadoukenBall, !f->facingRight);
+                        if (hadoukenBall && hadoukenBall->frameCount > 0)
+                            SpriteAnimForcePlay(&projectiles[i].animState, hadoukenBall, !f->facingRight);
                         break;
                     }
                 }
@@ -534,15 +538,17 @@ int main(void) {
     SetTargetFPS(60);
     SetExitKey(0);
 
-    // Load animations
+    // Load animations (from assets.pack when built by asset-pack, else the text files)
+    PackMount("assets.pack");
+    AssetsInit();
     LoadFighterAnims(&fighters[0], "ryu");
     LoadFighterAnims(&fighters[1], "ken");
+    hadoukenBall = AssetSpriteAnim("fighter/sprites/ryu/hadouken_ball", true);
+    AssetsWaitLoaded();
+    for (int i = 0; i < 2; i++) fighters[i].usePuppet = fighters[i].rig && fighters[i].rig->partCount > 0;
     fighters[0].maxHp = fighters[1].maxHp = 100;
     fighters[0].hp = fighters[1].hp = 100;
 
-    // Load hadouken ball anim
-    LoadSpriteAnim("fighter/sprites/ryu/hadouken_ball", &hadoukenBall, true);
-
     currentRound = 1;
     InitRound();
 
@@ -555,6 +561,10 @@ int main(void) {
         float dt = GetFrameTime();
         if (dt > 0.05f) dt = 0.05f;
         gameTime += dt;
+        if (AssetsUpdate() > 0) {
+            for (int i = 0; i < 2; i++) RefreshPuppetAfterReload(&fighters[i]);
+            for (int i = 0; i < MAX_PROJECTILES; i++) RefreshSpriteAnimAfterReload(&projectiles[i].animState);
+        }
         int sw = GetScreenWidth(), sh = GetScreenHeight();
         // Scale everything to fit window, maintaining aspect ratio
         float scaleX = (float)sw / DESIGN_W;
@@ -841,6 +851,8 @@ int main(void) {
         EndDrawing();
     }
 
+    AssetsShutdown();
+    PackUnmount();
     CloseWindow();
     return 0;
 }
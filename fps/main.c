@@ -1,5 +1,6 @@
 #include "raylib.h"
 #include "raymath.h"
+#include "../common/util/sim.h"
 #include "../common/objects3d.h"
 #include "../common/util/math.h"
 #include "../common/util/input.h"
@@ -7,6 +8,9 @@
 #include "../common/util/camera.h"
 #include "../common/util/collide.h"
 #include "../common/util/hud.h"
+#include "../common/util/loop.h"
+#include "../common/util/debug.h"
+#include "../common/util/arena.h"
 #include <math.h>
 #include <stdlib.h>
 
@@ -18,6 +22,7 @@
 #define MAX_PICKUPS      8
 #define MAP_SIZE       60.0f
 #define WALL_HEIGHT     4.0f
+#define SIM_HZ         60.0f   // fixed simulation tick rate
 
 // Player
 typedef struct {
@@ -51,6 +56,7 @@ typedef struct {
     EnemyType type;
     bool active;
     float hitFlash;
+    Vector3 prevPos;     // pos at the start of the last tick (render lerp)
 } Enemy;
 
 typedef struct {
@@ -193,9 +199,11 @@ static int numWalls = 0;
 
 // State
 static Player player;
+static Vector3 playerPrevPos;   // player.pos at the start of the last tick
 static Enemy enemies[MAX_ENEMIES];
 static Bullet bullets[MAX_BULLETS];
-static Particle3D particles[MAX_PARTICLES];
+static ParticleSoA particles;
+static ParticleBatch particleBatch;
 static Pickup pickups[MAX_PICKUPS];
 static int wave = 0;
 static int enemiesAlive = 0;
@@ -226,6 +234,13 @@ typedef struct {
 } Prop;
 static Prop props[MAX_PROPS];
 static int numProps = 0;
+// Prop collision spheres, SoA for the batch overlap kernels. Centres sit
+// PROP_HIT_Y above the prop base; propLive masks out destroyed props
+// (one mask word, so MAX_PROPS <= 64).
+#define PROP_HIT_Y 0.5f
+static float propX[MAX_PROPS], propY[MAX_PROPS], propZ[MAX_PROPS], propR[MAX_PROPS];
+static SphereSoA propSpheres = { propX, propY, propZ, propR, 0 };
+static uint64_t propLive = 0;
 
 // Barrel model
 static Part barrelParts[] = {
@@ -248,22 +263,31 @@ static Part crateParts[] = {
 void SpawnProp(PropType type, Vector3 pos) {
     if (numProps >= MAX_PROPS) return;
     float hp = (type == PROP_BARREL) ? 15 : 50;
-    props[numProps++] = (Prop){pos, type, hp, true};
+    int i = numProps++;
+    props[i] = (Prop){pos, type, hp, true};
+    propX[i] = pos.x;  propY[i] = pos.y + PROP_HIT_Y;  propZ[i] = pos.z;
+    propR[i] = (type == PROP_BARREL) ? 0.5f : 0.6f;
+    propSpheres.count = numProps;
+    propLive |= (uint64_t)1 << i;
 }
 
+void DestroyProp(int i) {
+    props[i].active = false;
+    propLive &= ~((uint64_t)1 << i);
+}
+
+// XZ test: the query is lifted to the props' hit height (props all stand on
+// the floor), so the batch sphere test reduces to a circle test.
 bool PropCollision(Vector3 pos, float radius) {
-    for (int i = 0; i < numProps; i++) {
-        if (!props[i].active) continue;
-        float r = (props[i].type == PROP_BARREL) ? 0.5f : 0.6f;
-        Vector3 diff = Vector3Subtract(pos, props[i].pos);
-        diff.y = 0;
-        if (Vector3Length(diff) < r + radius) return true;
-    }
-    return false;
+    uint64_t hits[COLLIDE_MASK_WORDS(MAX_PROPS)];
+    SphereOverlapBatch((Sphere){ {pos.x, PROP_HIT_Y, pos.z}, radius }, &propSpheres, hits);
+    return (hits[0] & propLive) != 0;
 }
 
 void BuildArena(void) {
     numProps = 0;
+    propSpheres.count = 0;
+    propLive = 0;
     numWalls = 0;
     Color wc = {120, 110, 100, 255};
     Color wc2 = {100, 90, 80, 255};
@@ -313,9 +337,32 @@ bool WallCollision(Vector3 pos, float radius) {
     return false;
 }
 
-static bool FpsBlocked(Vector3 pos, float radius, void *user) {
-    (void)user;
-    return WallCollision(pos, radius) || PropCollision(pos, radius);
+// Move with continuous collision: walls the mover is below plus live props
+// are the candidate set, swept once per move instead of sub-stepped. The
+// candidate lists are scratch, released before returning. At most
+// MAX_WALLS + MAX_PROPS entries (about 1 KB), so they only fail to fit if
+// the frame arena itself could not be created.
+static void MoveAndSlide(Vector3 *pos, Vector3 move, float radius) {
+    ArenaMark scratch = ScratchBegin();
+    AABB *boxes = FRAME_NEW(AABB, numWalls);
+    Sphere *spheres = FRAME_NEW(Sphere, numProps);
+    if (!boxes || !spheres) {
+        TraceLog(LOG_ERROR, "FPS: frame arena has no room for MoveAndSlide");
+        ScratchEnd(scratch);
+        return;
+    }
+    int nb = 0, ns = 0;
+    for (int i = 0; i < numWalls; i++) {
+        Wall *w = &walls[i];
+        if (pos->y >= w->h) continue;
+        boxes[nb++] = (AABB){ w->pos, { w->w/2, w->h/2, w->d/2 } };
+    }
+    for (int i = 0; i < numProps; i++) {
+        if (!props[i].active) continue;
+        spheres[ns++] = (Sphere){ props[i].pos, (props[i].type == PROP_BARREL) ? 0.5f : 0.6f };
+    }
+    SlideSweptXZ(pos, move, radius, boxes, nb, spheres, ns, NULL);
+    ScratchEnd(scratch);
 }
 
 void SpawnPickup(Vector3 pos, PickupType type) {
@@ -345,6 +392,7 @@ void SpawnWave(void) {
         float angle = (float)GetRandomValue(0, 628) / 100.0f;
         enemies[i] = (Enemy){
             .pos = {cosf(angle) * hs, 0, sinf(angle) * hs},
+            .prevPos = {cosf(angle) * hs, 0, sinf(angle) * hs},
             .hp = hp, .maxHp = hp, .speed = spd,
             .attackTimer = 0, .attackRange = (t == EN_GRUNT) ? 2.5f : 1.8f,
             .damage = dmg, .type = t, .active = true, .hitFlash = 0
@@ -363,9 +411,10 @@ void InitGame(void) {
         .ammo = weapons[0].maxAmmo, .maxAmmo = weapons[0].maxAmmo,
         .weapon = 0, .kills = 0
     };
+    playerPrevPos = player.pos;
     memset(enemies, 0, sizeof(enemies));
     memset(bullets, 0, sizeof(bullets));
-    memset(particles, 0, sizeof(particles));
+    ClearParticlesSoA(&particles);
     memset(pickups, 0, sizeof(pickups));
     wave = 0; enemiesAlive = 0; waveTimer = 3.0f;
     gameOver = false; gameTime = 0;
@@ -399,32 +448,32 @@ void FireWeapon(Player *p, Vector3 forward, Vector3 right) {
     if (p->ammo <= 0) { p->reloading = true; p->reloadTimer = w->reloadTime; }
 }
 
-int main(void) {
-    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
-    InitWindow(1280, 720, "FPS Arena");
-    MaximizeWindow();
-    SetTargetFPS(60);
-    DisableCursor();
-
-    InitGame();
-
-    CamFPS camRig = CamFPSInit((Vector3){0, 1.5f, 0});
+// Edge-triggered actions, polled per frame and consumed per tick
+enum { ACT_RESTART, ACT_NOCLIP, ACT_JUMP, ACT_WEAPON1, ACT_WEAPON2, ACT_WEAPON3, ACT_RELOAD };
+static PressLatch latch;
+
+static void PollActions(void) {
+    PressLatchPoll(&latch, ACT_RESTART, IsKeyPressed(KEY_ENTER));
+    PressLatchPoll(&latch, ACT_NOCLIP,  IsKeyPressed(KEY_V));
+    PressLatchPoll(&latch, ACT_JUMP,    IsKeyPressed(KEY_SPACE));
+    PressLatchPoll(&latch, ACT_WEAPON1, IsKeyPressed(KEY_ONE));
+    PressLatchPoll(&latch, ACT_WEAPON2, IsKeyPressed(KEY_TWO));
+    PressLatchPoll(&latch, ACT_WEAPON3, IsKeyPressed(KEY_THREE));
+    PressLatchPoll(&latch, ACT_RELOAD,  IsKeyPressed(KEY_R));
+}
 
-    while (!WindowShouldClose()) {
-        float dt = GetFrameTime();
-        if (dt > 0.05f) dt = 0.05f;
-        gameTime += dt;
-        int sw = GetScreenWidth(), sh = GetScreenHeight();
+// One fixed simulation tick
+static void UpdateGame(float dt) {
+    playerPrevPos = player.pos;
+    for (int e = 0; e < MAX_ENEMIES; e++) enemies[e].prevPos = enemies[e].pos;
 
-        if (gameOver) {
-            if (IsKeyPressed(KEY_ENTER)) { InitGame(); DisableCursor(); }
-        } else {
-            // --- Mouse look ---
-            InputLookMouse(&player.yaw, &player.pitch, 0.002f, 1.55f);
-
-            // --- Noclip toggle ---
-            if (IsKeyPressed(KEY_V)) player.noclip = !player.noclip;
+    if (gameOver) {
+        if (PressLatchTake(&latch, ACT_RESTART)) { InitGame(); DisableCursor(); }
+    } else {
+        // --- Noclip toggle ---
+        if (PressLatchTake(&latch, ACT_NOCLIP)) player.noclip = !player.noclip;
 
+        SIM_SECTION("player") {
             if (player.noclip) {
                 // Free-fly: WASD along full 3D forward (honours pitch), Space/LCtrl for up/down
                 float cy = cosf(player.yaw), sy = sinf(player.yaw);
@@ -448,7 +497,7 @@ int main(void) {
                 Vector3 move = Vector3Scale(InputMoveDir3Flat(player.yaw), speed);
 
                 // Try move with wall collision
-                SlideXZ(&player.pos, move, 0.4f, FpsBlocked, NULL);
+                MoveAndSlide(&player.pos, move, 0.4f);
 
                 // Clamp to arena
                 float hs = MAP_SIZE/2 - 0.5f;
@@ -456,7 +505,7 @@ int main(void) {
                 player.pos.z = Clamp(player.pos.z, -hs, hs);
 
                 // Jump
-                if (IsKeyPressed(KEY_SPACE) && player.grounded) {
+                if (PressLatchTake(&latch, ACT_JUMP) && player.grounded) {
                     player.velY = 8.0f;
                     player.grounded = false;
                 }
@@ -464,12 +513,12 @@ int main(void) {
             }
 
             // --- Weapon switch ---
-            if (IsKeyPressed(KEY_ONE)) { player.weapon = 0; player.ammo = weapons[0].maxAmmo; player.reloading = false; }
-            if (IsKeyPressed(KEY_TWO)) { player.weapon = 1; player.ammo = weapons[1].maxAmmo; player.reloading = false; }
-            if (IsKeyPressed(KEY_THREE)) { player.weapon = 2; player.ammo = weapons[2].maxAmmo; player.reloading = false; }
+            if (PressLatchTake(&latch, ACT_WEAPON1)) { player.weapon = 0; player.ammo = weapons[0].maxAmmo; player.reloading = false; }
+            if (PressLatchTake(&latch, ACT_WEAPON2)) { player.weapon = 1; player.ammo = weapons[1].maxAmmo; player.reloading = false; }
+            if (PressLatchTake(&latch, ACT_WEAPON3)) { player.weapon = 2; player.ammo = weapons[2].maxAmmo; player.reloading = false; }
 
             // Reload
-            if (IsKeyPressed(KEY_R) && !player.reloading && player.ammo < weapons[player.weapon].maxAmmo) {
+            if (PressLatchTake(&latch, ACT_RELOAD) && !player.reloading && player.ammo < weapons[player.weapon].maxAmmo) {
                 player.reloading = true;
                 player.reloadTimer = weapons[player.weapon].reloadTime;
             }
@@ -491,132 +540,243 @@ int main(void) {
                 Vector3 aimRight = Vector3Normalize(Vector3CrossProduct(aimFwd, (Vector3){0,1,0}));
                 FireWeapon(&player, aimFwd, aimRight);
             }
+        }
 
-            // --- Update bullets ---
-            POOL_FOREACH(bullets, MAX_BULLETS, b) {
-                if (!b->active) continue;
-                b->pos = Vector3Add(b->pos, Vector3Scale(b->vel, dt));
-                b->life -= dt;
-                if (b->life <= 0 || WallCollision(b->pos, 0.05f)) {
-                    SpawnParticleBurst(particles, MAX_PARTICLES, b->pos, 3, 1, 3, 0.1f, 0.3f, 0.02f, 0.08f);
-                    if (WallCollision(b->pos, 0.05f)) {
-                        Vector3 n = Vector3Normalize(Vector3Negate(b->vel));
-                        SpawnDecal(b->pos, n);
-                    }
-                    b->active = false;
-                    continue;
+        // --- Update bullets ---
+        SIM_SECTION("bullets")
+        POOL_FOREACH(bullets, MAX_BULLETS, b) {
+            if (!b->active) continue;
+            b->pos = Vector3Add(b->pos, Vector3Scale(b->vel, dt));
+            b->life -= dt;
+            if (b->life <= 0 || WallCollision(b->pos, 0.05f)) {
+                SpawnParticleBurstSoA(&particles, b->pos, 3, 1, 3, 0.1f, 0.3f, 0.02f, 0.08f);
+                if (WallCollision(b->pos, 0.05f)) {
+                    Vector3 n = Vector3Normalize(Vector3Negate(b->vel));
+                    SpawnDecal(b->pos, n);
                 }
-                // Hit enemies
-                POOL_FOREACH(enemies, MAX_ENEMIES, e) {
-                    if (!e->active) continue;
-                    if (Vector3Distance(b->pos, e->pos) < 0.8f) {
-                        e->hp -= b->damage;
-                        e->hitFlash = 0.1f;
-                        SpawnParticleBurst(particles, MAX_PARTICLES, b->pos, 4, 2, 5, 0.2f, 0.5f, 0.03f, 0.1f);
-                        b->active = false;
-                        if (e->hp <= 0) {
-                            e->active = false;
-                            enemiesAlive--;
-                            player.kills++;
-                            SpawnParticleBurst(particles, MAX_PARTICLES, e->pos, 12, 2, 8, 0.3f, 1.0f, 0.05f, 0.2f);
-                            ShakeTrigger(&shake, 0.15f);
-                        }
-                        break;
+                b->active = false;
+                continue;
+            }
+            // Hit enemies
+            POOL_FOREACH(enemies, MAX_ENEMIES, e) {
+                if (!e->active) continue;
+                if (Vector3Distance(b->pos, e->pos) < 0.8f) {
+                    e->hp -= b->damage;
+                    e->hitFlash = 0.1f;
+                    SpawnParticleBurstSoA(&particles, b->pos, 4, 2, 5, 0.2f, 0.5f, 0.03f, 0.1f);
+                    b->active = false;
+                    if (e->hp <= 0) {
+                        e->active = false;
+                        enemiesAlive--;
+                        player.kills++;
+                        SpawnParticleBurstSoA(&particles, e->pos, 12, 2, 8, 0.3f, 1.0f, 0.05f, 0.2f);
+                        ShakeTrigger(&shake, 0.15f);
                     }
+                    break;
                 }
-                // Hit props
-                if (b->active) {
-                    for (int p = 0; p < numProps; p++) {
-                        if (!props[p].active) continue;
-                        float hitR = (props[p].type == PROP_BARREL) ? 0.5f : 0.6f;
-                        if (Vector3Distance(b->pos, (Vector3){props[p].pos.x, props[p].pos.y + 0.5f, props[p].pos.z}) < hitR) {
-                            props[p].hp -= b->damage;
-                            SpawnParticleBurst(particles, MAX_PARTICLES, b->pos, 3, 1, 4, 0.1f, 0.4f, 0.02f, 0.08f);
-                            b->active = false;
-                            if (props[p].hp <= 0) {
-                                props[p].active = false;
-                                SpawnParticleBurst(particles, MAX_PARTICLES, props[p].pos, 10, 3, 8, 0.3f, 0.8f, 0.05f, 0.2f);
-                                ShakeTrigger(&shake, 0.1f);
-                                if (props[p].type == PROP_BARREL) {
-                                    PickupType pt = (PickupType)GetRandomValue(0, 2);
-                                    SpawnPickup((Vector3){props[p].pos.x, 0.5f, props[p].pos.z}, pt);
-                                }
-                            }
-                            break;
-                        }
+            }
+            // Hit props
+            uint64_t propHits[COLLIDE_MASK_WORDS(MAX_PROPS)];
+            if (b->active && SphereOverlapBatch((Sphere){ b->pos, 0.0f }, &propSpheres, propHits)
+                && (propHits[0] & propLive)) {
+                int p = POOL_CTZ64(propHits[0] & propLive);   // lowest index, as the old scan
+                props[p].hp -= b->damage;
+                SpawnParticleBurstSoA(&particles, b->pos, 3, 1, 4, 0.1f, 0.4f, 0.02f, 0.08f);
+                b->active = false;
+                if (props[p].hp <= 0) {
+                    DestroyProp(p);
+                    SpawnParticleBurstSoA(&particles, props[p].pos, 10, 3, 8, 0.3f, 0.8f, 0.05f, 0.2f);
+                    ShakeTrigger(&shake, 0.1f);
+                    if (props[p].type == PROP_BARREL) {
+                        PickupType pt = (PickupType)GetRandomValue(0, 2);
+                        SpawnPickup((Vector3){props[p].pos.x, 0.5f, props[p].pos.z}, pt);
                     }
                 }
             }
+        }
 
-            // --- Update enemies ---
-            for (int e = 0; e < MAX_ENEMIES; e++) {
-                if (!enemies[e].active) continue;
-                enemies[e].hitFlash -= dt;
-                // Move toward player
-                Vector3 toPlayer = Vector3Subtract(player.pos, enemies[e].pos);
-                toPlayer.y = 0;
-                float dist = Vector3Length(toPlayer);
-                if (dist > enemies[e].attackRange) {
-                    Vector3 dir = Vector3Normalize(toPlayer);
-                    Vector3 newP = Vector3Add(enemies[e].pos, Vector3Scale(dir, enemies[e].speed * dt));
-                    if (!WallCollision(newP, 0.5f) && !PropCollision(newP, 0.5f)) enemies[e].pos = newP;
-                }
-                // Attack
-                if (dist < enemies[e].attackRange) {
-                    enemies[e].attackTimer -= dt;
-                    if (enemies[e].attackTimer <= 0) {
-                        enemies[e].attackTimer = 1.0f;
-                        float dmg = enemies[e].damage;
-                        if (player.armor > 0) { player.armor -= dmg * 0.5f; dmg *= 0.5f; if (player.armor < 0) player.armor = 0; }
-                        player.hp -= dmg;
-                        player.damageFlash = 0.2f;
-                        ShakeTrigger(&shake, 0.2f);
-                        if (player.hp <= 0) { player.hp = 0; gameOver = true; EnableCursor(); }
-                    }
-                }
-                // Push apart from other enemies
-                for (int j = e + 1; j < MAX_ENEMIES; j++) {
-                    if (!enemies[j].active) continue;
-                    Vector3 diff = Vector3Subtract(enemies[e].pos, enemies[j].pos);
-                    diff.y = 0;
-                    float d = Vector3Length(diff);
-                    if (d < 1.2f && d > 0.01f) {
-                        Vector3 push = Vector3Scale(Vector3Normalize(diff), (1.2f - d) * 0.5f);
-                        enemies[e].pos = Vector3Add(enemies[e].pos, push);
-                        enemies[j].pos = Vector3Subtract(enemies[j].pos, push);
-                    }
+        // --- Update enemies ---
+        SIM_SECTION("enemies")
+        for (int e = 0; e < MAX_ENEMIES; e++) {
+            if (!enemies[e].active) continue;
+            enemies[e].hitFlash -= dt;
+            // Move toward player
+            Vector3 toPlayer = Vector3Subtract(player.pos, enemies[e].pos);
+            toPlayer.y = 0;
+            float dist = Vector3Length(toPlayer);
+            if (dist > enemies[e].attackRange) {
+                Vector3 dir = Vector3Normalize(toPlayer);
+                Vector3 newP = Vector3Add(enemies[e].pos, Vector3Scale(dir, enemies[e].speed * dt));
+                if (!WallCollision(newP, 0.5f) && !PropCollision(newP, 0.5f)) enemies[e].pos = newP;
+            }
+            // Attack
+            if (dist < enemies[e].attackRange) {
+                enemies[e].attackTimer -= dt;
+                if (enemies[e].attackTimer <= 0) {
+                    enemies[e].attackTimer = 1.0f;
+                    float dmg = enemies[e].damage;
+                    if (player.armor > 0) { player.armor -= dmg * 0.5f; dmg *= 0.5f; if (player.armor < 0) player.armor = 0; }
+                    player.hp -= dmg;
+                    player.damageFlash = 0.2f;
+                    ShakeTrigger(&shake, 0.2f);
+                    if (player.hp <= 0) { player.hp = 0; gameOver = true; EnableCursor(); }
                 }
             }
-
-            // --- Pickups ---
-            for (int i = 0; i < MAX_PICKUPS; i++) {
-                if (!pickups[i].active) continue;
-                if (Vector3Distance(player.pos, pickups[i].pos) < 1.5f) {
-                    switch (pickups[i].type) {
-                        case PICKUP_HEALTH: player.hp = fminf(player.hp + 25, player.maxHp); break;
-                        case PICKUP_AMMO: player.ammo = weapons[player.weapon].maxAmmo; player.reloading = false; break;
-                        case PICKUP_ARMOR: player.armor = fminf(player.armor + 50, 100); break;
-                    }
-                    pickups[i].active = false;
+            // Push apart from other enemies
+            for (int j = e + 1; j < MAX_ENEMIES; j++) {
+                if (!enemies[j].active) continue;
+                Vector3 diff = Vector3Subtract(enemies[e].pos, enemies[j].pos);
+                diff.y = 0;
+                float d = Vector3Length(diff);
+                if (d < 1.2f && d > 0.01f) {
+                    Vector3 push = Vector3Scale(Vector3Normalize(diff), (1.2f - d) * 0.5f);
+                    enemies[e].pos = Vector3Add(enemies[e].pos, push);
+                    enemies[j].pos = Vector3Subtract(enemies[j].pos, push);
                 }
             }
+        }
 
-            // --- Wave spawning ---
-            if (enemiesAlive <= 0) {
-                waveTimer -= dt;
-                if (waveTimer <= 0) { SpawnWave(); waveTimer = 5.0f; }
+        // --- Pickups ---
+        for (int i = 0; i < MAX_PICKUPS; i++) {
+            if (!pickups[i].active) continue;
+            if (Vector3Distance(player.pos, pickups[i].pos) < 1.5f) {
+                switch (pickups[i].type) {
+                    case PICKUP_HEALTH: player.hp = fminf(player.hp + 25, player.maxHp); break;
+                    case PICKUP_AMMO: player.ammo = weapons[player.weapon].maxAmmo; player.reloading = false; break;
+                    case PICKUP_ARMOR: player.armor = fminf(player.armor + 50, 100); break;
+                }
+                pickups[i].active = false;
             }
+        }
 
-            player.damageFlash -= dt;
+        // --- Wave spawning ---
+        if (enemiesAlive <= 0) {
+            waveTimer -= dt;
+            if (waveTimer <= 0) { SpawnWave(); waveTimer = 5.0f; }
         }
 
-        // Update particles and shake
-        UpdateParticles3D(particles, MAX_PARTICLES, dt, 10.0f);
+        player.damageFlash -= dt;
+    }
+}
+
+#ifdef SIM_HEADLESS
+// Scripted player: turns toward the nearest enemy, holds fire, strafes in a
+// box, jumps and reloads on a timer, and restarts straight after dying.
+static void SimScript(int t) {
+    int phase = (t / 90) % 4;   // 1.5 s per leg
+    SimSetKey(KEY_W, phase == 0);
+    SimSetKey(KEY_D, phase == 1);
+    SimSetKey(KEY_S, phase == 2);
+    SimSetKey(KEY_A, phase == 3);
+    SimSetKey(KEY_SPACE, t % 180 == 0);
+    SimSetKey(KEY_R, t % 600 == 300);
+    SimSetKey(KEY_ENTER, gameOver && !SimKeyDown(KEY_ENTER));
+    SimSetKey(KEY_ONE + (t / 1200) % 3, t % 1200 == 0);
+    SimSetButton(MOUSE_LEFT_BUTTON, true);
+
+    float best = 1e30f;
+    for (int e = 0; e < MAX_ENEMIES; e++) {
+        if (!enemies[e].active) continue;
+        float dx = enemies[e].pos.x - player.pos.x, dz = enemies[e].pos.z - player.pos.z;
+        float d2 = dx * dx + dz * dz;
+        if (d2 >= best) continue;
+        best = d2;
+        float yaw   = atan2f(dx, -dz);
+        float pitch = atan2f(enemies[e].pos.y - (player.pos.y + 1.5f), sqrtf(d2));   // bullets leave at eye height
+        // A quarter of the way there per tick, in mouse pixels at the game's 0.002 rad/px
+        simInput.mouseDelta.x =  WrapAnglePi(yaw - player.yaw) * 0.25f / 0.002f;
+        simInput.mouseDelta.y = -(pitch - player.pitch) * 0.25f / 0.002f;
+    }
+}
+
+int main(int argc, char **argv) {
+    SimRun run = SimBegin("fps", argc, argv, (int)(SIM_HZ * 600));
+    FrameArenaInit(256 * 1024);
+    InitParticlesSoA(&particles, MAX_PARTICLES);
+    InitGame();
+
+    float dt = 1.0f / SIM_HZ;
+    for (int t = 0; t < run.ticks; t++) {
+        FrameArenaReset();
+        SimInputNextTick();
+        SimScript(t);
+        if (!gameOver) InputLookMouse(&player.yaw, &player.pitch, 0.002f, 1.55f);
+        PollActions();
+        UpdateGame(dt);
+        PressLatchClear(&latch);
+        SIM_SECTION("particles") UpdateParticlesSoA(&particles, dt, (Vector3){0, -10.0f, 0});
         ShakeUpdate(&shake, dt);
+        gameTime += dt;
+    }
+    int rc = SimEnd(&run);
+    printf("  reached wave %d, %d kills\n", wave, player.kills);
+    printf("  frame arena peak %zu bytes, %d failed\n", frameArena.highWater, frameArena.failed);
+
+    FreeParticlesSoA(&particles);
+    return rc;
+}
+#else
+int main(void) {
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+    InitWindow(1280, 720, "FPS Arena");
+    MaximizeWindow();
+    SetTargetFPS(144);   // render rate; the simulation ticks at SIM_HZ
+    DisableCursor();
+
+    FrameArenaInit(256 * 1024);
+    InitParticlesSoA(&particles, MAX_PARTICLES);
+    InitParticleBatch(&particleBatch, MAX_PARTICLES);
+    InitGame();
+
+    // Enemy and prop models compiled once to meshes, indexed by type
+    Prefab3D *enemyPrefabs[] = {
+        [EN_GRUNT] = GetPrefab3D("fps/grunt", gruntParts, sizeof(gruntParts)/sizeof(Part)),
+        [EN_FAST]  = GetPrefab3D("fps/fast",  fastParts,  sizeof(fastParts)/sizeof(Part)),
+        [EN_TANK]  = GetPrefab3D("fps/tank",  tankParts,  sizeof(tankParts)/sizeof(Part)),
+    };
+    Prefab3D *propPrefabs[] = {
+        [PROP_BARREL] = GetPrefab3D("fps/barrel", barrelParts, sizeof(barrelParts)/sizeof(Part)),
+        [PROP_CRATE]  = GetPrefab3D("fps/crate",  crateParts,  sizeof(crateParts)/sizeof(Part)),
+    };
+
+    CamFPS camRig = CamFPSInit((Vector3){0, 1.5f, 0});
+    FixedStep loop = FixedStepInit(SIM_HZ, 5);
+    DebugOverlay debugOverlay = {0};
+
+    while (!WindowShouldClose()) {
+        FrameArenaReset();
+        ProfileFrameBegin();
+        float frameDt = GetFrameTime();
+        if (frameDt > 0.05f) frameDt = 0.05f;
+        gameTime += frameDt;
+        int sw = GetScreenWidth(), sh = GetScreenHeight();
+
+        // Profiler (-Dprofile=true): F3 overlay, F4 dumps the last 120 frames
+        ProfilerToggleOnKey(KEY_F3);
+        if (IsKeyPressed(KEY_F4)) ProfileWriteChromeTrace("fps-trace.json", 120);
+        // F2: debug panel with frame arena usage
+        DebugOverlayToggleOnKey(&debugOverlay, KEY_F2);
+        DebugOverlayUpdate(&debugOverlay, GetFrameTime());
+
+        // Look at render rate; everything else steps at the fixed tick
+        if (!gameOver) InputLookMouse(&player.yaw, &player.pitch, 0.002f, 1.55f);
+        PollActions();
+        int ticks = FixedStepAdvance(&loop, GetFrameTime());
+        PROFILE_BEGIN("sim");
+        for (int t = 0; t < ticks; t++) UpdateGame(loop.dt);
+        PROFILE_END();
+        if (ticks > 0) PressLatchClear(&latch);
+
+        // Update particles and shake
+        PROFILE_BEGIN("particles");
+        UpdateParticlesSoA(&particles, frameDt, (Vector3){0, -10.0f, 0});
+        PROFILE_END();
+        ShakeUpdate(&shake, frameDt);
         Vector2 shakeOff = ShakeOffset(&shake);
 
         // --- Camera ---
-        camRig.pos   = (Vector3){ player.pos.x, player.pos.y + 1.5f, player.pos.z };
+        Vector3 eye = Vector3Lerp(playerPrevPos, player.pos, loop.alpha);
+        camRig.pos   = (Vector3){ eye.x, eye.y + 1.5f, eye.z };
         camRig.yaw   = player.yaw;
         camRig.pitch = player.pitch;
         Camera3D camera = CamFPSToCamera3D(&camRig);
@@ -629,6 +789,7 @@ int main(void) {
         BeginDrawing();
         ClearBackground((Color){40, 50, 60, 255});
         BeginMode3D(camera);
+        PROFILE_BEGIN("draw world");
 
         // Floor
         DrawPlane((Vector3){0,0,0}, (Vector2){MAP_SIZE, MAP_SIZE}, (Color){50, 55, 50, 255});
@@ -665,22 +826,16 @@ int main(void) {
         // Enemies
         POOL_FOREACH(enemies, MAX_ENEMIES, en) {
             if (!en->active) continue;
-            Part *ep; int ec;
-            switch (en->type) {
-                case EN_GRUNT: ep = gruntParts; ec = sizeof(gruntParts)/sizeof(Part); break;
-                case EN_FAST:  ep = fastParts;  ec = sizeof(fastParts)/sizeof(Part); break;
-                case EN_TANK:  ep = tankParts;  ec = sizeof(tankParts)/sizeof(Part); break;
-            }
-            float rotY = atan2f(player.pos.x - en->pos.x, player.pos.z - en->pos.z);
+            Vector3 enPos = Vector3Lerp(en->prevPos, en->pos, loop.alpha);
+            float rotY = atan2f(eye.x - enPos.x, eye.z - enPos.z);
             if (en->hitFlash > 0) {
-                DrawCube(en->pos, 0.8f, 1.2f, 0.5f, WHITE);
+                DrawCube(enPos, 0.8f, 1.2f, 0.5f, WHITE);
             } else {
-                Object3D obj = {ep, ec, en->pos, rotY};
-                DrawObject3D(&obj);
+                DrawPrefab3D(enemyPrefabs[en->type], enPos, rotY);
             }
             // HP bar
             if (en->hp < en->maxHp) {
-                Vector2 sp = GetWorldToScreen((Vector3){en->pos.x, 2.0f, en->pos.z}, camera);
+                Vector2 sp = GetWorldToScreen((Vector3){enPos.x, 2.0f, enPos.z}, camera);
                 if (sp.y > 0 && sp.y < sh) {
                     float pct = en->hp / en->maxHp;
                     DrawRectangle(sp.x-15, sp.y, 30, 4, (Color){40,40,40,200});
@@ -756,25 +911,22 @@ int main(void) {
             }
         }
 
-        // Particles
-        DrawParticles3D(particles, MAX_PARTICLES);
+        // Particles: one camera-facing quad each, submitted as a single batch
+        Vector3 bbRight, bbUp;
+        ParticleBillboardAxes(camera, &bbRight, &bbUp);
+        ClearParticleBatch(&particleBatch);
+        BatchParticlesSoA3D(&particleBatch, &particles, bbRight, bbUp);
+        DrawParticleBatch(&particleBatch);
 
         // Props (barrels and crates)
         for (int i = 0; i < numProps; i++) {
             if (!props[i].active) continue;
-            Part *pp2; int pc2;
-            if (props[i].type == PROP_BARREL) {
-                pp2 = barrelParts; pc2 = sizeof(barrelParts)/sizeof(Part);
-            } else {
-                pp2 = crateParts; pc2 = sizeof(crateParts)/sizeof(Part);
-            }
-            Object3D propObj = {pp2, pc2, props[i].pos, 0};
-            DrawObject3D(&propObj);
+            DrawPrefab3D(propPrefabs[props[i].type], props[i].pos, 0);
         }
 
         // Decals on walls
         for (int i = 0; i < MAX_DECALS; i++) {
-            decals[i].life -= dt;
+            decals[i].life -= frameDt;
             if (decals[i].life <= 0) continue;
             float alpha = fminf(decals[i].life / 2.0f, 1.0f);
             if (alpha < 0) alpha = 0;
@@ -838,9 +990,11 @@ int main(void) {
             #undef GUN_PT
         }
 
+        PROFILE_END();
         EndMode3D();
 
         // --- HUD ---
+        PROFILE_BEGIN("hud");
         // Crosshair
         int crossSize = 8 + (player.weapon == 1 ? 4 : 0);
         HudCrosshair(sw / 2, sh / 2, crossSize, 4, 0, WHITE);
@@ -893,9 +1047,21 @@ int main(void) {
         }
 
         DrawFPS(sw-80, 10);
+        DebugOverlayDraw(&debugOverlay, FrameFormat("Wave %d  Enemies %d", wave, enemiesAlive), player.pos);
+        DebugOverlayDrawArena(&debugOverlay, &frameArena, "frame arena");
+        PROFILE_END();
+        ProfilerDrawOverlay(10, 10, 8);
+        PROFILE_BEGIN("present");
         EndDrawing();
+        PROFILE_END();
+        ProfileFrameEnd();
     }
 
+    FreeParticleBatch(&particleBatch);
+    FreeParticlesSoA(&particles);
+    ArenaDestroy(&frameArena);
+    UnloadPrefabs3D();
     CloseWindow();
     return 0;
 }
+#endif
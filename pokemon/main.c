@@ -3,6 +3,7 @@
 #include "rlgl.h"
 #include "../common/objects3d.h"
 #include "../common/sprites2d.h"
+#include "../common/assets.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -176,61 +177,55 @@ static WildTemplate wildTemplates[] = {
 #define NUM_WILD_TEMPLATES (int)(sizeof(wildTemplates)/sizeof(wildTemplates[0]))
 
 // --- Sprites loaded from .spr2d files ---
-#define MAX_SPRITE_PARTS 32
-
-typedef struct {
-    Sprite2DPart parts[MAX_SPRITE_PARTS];
-    int count;
-} SpriteData;
+// Owned by the asset registry (assets.h), so edits to the files show up live
+typedef Sprite2DAsset SpriteData;
 
 // Tile sprites
-static SpriteData tileSpr[20];   // indexed by tile type
-static SpriteData tileSprFloorDark;
-static SpriteData tileSprRugPC;
+static SpriteData *tileSpr[20];   // indexed by tile type
+static SpriteData *tileSprFloorDark;
+static SpriteData *tileSprRugPC;
 
 // Character sprites
-static SpriteData sprPlayerDown, sprPlayerUp, sprPlayerSide, sprNPC;
+static SpriteData *sprPlayerDown, *sprPlayerUp, *sprPlayerSide, *sprNPC;
 
 void LoadAllSprites(void) {
     // Tiles
-    tileSpr[T_GRASS].count     = LoadSprite2D("pokemon/sprites/tiles/grass.spr2d",      tileSpr[T_GRASS].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_PATH].count      = LoadSprite2D("pokemon/sprites/tiles/path.spr2d",       tileSpr[T_PATH].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_WALL].count      = LoadSprite2D("pokemon/sprites/tiles/wall.spr2d",       tileSpr[T_WALL].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_TREE].count      = LoadSprite2D("pokemon/sprites/tiles/tree.spr2d",       tileSpr[T_TREE].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_FENCE].count     = LoadSprite2D("pokemon/sprites/tiles/fence.spr2d",      tileSpr[T_FENCE].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_HOUSE].count     = LoadSprite2D("pokemon/sprites/tiles/house.spr2d",      tileSpr[T_HOUSE].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_DOOR].count      = LoadSprite2D("pokemon/sprites/tiles/door.spr2d",       tileSpr[T_DOOR].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_SIGN].count      = LoadSprite2D("pokemon/sprites/tiles/sign.spr2d",       tileSpr[T_SIGN].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_POKECENTER].count= LoadSprite2D("pokemon/sprites/tiles/pokecenter.spr2d", tileSpr[T_POKECENTER].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_FLOOR].count     = LoadSprite2D("pokemon/sprites/tiles/floor.spr2d",      tileSpr[T_FLOOR].parts, MAX_SPRITE_PARTS);
-    tileSprFloorDark.count     = LoadSprite2D("pokemon/sprites/tiles/floor_dark.spr2d", tileSprFloorDark.parts, MAX_SPRITE_PARTS);
-    tileSpr[T_COUNTER].count   = LoadSprite2D("pokemon/sprites/tiles/counter.spr2d",    tileSpr[T_COUNTER].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_SHELF].count     = LoadSprite2D("pokemon/sprites/tiles/shelf.spr2d",      tileSpr[T_SHELF].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_EXIT].count      = LoadSprite2D("pokemon/sprites/tiles/exit.spr2d",       tileSpr[T_EXIT].parts, MAX_SPRITE_PARTS);
-    tileSpr[T_RUG].count       = LoadSprite2D("pokemon/sprites/tiles/rug_house.spr2d",  tileSpr[T_RUG].parts, MAX_SPRITE_PARTS);
-    tileSprRugPC.count         = LoadSprite2D("pokemon/sprites/tiles/rug_pokecenter.spr2d", tileSprRugPC.parts, MAX_SPRITE_PARTS);
+    tileSpr[T_GRASS]     = AssetSprite2D("pokemon/sprites/tiles/grass.spr2d");
+    tileSpr[T_PATH]      = AssetSprite2D("pokemon/sprites/tiles/path.spr2d");
+    tileSpr[T_WALL]      = AssetSprite2D("pokemon/sprites/tiles/wall.spr2d");
+    tileSpr[T_TREE]      = AssetSprite2D("pokemon/sprites/tiles/tree.spr2d");
+    tileSpr[T_FENCE]     = AssetSprite2D("pokemon/sprites/tiles/fence.spr2d");
+    tileSpr[T_HOUSE]     = AssetSprite2D("pokemon/sprites/tiles/house.spr2d");
+    tileSpr[T_DOOR]      = AssetSprite2D("pokemon/sprites/tiles/door.spr2d");
+    tileSpr[T_SIGN]      = AssetSprite2D("pokemon/sprites/tiles/sign.spr2d");
+    tileSpr[T_POKECENTER]= AssetSprite2D("pokemon/sprites/tiles/pokecenter.spr2d");
+    tileSpr[T_FLOOR]     = AssetSprite2D("pokemon/sprites/tiles/floor.spr2d");
+    tileSprFloorDark     = AssetSprite2D("pokemon/sprites/tiles/floor_dark.spr2d");
+    tileSpr[T_COUNTER]   = AssetSprite2D("pokemon/sprites/tiles/counter.spr2d");
+    tileSpr[T_SHELF]     = AssetSprite2D("pokemon/sprites/tiles/shelf.spr2d");
+    tileSpr[T_EXIT]      = AssetSprite2D("pokemon/sprites/tiles/exit.spr2d");
+    tileSpr[T_RUG]       = AssetSprite2D("pokemon/sprites/tiles/rug_house.spr2d");
+    tileSprRugPC         = AssetSprite2D("pokemon/sprites/tiles/rug_pokecenter.spr2d");
 
     // Characters
-    sprPlayerDown.count = LoadSprite2D("pokemon/sprites/player_down.spr2d", sprPlayerDown.parts, MAX_SPRITE_PARTS);
-    sprPlayerUp.count   = LoadSprite2D("pokemon/sprites/player_up.spr2d",   sprPlayerUp.parts, MAX_SPRITE_PARTS);
-    sprPlayerSide.count = LoadSprite2D("pokemon/sprites/player_side.spr2d", sprPlayerSide.parts, MAX_SPRITE_PARTS);
-    sprNPC.count        = LoadSprite2D("pokemon/sprites/npc.spr2d",         sprNPC.parts, MAX_SPRITE_PARTS);
+    sprPlayerDown = AssetSprite2D("pokemon/sprites/player_down.spr2d");
+    sprPlayerUp   = AssetSprite2D("pokemon/sprites/player_up.spr2d");
+    sprPlayerSide = AssetSprite2D("pokemon/sprites/player_side.spr2d");
+    sprNPC        = AssetSprite2D("pokemon/sprites/npc.spr2d");
 }
 
 // --- Pokemon sprites loaded from .spr2d files ---
-#define MAX_PKM_SPRITE_PARTS 48
 #define MAX_PKM_SPRITES 10
 
 typedef struct {
     char name[32];
-    Sprite2DPart parts[MAX_PKM_SPRITE_PARTS];
-    int count;
+    SpriteData *spr;            // registry-owned; reloads swap in under it
 } PokemonSprite;
 
 static PokemonSprite pkmSprites[MAX_PKM_SPRITES];
 static int numPkmSprites = 0;
 
-// Load all pokemon sprite files from sprites/ directory
+// Request all pokemon sprite files from sprites/ directory
 void LoadPokemonSprites(void) {
     numPkmSprites = 0;
     const char *spriteFiles[] = {
@@ -241,10 +236,10 @@ void LoadPokemonSprites(void) {
     for (int i = 0; i < numFiles && numPkmSprites < MAX_PKM_SPRITES; i++) {
         char path[64];
         snprintf(path, sizeof(path), "pokemon/sprites/%s.spr2d", spriteFiles[i]);
-        int count = LoadSprite2D(path, pkmSprites[numPkmSprites].parts, MAX_PKM_SPRITE_PARTS);
-        if (count > 0) {
+        SpriteData *spr = AssetSprite2D(path);
+        if (spr) {
             strncpy(pkmSprites[numPkmSprites].name, spriteFiles[i], 31);
-            pkmSprites[numPkmSprites].count = count;
+            pkmSprites[numPkmSprites].spr = spr;
             numPkmSprites++;
         }
     }
@@ -264,20 +259,21 @@ void GetPokemonSpriteByName(const char *name, Sprite2DPart **parts, int *count)
             if (ca != cb) { match = false; break; }
             a++; b++;
         }
-        if (match) {
-            *parts = pkmSprites[i].parts;
-            *count = pkmSprites[i].count;
+        if (match && pkmSprites[i].spr->count > 0) {
+            *parts = pkmSprites[i].spr->parts;
+            *count = pkmSprites[i].spr->count;
             return;
         }
     }
-    // Fallback to first loaded sprite
-    if (numPkmSprites > 0) {
-        *parts = pkmSprites[0].parts;
-        *count = pkmSprites[0].count;
-    } else {
-        *parts = NULL;
-        *count = 0;
+    // Fallback to first sprite that loaded
+    for (int i = 0; i < numPkmSprites; i++) {
+        if (pkmSprites[i].spr->count == 0) continue;
+        *parts = pkmSprites[i].spr->parts;
+        *count = pkmSprites[i].spr->count;
+        return;
     }
+    *parts = NULL;
+    *count = 0;
 }
 
 Pokemon SpawnWild(void) {
@@ -524,10 +520,10 @@ void DrawTile(int tx, int ty, Vector2 offset) {
     int t = GetTile(tx, ty);
     switch (t) {
         case T_GRASS:
-            DrawTileSpr(&tileSpr[T_GRASS], x, y);
+            DrawTileSpr(tileSpr[T_GRASS], x, y);
             break;
         case T_TALLGRASS:
-            DrawTileSpr(&tileSpr[T_GRASS], x, y);
+            DrawTileSpr(tileSpr[T_GRASS], x, y);
             // Animated grass blades overlay
             for (int i = 0; i < 3; i++) {
                 float gx = x + 3 + i * 5;
@@ -537,7 +533,7 @@ void DrawTile(int tx, int ty, Vector2 offset) {
             }
             break;
         case T_WALL:
-            DrawTileSpr(&tileSpr[T_WALL], x, y);
+            DrawTileSpr(tileSpr[T_WALL], x, y);
             break;
         case T_WATER: {
             float wave = sinf(gameTime * 3.0f + tx + ty * 0.7f) * 0.3f;
@@ -551,10 +547,10 @@ void DrawTile(int tx, int ty, Vector2 offset) {
             break;
         }
         case T_PATH:
-            DrawTileSpr(&tileSpr[T_PATH], x, y);
+            DrawTileSpr(tileSpr[T_PATH], x, y);
             break;
         case T_TREE: {
-            DrawTileSpr(&tileSpr[T_TREE], x, y);
+            DrawTileSpr(tileSpr[T_TREE], x, y);
             // Animated dappled sunlight overlay
             int seed = tx * 7 + ty * 13;
             if (seed % 3 == 0) DrawCircle(x + 4, y + 3, 1, (Color){80, 200, 80, (unsigned char)(150 + sinf(gameTime + seed)*50)});
@@ -562,16 +558,16 @@ void DrawTile(int tx, int ty, Vector2 offset) {
             break;
         }
         case T_HOUSE:
-            DrawTileSpr(&tileSpr[T_HOUSE], x, y);
+            DrawTileSpr(tileSpr[T_HOUSE], x, y);
             break;
         case T_DOOR:
-            DrawTileSpr(&tileSpr[T_DOOR], x, y);
+            DrawTileSpr(tileSpr[T_DOOR], x, y);
             break;
         case T_FENCE:
-            DrawTileSpr(&tileSpr[T_FENCE], x, y);
+            DrawTileSpr(tileSpr[T_FENCE], x, y);
             break;
         case T_FLOWER: {
-            DrawTileSpr(&tileSpr[T_GRASS], x, y);
+            DrawTileSpr(tileSpr[T_GRASS], x, y);
             int fseed = tx * 11 + ty * 7;
             // Two flowers per tile, varied by position
             float sway = sinf(gameTime * 1.5f + fseed) * 0.8f;
@@ -599,18 +595,18 @@ void DrawTile(int tx, int ty, Vector2 offset) {
             break;
         }
         case T_SIGN:
-            DrawTileSpr(&tileSpr[T_SIGN], x, y);
+            DrawTileSpr(tileSpr[T_SIGN], x, y);
             break;
         case T_POKECENTER:
-            DrawTileSpr(&tileSpr[T_POKECENTER], x, y);
+            DrawTileSpr(tileSpr[T_POKECENTER], x, y);
             break;
         case T_FLOOR: {
             bool light = ((tx + ty) % 2 == 0);
-            DrawTileSpr(light ? &tileSpr[T_FLOOR] : &tileSprFloorDark, x, y);
+            DrawTileSpr(light ? tileSpr[T_FLOOR] : tileSprFloorDark, x, y);
             break;
         }
         case T_COUNTER:
-            DrawTileSpr(&tileSpr[T_COUNTER], x, y);
+            DrawTileSpr(tileSpr[T_COUNTER], x, y);
             // Pokecenter items overlay
             if (currentInterior >= 0 && interiors[currentInterior].isPokecenter) {
                 DrawCircle(x + 5, y + 3, 2, (Color){220, 50, 50, 255});
@@ -621,16 +617,16 @@ void DrawTile(int tx, int ty, Vector2 offset) {
             }
             break;
         case T_SHELF:
-            DrawTileSpr(&tileSpr[T_SHELF], x, y);
+            DrawTileSpr(tileSpr[T_SHELF], x, y);
             break;
         case T_EXIT:
-            DrawTileSpr(&tileSpr[T_EXIT], x, y);
+            DrawTileSpr(tileSpr[T_EXIT], x, y);
             break;
         case T_RUG:
             if (currentInterior >= 0 && interiors[currentInterior].isPokecenter)
-                DrawTileSpr(&tileSprRugPC, x, y);
+                DrawTileSpr(tileSprRugPC, x, y);
             else
-                DrawTileSpr(&tileSpr[T_RUG], x, y);
+                DrawTileSpr(tileSpr[T_RUG], x, y);
             break;
     }
 }
@@ -644,10 +640,10 @@ void DrawPlayer(Vector2 offset) {
 
     SpriteData *sd;
     switch (player.dir) {
-        case DIR_UP:    sd = &sprPlayerUp;   break;
+        case DIR_UP:    sd = sprPlayerUp;   break;
         case DIR_LEFT:
-        case DIR_RIGHT: sd = &sprPlayerSide; break;
-        default:        sd = &sprPlayerDown; break;
+        case DIR_RIGHT: sd = sprPlayerSide; break;
+        default:        sd = sprPlayerDown; break;
     }
     // Flip for left-facing (mirror X) — sprite eye faces right by default
     if (player.dir == DIR_LEFT) {
@@ -862,9 +858,13 @@ int main(void) {
     SetExitKey(0);  // disable ESC quit — we use ESC in menus
     SetTargetFPS(60);
 
+    PackMount("assets.pack");   // sprites from the asset-pack build if present, else text files
+    AssetsInit();               // edited .spr2d files reload while the game runs
     InitGame();
+    AssetsWaitLoaded();
 
     while (!WindowShouldClose()) {
+        AssetsUpdate();
         float dt = GetFrameTime();
         if (dt > 0.05f) dt = 0.05f;
         gameTime += dt;
@@ -1163,7 +1163,7 @@ int main(void) {
             if (currentInterior < 0) for (int i = 0; i < numNPCs; i++) {
                 float nx = offset.x + npcs[i].pos.x + 8;
                 float ny = offset.y + npcs[i].pos.y + 8;
-                DrawSprite2D(sprNPC.parts, sprNPC.count, nx, ny, 1.0f);
+                DrawSprite2D(sprNPC->parts, sprNPC->count, nx, ny, 1.0f);
                 if (!npcs[i].talked) {
                     DrawText("!", nx - 2, ny - 18, 8, RED);
                 }
@@ -1333,6 +1333,8 @@ int main(void) {
         EndDrawing();
     }
 
+    AssetsShutdown();
+    PackUnmount();
     CloseWindow();
     return 0;
 }
@@ -1,9 +1,15 @@
 #include "raylib.h"
 #include "raymath.h"
+#include "../common/util/sim.h"
 #include "../common/objects3d.h"
+#include "../common/util/math.h"
+#include "../common/util/loop.h"
+#include "../common/util/arena.h"
+#include "../common/util/camera.h"
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <time.h>
 
 // Sega Rally style: winding track with surface types, AI, dust effects
 
@@ -12,6 +18,7 @@
 #define BANK_WIDTH     5.0f  // horizontal reach of the grassy bank beyond each edge
 #define BANK_HEIGHT    0.4f  // vertical rise of the bank at its outer lip (just a shoulder)
 #define NUM_CARS       4
+#define SIM_HZ       120.0f  // fixed simulation tick rate
 #define TOTAL_LAPS     3
 #define MAX_DUST      80
 
@@ -21,6 +28,7 @@
 #define CAR_HANDBRAKE  18.0f   // Space handbrake — gentler, clamps at 0 (no reverse)
 #define CAR_MAX_SPEED  45.0f
 #define CAR_TURN        2.8f
+#define CAR_DRAG_HZ   144.0f   // the CAR_DRAG_* factors are per step at this rate (the old 144 FPS frame)
 #define CAR_DRAG_ROAD   0.992f
 #define CAR_DRAG_GRAVEL 0.990f
 #define CAR_DRAG_MUD    0.985f
@@ -52,6 +60,8 @@ typedef struct {
     Color color;
     float aiNoise;
     float steerInput;
+    Vector3 prevPos;     // pos/rotation at the start of the last tick (render lerp)
+    float prevRotation;
 } Car;
 
 // --- Skid marks (ring buffer) ---
@@ -112,6 +122,10 @@ static int dustIdx = 0;
 static Vector3 treePosns[MAX_TREES];
 static float treeSizes[MAX_TREES];
 static int numTrees = 0;
+// Bounding spheres of the trees (trunk + canopy), culled as one batch
+static float treeBX[MAX_TREES], treeBY[MAX_TREES], treeBZ[MAX_TREES], treeBR[MAX_TREES];
+static SphereSoA treeBounds = { treeBX, treeBY, treeBZ, treeBR, 0 };
+static VisibleList treeVis;
 
 #define MAX_BUILDINGS 28
 typedef struct { Vector3 pos; Vector3 size; float rotY; Color wall, roof; } Building;
@@ -152,7 +166,10 @@ static float cpSplitTimes[NUM_CHECKPOINTS] = {0};
 static int cpNextIdx = 0;
 static float cpFlashTimer = 0.0f;
 
-void GenerateTrack(void) {
+// Everything random about the circuit comes from `seed`: the same seed
+// rebuilds the same trees, buildings, props, fans and puddles.
+void GenerateTrack(uint64_t seed) {
+    Rng rng = RngStream(seed, RNG_STREAM_WORLD);
     // Winding rally course with varied curvature and gentle height.
     for (int i = 0; i < TRACK_SEGS; i++) {
         float t = (float)i / TRACK_SEGS * 2.0f * PI;
@@ -169,9 +186,13 @@ void GenerateTrack(void) {
         else trackSurface[i] = SURF_TARMAC;
     }
 
-    // Smooth track (all three axes).
-    for (int pass = 0; pass < 4; pass++) {
-        Vector3 temp[TRACK_SEGS];
+    // Smooth track (all three axes). The smoothing passes share one scratch
+    // copy: TRACK_SEGS Vector3s, far below the frame arena's size, so it only
+    // fails if the arena itself could not be created.
+    ArenaMark scratch = ScratchBegin();
+    Vector3 *temp = FRAME_NEW(Vector3, TRACK_SEGS);
+    if (!temp) TraceLog(LOG_ERROR, "RALLY: frame arena has no room to smooth the track");
+    for (int pass = 0; pass < 4 && temp; pass++) {
         for (int i = 0; i < TRACK_SEGS; i++) {
             int prev = (i - 1 + TRACK_SEGS) % TRACK_SEGS;
             int next = (i + 1) % TRACK_SEGS;
@@ -196,8 +217,7 @@ void GenerateTrack(void) {
 
     // Final light smoothing so ramp approach/landing isn't a cliff, then
     // shift so the lowest point sits on the ground plane (trees stay at y=0).
-    for (int pass = 0; pass < 1; pass++) {
-        Vector3 temp[TRACK_SEGS];
+    for (int pass = 0; pass < 1 && temp; pass++) {
         for (int i = 0; i < TRACK_SEGS; i++) {
             int prev = (i - 1 + TRACK_SEGS) % TRACK_SEGS;
             int next = (i + 1) % TRACK_SEGS;
@@ -210,6 +230,8 @@ void GenerateTrack(void) {
         for (int i = 0; i < TRACK_SEGS; i++) trackPts[i] = temp[i];
     }
 
+    ScratchEnd(scratch);
+
     float minY = 1e9f;
     for (int i = 0; i < TRACK_SEGS; i++) if (trackPts[i].y < minY) minY = trackPts[i].y;
     if (minY < 0.0f) for (int i = 0; i < TRACK_SEGS; i++) trackPts[i].y -= minY;
@@ -226,20 +248,26 @@ void GenerateTrack(void) {
     for (int i = 0; i < TRACK_SEGS && numTrees < MAX_TREES; i += 1) {
         for (int side = -1; side <= 1; side += 2) {
             if (numTrees >= MAX_TREES) break;
-            if (GetRandomValue(0, 3) != 0) continue; // sparse
+            if (RngInt(&rng, 0, 3) != 0) continue; // sparse
             // Keep trees clear of the bank geometry (road edge + BANK_WIDTH)
             // — they'd otherwise be swallowed by the sloping bank quads.
             float offset = (TRACK_WIDTH / 2.0f) + BANK_WIDTH + 1.5f
-                         + (float)GetRandomValue(0, 10);
+                         + (float)RngInt(&rng, 0, 10);
             treePosns[numTrees] = Vector3Add(trackPts[i], Vector3Scale(trackNormals[i], side * offset));
             // Plant the tree at its adjacent track segment's height so it
             // rides the same terrain as the road — the flat ground plane
             // is way below once the track gains height variation.
             treePosns[numTrees].y = trackPts[i].y;
-            treeSizes[numTrees] = 1.0f + (float)GetRandomValue(0, 10) / 10.0f;
+            treeSizes[numTrees] = 1.0f + (float)RngInt(&rng, 0, 10) / 10.0f;
+            // DrawTree reaches ~3*size up and ~size out: centre halfway up
+            treeBX[numTrees] = treePosns[numTrees].x;
+            treeBY[numTrees] = treePosns[numTrees].y + treeSizes[numTrees] * 1.5f;
+            treeBZ[numTrees] = treePosns[numTrees].z;
+            treeBR[numTrees] = treeSizes[numTrees] * 1.8f;
             numTrees++;
         }
     }
+    treeBounds.count = numTrees;
 
     // Place buildings sparsely further out than the trees. Each building
     // is a coloured box with a pitched roof; rotated to face the track.
@@ -258,25 +286,25 @@ void GenerateTrack(void) {
     for (int i = 0; i < TRACK_SEGS && numBuildings < MAX_BUILDINGS; i += 2) {
         for (int side = -1; side <= 1; side += 2) {
             if (numBuildings >= MAX_BUILDINGS) break;
-            if (GetRandomValue(0, 5) != 0) continue;  // very sparse
+            if (RngInt(&rng, 0, 5) != 0) continue;  // very sparse
 
             float offset = (TRACK_WIDTH / 2.0f) + BANK_WIDTH + 18.0f
-                         + (float)GetRandomValue(0, 20);
+                         + (float)RngInt(&rng, 0, 20);
             Vector3 p = Vector3Add(trackPts[i], Vector3Scale(trackNormals[i], side * offset));
             p.y = trackPts[i].y;
 
             Building *b = &buildings[numBuildings++];
             b->pos  = p;
             b->size = (Vector3){
-                4.0f + (float)GetRandomValue(0, 40) / 10.0f,  // width 4–8
-                3.0f + (float)GetRandomValue(0, 60) / 10.0f,  // height 3–9
-                4.0f + (float)GetRandomValue(0, 40) / 10.0f,  // depth 4–8
+                4.0f + (float)RngInt(&rng, 0, 40) / 10.0f,  // width 4–8
+                3.0f + (float)RngInt(&rng, 0, 60) / 10.0f,  // height 3–9
+                4.0f + (float)RngInt(&rng, 0, 40) / 10.0f,  // depth 4–8
             };
             // Face roughly toward the track (flip if on the far side).
             float toTrack = atan2f(-trackNormals[i].x * side, -trackNormals[i].z * side);
-            b->rotY = toTrack + ((float)GetRandomValue(-20, 20)) * 0.01f;
-            b->wall = wallPalette[GetRandomValue(0, paletteWalls - 1)];
-            b->roof = roofPalette[GetRandomValue(0, paletteRoofs - 1)];
+            b->rotY = toTrack + ((float)RngInt(&rng, -20, 20)) * 0.01f;
+            b->wall = wallPalette[RngInt(&rng, 0, paletteWalls - 1)];
+            b->roof = roofPalette[RngInt(&rng, 0, paletteRoofs - 1)];
         }
     }
 
@@ -298,14 +326,14 @@ void GenerateTrack(void) {
             pr->alive = true;
         }
         // Crates scattered in the road (rare — don't clog every lap).
-        if (GetRandomValue(0, 7) == 0 && numProps < MAX_PROPS) {
-            float off = ((float)GetRandomValue(-30, 30)) / 10.0f;  // -3..3 from centerline
+        if (RngInt(&rng, 0, 7) == 0 && numProps < MAX_PROPS) {
+            float off = ((float)RngInt(&rng, -30, 30)) / 10.0f;  // -3..3 from centerline
             Vector3 p = Vector3Add(trackPts[i], Vector3Scale(trackNormals[i], off));
             p.y = trackPts[i].y + 0.4f;  // half-height above road
             Prop *pr = &props[numProps++];
             pr->pos = p;
             pr->size = (Vector3){0.8f, 0.8f, 0.8f};
-            pr->rotY = (float)GetRandomValue(0, 314) * 0.01f;
+            pr->rotY = (float)RngInt(&rng, 0, 314) * 0.01f;
             pr->type = PROP_CRATE;
             pr->alive = true;
         }
@@ -322,18 +350,18 @@ void GenerateTrack(void) {
     for (int i = 1; i < TRACK_SEGS && numFans < MAX_FANS; i += 2) {
         for (int side = -1; side <= 1; side += 2) {
             if (numFans >= MAX_FANS) break;
-            if (GetRandomValue(0, 2) != 0) continue;   // not every segment
-            int cluster = GetRandomValue(2, 4);
+            if (RngInt(&rng, 0, 2) != 0) continue;   // not every segment
+            int cluster = RngInt(&rng, 2, 4);
             for (int c = 0; c < cluster && numFans < MAX_FANS; c++) {
                 float radial = (TRACK_WIDTH / 2.0f) + BANK_WIDTH + 1.0f
-                             + (float)GetRandomValue(0, 15) / 10.0f;
-                float lateral = ((float)GetRandomValue(-20, 20)) / 10.0f;
+                             + (float)RngInt(&rng, 0, 15) / 10.0f;
+                float lateral = ((float)RngInt(&rng, -20, 20)) / 10.0f;
                 Vector3 p = Vector3Add(trackPts[i], Vector3Scale(trackNormals[i], side * radial));
                 p = Vector3Add(p, Vector3Scale(trackDirs[i], lateral));
                 p.y = trackPts[i].y;
                 fans[numFans].pos = p;
-                fans[numFans].shirt = shirtPalette[GetRandomValue(0, shirtCount - 1)];
-                fans[numFans].phase = (float)GetRandomValue(0, 628) / 100.0f;
+                fans[numFans].shirt = shirtPalette[RngInt(&rng, 0, shirtCount - 1)];
+                fans[numFans].phase = (float)RngInt(&rng, 0, 628) / 100.0f;
                 numFans++;
             }
         }
@@ -343,12 +371,12 @@ void GenerateTrack(void) {
     numPuddles = 0;
     for (int i = 0; i < TRACK_SEGS && numPuddles < MAX_PUDDLES; i++) {
         if (trackSurface[i] != SURF_MUD) continue;
-        if (GetRandomValue(0, 2) != 0) continue;
-        float off = ((float)GetRandomValue(-35, 35)) / 10.0f;
+        if (RngInt(&rng, 0, 2) != 0) continue;
+        float off = ((float)RngInt(&rng, -35, 35)) / 10.0f;
         Vector3 p = Vector3Add(trackPts[i], Vector3Scale(trackNormals[i], off));
         p.y = trackPts[i].y + 0.015f;  // flush on the road
         puddles[numPuddles].pos = p;
-        puddles[numPuddles].radius = 0.9f + (float)GetRandomValue(0, 16) / 10.0f;
+        puddles[numPuddles].radius = 0.9f + (float)RngInt(&rng, 0, 16) / 10.0f;
         numPuddles++;
     }
 }
@@ -430,11 +458,11 @@ void SpawnDust(Vector3 pos, Color col) {
     d->pos = pos;  // caller is responsible for Y; with track height variation,
                    // spawning at a fixed y buried the dust under the road.
     d->vel = (Vector3){
-        (float)GetRandomValue(-20, 20) / 10.0f,
-        (float)GetRandomValue(5, 20) / 10.0f,
-        (float)GetRandomValue(-20, 20) / 10.0f
+        (float)RngInt(&fxRng, -20, 20) / 10.0f,
+        (float)RngInt(&fxRng, 5, 20) / 10.0f,
+        (float)RngInt(&fxRng, -20, 20) / 10.0f
     };
-    d->life = 0.5f + (float)GetRandomValue(0, 30) / 100.0f;
+    d->life = 0.5f + (float)RngInt(&fxRng, 0, 30) / 100.0f;
     d->color = col;
     d->active = true;
     dustIdx = (dustIdx + 1) % MAX_DUST;
@@ -714,7 +742,7 @@ static void ArcTextMono(const char *t, int x, int y, int size, Color col) {
 }
 
 static int NUM_CARS_RENDER = 4;  // populated from compile-time NUM_CARS
-static void DrawScene3D(Car *cars_arr, float rTimer);
+static void DrawScene3D(Car *cars_arr, float rTimer, const Frustum *view);
 
 void DrawCar(Car *car, int colorIdx) {
     // Copy parts and tint body color
@@ -758,7 +786,7 @@ void DrawCar(Car *car, int colorIdx) {
     if (car->drifting && car->speed > 10) {
         float cs = cosf(car->rotation), sn = sinf(car->rotation);
         Vector3 rearPos = { car->pos.x - sn * 0.8f, car->pos.y - 0.1f, car->pos.z + cs * 0.8f };
-        if (GetRandomValue(0, 2) == 0) SpawnDust(rearPos, (Color){200,200,200,150});
+        if (RngInt(&fxRng, 0, 2) == 0) SpawnDust(rearPos, (Color){200,200,200,150});
     }
 
     // Surface dust
@@ -767,12 +795,14 @@ void DrawCar(Car *car, int colorIdx) {
         float cs = cosf(car->rotation), sn = sinf(car->rotation);
         Vector3 rearPos = { car->pos.x - sn * 0.9f, car->pos.y - 0.1f, car->pos.z + cs * 0.9f };
         Color dustCol = (surf == SURF_GRAVEL) ? (Color){180,160,120,120} : (Color){100,80,50,120};
-        if (GetRandomValue(0, 1) == 0) SpawnDust(rearPos, dustCol);
+        if (RngInt(&fxRng, 0, 1) == 0) SpawnDust(rearPos, dustCol);
     }
 
 }
 
-static void DrawScene3D(Car *cars_arr, float rTimer) {
+// Draws only what the view frustum can see: the scene is drawn twice a
+// frame (mirror + main) and each camera sees well under half of it.
+static void DrawScene3D(Car *cars_arr, float rTimer, const Frustum *view) {
     DrawPlane((Vector3){0, -0.02f, 0}, (Vector2){500, 500}, (Color){60, 100, 40, 255});
     DrawTrack();
 
@@ -796,11 +826,24 @@ static void DrawScene3D(Car *cars_arr, float rTimer) {
         DrawTriangle3D(p1, p4, p3, sc);
     }
 
-    for (int i = 0; i < numBuildings; i++) DrawBuilding(&buildings[i]);
-    for (int i = 0; i < numProps; i++) DrawProp(&props[i]);
-    for (int i = 0; i < numFans; i++) DrawFan(&fans[i], rTimer);
+    for (int i = 0; i < numBuildings; i++) {
+        const Building *b = &buildings[i];
+        // Walls plus the roof peak (0.45 of the wall height above it)
+        Vector3 c = { b->pos.x, b->pos.y + b->size.y * 0.725f, b->pos.z };
+        float r = 0.5f * Vector3Length((Vector3){ b->size.x, b->size.y * 1.45f, b->size.z });
+        if (FrustumSphere(view, c, r)) DrawBuilding(b);
+    }
+    for (int i = 0; i < numProps; i++) {
+        // Sphere bound: stays valid while the debris tumbles
+        if (FrustumSphere(view, props[i].pos, 0.5f * Vector3Length(props[i].size))) DrawProp(&props[i]);
+    }
+    for (int i = 0; i < numFans; i++) {
+        Vector3 c = { fans[i].pos.x, fans[i].pos.y + 0.8f, fans[i].pos.z };
+        if (FrustumSphere(view, c, 1.0f)) DrawFan(&fans[i], rTimer);
+    }
     for (int i = 0; i < NUM_CHECKPOINTS; i++) DrawCheckpoint(CHECKPOINT_SEGS[i], i);
     for (int i = 0; i < numPuddles; i++) {
+        if (!FrustumSphere(view, puddles[i].pos, puddles[i].radius)) continue;
         Vector3 a = puddles[i].pos;
         Vector3 b = (Vector3){ a.x, a.y + 0.005f, a.z };
         DrawCylinderEx(a, b, puddles[i].radius, puddles[i].radius, 14,
@@ -808,36 +851,42 @@ static void DrawScene3D(Car *cars_arr, float rTimer) {
         DrawCylinderWiresEx(a, b, puddles[i].radius, puddles[i].radius, 14,
                             (Color){80, 140, 190, 200});
     }
-    for (int i = 0; i < numTrees; i++) DrawTree(treePosns[i], treeSizes[i]);
+    VisibleListBegin(&treeVis, view);
+    VisibleListAddSpheres(&treeVis, 0, &treeBounds);
+    for (int v = 0; v < treeVis.count; v++) {
+        int i = treeVis.ids[v];
+        DrawTree(treePosns[i], treeSizes[i]);
+    }
     for (int i = 0; i < MAX_DUST; i++) {
-        if (!dust[i].active) continue;
+        if (!dust[i].active || !FrustumSphere(view, dust[i].pos, 0.3f)) continue;
         float alpha = dust[i].life / 0.6f;
         Color dc = dust[i].color;
         dc.a = (unsigned char)(alpha * dc.a);
         DrawSphere(dust[i].pos, 0.1f + (1.0f - alpha) * 0.2f, dc);
     }
+    // Cars stay unculled: DrawCar also spawns their smoke and dust.
     for (int ci = 0; ci < NUM_CARS_RENDER; ci++) DrawCar(&cars_arr[ci], ci);
 }
 
-int main(void) {
-    InitWindow(800, 600, "Rally Racing");
-    SetTargetFPS(144);
-    SetWindowState(FLAG_WINDOW_RESIZABLE);
-    MaximizeWindow();
-
-    // Rear-view mirror render texture. Wider aspect (~4.3:1) so the
-    // mirror shows a lot of road behind and reads at a glance.
-    RenderTexture2D mirrorRT = LoadRenderTexture(860, 200);
-    SetTextureFilter(mirrorRT.texture, TEXTURE_FILTER_BILINEAR);
-    NUM_CARS_RENDER = NUM_CARS;
-
-    GenerateTrack();
-
-    // Init cars
-    Car cars[NUM_CARS] = {0};
+// Race state, stepped by UpdateRace
+static Car cars[NUM_CARS];
+static float countdown;
+static bool raceStarted;
+static int playerRank;
+static float bestLapTime;
+static float lapTimer;
+static float raceTimer;
+static float splitTimes[TOTAL_LAPS];
+static Rng raceRng;   // gameplay randomness inside UpdateRace
+
+// Cars on the grid, lights about to start. Call after GenerateTrack.
+static void InitRace(uint64_t seed) {
+    raceRng = RngStream(seed, RNG_STREAM_GAMEPLAY);
+    Rng ai = RngStream(seed, RNG_STREAM_AI);
     Color carColors[] = { {200,40,40,255}, {40,40,200,255}, {40,180,40,255}, {220,200,40,255} };
     for (int i = 0; i < NUM_CARS; i++) {
         float offset = ((float)i - (NUM_CARS - 1) * 0.5f) * 3.0f;
+        cars[i] = (Car){0};
         cars[i].pos = Vector3Add(trackPts[0], Vector3Scale(trackNormals[0], offset));
         cars[i].pos.y = trackPts[0].y + 0.2f;
         cars[i].rotation = atan2f(trackDirs[0].x, trackDirs[0].z);
@@ -857,401 +906,489 @@ int main(void) {
         cars[i].drifting = false;
         cars[i].driftTime = 0;
         cars[i].color = carColors[i];
-        cars[i].aiNoise = (float)GetRandomValue(-20, 20) / 100.0f;
+        cars[i].aiNoise = (float)RngInt(&ai, -20, 20) / 100.0f;
         cars[i].steerInput = 0;
+        cars[i].prevPos = cars[i].pos;
+        cars[i].prevRotation = cars[i].rotation;
     }
+    countdown = 3.99f;
+    raceStarted = false;
+    playerRank = 1;
+    bestLapTime = 999.0f;
+    lapTimer = 0;
+    raceTimer = 0;
+    for (int i = 0; i < TOTAL_LAPS; i++) splitTimes[i] = 0;
+}
 
-    Camera3D camera = { 0 };
-    camera.up = (Vector3){0, 1, 0};
-    camera.fovy = 55;
-    camera.projection = CAMERA_PERSPECTIVE;
-
-    float countdown = 3.99f;
-    bool raceStarted = false;
-    int playerRank = 1;
-    float bestLapTime = 999.0f;
-    float lapTimer = 0;
-    float raceTimer = 0;
-    float splitTimes[TOTAL_LAPS] = {0};
-    float finishCinTime = 0.0f;  // seconds since player crossed finish line
-
-    while (!WindowShouldClose()) {
-        float dt = GetFrameTime();
-        if (dt > 0.033f) dt = 0.033f;
-        int sw = GetScreenWidth(), sh = GetScreenHeight();
-
-        countdown -= dt;
-        if (!raceStarted && countdown <= 0) raceStarted = true;
-        if (raceStarted && !cars[0].finished) { raceTimer += dt; lapTimer += dt; }
+// One fixed simulation tick
+static void UpdateRace(float dt) {
+    for (int ci = 0; ci < NUM_CARS; ci++) {
+        cars[ci].prevPos = cars[ci].pos;
+        cars[ci].prevRotation = cars[ci].rotation;
+    }
 
-        // --- Update cars ---
-        for (int ci = 0; ci < NUM_CARS; ci++) {
-            Car *car = &cars[ci];
-            if (car->finished) continue;
-
-            float accel = 0, steer = 0;
-            SurfaceType surf = GetSurface(car->pos);
-            float maxSpd = CAR_MAX_SPEED;
-            float drag;
-            float surfTurnMult = 1.0f;  // extra oversteer on loose surfaces
-            switch (surf) {
-                case SURF_TARMAC: drag = CAR_DRAG_ROAD; surfTurnMult = 1.0f; break;
-                case SURF_GRAVEL: drag = CAR_DRAG_GRAVEL; maxSpd *= 0.95f; surfTurnMult = 1.4f; break;
-                case SURF_MUD:    drag = CAR_DRAG_MUD; maxSpd *= 0.9f; surfTurnMult = 1.8f; break;
-            }
+    countdown -= dt;
+    if (!raceStarted && countdown <= 0) raceStarted = true;
+    if (raceStarted && !cars[0].finished) { raceTimer += dt; lapTimer += dt; }
+
+    // --- Update cars ---
+    SIM_SECTION("cars")
+    for (int ci = 0; ci < NUM_CARS; ci++) {
+        Car *car = &cars[ci];
+        if (car->finished) continue;
+
+        float accel = 0, steer = 0;
+        SurfaceType surf = GetSurface(car->pos);
+        float maxSpd = CAR_MAX_SPEED;
+        float drag;
+        float surfTurnMult = 1.0f;  // extra oversteer on loose surfaces
+        switch (surf) {
+            case SURF_TARMAC: drag = CAR_DRAG_ROAD; surfTurnMult = 1.0f; break;
+            case SURF_GRAVEL: drag = CAR_DRAG_GRAVEL; maxSpd *= 0.95f; surfTurnMult = 1.4f; break;
+            case SURF_MUD:    drag = CAR_DRAG_MUD; maxSpd *= 0.9f; surfTurnMult = 1.8f; break;
+        }
 
-            if (!raceStarted) goto moveCar;
-
-            bool handbraking = false;
-            if (car->isPlayer) {
-                if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_W))    accel = CAR_ACCEL;
-                if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S))  accel = -CAR_BRAKE;
-                if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A))  steer = CAR_TURN;
-                if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) steer = -CAR_TURN;
-
-                // Space held: either drift (when turning at speed) or
-                // straight-line handbrake (when not).
-                bool spaceHeld = IsKeyDown(KEY_SPACE);
-                if (spaceHeld && fabsf(steer) > 0.1f && car->speed > 15.0f) {
-                    // DRIFT: skid through the corner. W/S accel stays active
-                    // so the player can throttle through the slide; drift
-                    // drag + boosted turn do the work without bleeding speed.
-                    car->drifting = true;
-                    car->driftTime += dt;
-                    steer *= CAR_DRIFT_MULT;
-                    drag = CAR_DRIFT_DRAG;
-                } else {
-                    car->drifting = false;
-                    car->driftTime = 0;
-                    if (spaceHeld) handbraking = true;  // straight-line handbrake
-                }
+        if (!raceStarted) goto moveCar;
+
+        bool handbraking = false;
+        if (car->isPlayer) {
+            if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_W))    accel = CAR_ACCEL;
+            if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S))  accel = -CAR_BRAKE;
+            if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A))  steer = CAR_TURN;
+            if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) steer = -CAR_TURN;
+
+            // Space held: either drift (when turning at speed) or
+            // straight-line handbrake (when not).
+            bool spaceHeld = IsKeyDown(KEY_SPACE);
+            if (spaceHeld && fabsf(steer) > 0.1f && car->speed > 15.0f) {
+                // DRIFT: skid through the corner. W/S accel stays active
+                // so the player can throttle through the slide; drift
+                // drag + boosted turn do the work without bleeding speed.
+                car->drifting = true;
+                car->driftTime += dt;
+                steer *= CAR_DRIFT_MULT;
+                drag = CAR_DRIFT_DRAG;
             } else {
-                // AI
-                Vector3 target = trackPts[car->nextWP];
-                target = Vector3Add(target, Vector3Scale(trackNormals[car->nextWP], car->aiNoise * TRACK_WIDTH * 0.3f));
-                Vector3 toTarget = Vector3Subtract(target, car->pos);
-                toTarget.y = 0;
-                float targetAngle = atan2f(toTarget.x, toTarget.z);
-                float angleDiff = targetAngle - car->rotation;
-                while (angleDiff > PI)  angleDiff -= 2*PI;
-                while (angleDiff < -PI) angleDiff += 2*PI;
-                steer = Clamp(angleDiff * 3.0f, -CAR_TURN, CAR_TURN);
-                accel = CAR_ACCEL * 1.00f;  // was 0.88 — AI now matches player throttle
-
-                // Rubber banding: closer catch-up, softer ease-off.
-                float playerProg = CarProgress(&cars[0]);
-                float myProg = CarProgress(car);
-                if (myProg > playerProg + 5) accel *= 0.80f;
-                else if (myProg < playerProg - 5) accel *= 1.25f;
-
-                // Brake for sharp corners
-                if (fabsf(angleDiff) > 0.6f) accel *= 0.5f;
+                car->drifting = false;
+                car->driftTime = 0;
+                if (spaceHeld) handbraking = true;  // straight-line handbrake
             }
+        } else {
+            // AI
+            Vector3 target = trackPts[car->nextWP];
+            target = Vector3Add(target, Vector3Scale(trackNormals[car->nextWP], car->aiNoise * TRACK_WIDTH * 0.3f));
+            Vector3 toTarget = Vector3Subtract(target, car->pos);
+            toTarget.y = 0;
+            float targetAngle = atan2f(toTarget.x, toTarget.z);
+            float angleDiff = targetAngle - car->rotation;
+            while (angleDiff > PI)  angleDiff -= 2*PI;
+            while (angleDiff < -PI) angleDiff += 2*PI;
+            steer = Clamp(angleDiff * 3.0f, -CAR_TURN, CAR_TURN);
+            accel = CAR_ACCEL * 1.00f;  // was 0.88 — AI now matches player throttle
+
+            // Rubber banding: closer catch-up, softer ease-off.
+            float playerProg = CarProgress(&cars[0]);
+            float myProg = CarProgress(car);
+            if (myProg > playerProg + 5) accel *= 0.80f;
+            else if (myProg < playerProg - 5) accel *= 1.25f;
+
+            // Brake for sharp corners
+            if (fabsf(angleDiff) > 0.6f) accel *= 0.5f;
+        }
 
-            // No throttle / steering / drag while airborne — the car
-            // coasts along its launch velocity until it lands.
-            if (car->airborne) { accel = 0; steer = 0; drag = 1.0f; }
-
-            // Physics
-            if (handbraking) {
-                // Handbrake decelerates toward 0 from either direction and
-                // holds there — reverse requires S / Down.
-                float dv = CAR_HANDBRAKE * dt;
-                if      (car->speed >  dv) car->speed -= dv;
-                else if (car->speed < -dv) car->speed += dv;
-                else                       car->speed  = 0.0f;
-            } else {
-                car->speed += accel * dt;
-            }
-            car->speed *= drag;
-            car->speed = Clamp(car->speed, -10.0f, maxSpd);
-            car->steerInput = steer;
+        // No throttle / steering / drag while airborne — the car
+        // coasts along its launch velocity until it lands.
+        if (car->airborne) { accel = 0; steer = 0; drag = 1.0f; }
+
+        // Physics
+        if (handbraking) {
+            // Handbrake decelerates toward 0 from either direction and
+            // holds there — reverse requires S / Down.
+            float dv = CAR_HANDBRAKE * dt;
+            if      (car->speed >  dv) car->speed -= dv;
+            else if (car->speed < -dv) car->speed += dv;
+            else                       car->speed  = 0.0f;
+        } else {
+            car->speed += accel * dt;
+        }
+        car->speed *= powf(drag, dt * CAR_DRAG_HZ);   // same handling at any SIM_HZ
+        car->speed = Clamp(car->speed, -10.0f, maxSpd);
+        car->steerInput = steer;
 
 moveCar:;
-            // Bicycle model: rear-wheel drive, front-wheel steering
-            // No turning without speed — wheels must be rolling
-            // Bicycle geometry: turn radius = wheelbase / tan(steerAngle).
-            // With wheelbase=3.0 and maxSteerAngle=0.13 on tarmac, radius is
-            // ~23 units — a proper rally car's turning circle. Drift (1.6×)
-            // and loose-surface mult (1.4×–1.8×) tighten it meaningfully.
-            float wheelbase = 3.0f;
-            float maxSteerAngle = 0.13f * surfTurnMult;
-            float steerAngle = steer / CAR_TURN * maxSteerAngle;  // normalize steer input
-            if (car->speed < 0) steerAngle = -steerAngle;
-
-            float cs = cosf(car->rotation), sn = sinf(car->rotation);
-
-            if (fabsf(car->speed) > 0.5f) {
-                // Rotation only updates while the wheels are on the road —
-                // in the air the car holds its heading.
-                if (!car->airborne) {
-                    float angularVel = car->speed * tanf(steerAngle) / wheelbase;
-                    car->rotation += angularVel * dt;
-                }
+        // Bicycle model: rear-wheel drive, front-wheel steering
+        // No turning without speed — wheels must be rolling
+        // Bicycle geometry: turn radius = wheelbase / tan(steerAngle).
+        // With wheelbase=3.0 and maxSteerAngle=0.13 on tarmac, radius is
+        // ~23 units — a proper rally car's turning circle. Drift (1.6×)
+        // and loose-surface mult (1.4×–1.8×) tighten it meaningfully.
+        float wheelbase = 3.0f;
+        float maxSteerAngle = 0.13f * surfTurnMult;
+        float steerAngle = steer / CAR_TURN * maxSteerAngle;  // normalize steer input
+        if (car->speed < 0) steerAngle = -steerAngle;
 
-                // Move the whole car forward in its (now updated) facing direction
-                float newCs = cosf(car->rotation), newSn = sinf(car->rotation);
-                car->pos.x += newSn * car->speed * dt;
-                car->pos.z += newCs * car->speed * dt;
-            }
-            // Refresh currentSeg before reading TrackHeightAt so a
-            // segment-boundary crossing doesn't alias targetY against the
-            // old segment.
-            car->prevSeg = car->currentSeg;
-            car->currentSeg = NearestSegLocal(car->pos, car->currentSeg);
-
-            // --- Vertical / airborne physics ---
-            // Natural hills just follow the road — only the explicit ramps
-            // launch the car. This keeps flat / rolling terrain stable.
-            {
-                float targetY = TrackHeightAt(car->pos, car->currentSeg);
-                if (car->airborne) {
-                    car->velY -= RALLY_GRAVITY * dt;
-                    car->pos.y += car->velY * dt;
-                    if (car->pos.y <= targetY) {
-                        car->pos.y = targetY;
-                        car->velY = 0.0f;
-                        car->airborne = false;
-                    }
-                } else {
-                    if (car->rampCooldown > 0.0f) car->rampCooldown -= dt;
-                    bool justEnteredRamp =
-                        (car->currentSeg != car->prevSeg) && IsRampSeg(car->currentSeg);
-                    if (justEnteredRamp && fabsf(car->speed) > 15.0f
-                        && car->rampCooldown <= 0.0f) {
-                        car->airborne = true;
-                        // Modest launch — speed-scaled with a firm cap so
-                        // even top-speed hits stay in rally territory.
-                        float launch = 4.0f + fabsf(car->speed) * 0.2f;
-                        if (launch > 13.0f) launch = 13.0f;
-                        car->velY = launch;
-                        // 0.6s lock-out: stops re-launch if currentSeg
-                        // re-crosses the ramp due to corner jitter.
-                        car->rampCooldown = 0.6f;
-                        car->pos.y = targetY;
-                    } else {
-                        // Glued to the road.
-                        car->pos.y = targetY;
-                        car->velY = 0.0f;
-                    }
-                }
+        float cs = cosf(car->rotation), sn = sinf(car->rotation);
+
+        if (fabsf(car->speed) > 0.5f) {
+            // Rotation only updates while the wheels are on the road —
+            // in the air the car holds its heading.
+            if (!car->airborne) {
+                float angularVel = car->speed * tanf(steerAngle) / wheelbase;
+                car->rotation += angularVel * dt;
             }
 
-            // --- Visual lean / tilt (cosmetic, does not affect physics) ---
-            {
-                float steerMag  = car->steerInput / CAR_TURN;
-                float speedFrac = fabsf(car->speed) / CAR_MAX_SPEED;
-                // Subtle body lean — a real rally car rolls maybe 3–5° in a
-                // hard corner. 0.22 rad at 1.8× drift mult was ~22°, enough
-                // that the inside wheels lifted off the road visually.
-                float targetRoll = -steerMag * speedFrac * 0.08f;
-                if (car->drifting)  targetRoll *= 1.4f;
-                if (car->airborne)  targetRoll *= 0.3f;
-
-                float targetPitch = 0.0f;
-                if (car->airborne) {
-                    float v = car->velY;
-                    if (v >  15.0f) v =  15.0f;
-                    if (v < -15.0f) v = -15.0f;
-                    targetPitch = -v * 0.025f;  // nose up while rising
+            // Move the whole car forward in its (now updated) facing direction
+            float newCs = cosf(car->rotation), newSn = sinf(car->rotation);
+            car->pos.x += newSn * car->speed * dt;
+            car->pos.z += newCs * car->speed * dt;
+        }
+        // Refresh currentSeg before reading TrackHeightAt so a
+        // segment-boundary crossing doesn't alias targetY against the
+        // old segment.
+        car->prevSeg = car->currentSeg;
+        car->currentSeg = NearestSegLocal(car->pos, car->currentSeg);
+
+        // --- Vertical / airborne physics ---
+        // Natural hills just follow the road — only the explicit ramps
+        // launch the car. This keeps flat / rolling terrain stable.
+        {
+            float targetY = TrackHeightAt(car->pos, car->currentSeg);
+            if (car->airborne) {
+                car->velY -= RALLY_GRAVITY * dt;
+                car->pos.y += car->velY * dt;
+                if (car->pos.y <= targetY) {
+                    car->pos.y = targetY;
+                    car->velY = 0.0f;
+                    car->airborne = false;
+                }
+            } else {
+                if (car->rampCooldown > 0.0f) car->rampCooldown -= dt;
+                bool justEnteredRamp =
+                    (car->currentSeg != car->prevSeg) && IsRampSeg(car->currentSeg);
+                if (justEnteredRamp && fabsf(car->speed) > 15.0f
+                    && car->rampCooldown <= 0.0f) {
+                    car->airborne = true;
+                    // Modest launch — speed-scaled with a firm cap so
+                    // even top-speed hits stay in rally territory.
+                    float launch = 4.0f + fabsf(car->speed) * 0.2f;
+                    if (launch > 13.0f) launch = 13.0f;
+                    car->velY = launch;
+                    // 0.6s lock-out: stops re-launch if currentSeg
+                    // re-crosses the ramp due to corner jitter.
+                    car->rampCooldown = 0.6f;
+                    car->pos.y = targetY;
                 } else {
-                    int next = (car->currentSeg + 1) % TRACK_SEGS;
-                    float dx = XZDistance(trackPts[next], trackPts[car->currentSeg]);
-                    float dy = trackPts[next].y - trackPts[car->currentSeg].y;
-                    if (dx > 0.001f) targetPitch = -atan2f(dy, dx);
+                    // Glued to the road.
+                    car->pos.y = targetY;
+                    car->velY = 0.0f;
                 }
-
-                // Exponential-style smoothing so motion reads dynamic but stays framerate-safe.
-                float rRate = 1.0f - expf(-10.0f * dt);
-                float pRate = 1.0f - expf(-6.0f  * dt);
-                car->visRoll  += (targetRoll  - car->visRoll)  * rRate;
-                car->visPitch += (targetPitch - car->visPitch) * pRate;
             }
+        }
 
-            // --- Skid marks: spawn rear-wheel streaks while drifting on ground. ---
-            if (car->drifting && !car->airborne && fabsf(car->speed) > 5.0f) {
-                // Rear-wheel body offsets (matches carBody RL / RR parts).
-                // Y = car->pos.y - 0.18 puts the streak flush on the road
-                // (car->pos.y = track+0.2, so track+0.02 = car->pos.y-0.18).
-                Vector3 lBody = { -0.45f, 0, -0.7f };
-                Vector3 rBody = {  0.45f, 0, -0.7f };
-                Vector3 lWorld = Vector3Add(car->pos, RotateY(lBody, -car->rotation));
-                Vector3 rWorld = Vector3Add(car->pos, RotateY(rBody, -car->rotation));
-                lWorld.y = car->pos.y - 0.18f;
-                rWorld.y = car->pos.y - 0.18f;
-                if (car->hasPrevWheels) {
-                    skids[skidIdx] = (Skid){ car->prevRearL, lWorld, true };
-                    skidIdx = (skidIdx + 1) % MAX_SKIDS;
-                    skids[skidIdx] = (Skid){ car->prevRearR, rWorld, true };
-                    skidIdx = (skidIdx + 1) % MAX_SKIDS;
-                }
-                car->prevRearL = lWorld;
-                car->prevRearR = rWorld;
-                car->hasPrevWheels = true;
+        // --- Visual lean / tilt (cosmetic, does not affect physics) ---
+        {
+            float steerMag  = car->steerInput / CAR_TURN;
+            float speedFrac = fabsf(car->speed) / CAR_MAX_SPEED;
+            // Subtle body lean — a real rally car rolls maybe 3–5° in a
+            // hard corner. 0.22 rad at 1.8× drift mult was ~22°, enough
+            // that the inside wheels lifted off the road visually.
+            float targetRoll = -steerMag * speedFrac * 0.08f;
+            if (car->drifting)  targetRoll *= 1.4f;
+            if (car->airborne)  targetRoll *= 0.3f;
+
+            float targetPitch = 0.0f;
+            if (car->airborne) {
+                float v = car->velY;
+                if (v >  15.0f) v =  15.0f;
+                if (v < -15.0f) v = -15.0f;
+                targetPitch = -v * 0.025f;  // nose up while rising
             } else {
-                car->hasPrevWheels = false;
+                int next = (car->currentSeg + 1) % TRACK_SEGS;
+                float dx = XZDistance(trackPts[next], trackPts[car->currentSeg]);
+                float dy = trackPts[next].y - trackPts[car->currentSeg].y;
+                if (dx > 0.001f) targetPitch = -atan2f(dy, dx);
             }
 
-            // Checkpoint crossing (player only): arm the next checkpoint
-            // and record a split when the expected segment is entered.
-            if (car->isPlayer && car->currentSeg != car->prevSeg
-                && car->currentSeg == CHECKPOINT_SEGS[cpNextIdx]) {
-                cpSplitTimes[cpNextIdx] = lapTimer;
-                cpNextIdx = (cpNextIdx + 1) % NUM_CHECKPOINTS;
-                cpFlashTimer = 1.2f;
-            }
+            // Exponential-style smoothing so motion reads dynamic but stays framerate-safe.
+            float rRate = 1.0f - expf(-10.0f * dt);
+            float pRate = 1.0f - expf(-6.0f  * dt);
+            car->visRoll  += (targetRoll  - car->visRoll)  * rRate;
+            car->visPitch += (targetPitch - car->visPitch) * pRate;
+        }
 
-            // Track boundary: only push when the car is actually past the edge.
-            // The previous implementation triggered at (edgeDist - 3), i.e. the
-            // inner 40% of the track, so it was constantly nudging the car
-            // toward centerline during normal driving — felt like teleporting.
-            // Inside the track: total freedom. Past the edge: linear capped push.
-            Vector3 closest = ClosestPointOnSeg(car->pos, car->currentSeg);
-            Vector3 toCenter = Vector3Subtract(closest, car->pos);
-            toCenter.y = 0;
-            float trackDist = Vector3Length(toCenter);
-            float edgeDist = TRACK_WIDTH / 2.0f;
-            if (trackDist > edgeDist && trackDist > 0.01f) {
-                Vector3 pushDir = Vector3Scale(toCenter, 1.0f / trackDist);
-                float overEdge = trackDist - edgeDist;
-                float pushStrength = 3.0f + overEdge * 4.0f;
-                if (pushStrength > 10.0f) pushStrength = 10.0f;
-                car->pos = Vector3Add(car->pos, Vector3Scale(pushDir, pushStrength * dt));
-                car->speed *= (1.0f - 0.3f * dt);
+        // --- Skid marks: spawn rear-wheel streaks while drifting on ground. ---
+        if (car->drifting && !car->airborne && fabsf(car->speed) > 5.0f) {
+            // Rear-wheel body offsets (matches carBody RL / RR parts).
+            // Y = car->pos.y - 0.18 puts the streak flush on the road
+            // (car->pos.y = track+0.2, so track+0.02 = car->pos.y-0.18).
+            Vector3 lBody = { -0.45f, 0, -0.7f };
+            Vector3 rBody = {  0.45f, 0, -0.7f };
+            Vector3 lWorld = Vector3Add(car->pos, RotateY(lBody, -car->rotation));
+            Vector3 rWorld = Vector3Add(car->pos, RotateY(rBody, -car->rotation));
+            lWorld.y = car->pos.y - 0.18f;
+            rWorld.y = car->pos.y - 0.18f;
+            if (car->hasPrevWheels) {
+                skids[skidIdx] = (Skid){ car->prevRearL, lWorld, true };
+                skidIdx = (skidIdx + 1) % MAX_SKIDS;
+                skids[skidIdx] = (Skid){ car->prevRearR, rWorld, true };
+                skidIdx = (skidIdx + 1) % MAX_SKIDS;
             }
+            car->prevRearL = lWorld;
+            car->prevRearR = rWorld;
+            car->hasPrevWheels = true;
+        } else {
+            car->hasPrevWheels = false;
+        }
 
-            // Tree collision
-            for (int t = 0; t < numTrees; t++) {
-                Vector3 diff = Vector3Subtract(car->pos, treePosns[t]);
-                diff.y = 0;
-                if (Vector3Length(diff) < treeSizes[t] * 0.5f + 0.8f) {
-                    car->speed *= 0.3f;
-                    Vector3 push = Vector3Normalize(diff);
-                    car->pos = Vector3Add(car->pos, Vector3Scale(push, 0.5f));
-                }
-            }
+        // Checkpoint crossing (player only): arm the next checkpoint
+        // and record a split when the expected segment is entered.
+        if (car->isPlayer && car->currentSeg != car->prevSeg
+            && car->currentSeg == CHECKPOINT_SEGS[cpNextIdx]) {
+            cpSplitTimes[cpNextIdx] = lapTimer;
+            cpNextIdx = (cpNextIdx + 1) % NUM_CHECKPOINTS;
+            cpFlashTimer = 1.2f;
+        }
 
-            // Puddle splash: spawn blue dust while the car is passing through.
-            for (int pu = 0; pu < numPuddles; pu++) {
-                float dx = car->pos.x - puddles[pu].pos.x;
-                float dz = car->pos.z - puddles[pu].pos.z;
-                float r  = puddles[pu].radius + 0.4f;
-                if (dx*dx + dz*dz < r*r && fabsf(car->speed) > 3.0f) {
-                    if (GetRandomValue(0, 1) == 0) {
-                        Vector3 sp = {
-                            car->pos.x + ((float)GetRandomValue(-40,40))/100.0f,
-                            puddles[pu].pos.y + 0.1f,
-                            car->pos.z + ((float)GetRandomValue(-40,40))/100.0f,
-                        };
-                        SpawnDust(sp, (Color){130, 180, 220, 180});
-                    }
-                }
+        // Track boundary: only push when the car is actually past the edge.
+        // The previous implementation triggered at (edgeDist - 3), i.e. the
+        // inner 40% of the track, so it was constantly nudging the car
+        // toward centerline during normal driving — felt like teleporting.
+        // Inside the track: total freedom. Past the edge: linear capped push.
+        Vector3 closest = ClosestPointOnSeg(car->pos, car->currentSeg);
+        Vector3 toCenter = Vector3Subtract(closest, car->pos);
+        toCenter.y = 0;
+        float trackDist = Vector3Length(toCenter);
+        float edgeDist = TRACK_WIDTH / 2.0f;
+        if (trackDist > edgeDist && trackDist > 0.01f) {
+            Vector3 pushDir = Vector3Scale(toCenter, 1.0f / trackDist);
+            float overEdge = trackDist - edgeDist;
+            float pushStrength = 3.0f + overEdge * 4.0f;
+            if (pushStrength > 10.0f) pushStrength = 10.0f;
+            car->pos = Vector3Add(car->pos, Vector3Scale(pushDir, pushStrength * dt));
+            car->speed *= (1.0f - 0.3f * dt);
+        }
+
+        // Tree collision
+        for (int t = 0; t < numTrees; t++) {
+            Vector3 diff = Vector3Subtract(car->pos, treePosns[t]);
+            diff.y = 0;
+            if (Vector3Length(diff) < treeSizes[t] * 0.5f + 0.8f) {
+                car->speed *= 0.3f;
+                Vector3 push = Vector3Normalize(diff);
+                car->pos = Vector3Add(car->pos, Vector3Scale(push, 0.5f));
             }
+        }
 
-            // Crashable prop collision — crates spin and tumble away
-            // for a moment after the hit; fences just disintegrate.
-            for (int pi = 0; pi < numProps; pi++) {
-                Prop *pr = &props[pi];
-                if (!pr->alive) continue;
-                float dx = car->pos.x - pr->pos.x;
-                float dz = car->pos.z - pr->pos.z;
-                float hitR = (pr->type == PROP_FENCE) ? 1.1f : 0.55f;
-                if (dx*dx + dz*dz < (hitR + 0.4f) * (hitR + 0.4f)) {
-                    pr->alive = false;
-                    car->speed *= (pr->type == PROP_FENCE) ? 0.90f : 0.82f;
-                    if (pr->type == PROP_CRATE) {
-                        // Fling the crate away from the car's direction of
-                        // travel with some upward kick and a random spin.
-                        float hx = -dx, hz = -dz;  // from car → prop
-                        float mag = sqrtf(hx*hx + hz*hz);
-                        if (mag > 1e-4f) { hx /= mag; hz /= mag; }
-                        float shove = 6.0f + fabsf(car->speed) * 0.4f;
-                        pr->vel = (Vector3){
-                            hx * shove + ((float)GetRandomValue(-20,20))/20.0f,
-                            5.0f + (float)GetRandomValue(0, 40) / 10.0f,
-                            hz * shove + ((float)GetRandomValue(-20,20))/20.0f,
-                        };
-                        pr->angVel = ((float)GetRandomValue(-80, 80)) / 10.0f;
-                        pr->flyTimer = 1.8f;
-                    }
-                    // Debris puff: brown for crates, lighter for fences.
-                    Color debris = (pr->type == PROP_FENCE)
-                        ? (Color){200, 200, 200, 180}
-                        : (Color){150, 100,  60, 180};
-                    for (int k = 0; k < 6; k++) {
-                        SpawnDust((Vector3){pr->pos.x, pr->pos.y + 0.3f, pr->pos.z}, debris);
-                    }
+        // Puddle splash: spawn blue dust while the car is passing through.
+        for (int pu = 0; pu < numPuddles; pu++) {
+            float dx = car->pos.x - puddles[pu].pos.x;
+            float dz = car->pos.z - puddles[pu].pos.z;
+            float r  = puddles[pu].radius + 0.4f;
+            if (dx*dx + dz*dz < r*r && fabsf(car->speed) > 3.0f) {
+                if (RngInt(&raceRng, 0, 1) == 0) {
+                    Vector3 sp = {
+                        car->pos.x + ((float)RngInt(&raceRng, -40,40))/100.0f,
+                        puddles[pu].pos.y + 0.1f,
+                        car->pos.z + ((float)RngInt(&raceRng, -40,40))/100.0f,
+                    };
+                    SpawnDust(sp, (Color){130, 180, 220, 180});
                 }
             }
+        }
 
-            // Integrate flying props (crates only).
-            for (int pi = 0; pi < numProps; pi++) {
-                Prop *pr = &props[pi];
-                if (pr->flyTimer <= 0.0f) continue;
-                pr->flyTimer -= dt;
-                pr->vel.y -= 18.0f * dt;           // gravity
-                pr->pos = Vector3Add(pr->pos, Vector3Scale(pr->vel, dt));
-                pr->rotY += pr->angVel * dt;
-                // Bounce off the ground once, then settle.
-                float floorY = TrackHeightAt(pr->pos, car->currentSeg) - 0.2f;
-                if (pr->pos.y < floorY + 0.1f && pr->vel.y < 0.0f) {
-                    pr->pos.y = floorY + 0.1f;
-                    pr->vel.y = -pr->vel.y * 0.35f;
-                    pr->vel.x *= 0.6f; pr->vel.z *= 0.6f;
-                    pr->angVel *= 0.5f;
-                    if (fabsf(pr->vel.y) < 0.8f) pr->flyTimer = fminf(pr->flyTimer, 0.3f);
+        // Crashable prop collision — crates spin and tumble away
+        // for a moment after the hit; fences just disintegrate.
+        for (int pi = 0; pi < numProps; pi++) {
+            Prop *pr = &props[pi];
+            if (!pr->alive) continue;
+            float dx = car->pos.x - pr->pos.x;
+            float dz = car->pos.z - pr->pos.z;
+            float hitR = (pr->type == PROP_FENCE) ? 1.1f : 0.55f;
+            if (dx*dx + dz*dz < (hitR + 0.4f) * (hitR + 0.4f)) {
+                pr->alive = false;
+                car->speed *= (pr->type == PROP_FENCE) ? 0.90f : 0.82f;
+                if (pr->type == PROP_CRATE) {
+                    // Fling the crate away from the car's direction of
+                    // travel with some upward kick and a random spin.
+                    float hx = -dx, hz = -dz;  // from car → prop
+                    float mag = sqrtf(hx*hx + hz*hz);
+                    if (mag > 1e-4f) { hx /= mag; hz /= mag; }
+                    float shove = 6.0f + fabsf(car->speed) * 0.4f;
+                    pr->vel = (Vector3){
+                        hx * shove + ((float)RngInt(&raceRng, -20,20))/20.0f,
+                        5.0f + (float)RngInt(&raceRng, 0, 40) / 10.0f,
+                        hz * shove + ((float)RngInt(&raceRng, -20,20))/20.0f,
+                    };
+                    pr->angVel = ((float)RngInt(&raceRng, -80, 80)) / 10.0f;
+                    pr->flyTimer = 1.8f;
+                }
+                // Debris puff: brown for crates, lighter for fences.
+                Color debris = (pr->type == PROP_FENCE)
+                    ? (Color){200, 200, 200, 180}
+                    : (Color){150, 100,  60, 180};
+                for (int k = 0; k < 6; k++) {
+                    SpawnDust((Vector3){pr->pos.x, pr->pos.y + 0.3f, pr->pos.z}, debris);
                 }
             }
+        }
 
-            // Waypoint progression
-            float wpDist = Vector3Distance(car->pos, trackPts[car->nextWP]);
-            if (wpDist < 10.0f) {
-                int prev = car->nextWP;
-                car->nextWP = (car->nextWP + 1) % TRACK_SEGS;
-                if (car->nextWP == 0 && prev == TRACK_SEGS - 1) {
-                    car->lap++;
-                    if (car->isPlayer) {
-                        if (lapTimer < bestLapTime) bestLapTime = lapTimer;
-                        if (car->lap <= TOTAL_LAPS) splitTimes[car->lap - 1] = lapTimer;
-                        lapTimer = 0;
-                    }
-                    if (car->lap >= TOTAL_LAPS) car->finished = true;
-                }
+        // Integrate flying props (crates only).
+        for (int pi = 0; pi < numProps; pi++) {
+            Prop *pr = &props[pi];
+            if (pr->flyTimer <= 0.0f) continue;
+            pr->flyTimer -= dt;
+            pr->vel.y -= 18.0f * dt;           // gravity
+            pr->pos = Vector3Add(pr->pos, Vector3Scale(pr->vel, dt));
+            pr->rotY += pr->angVel * dt;
+            // Bounce off the ground once, then settle.
+            float floorY = TrackHeightAt(pr->pos, car->currentSeg) - 0.2f;
+            if (pr->pos.y < floorY + 0.1f && pr->vel.y < 0.0f) {
+                pr->pos.y = floorY + 0.1f;
+                pr->vel.y = -pr->vel.y * 0.35f;
+                pr->vel.x *= 0.6f; pr->vel.z *= 0.6f;
+                pr->angVel *= 0.5f;
+                if (fabsf(pr->vel.y) < 0.8f) pr->flyTimer = fminf(pr->flyTimer, 0.3f);
             }
         }
 
-        // Car-car collision
-        for (int i = 0; i < NUM_CARS; i++) {
-            for (int j = i + 1; j < NUM_CARS; j++) {
-                Vector3 diff = Vector3Subtract(cars[i].pos, cars[j].pos);
-                diff.y = 0;
-                float dist = Vector3Length(diff);
-                if (dist < 2.0f && dist > 0.01f) {
-                    Vector3 push = Vector3Scale(Vector3Normalize(diff), (2.0f - dist) * 0.5f);
-                    cars[i].pos = Vector3Add(cars[i].pos, push);
-                    cars[j].pos = Vector3Subtract(cars[j].pos, push);
+        // Waypoint progression
+        float wpDist = Vector3Distance(car->pos, trackPts[car->nextWP]);
+        if (wpDist < 10.0f) {
+            int prev = car->nextWP;
+            car->nextWP = (car->nextWP + 1) % TRACK_SEGS;
+            if (car->nextWP == 0 && prev == TRACK_SEGS - 1) {
+                car->lap++;
+                if (car->isPlayer) {
+                    if (lapTimer < bestLapTime) bestLapTime = lapTimer;
+                    if (car->lap <= TOTAL_LAPS) splitTimes[car->lap - 1] = lapTimer;
+                    lapTimer = 0;
                 }
+                if (car->lap >= TOTAL_LAPS) car->finished = true;
             }
         }
+    }
 
-        // Update dust
-        for (int i = 0; i < MAX_DUST; i++) {
-            if (!dust[i].active) continue;
-            dust[i].pos = Vector3Add(dust[i].pos, Vector3Scale(dust[i].vel, dt));
-            dust[i].vel.y -= 3.0f * dt;
-            dust[i].life -= dt;
-            if (dust[i].life <= 0) dust[i].active = false;
+    // Car-car collision
+    SIM_SECTION("collide")
+    for (int i = 0; i < NUM_CARS; i++) {
+        for (int j = i + 1; j < NUM_CARS; j++) {
+            Vector3 diff = Vector3Subtract(cars[i].pos, cars[j].pos);
+            diff.y = 0;
+            float dist = Vector3Length(diff);
+            if (dist < 2.0f && dist > 0.01f) {
+                Vector3 push = Vector3Scale(Vector3Normalize(diff), (2.0f - dist) * 0.5f);
+                cars[i].pos = Vector3Add(cars[i].pos, push);
+                cars[j].pos = Vector3Subtract(cars[j].pos, push);
+            }
         }
+    }
+
+    // Update dust
+    SIM_SECTION("dust")
+    for (int i = 0; i < MAX_DUST; i++) {
+        if (!dust[i].active) continue;
+        dust[i].pos = Vector3Add(dust[i].pos, Vector3Scale(dust[i].vel, dt));
+        dust[i].vel.y -= 3.0f * dt;
+        dust[i].life -= dt;
+        if (dust[i].life <= 0) dust[i].active = false;
+    }
+
+    // Rankings
+    playerRank = 1;
+    for (int i = 1; i < NUM_CARS; i++)
+        if (CarProgress(&cars[i]) > CarProgress(&cars[0])) playerRank++;
+}
+
+#ifdef SIM_HEADLESS
+// Scripted driver: full throttle, steers for the next waypoint with the
+// arrow keys, drifts through anything sharper than the AI's brake angle.
+// Wedged against scenery for a second, it backs off for a moment and retries.
+static void SimScript(void) {
+    static int stuckTicks = 0, reverseTicks = 0;
+    Car *p = &cars[0];
+    Vector3 to = Vector3Subtract(trackPts[p->nextWP], p->pos);
+    float turn = WrapAnglePi(atan2f(to.x, to.z) - p->rotation);
+    stuckTicks = (raceStarted && fabsf(p->speed) < 2.0f) ? stuckTicks + 1 : 0;
+    if (stuckTicks > (int)SIM_HZ) { reverseTicks = (int)(SIM_HZ * 0.6f); stuckTicks = 0; }
+    bool reversing = reverseTicks > 0;
+    if (reversing) reverseTicks--;
+    SimSetKey(KEY_W, !reversing);
+    SimSetKey(KEY_S, reversing);
+    SimSetKey(KEY_A, turn >  0.05f);
+    SimSetKey(KEY_D, turn < -0.05f);
+    SimSetKey(KEY_SPACE, !reversing && fabsf(turn) > 0.6f);
+}
 
-        // Rankings
-        playerRank = 1;
-        for (int i = 1; i < NUM_CARS; i++)
-            if (CarProgress(&cars[i]) > CarProgress(&cars[0])) playerRank++;
+int main(int argc, char **argv) {
+    SimRun run = SimBegin("rally", argc, argv, (int)(SIM_HZ * 600));
+    FxSeedRng(run.seed);
+    GenerateTrack(run.seed);
+    InitRace(run.seed);
+
+    int races = 0;
+    for (int t = 0; t < run.ticks; t++) {
+        SimInputNextTick();
+        SimScript();
+        UpdateRace(1.0f / SIM_HZ);
+        bool allDone = true;
+        for (int ci = 0; ci < NUM_CARS; ci++) allDone = allDone && cars[ci].finished;
+        if (allDone) { races++; InitRace(run.seed); }
+    }
+    int rc = SimEnd(&run);
+    printf("  %d races finished, player on lap %d\n", races, cars[0].lap);
+    return rc;
+}
+#else
+int main(int argc, char **argv) {
+    // Optional argument: a seed to replay a track layout; otherwise a fresh one
+    uint64_t seed = (argc > 1) ? strtoull(argv[1], NULL, 10) : (uint64_t)time(NULL);
+
+    InitWindow(800, 600, "Rally Racing");
+    TraceLog(LOG_INFO, "RALLY: seed %llu", (unsigned long long)seed);
+    SetTargetFPS(144);   // render rate; the simulation ticks at SIM_HZ
+    SetWindowState(FLAG_WINDOW_RESIZABLE);
+    MaximizeWindow();
+
+    // Rear-view mirror render texture. Wider aspect (~4.3:1) so the
+    // mirror shows a lot of road behind and reads at a glance.
+    RenderTexture2D mirrorRT = LoadRenderTexture(860, 200);
+    SetTextureFilter(mirrorRT.texture, TEXTURE_FILTER_BILINEAR);
+    NUM_CARS_RENDER = NUM_CARS;
+    InitVisibleList(&treeVis, MAX_TREES);
+
+    GenerateTrack(seed);
+    InitRace(seed);
+
+    Camera3D camera = { 0 };
+    camera.up = (Vector3){0, 1, 0};
+    camera.fovy = 55;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    float finishCinTime = 0.0f;  // seconds since player crossed finish line
+
+    FixedStep loop = FixedStepInit(SIM_HZ, 4);
+    while (!WindowShouldClose()) {
+        FrameArenaReset();
+        float frameDt = GetFrameTime();
+        if (frameDt > 0.033f) frameDt = 0.033f;
+        int sw = GetScreenWidth(), sh = GetScreenHeight();
+
+        // --- Simulation: fixed ticks, decoupled from the render rate ---
+        int ticks = FixedStepAdvance(&loop, GetFrameTime());
+        for (int tick = 0; tick < ticks; tick++) UpdateRace(loop.dt);
+
+        // Cars as drawn this frame: blended between the last two ticks
+        Car drawCars[NUM_CARS];
+        for (int ci = 0; ci < NUM_CARS; ci++) {
+            drawCars[ci] = cars[ci];
+            drawCars[ci].pos = Vector3Lerp(cars[ci].prevPos, cars[ci].pos, loop.alpha);
+            drawCars[ci].rotation = AngleLerp(cars[ci].prevRotation, cars[ci].rotation, loop.alpha);
+        }
 
         // --- Camera ---
         if (cars[0].finished) {
-            finishCinTime += dt;
-            Car *p = &cars[0];
+            finishCinTime += frameDt;
+            Car *p = &drawCars[0];
             float t = finishCinTime;
 
             // Stage 1 (0 – 3s): ease a 180° orbit around the car.
@@ -1283,11 +1420,11 @@ moveCar:;
             };
             Vector3 camTarget = { p->pos.x, p->pos.y + 0.8f, p->pos.z };
             // Ease into the cinematic from whatever the follow-cam had.
-            camera.position = Vector3Lerp(camera.position, camPos,    6.0f * dt);
-            camera.target   = Vector3Lerp(camera.target,   camTarget, 6.0f * dt);
-            camera.fovy    += (52.0f - camera.fovy) * 3.0f * dt;
+            camera.position = Vector3Lerp(camera.position, camPos,    6.0f * frameDt);
+            camera.target   = Vector3Lerp(camera.target,   camTarget, 6.0f * frameDt);
+            camera.fovy    += (52.0f - camera.fovy) * 3.0f * frameDt;
         } else {
-            Car *p = &cars[0];
+            Car *p = &drawCars[0];
             float cs = cosf(p->rotation), sn = sinf(p->rotation);
             float speedPct = Clamp(fabsf(p->speed) / CAR_MAX_SPEED, 0, 1.2f);
             float camDist = 2.8f - speedPct * 0.6f;   // pulled right in behind the car
@@ -1302,18 +1439,18 @@ moveCar:;
                 p->pos.y + 0.5f,
                 p->pos.z + cs * 2.0f
             };
-            camera.position = Vector3Lerp(camera.position, camPos,    20.0f * dt);
-            camera.target   = Vector3Lerp(camera.target,   camTarget, 20.0f * dt);
+            camera.position = Vector3Lerp(camera.position, camPos,    20.0f * frameDt);
+            camera.target   = Vector3Lerp(camera.target,   camTarget, 20.0f * frameDt);
 
             float targetFov = 48.0f + speedPct * 12.0f;  // narrower base FOV = bigger car
-            camera.fovy += (targetFov - camera.fovy) * 4.0f * dt;
+            camera.fovy += (targetFov - camera.fovy) * 4.0f * frameDt;
         }
 
         // --- Rear-view mirror pass: render from a camera facing backwards
         //     from the driver's eye into the mirrorRT, for a 2D blit later.
         Camera3D mirrorCam = {0};
         {
-            Car *p = &cars[0];
+            Car *p = &drawCars[0];
             float fx = sinf(p->rotation), fz = cosf(p->rotation);
             mirrorCam.position   = (Vector3){ p->pos.x, p->pos.y + 1.2f, p->pos.z };
             mirrorCam.target     = (Vector3){ p->pos.x - fx * 12.0f,
@@ -1326,7 +1463,9 @@ moveCar:;
         BeginTextureMode(mirrorRT);
             ClearBackground((Color){75, 120, 180, 255});
             BeginMode3D(mirrorCam);
-                DrawScene3D(cars, raceTimer);
+                Frustum mirrorView = CameraFrustumDefault(mirrorCam,
+                    (float)mirrorRT.texture.width / (float)mirrorRT.texture.height);
+                DrawScene3D(drawCars, raceTimer, &mirrorView);
             EndMode3D();
         EndTextureMode();
 
@@ -1339,7 +1478,8 @@ moveCar:;
             (Color){200, 205, 195, 255});  // horizon
 
         BeginMode3D(camera);
-            DrawScene3D(cars, raceTimer);
+            Frustum view = CameraFrustumDefault(camera, (float)sw / (float)(sh > 0 ? sh : 1));
+            DrawScene3D(drawCars, raceTimer, &view);
         EndMode3D();
 
         // --- HUD ---
@@ -1413,7 +1553,7 @@ moveCar:;
 
         // Checkpoint flash (shows the split just banked)
         if (cpFlashTimer > 0.0f) {
-            cpFlashTimer -= dt;
+            cpFlashTimer -= frameDt;
             if (cpFlashTimer < 0.0f) cpFlashTimer = 0.0f;
             int prevIdx = (cpNextIdx + NUM_CHECKPOINTS - 1) % NUM_CHECKPOINTS;
             float alpha = cpFlashTimer / 1.2f;
@@ -1542,6 +1682,9 @@ moveCar:;
         EndDrawing();
     }
 
+    FreeVisibleList(&treeVis);
+    ArenaDestroy(&frameArena);
     CloseWindow();
     return 0;
 }
+#endif
@@ -1,5 +1,6 @@
 #include "raylib.h"
 #include "raymath.h"
+#include "../common/util/collide.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -207,6 +208,25 @@ bool Collides(Vector3 pos, float radius, int room) {
     return false;
 }
 
+// Swept version of Collides for the player: the room's walls plus four slabs
+// just outside the floor rectangle, resolved in one pass with sliding.
+void MoveAndSlide(Vector3 *pos, Vector3 move, float radius, int room) {
+    Room *r = &rooms[room];
+    AABB boxes[MAX_WALLS + 4];
+    int nb = 0;
+    Vector3 mid = Vector3Scale(Vector3Add(r->floorMin, r->floorMax), 0.5f);
+    float hx = (r->floorMax.x - r->floorMin.x) / 2 + 1.0f;
+    float hz = (r->floorMax.z - r->floorMin.z) / 2 + 1.0f;
+    boxes[nb++] = (AABB){ {r->floorMin.x - 0.5f, 0, mid.z}, {0.5f, 1, hz} };
+    boxes[nb++] = (AABB){ {r->floorMax.x + 0.5f, 0, mid.z}, {0.5f, 1, hz} };
+    boxes[nb++] = (AABB){ {mid.x, 0, r->floorMin.z - 0.5f}, {hx, 1, 0.5f} };
+    boxes[nb++] = (AABB){ {mid.x, 0, r->floorMax.z + 0.5f}, {hx, 1, 0.5f} };
+    for (int i = 0; i < r->numWalls; i++)
+        boxes[nb++] = (AABB){ r->walls[i].pos, r->walls[i].size };
+    SlideSweptXZ(pos, move, radius, boxes, nb, NULL, 0, NULL);
+    pos->y = 0;
+}
+
 void BuildMansion(void) {
     Color darkWood = {50,30,18,255};
     Color carpet   = {70,25,25,255};
@@ -592,9 +612,7 @@ int main(void) {
         if (player.knockbackTimer > 0) {
             player.knockbackTimer -= dt;
             Vector3 kb = Vector3Scale(player.knockbackDir, KNOCKBACK_SPEED * dt);
-            Vector3 np = Vector3Add(player.pos, kb);
-            np.y = 0;
-            if (!Collides(np, 0.3f, player.currentRoom)) player.pos = np;
+            MoveAndSlide(&player.pos, kb, 0.3f, player.currentRoom);
             goto skip_input;
         }
 
@@ -613,8 +631,8 @@ int main(void) {
             if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S)) moveDir = -1;
             if (moveDir != 0) {
                 float cs = cosf(player.rotation), sn = sinf(player.rotation);
-                Vector3 np = {player.pos.x + cs*spd*moveDir*dt, 0, player.pos.z + sn*spd*moveDir*dt};
-                if (!Collides(np, 0.3f, player.currentRoom)) player.pos = np;
+                Vector3 step = {cs*spd*moveDir*dt, 0, sn*spd*moveDir*dt};
+                MoveAndSlide(&player.pos, step, 0.3f, player.currentRoom);
                 player.walkTimer += dt;
             }
         }
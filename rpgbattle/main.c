@@ -832,6 +832,7 @@ int main(void) {
         EndDrawing();
     }
 
+    UnloadMap3D(&battleMap);
     CloseWindow();
     return 0;
 }
@@ -1,13 +1,19 @@
 #include "raylib.h"
 #include "raymath.h"
+#include "../common/util/sim.h"
 #include "../common/objects3d.h"
+#include "../common/util/pool.h"
+#include "../common/util/collide.h"
+#include "../common/util/jobs.h"
 #include <math.h>
 #include <stdlib.h>
 
 // RTS: two factions, unit types, buildings, combat, fog of war, minimap
 
 #define GROUND_SIZE    80.0f
-#define MAX_UNITS      60
+#define MAX_UNITS      2048
+#define UNIT_GRID_BUCKETS 4096     // power of two, 2x MAX_UNITS
+#define UNIT_GRID_CELL 2.0f        // ~ push-apart radius
 #define MAX_BUILDINGS  16
 #define MAX_PROJECTILES 32
 #define MAX_PARTICLES  64
@@ -26,7 +32,7 @@ typedef struct {
     float attackDamage;
     float attackCooldown;
     float attackTimer;
-    int targetUnit;     // index of unit being attacked (-1 = none)
+    PoolHandle targetUnit;  // unit being attacked (POOL_HANDLE_NONE = none)
     UnitType type;
     Faction faction;
     bool selected;
@@ -113,6 +119,12 @@ static Part towerParts[] = {
 
 // State
 static Unit units[MAX_UNITS];
+static uint32_t unitSlots[MAX_UNITS];
+static uint64_t unitLive[POOL_BITSET_WORDS(MAX_UNITS)];
+static HandlePool unitPool;
+static int unitGridHeads[UNIT_GRID_BUCKETS];
+static SpatialHashEntry unitGridEntries[MAX_UNITS];
+static SpatialHash unitGrid;   // live units by index, kept current incrementally
 static Building buildings[MAX_BUILDINGS];
 static Projectile projectiles[MAX_PROJECTILES];
 static Particle3D particles[MAX_PARTICLES];
@@ -153,21 +165,30 @@ Part *GetUnitParts(UnitType type, Faction faction, int *count) {
 }
 
 int SpawnUnit(UnitType type, Faction faction, Vector3 pos) {
-    for (int i = 0; i < MAX_UNITS; i++) {
-        if (units[i].active) continue;
-        UnitStats *s = &unitStats[type];
-        units[i] = (Unit){
-            .pos = pos, .target = pos,
-            .hp = s->hp, .maxHp = s->hp,
-            .speed = s->speed, .attackRange = s->range,
-            .attackDamage = s->damage, .attackCooldown = s->cooldown,
-            .attackTimer = 0, .targetUnit = -1,
-            .type = type, .faction = faction,
-            .selected = false, .active = true
-        };
-        return i;
-    }
-    return -1;
+    PoolHandle h = HandlePoolSpawn(&unitPool);
+    if (h == POOL_HANDLE_NONE) return -1;
+    int i = PoolHandleIndex(h);
+    UnitStats *s = &unitStats[type];
+    units[i] = (Unit){
+        .pos = pos, .target = pos,
+        .hp = s->hp, .maxHp = s->hp,
+        .speed = s->speed, .attackRange = s->range,
+        .attackDamage = s->damage, .attackCooldown = s->cooldown,
+        .attackTimer = 0, .targetUnit = POOL_HANDLE_NONE,
+        .type = type, .faction = faction,
+        .selected = false, .active = true
+    };
+    SpatialHashInsert(&unitGrid, i, pos);
+    return i;
+}
+
+// Retire a unit: its slot goes back on the free list and any handle other
+// units hold to it goes stale.
+void KillUnit(int i) {
+    units[i].active = false;
+    units[i].selected = false;
+    HandlePoolFreeIndex(&unitPool, i);
+    SpatialHashRemove(&unitGrid, i);
 }
 
 void SpawnBuilding(BuildingType type, Faction faction, Vector3 pos) {
@@ -185,6 +206,8 @@ void SpawnBuilding(BuildingType type, Faction faction, Vector3 pos) {
 
 void InitGame(void) {
     memset(units, 0, sizeof(units));
+    HandlePoolInit(&unitPool, unitSlots, unitLive, MAX_UNITS);
+    SpatialHashInit(&unitGrid, unitGridHeads, UNIT_GRID_BUCKETS, unitGridEntries, MAX_UNITS, UNIT_GRID_CELL);
     memset(buildings, 0, sizeof(buildings));
     memset(projectiles, 0, sizeof(projectiles));
     memset(particles, 0, sizeof(particles));
@@ -211,15 +234,17 @@ void InitGame(void) {
     camFocus = (Vector3){-25, 0, -25};
 }
 
-int FindNearestEnemy(Unit *u) {
-    float bestD = 1e9f;
-    int best = -1;
-    for (int i = 0; i < MAX_UNITS; i++) {
-        if (!units[i].active || units[i].faction == u->faction) continue;
-        float d = Vector3Distance(u->pos, units[i].pos);
-        if (d < bestD) { bestD = d; best = i; }
-    }
-    return (bestD < 30.0f) ? best : -1;
+// SpatialHashQueryNearest filter: user points at the wanted Faction.
+static bool UnitIsFaction(int id, void *user) {
+    return units[id].faction == *(Faction *)user;
+}
+
+PoolHandle FindNearestEnemy(Unit *u) {
+    Faction enemy = (u->faction == FACTION_PLAYER) ? FACTION_ENEMY : FACTION_PLAYER;
+    int best;
+    if (!SpatialHashQueryNearest(&unitGrid, u->pos, 30.0f, 1, UnitIsFaction, &enemy, &best, NULL))
+        return POOL_HANDLE_NONE;
+    return HandlePoolHandleOf(&unitPool, best);
 }
 
 void ShootProjectile(int owner, Vector3 target) {
@@ -236,66 +261,110 @@ void ShootProjectile(int owner, Vector3 target) {
     }
 }
 
-void UpdateUnit(Unit *u, int idx, float dt) {
-    if (!u->active) return;
-
-    // Find target enemy if none
-    if (u->targetUnit < 0 || !units[u->targetUnit].active)
+// Units update in two passes so the expensive part can run on every core:
+// ThinkUnit (parallel) reads positions and the spatial hash and writes only
+// the unit's own fields plus its slots below; ApplyUnit (serial, pool order)
+// then lands hits, kills and moves. Every unit thinks against the same
+// snapshot, so the outcome does not depend on the worker count.
+static Vector3 unitNextPos[MAX_UNITS];
+static int unitStrike[MAX_UNITS];     // unit index to hit this tick, or -1
+static int unitOrder[MAX_UNITS];      // live units this tick
+static int unitOrderCount = 0;
+
+void ThinkUnit(Unit *u, int idx, float dt) {
+    unitStrike[idx] = -1;
+    unitNextPos[idx] = u->pos;
+
+    // Find target enemy if none (a stale handle means the target died,
+    // even if its slot has since been reused)
+    int t = HandlePoolResolve(&unitPool, u->targetUnit);
+    if (t < 0) {
         u->targetUnit = FindNearestEnemy(u);
+        t = HandlePoolResolve(&unitPool, u->targetUnit);
+    }
 
     // Attack if in range
-    if (u->targetUnit >= 0 && units[u->targetUnit].active) {
-        float dist = Vector3Distance(u->pos, units[u->targetUnit].pos);
+    if (t >= 0) {
+        float dist = Vector3Distance(u->pos, units[t].pos);
         if (dist <= u->attackRange) {
             u->attackTimer -= dt;
-            if (u->attackTimer <= 0) {
-                u->attackTimer = u->attackCooldown;
-                if (u->type == UNIT_ARCHER) {
-                    ShootProjectile(idx, units[u->targetUnit].pos);
-                } else {
-                    units[u->targetUnit].hp -= u->attackDamage;
-                    if (units[u->targetUnit].hp <= 0) {
-                        units[u->targetUnit].active = false;
-                        SpawnParticleBurst(particles, MAX_PARTICLES, units[u->targetUnit].pos, 8, 2, 6, 0.3f, 0.8f, 0.1f, 0.3f);
-                        if (u->faction == FACTION_PLAYER) resources += 5;
-                        u->targetUnit = -1;
-                    }
-                }
-            }
+            if (u->attackTimer <= 0) unitStrike[idx] = t;   // cooldown restarts if it lands
             return; // Don't move while attacking in melee range
         } else {
             // Move toward enemy
-            u->target = units[u->targetUnit].pos;
+            u->target = units[t].pos;
         }
     }
 
     // Move toward target
-    Vector3 dir = Vector3Subtract(u->target, u->pos);
+    Vector3 pos = u->pos;
+    Vector3 dir = Vector3Subtract(u->target, pos);
     dir.y = 0;
     float dist = Vector3Length(dir);
     if (dist > 0.5f) {
         dir = Vector3Normalize(dir);
-        u->pos = Vector3Add(u->pos, Vector3Scale(dir, u->speed * dt));
+        pos = Vector3Add(pos, Vector3Scale(dir, u->speed * dt));
     }
 
     // Clamp to bounds
     float half = GROUND_SIZE / 2.0f;
-    if (u->pos.x < -half) u->pos.x = -half;
-    if (u->pos.x > half) u->pos.x = half;
-    if (u->pos.z < -half) u->pos.z = -half;
-    if (u->pos.z > half) u->pos.z = half;
+    if (pos.x < -half) pos.x = -half;
+    if (pos.x > half) pos.x = half;
+    if (pos.z < -half) pos.z = -half;
+    if (pos.z > half) pos.z = half;
 
     // Push apart from other units
-    for (int i = 0; i < MAX_UNITS; i++) {
-        if (i == idx || !units[i].active) continue;
-        Vector3 diff = Vector3Subtract(u->pos, units[i].pos);
+    int near[32];
+    int nearCount = SpatialHashQueryRadius(&unitGrid, pos, 1.2f, near, 32);
+    for (int n = 0; n < nearCount; n++) {
+        int i = near[n];
+        if (i == idx) continue;
+        Vector3 diff = Vector3Subtract(pos, units[i].pos);
         diff.y = 0;
         float d = Vector3Length(diff);
         if (d < 1.2f && d > 0.01f) {
             Vector3 push = Vector3Scale(Vector3Normalize(diff), (1.2f - d) * 0.5f);
-            u->pos = Vector3Add(u->pos, push);
+            pos = Vector3Add(pos, push);
         }
     }
+    unitNextPos[idx] = pos;
+}
+
+static void ThinkUnitRange(void *ctx, int begin, int end) {
+    float dt = *(const float *)ctx;
+    for (int n = begin; n < end; n++) ThinkUnit(&units[unitOrder[n]], unitOrder[n], dt);
+}
+
+void ApplyUnit(Unit *u, int idx) {
+    if (!u->active) return;   // killed earlier in this pass
+
+    int t = unitStrike[idx];
+    if (t >= 0) {
+        if (!units[t].active) return;   // someone else finished it first: swing again next tick
+        u->attackTimer = u->attackCooldown;
+        if (u->type == UNIT_ARCHER) {
+            ShootProjectile(idx, units[t].pos);
+        } else {
+            units[t].hp -= u->attackDamage;
+            if (units[t].hp <= 0) {
+                KillUnit(t);
+                SpawnParticleBurst(particles, MAX_PARTICLES, units[t].pos, 8, 2, 6, 0.3f, 0.8f, 0.1f, 0.3f);
+                if (u->faction == FACTION_PLAYER) resources += 5;
+                u->targetUnit = POOL_HANDLE_NONE;
+            }
+        }
+        return;
+    }
+
+    u->pos = unitNextPos[idx];
+    SpatialHashMove(&unitGrid, idx, u->pos);
+}
+
+void UpdateUnits(float dt) {
+    unitOrderCount = 0;
+    HANDLE_POOL_FOREACH(&unitPool, i) unitOrder[unitOrderCount++] = i;
+    SIM_SECTION("units think") ParallelFor(unitOrderCount, 64, ThinkUnitRange, &dt);
+    SIM_SECTION("units apply") for (int n = 0; n < unitOrderCount; n++) ApplyUnit(&units[unitOrder[n]], unitOrder[n]);
 }
 
 void EnemyAI(float dt) {
@@ -326,14 +395,9 @@ void EnemyAI(float dt) {
         buildings[i].spawnTimer -= dt;
         if (buildings[i].spawnTimer <= 0) {
             // Find nearest player unit
-            float bestD = 20.0f;
-            int best = -1;
-            for (int u = 0; u < MAX_UNITS; u++) {
-                if (!units[u].active || units[u].faction != FACTION_PLAYER) continue;
-                float d = Vector3Distance(buildings[i].pos, units[u].pos);
-                if (d < bestD) { bestD = d; best = u; }
-            }
-            if (best >= 0) {
+            Faction target = FACTION_PLAYER;
+            int best;
+            if (SpatialHashQueryNearest(&unitGrid, buildings[i].pos, 20.0f, 1, UnitIsFaction, &target, &best, NULL)) {
                 // Tower shoots
                 for (int p = 0; p < MAX_PROJECTILES; p++) {
                     if (projectiles[p].active) continue;
@@ -351,11 +415,129 @@ void EnemyAI(float dt) {
     }
 }
 
+// Train one unit at the player's barracks, if affordable.
+void TrainUnit(UnitType type) {
+    int cost = (type == UNIT_KNIGHT) ? 20 : 10;
+    if (resources < cost) return;
+    // Find player barracks
+    for (int i = 0; i < MAX_BUILDINGS; i++) {
+        if (!buildings[i].active || buildings[i].faction != FACTION_PLAYER || buildings[i].type != BLDG_BARRACKS) continue;
+        Vector3 sp = buildings[i].pos;
+        sp.x += (float)GetRandomValue(-20, 20) / 10.0f;
+        sp.z += 3.0f;
+        SpawnUnit(type, FACTION_PLAYER, sp);
+        resources -= cost;
+        break;
+    }
+}
+
+// Move the selection to dest in a square formation.
+void OrderSelected(Vector3 dest) {
+    // Formation spread
+    int selCount = 0;
+    for (int i = 0; i < MAX_UNITS; i++) if (units[i].selected) selCount++;
+    int placed = 0;
+    int cols = (int)ceilf(sqrtf((float)selCount));
+    for (int i = 0; i < MAX_UNITS; i++) {
+        if (!units[i].selected) continue;
+        int row = placed / cols, col = placed % cols;
+        units[i].target = (Vector3){
+            dest.x + (col - cols/2) * 1.5f,
+            0,
+            dest.z + row * 1.5f
+        };
+        units[i].targetUnit = POOL_HANDLE_NONE; // Clear attack target, let AI re-acquire
+        placed++;
+    }
+}
+
+// Everything that advances without player input: income, units, AI, shots, effects.
+void UpdateWorld(float dt) {
+    gameTime += dt;
+
+    // Resource income
+    if ((int)(gameTime * 10) % 50 == 0) resources++;
+
+    UpdateUnits(dt);
+    SIM_SECTION("ai") EnemyAI(dt);
+
+    // Update projectiles
+    SIM_SECTION("projectiles")
+    for (int i = 0; i < MAX_PROJECTILES; i++) {
+        if (!projectiles[i].active) continue;
+        projectiles[i].pos = Vector3Add(projectiles[i].pos, Vector3Scale(projectiles[i].vel, dt));
+        projectiles[i].life -= dt;
+        if (projectiles[i].life <= 0) { projectiles[i].active = false; continue; }
+        // Hit check
+        int near[16];
+        int nearCount = SpatialHashQueryRadius(&unitGrid, projectiles[i].pos, 1.0f, near, 16);
+        for (int n = 0; n < nearCount; n++) {
+            int u = near[n];
+            if (projectiles[i].owner >= 0 && units[u].faction == units[projectiles[i].owner].faction) continue;
+            if (projectiles[i].owner < 0 && units[u].faction == FACTION_ENEMY) continue; // tower shots hit player
+            if (Vector3Distance(projectiles[i].pos, units[u].pos) < 1.0f) {
+                units[u].hp -= projectiles[i].damage;
+                SpawnParticleBurst(particles, MAX_PARTICLES, units[u].pos, 4, 1, 4, 0.2f, 0.5f, 0.05f, 0.15f);
+                if (units[u].hp <= 0) {
+                    KillUnit(u);
+                    SpawnParticleBurst(particles, MAX_PARTICLES, units[u].pos, 10, 2, 8, 0.3f, 1.0f, 0.1f, 0.3f);
+                    if (units[u].faction == FACTION_ENEMY) resources += 5;
+                }
+                projectiles[i].active = false;
+                break;
+            }
+        }
+    }
+
+    // Update particles
+    UpdateParticles3D(particles, MAX_PARTICLES, dt, 10.0f);
+}
+
+#ifdef SIM_HEADLESS
+#define SIM_ARMY 600   // units per side fielded at the start of a headless run
+
+// Scripted commander: every 10 s selects the whole army and sends it at the
+// enemy base; trains a unit whenever there is money for one.
+static void SimScript(int t) {
+    if (t % 600 == 0) {
+        HANDLE_POOL_FOREACH(&unitPool, i) units[i].selected = (units[i].faction == FACTION_PLAYER);
+        OrderSelected((Vector3){25, 0, 25});
+    }
+    TrainUnit((UnitType)(t % 3));
+}
+
+// Command line: <ticks> [seed] [extra worker threads, 0 = one per spare core]
+int main(int argc, char **argv) {
+    SimRun run = SimBegin("rts", argc, argv, 60 * 60);
+    int workers = JobsInit(argc > 3 ? atoi(argv[3]) : 0);
+    InitGame();
+    for (int i = 0; i < SIM_ARMY; i++) {
+        Vector3 off = { (float)GetRandomValue(-120, 120) / 10.0f, 0, (float)GetRandomValue(-120, 120) / 10.0f };
+        SpawnUnit((UnitType)(i % 3), FACTION_PLAYER, Vector3Add((Vector3){-20, 0, -20}, off));
+        int e = SpawnUnit((UnitType)(i % 3), FACTION_ENEMY, Vector3Add((Vector3){20, 0, 20}, off));
+        if (e >= 0) units[e].target = (Vector3){-25, 0, -25};
+    }
+
+    for (int t = 0; t < run.ticks; t++) {
+        SimInputNextTick();
+        SimScript(t);
+        UpdateWorld(1.0f / 60.0f);
+    }
+    int rc = SimEnd(&run);
+    int alive[2] = {0, 0};
+    HANDLE_POOL_FOREACH(&unitPool, i) alive[units[i].faction]++;
+    printf("  %d player / %d enemy units left, %d extra worker threads\n",
+           alive[FACTION_PLAYER], alive[FACTION_ENEMY], workers - 1);
+    JobsShutdown();
+    return rc;
+}
+#else
 int main(void) {
     SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     InitWindow(1280, 720, "RTS");
     MaximizeWindow();
     SetTargetFPS(60);
+    JobsInit(0);
 
     InitGame();
 
@@ -370,7 +552,6 @@ int main(void) {
     while (!WindowShouldClose()) {
         float dt = GetFrameTime();
         if (dt > 0.05f) dt = 0.05f;
-        gameTime += dt;
         int sw = GetScreenWidth(), sh = GetScreenHeight();
         Vector2 mouse = GetMousePosition();
 
@@ -399,9 +580,6 @@ int main(void) {
         Vector3 groundHit = ScreenToGround(mouse, camera);
         bool overUI = (mouse.x < 200 || mouse.y > sh - 80);
 
-        // Resource income
-        if ((int)(gameTime * 10) % 50 == 0) resources++;
-
         // --- Input ---
         // Build mode keys
         if (IsKeyPressed(KEY_B)) buildMode = 0; // barracks
@@ -423,19 +601,7 @@ int main(void) {
         if (IsKeyPressed(KEY_TWO)) trainType = 1;
         if (IsKeyPressed(KEY_THREE)) trainType = 2;
         if (trainType >= 0) {
-            int cost = (trainType == 2) ? 20 : 10;
-            if (resources >= cost) {
-                // Find player barracks
-                for (int i = 0; i < MAX_BUILDINGS; i++) {
-                    if (!buildings[i].active || buildings[i].faction != FACTION_PLAYER || buildings[i].type != BLDG_BARRACKS) continue;
-                    Vector3 sp = buildings[i].pos;
-                    sp.x += (float)GetRandomValue(-20, 20) / 10.0f;
-                    sp.z += 3.0f;
-                    SpawnUnit((UnitType)trainType, FACTION_PLAYER, sp);
-                    resources -= cost;
-                    break;
-                }
-            }
+            TrainUnit((UnitType)trainType);
             trainType = -1;
         }
 
@@ -479,57 +645,10 @@ int main(void) {
             }
 
             // Right click: move/attack
-            if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) && !overUI) {
-                // Formation spread
-                int selCount = 0;
-                for (int i = 0; i < MAX_UNITS; i++) if (units[i].selected) selCount++;
-                int placed = 0;
-                int cols = (int)ceilf(sqrtf((float)selCount));
-                for (int i = 0; i < MAX_UNITS; i++) {
-                    if (!units[i].selected) continue;
-                    int row = placed / cols, col = placed % cols;
-                    units[i].target = (Vector3){
-                        groundHit.x + (col - cols/2) * 1.5f,
-                        0,
-                        groundHit.z + row * 1.5f
-                    };
-                    units[i].targetUnit = -1; // Clear attack target, let AI re-acquire
-                    placed++;
-                }
-            }
-        }
-
-        // Update
-        for (int i = 0; i < MAX_UNITS; i++) UpdateUnit(&units[i], i, dt);
-        EnemyAI(dt);
-
-        // Update projectiles
-        for (int i = 0; i < MAX_PROJECTILES; i++) {
-            if (!projectiles[i].active) continue;
-            projectiles[i].pos = Vector3Add(projectiles[i].pos, Vector3Scale(projectiles[i].vel, dt));
-            projectiles[i].life -= dt;
-            if (projectiles[i].life <= 0) { projectiles[i].active = false; continue; }
-            // Hit check
-            for (int u = 0; u < MAX_UNITS; u++) {
-                if (!units[u].active) continue;
-                if (projectiles[i].owner >= 0 && units[u].faction == units[projectiles[i].owner].faction) continue;
-                if (projectiles[i].owner < 0 && units[u].faction == FACTION_ENEMY) continue; // tower shots hit player
-                if (Vector3Distance(projectiles[i].pos, units[u].pos) < 1.0f) {
-                    units[u].hp -= projectiles[i].damage;
-                    SpawnParticleBurst(particles, MAX_PARTICLES, units[u].pos, 4, 1, 4, 0.2f, 0.5f, 0.05f, 0.15f);
-                    if (units[u].hp <= 0) {
-                        units[u].active = false;
-                        SpawnParticleBurst(particles, MAX_PARTICLES, units[u].pos, 10, 2, 8, 0.3f, 1.0f, 0.1f, 0.3f);
-                        if (units[u].faction == FACTION_ENEMY) resources += 5;
-                    }
-                    projectiles[i].active = false;
-                    break;
-                }
-            }
+            if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) && !overUI) OrderSelected(groundHit);
         }
 
-        // Update particles
-        UpdateParticles3D(particles, MAX_PARTICLES, dt, 10.0f);
+        UpdateWorld(dt);
 
         // --- Draw ---
         BeginDrawing();
@@ -669,6 +788,8 @@ int main(void) {
         EndDrawing();
     }
 
+    JobsShutdown();
     CloseWindow();
     return 0;
 }
+#endif
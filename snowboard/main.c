@@ -1,5 +1,6 @@
 #include "raylib.h"
 #include "raymath.h"
+#include "../common/util/noise.h"
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -131,26 +132,31 @@ static TreeObj trees[NUM_TREES];
 static Gate gates[NUM_GATES];
 
 // Slope height: gentle downhill with undulations
-float SlopeHeight(float x, float z) {
-    // Main downhill gradient — rider goes in -Z, height decreases
-    float h = z * 0.6f;
-    // Undulations
-    h += sinf(z * 0.05f) * 3.0f;
-    h += cosf(z * 0.08f + x * 0.1f) * 1.5f;
-    // Banked edges
+static const Heightfield slopeField = {
+    .slopeZ = 0.6f,    // main downhill gradient — rider goes in -Z, height decreases
+    .waves = {         // undulations
+        { .kz = 0.05f, .amp = 3.0f },
+        { .kx = 0.1f, .kz = 0.08f, .phase = PI / 2, .amp = 1.5f },
+    },
+    .waveCount = 2,
+};
+
+// Banked edges: a ramp on the outer 30% of each side
+float SlopeBank(float x, float *ddx) {
     float edge = fabsf(x) / (SLOPE_WIDTH / 2.0f);
-    if (edge > 0.7f) h += (edge - 0.7f) * 8.0f;
-    return h;
+    if (ddx) *ddx = (edge > 0.7f) ? copysignf(8.0f / (SLOPE_WIDTH / 2.0f), x) : 0.0f;
+    return (edge > 0.7f) ? (edge - 0.7f) * 8.0f : 0.0f;
+}
+
+float SlopeHeight(float x, float z) {
+    return HeightfieldSample(&slopeField, x, z) + SlopeBank(x, NULL);
 }
 
 Vector3 SlopeNormal(float x, float z) {
-    float eps = 0.5f;
-    float hc = SlopeHeight(x, z);
-    float hx = SlopeHeight(x + eps, z);
-    float hz = SlopeHeight(x, z + eps);
-    Vector3 dx = { eps, hx - hc, 0 };
-    Vector3 dz = { 0, hz - hc, eps };
-    return Vector3Normalize(Vector3CrossProduct(dz, dx));
+    float gx, gz, bank;
+    HeightfieldSampleD(&slopeField, x, z, &gx, &gz);
+    SlopeBank(x, &bank);
+    return Vector3Normalize((Vector3){ -(gx + bank), 1.0f, -gz });
 }
 
 void GenerateCourse(void) {
@@ -200,12 +206,24 @@ void DrawSlope(Vector3 camPos) {
     float zStart = floorf((camPos.z + 20) / step) * step;
     float zEnd = camPos.z - viewDist;
 
-    for (float z = zStart; z > zEnd; z -= step) {
-        for (float x = -SLOPE_WIDTH / 2; x < SLOPE_WIDTH / 2; x += step) {
-            Vector3 p00 = { x, SlopeHeight(x, z), z };
-            Vector3 p10 = { x + step, SlopeHeight(x + step, z), z };
-            Vector3 p01 = { x, SlopeHeight(x, z - step), z - step };
-            Vector3 p11 = { x + step, SlopeHeight(x + step, z - step), z - step };
+    // Heights per grid line, shared by the quads on both sides of it
+    int cols = (int)(SLOPE_WIDTH / step);
+    float rows[2][64];
+    float x0 = -SLOPE_WIDTH / 2;
+    HeightfieldRow(&slopeField, x0, step, zStart, cols + 1, rows[0]);
+    for (int i = 0; i <= cols; i++) rows[0][i] += SlopeBank(x0 + i * step, NULL);
+
+    int j = 0;
+    for (float z = zStart; z > zEnd; z -= step, j++) {
+        float *row0 = rows[j & 1], *row1 = rows[(j + 1) & 1];
+        HeightfieldRow(&slopeField, x0, step, z - step, cols + 1, row1);
+        for (int i = 0; i <= cols; i++) row1[i] += SlopeBank(x0 + i * step, NULL);
+        for (int i = 0; i < cols; i++) {
+            float x = x0 + i * step;
+            Vector3 p00 = { x, row0[i], z };
+            Vector3 p10 = { x + step, row0[i + 1], z };
+            Vector3 p01 = { x, row1[i], z - step };
+            Vector3 p11 = { x + step, row1[i + 1], z - step };
 
             // Color based on position (snow with tracks)
             int shade = 200 + (int)(sinf(x * 0.5f + z * 0.3f) * 20);
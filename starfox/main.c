@@ -2,8 +2,11 @@
 #include "raymath.h"
 #include "rlgl.h"
 #include "../common/objects3d.h"
+#include "../common/util/math.h"
+#include "../common/util/noise.h"
 #include <math.h>
 #include <stdlib.h>
+#include <time.h>
 
 // Star Fox style on-rails shooter: Arwing flies forward automatically,
 // player steers within a corridor, shoots enemies and dodges obstacles
@@ -149,11 +152,18 @@ static bool gameOver = false;
 static float gameOverTimer = 0;
 
 // Terrain
+static const Heightfield terrainField = {
+    .waves = {
+        { .kx = 0.015f, .amp = 3.0f },
+        { .kz = 0.01f, .phase = PI / 2, .amp = 2.0f },
+        { .kx = 0.04f, .kz = 0.02f, .amp = 1.5f },
+    },
+    .waveCount = 3,
+    .clampFloor = true,
+};
+
 float TerrainHeight(float x, float z) {
-    float h = sinf(x * 0.015f) * 3.0f + cosf(z * 0.01f) * 2.0f;
-    h += sinf(x * 0.04f + z * 0.02f) * 1.5f;
-    if (h < 0) h = 0;
-    return h;
+    return HeightfieldSample(&terrainField, x, z);
 }
 
 // Spawn explosion particles
@@ -205,8 +215,10 @@ void SpawnEnemy(void) {
 static float nextBuildingZ = 0;
 static float nextPillarZ = 0;
 static float nextRingZ = 0;
+static Rng worldRng;   // obstacle layout; one seed replays the same course
 
-void SpawnObstaclesInit(void) {
+void SpawnObstaclesInit(uint64_t seed) {
+    worldRng = RngStream(seed, RNG_STREAM_WORLD);
     nextBuildingZ = scrollZ + 50.0f;
     nextPillarZ = scrollZ + 50.0f;
     nextRingZ = scrollZ + 50.0f;
@@ -227,20 +239,20 @@ void RecycleObstacles(void) {
             if (buildings[i].pos.z < behindZ) { slot = i; break; }
         }
         if (slot < 0) break;
-        float x = (float)GetRandomValue(-350, 350) / 10.0f;
-        float h = 5.0f + (float)GetRandomValue(0, 150) / 10.0f;
-        float w = 3.0f + (float)GetRandomValue(0, 40) / 10.0f;
-        float d = 3.0f + (float)GetRandomValue(0, 40) / 10.0f;
+        float x = (float)RngInt(&worldRng, -350, 350) / 10.0f;
+        float h = 5.0f + (float)RngInt(&worldRng, 0, 150) / 10.0f;
+        float w = 3.0f + (float)RngInt(&worldRng, 0, 40) / 10.0f;
+        float d = 3.0f + (float)RngInt(&worldRng, 0, 40) / 10.0f;
         float bGroundH = TerrainHeight(x, nextBuildingZ);
         buildings[slot].pos = (Vector3){x, bGroundH + h / 2.0f, nextBuildingZ};
         buildings[slot].w = w;
         buildings[slot].h = h;
         buildings[slot].d = d;
-        int cv = GetRandomValue(0, 2);
+        int cv = RngInt(&worldRng, 0, 2);
         if (cv == 0) buildings[slot].color = (Color){130, 125, 120, 255};
         else if (cv == 1) buildings[slot].color = (Color){100, 110, 120, 255};
         else buildings[slot].color = (Color){140, 130, 110, 255};
-        nextBuildingZ += 15.0f + (float)GetRandomValue(0, 100) / 10.0f;
+        nextBuildingZ += 15.0f + (float)RngInt(&worldRng, 0, 100) / 10.0f;
     }
 
     // Recycle pillars
@@ -250,15 +262,15 @@ void RecycleObstacles(void) {
             if (pillars[i].pos.z < behindZ) { slot = i; break; }
         }
         if (slot < 0) break;
-        float x = (float)GetRandomValue(-250, 250) / 10.0f;
-        float h = 10.0f + (float)GetRandomValue(0, 100) / 10.0f;
+        float x = (float)RngInt(&worldRng, -250, 250) / 10.0f;
+        float h = 10.0f + (float)RngInt(&worldRng, 0, 100) / 10.0f;
         float groundH = TerrainHeight(x, nextPillarZ);
         pillars[slot].pos = (Vector3){x, groundH, nextPillarZ};
         pillars[slot].w = 1.5f;
         pillars[slot].h = h;
         pillars[slot].d = 1.5f;
         pillars[slot].color = (Color){90, 85, 80, 255};
-        nextPillarZ += 20.0f + (float)GetRandomValue(0, 100) / 10.0f;
+        nextPillarZ += 20.0f + (float)RngInt(&worldRng, 0, 100) / 10.0f;
     }
 
     // Recycle rings
@@ -268,16 +280,16 @@ void RecycleObstacles(void) {
             if (rings[i].pos.z < behindZ || rings[i].collected) { slot = i; break; }
         }
         if (slot < 0) break;
-        float x = (float)GetRandomValue(-150, 150) / 10.0f;
-        float y = 5.0f + (float)GetRandomValue(0, 100) / 10.0f;
+        float x = (float)RngInt(&worldRng, -150, 150) / 10.0f;
+        float y = 5.0f + (float)RngInt(&worldRng, 0, 100) / 10.0f;
         rings[slot].pos = (Vector3){x, y, nextRingZ};
         rings[slot].radius = 3.0f;
         rings[slot].collected = false;
-        nextRingZ += 25.0f + (float)GetRandomValue(0, 100) / 10.0f;
+        nextRingZ += 25.0f + (float)RngInt(&worldRng, 0, 100) / 10.0f;
     }
 }
 
-void InitGame(void) {
+void InitGame(uint64_t seed) {
     LoadOrCreate("objects/arwing.obj3d", arwingParts, &arwingPartCount,
         arwingFallback, sizeof(arwingFallback)/sizeof(Part));
     LoadOrCreate("objects/enemy_fighter.obj3d", enemyParts, &enemyPartCount,
@@ -299,15 +311,19 @@ void InitGame(void) {
     for (int i = 0; i < MAX_ENEMIES; i++) enemies[i].active = false;
     for (int i = 0; i < MAX_PARTICLES; i++) particles[i].active = false;
 
-    SpawnObstaclesInit();
+    SpawnObstaclesInit(seed);
     RecycleObstacles();
 }
 
-int main(void) {
+int main(int argc, char **argv) {
+    // Optional argument: the course seed to replay; each restart moves to the next one
+    uint64_t seed = (argc > 1) ? strtoull(argv[1], NULL, 10) : (uint64_t)time(NULL);
+
     InitWindow(1280, 720, "Star Fox");
     SetTargetFPS(60);
 
-    InitGame();
+    TraceLog(LOG_INFO, "STARFOX: course seed %llu", (unsigned long long)seed);
+    InitGame(seed);
 
     Camera3D camera = {0};
     camera.fovy = 55.0f;
@@ -321,7 +337,11 @@ int main(void) {
         // --- Restart ---
         if (gameOver) {
             gameOverTimer += dt;
-            if (IsKeyPressed(KEY_ENTER) && gameOverTimer > 1.0f) InitGame();
+            if (IsKeyPressed(KEY_ENTER) && gameOverTimer > 1.0f) {
+                seed++;
+                TraceLog(LOG_INFO, "STARFOX: course seed %llu", (unsigned long long)seed);
+                InitGame(seed);
+            }
         }
 
         if (!gameOver) {
@@ -514,9 +534,13 @@ int main(void) {
         {
             float gx0 = floorf((player.pos.x - 200) / 10) * 10;
             float gz0 = floorf((scrollZ - 100) / 10) * 10;
-            for (float gx = gx0; gx < gx0 + 400; gx += 10) {
-                for (float gz = gz0; gz < gz0 + 400; gz += 10) {
-                    float h = TerrainHeight(gx + 5, gz + 5);
+            float heights[40];
+            for (int j = 0; j < 40; j++) {
+                float gz = gz0 + j * 10.0f;
+                HeightfieldRow(&terrainField, gx0 + 5, 10.0f, gz + 5, 40, heights);
+                for (int i = 0; i < 40; i++) {
+                    float gx = gx0 + i * 10.0f;
+                    float h = heights[i];
                     Color gc;
                     if (h < 0.5f) gc = (Color){50, 110, 50, 255};
                     else if (h < 2.0f) gc = (Color){60, 120, 55, 255};
@@ -0,0 +1,398 @@
+// util-bench: CPU microbenchmarks for common/util/*.h
+// Headless like util-tests: no InitWindow, only pure-logic paths are timed.
+// Prints one line per benchmark; compare runs on the same machine only.
+//
+// Timing uses clock() (process CPU time), averaged over many iterations so
+// its coarse resolution on some platforms does not matter.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "raylib.h"
+#include "raymath.h"
+
+#include "../common/util/collide.h"
+#include "../common/util/fx.h"
+#include "../common/util/noise.h"
+#include "../common/util/pack.h"
+#include "../common/sprites2d.h"
+#include "../common/map3d.h"
+
+static double NowSec(void) { return (double)clock() / (double)CLOCKS_PER_SEC; }
+
+static void Report(const char *name, double totalSec, int iters, int items) {
+    double perIter = totalSec / (double)iters;
+    printf("%-34s %9.3f ms/iter  %8.2f ns/item\n",
+           name, perIter * 1e3, perIter * 1e9 / (double)items);
+}
+
+// 100k live particles: the AoS pool the games use today vs the SoA store.
+// Lifetimes are long enough that nothing dies during the run, so both paths
+// do the same amount of integration work every iteration.
+static void bench_particles(void) {
+    enum { N = 100000, ITERS = 200 };
+    const float dt = 1.0f / 60.0f;
+    SetRandomSeed(1);
+
+    Particle3D *aos = (Particle3D *)calloc(N, sizeof(Particle3D));
+    SpawnParticleBurst(aos, N, (Vector3){0, 0, 0}, N, 1.0f, 8.0f, 1e6f, 1e6f, 0.1f, 0.3f);
+    double t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) UpdateParticles3D(aos, N, dt, 10.0f);
+    Report("particles AoS UpdateParticles3D", NowSec() - t0, ITERS, N);
+    free(aos);
+
+    ParticleSoA soa;
+    InitParticlesSoA(&soa, N);
+    SpawnParticleBurstSoA(&soa, (Vector3){0, 0, 0}, N, 1.0f, 8.0f, 1e6f, 1e6f, 0.1f, 0.3f);
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) UpdateParticlesSoA(&soa, dt, (Vector3){0, -10.0f, 0});
+    Report("particles SoA UpdateParticlesSoA", NowSec() - t0, ITERS, soa.count);
+
+    // Steady-state churn: refill what died each frame (exercises swap-remove
+    // and tail append together).
+    ClearParticlesSoA(&soa);
+    SpawnParticleBurstSoA(&soa, (Vector3){0, 0, 0}, N, 1.0f, 8.0f, 0.2f, 2.0f, 0.1f, 0.3f);
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        UpdateParticlesSoA(&soa, dt, (Vector3){0, -10.0f, 0});
+        SpawnParticleBurstSoA(&soa, (Vector3){0, 0, 0}, N - soa.count, 1.0f, 8.0f, 0.2f, 2.0f, 0.1f, 0.3f);
+    }
+    Report("particles SoA update+respawn", NowSec() - t0, ITERS, N);
+    FreeParticlesSoA(&soa);
+}
+
+// 4k units on an 80x80 field (rts density at scale): every unit asks for its
+// neighbours within 1.2 — brute force vs the spatial hash, with the hash
+// kept current incrementally (one SpatialHashMove per unit per frame).
+static void bench_broadphase(void) {
+    enum { N = 4096, ITERS = 20, MAXN = 64 };
+    static Vector3 pos[N];
+    static int heads[2 * N];
+    static SpatialHashEntry entries[N];
+    static int near[MAXN];
+    SetRandomSeed(2);
+    for (int i = 0; i < N; i++)
+        pos[i] = (Vector3){ GetRandomValue(-4000, 4000) / 100.0f, 0, GetRandomValue(-4000, 4000) / 100.0f };
+
+    volatile int sink = 0;
+    double t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        for (int i = 0; i < N; i++) {
+            int n = 0;
+            for (int j = 0; j < N; j++) {
+                float dx = pos[i].x - pos[j].x, dz = pos[i].z - pos[j].z;
+                if (dx*dx + dz*dz < 1.2f * 1.2f && n < MAXN) near[n++] = j;
+            }
+            sink += n;
+        }
+    }
+    Report("broadphase brute force N^2", NowSec() - t0, ITERS, N);
+
+    SpatialHash grid;
+    SpatialHashInit(&grid, heads, 2 * N, entries, N, 2.0f);
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        for (int i = 0; i < N; i++) {
+            pos[i].x += (it & 1) ? 0.05f : -0.05f;
+            SpatialHashMove(&grid, i, pos[i]);
+        }
+        for (int i = 0; i < N; i++) sink += SpatialHashQueryRadius(&grid, pos[i], 1.2f, near, MAXN);
+    }
+    Report("broadphase SpatialHash move+query", NowSec() - t0, ITERS, N);
+
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        for (int i = 0; i < N; i++)
+            sink += SpatialHashQueryNearest(&grid, pos[i], 30.0f, 1, NULL, NULL, near, NULL);
+    }
+    Report("broadphase SpatialHash nearest-1", NowSec() - t0, ITERS, N);
+    (void)sink;
+}
+
+// One sphere query against 1024 spheres: pairwise SphereOverlap per shape
+// vs the SoA batch kernel producing a hit mask.
+static void bench_overlap(void) {
+    enum { N = 1024, ITERS = 20000 };
+    static float x[N], y[N], z[N], r[N];
+    static Sphere aos[N];
+    static uint64_t mask[COLLIDE_MASK_WORDS(N)];
+    SetRandomSeed(3);
+    for (int i = 0; i < N; i++) {
+        x[i] = GetRandomValue(-1000, 1000) / 100.0f;
+        y[i] = GetRandomValue(-1000, 1000) / 100.0f;
+        z[i] = GetRandomValue(-1000, 1000) / 100.0f;
+        r[i] = GetRandomValue(10, 100) / 100.0f;
+        aos[i] = (Sphere){ {x[i], y[i], z[i]}, r[i] };
+    }
+    SphereSoA soa = { x, y, z, r, N };
+    volatile int sink = 0;
+    double t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        Sphere q = { {(float)(it % 7) - 3.0f, 0, 0}, 2.0f };
+        int hits = 0;
+        for (int i = 0; i < N; i++) hits += SphereOverlap(q, aos[i]);
+        sink += hits;
+    }
+    Report("overlap SphereOverlap pairwise", NowSec() - t0, ITERS, N);
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        Sphere q = { {(float)(it % 7) - 3.0f, 0, 0}, 2.0f };
+        sink += SphereOverlapBatch(q, &soa, mask);
+    }
+    Report("overlap SphereOverlapBatch SoA", NowSec() - t0, ITERS, N);
+    (void)sink;
+}
+
+// 1M floats in [0.1, 0.3): raylib's global GetRandomValue (what RandF uses),
+// a scalar xoshiro stream, and the lane-parallel fill.
+static void bench_rng(void) {
+    enum { N = 1 << 20, ITERS = 20 };
+    float *out = (float *)malloc(N * sizeof(float));
+    volatile float sink = 0.0f;
+
+    SetRandomSeed(1);
+    double t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        for (int i = 0; i < N; i++) out[i] = RandF(0.1f, 0.3f);
+        sink += out[it];
+    }
+    Report("rng RandF (GetRandomValue)", NowSec() - t0, ITERS, N);
+
+    Rng r = RngStream(1, RNG_STREAM_FX);
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        RngFillFloats(&r, out, N, 0.1f, 0.3f);
+        sink += out[it];
+    }
+    Report("rng RngFillFloats", NowSec() - t0, ITERS, N);
+
+    RngWide w = RngWideStream(1, RNG_STREAM_FX);
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        RngWideFillFloats(&w, out, N, 0.1f, 0.3f);
+        sink += out[it];
+    }
+    Report("rng RngWideFillFloats", NowSec() - t0, ITERS, N);
+    free(out);
+    (void)sink;
+}
+
+// biplane's DrawTerrain: 100x100 cells. The old path called the scalar
+// sinf height function at all four corners of every cell; the row path
+// evaluates each grid line once and shares it between neighbouring cells.
+static float OldTerrainHeight(float x, float z) {
+    float h = sinf(x * 0.02f) * 8.0f + cosf(z * 0.015f) * 6.0f;
+    h += sinf(x * 0.05f + z * 0.03f) * 3.0f;
+    if (h < 0) h = 0;
+    return h;
+}
+
+static void bench_heightfield(void) {
+    enum { CELLS = 100, ITERS = 200 };
+    const float step = 10.0f, x0 = -500.0f, z0 = -500.0f;
+    static const Heightfield hf = {
+        .waves = { { .kx = 0.02f, .amp = 8.0f }, { .kz = 0.015f, .phase = PI / 2, .amp = 6.0f },
+                   { .kx = 0.05f, .kz = 0.03f, .amp = 3.0f } },
+        .waveCount = 3, .clampFloor = true,
+    };
+    volatile float sink = 0.0f;
+
+    double t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        float acc = 0.0f;
+        for (int j = 0; j < CELLS; j++)
+            for (int i = 0; i < CELLS; i++) {
+                float x = x0 + i * step, z = z0 + j * step + (float)it;
+                acc += OldTerrainHeight(x, z) + OldTerrainHeight(x + step, z)
+                     + OldTerrainHeight(x, z + step) + OldTerrainHeight(x + step, z + step);
+            }
+        sink += acc;
+    }
+    Report("terrain sinf x4 per cell", NowSec() - t0, ITERS, CELLS * CELLS);
+
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        float acc = 0.0f;
+        for (int j = 0; j < CELLS; j++)
+            for (int i = 0; i < CELLS; i++) {
+                float x = x0 + i * step, z = z0 + j * step + (float)it;
+                acc += HeightfieldSample(&hf, x, z) + HeightfieldSample(&hf, x + step, z)
+                     + HeightfieldSample(&hf, x, z + step) + HeightfieldSample(&hf, x + step, z + step);
+            }
+        sink += acc;
+    }
+    Report("terrain HeightfieldSample x4", NowSec() - t0, ITERS, CELLS * CELLS);
+
+    float rows[2][CELLS + 1];
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        float acc = 0.0f;
+        HeightfieldRow(&hf, x0, step, z0 + (float)it, CELLS + 1, rows[0]);
+        for (int j = 0; j < CELLS; j++) {
+            float *row0 = rows[j & 1], *row1 = rows[(j + 1) & 1];
+            HeightfieldRow(&hf, x0, step, z0 + (j + 1) * step + (float)it, CELLS + 1, row1);
+            for (int i = 0; i < CELLS; i++) acc += row0[i] + row0[i + 1] + row1[i] + row1[i + 1];
+        }
+        sink += acc;
+    }
+    Report("terrain HeightfieldRow shared", NowSec() - t0, ITERS, CELLS * CELLS);
+
+    float h[CELLS + 1], dx[CELLS + 1], dz[CELLS + 1];
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        for (int j = 0; j <= CELLS; j++) {
+            HeightfieldRowD(&hf, x0, step, z0 + j * step + (float)it, CELLS + 1, h, dx, dz);
+            sink += h[j % CELLS] + dx[0] + dz[0];
+        }
+    }
+    Report("terrain HeightfieldRowD +normals", NowSec() - t0, ITERS, CELLS * CELLS);
+    (void)sink;
+}
+
+// Cold-start asset loading: a fighter-sized set of sprite frames parsed from
+// text files one fopen at a time, vs the same frames from one mounted pack
+// (the mount/unmount is inside the timed loop). Files are written to the
+// working directory and removed afterwards.
+static void bench_pack(void) {
+    enum { FILES = 64, PARTS = 40, ITERS = 50 };
+    static SpriteFrame frame;
+    char paths[FILES][32];
+    PackBuilder builder = { 0 };
+    PackBuffer blob = { 0 };
+    SetRandomSeed(3);
+    for (int i = 0; i < FILES; i++) {
+        Sprite2DPart parts[PARTS];
+        for (int j = 0; j < PARTS; j++)
+            parts[j] = (Sprite2DPart){ (Sprite2DType)(j % 6), (float)GetRandomValue(-40, 40), (float)GetRandomValue(-80, 0),
+                                       (float)GetRandomValue(1, 20), (float)GetRandomValue(1, 20), 2.0f, 3.0f,
+                                       { (unsigned char)(j * 5), 80, 120, 255 } };
+        snprintf(paths[i], sizeof(paths[i]), "util-bench-%02d.spr2d", i);
+        SaveSprite2D(paths[i], parts, PARTS);
+        LoadSpriteFrame(paths[i], &frame);
+        blob.size = 0;
+        WriteSpriteFrameBinary(&blob, &frame);
+        PackBuilderAdd(&builder, paths[i], PACK_SPR2D, blob.data, blob.size);
+    }
+    PackBuilderSave(&builder, "util-bench.pack");
+    PackBufferFree(&blob);
+    PackBuilderFree(&builder);
+    volatile int sink = 0;
+
+    double t0 = NowSec();
+    for (int it = 0; it < ITERS; it++)
+        for (int i = 0; i < FILES; i++) sink += LoadSpriteFrame(paths[i], &frame);
+    Report("sprite frames from text files", NowSec() - t0, ITERS, FILES);
+
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        PackMount("util-bench.pack");
+        for (int i = 0; i < FILES; i++) sink += LoadSpriteFrame(paths[i], &frame);
+        PackUnmount();
+    }
+    Report("sprite frames from mounted pack", NowSec() - t0, ITERS, FILES);
+
+    for (int i = 0; i < FILES; i++) remove(paths[i]);
+    remove("util-bench.pack");
+    (void)sink;
+}
+
+// A 4096x4096 map with a painted 1024x1024 island (walls, water, mixed
+// floor) loaded four ways: the text import, the binary file read whole (raw
+// and LZ chunks), and OpenMap3D plus the first Map3DStream around a camera,
+// which is all a streaming game waits for. Then vision-fan raycasts over the
+// map read whole with LoadMap3DBinary (every chunk in memory).
+static void bench_map3d(void) {
+    enum { SIZE = 4096, ISLAND = 1024, ITERS = 5 };
+    TileDef defs[4] = { { TILE_EMPTY, 0, BLANK, BLANK }, { TILE_FLOOR, 0, GREEN, DARKGREEN },
+                        { TILE_WALL, 2, GRAY, DARKGRAY }, { TILE_WATER, 0, BLUE, DARKBLUE } };
+    static Map3D map;
+    InitMap3D(&map, SIZE, SIZE, 2.0f, defs, 4);
+    for (int z = 0; z < ISLAND; z++)
+        for (int x = 0; x < ISLAND; x++) {
+            int h = (x * 7 + z * 13 + (x * z) % 29) % 97;
+            Map3DSet(&map, 1500 + x, 1500 + z, h < 6 ? 2 : h < 10 ? 3 : 1);
+        }
+    SaveMap3D("util-bench.m3d", &map);
+    SaveMap3DBinary("util-bench-raw.m3db", &map, false);
+    SaveMap3DBinary("util-bench-lz.m3db", &map, true);
+    int chunks = map.chunkCount;
+    volatile int sink = 0;
+
+    double t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) sink += LoadMap3DFile("util-bench.m3d", &map, defs, 4);
+    Report("4096^2 map from text", NowSec() - t0, ITERS, chunks);
+
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) sink += LoadMap3DBinary("util-bench-raw.m3db", &map);
+    Report("4096^2 map from binary, raw", NowSec() - t0, ITERS, chunks);
+
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) sink += LoadMap3DBinary("util-bench-lz.m3db", &map);
+    Report("4096^2 map from binary, LZ", NowSec() - t0, ITERS, chunks);
+
+    Vector3 cam = { 2000 * 2.0f, 0, 2000 * 2.0f };
+    t0 = NowSec();
+    for (int it = 0; it < ITERS; it++) {
+        sink += OpenMap3D(&map, "util-bench-lz.m3db");
+        sink += Map3DStream(&map, cam, 120.0f, 64);
+    }
+    Report("4096^2 map opened + first stream", NowSec() - t0, ITERS, chunks);
+
+    printf("  files: text %d, raw %d, LZ %d bytes\n", GetFileLength("util-bench.m3d"),
+           GetFileLength("util-bench-raw.m3db"), GetFileLength("util-bench-lz.m3db"));
+
+    // A guard's 64-ray vision fan, 200 units, over the island's walls, with
+    // the whole map loaded so no ray crosses an unread chunk
+    enum { RAYS = 64, FANS = 2000 };
+    Ray fan[RAYS];
+    Map3DHit hits[RAYS];
+    LoadMap3DBinary("util-bench-lz.m3db", &map);
+    for (int i = 0; i < RAYS; i++) {
+        float a = 2.0f * PI * (float)i / RAYS;
+        fan[i] = (Ray){ { 2012.0f * 2.0f, 1.0f, 2012.0f * 2.0f }, { cosf(a), -0.002f, sinf(a) } };
+    }
+    t0 = NowSec();
+    for (int it = 0; it < FANS; it++) sink += Map3DRaycastBatch(&map, fan, RAYS, 200.0f, hits);
+    Report("Map3DRaycastBatch, 64-ray fan", NowSec() - t0, FANS, RAYS);
+
+    // Culling a frame where nothing changed: the tree walk alone, no baking.
+    // Then the same on the streamed map, Map3DStream included, camera still.
+    enum { FRAMES = 2000 };
+    VisibleList vis;
+    InitVisibleList(&vis, map.chunksX * map.chunksZ);
+    Camera3D eye = { { 2012.0f * 2.0f, 40.0f, 2012.0f * 2.0f }, { 2100.0f * 2.0f, 0.0f, 2050.0f * 2.0f },
+                     { 0, 1, 0 }, 60.0f, CAMERA_PERSPECTIVE };
+    Frustum view = CameraFrustumDefault(eye, 16.0f / 9.0f);
+    Map3DBake(&map);
+    t0 = NowSec();
+    for (int it = 0; it < FRAMES; it++) sink += Map3DCull(&map, &vis, &view, eye.position);
+    Report("Map3DCull, unchanged frame", NowSec() - t0, FRAMES, vis.count);
+    OpenMap3D(&map, "util-bench-lz.m3db");
+    Map3DStream(&map, eye.position, 120.0f, 1 << 20);
+    Map3DBake(&map);
+    t0 = NowSec();
+    for (int it = 0; it < FRAMES; it++) {
+        sink += Map3DStream(&map, eye.position, 120.0f, 64);
+        sink += Map3DCull(&map, &vis, &view, eye.position);
+    }
+    Report("Map3DStream + Map3DCull, streamed", NowSec() - t0, FRAMES, map.chunkCount);
+    FreeVisibleList(&vis);
+    UnloadMap3D(&map);
+    remove("util-bench.m3d");
+    remove("util-bench-raw.m3db");
+    remove("util-bench-lz.m3db");
+    (void)sink;
+}
+
+int main(void) {
+    bench_particles();
+    bench_broadphase();
+    bench_overlap();
+    bench_rng();
+    bench_heightfield();
+    bench_pack();
+    bench_map3d();
+    return 0;
+}
@@ -1,8 +1,12 @@
-// util-tests: smoke test for common/util/*.h
+// util-tests: smoke test for common/util/*.h (plus objects3d.h's prefab compiler
+// and the binary asset forms in objects3d.h/sprites2d.h, assets.h's registry,
+// and map3d.h's chunk baking)
 // Exercises every pure-logic function with assertions.
 // Exits non-zero if any assertion fails.
 //
-// No InitWindow: the tests only touch pure-logic (math/pool/collide/camera/fx).
+// No InitWindow: the tests only touch pure-logic (math/rng/noise/pool/collide/
+// camera/fx/loop/jobs, and debug.h's profiler, compiled in here and run off a
+// fake clock).
 // raylib's RNG (GetRandomValue, SetRandomSeed) operates on private static
 // state in rprand.h and does not touch CORE.Window, so it is safe to call
 // before InitWindow. Headers for input/hud/debug are included for compile-
@@ -12,6 +16,15 @@
 #include <stdio.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+// Profiler on, timed by a clock the tests set by hand
+static uint64_t g_profNs = 0;
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE
+#endif
+#define PROFILE_NOW_NS() (g_profNs)
 
 #include "raylib.h"
 #include "raymath.h"
@@ -25,6 +38,15 @@
 #include "../common/util/hud.h"
 #include "../common/util/debug.h"
 #include "../common/util/vehicle.h"
+#include "../common/util/loop.h"
+#include "../common/util/noise.h"
+#include "../common/util/jobs.h"
+#include "../common/util/arena.h"
+#include "../common/util/pack.h"
+#include "../common/objects3d.h"
+#include "../common/sprites2d.h"
+#include "../common/assets.h"
+#include "../common/map3d.h"
 
 static int g_fails = 0;
 
@@ -178,6 +200,66 @@ static void test_pool(void) {
         sum += s->payload;
     }
     CHECK(sum == 70, "POOL_FOREACH continue skips inactive");
+
+    // HandlePool — spans two bitset words so iteration crosses a boundary
+    enum { HN = 70 };
+    static uint32_t hslots[HN];
+    static uint64_t hlive[POOL_BITSET_WORDS(HN)];
+    HandlePool hp;
+    HandlePoolInit(&hp, hslots, hlive, HN);
+    CHECK(HandlePoolCount(&hp) == 0, "HandlePool starts empty");
+
+    PoolHandle hs[HN];
+    bool inOrder = true;
+    for (int i = 0; i < HN; i++) {
+        hs[i] = HandlePoolSpawn(&hp);
+        if (hs[i] == POOL_HANDLE_NONE || PoolHandleIndex(hs[i]) != i) inOrder = false;
+    }
+    CHECK(inOrder, "HandlePoolSpawn hands out 0..N-1 in order");
+    CHECK(HandlePoolSpawn(&hp) == POOL_HANDLE_NONE, "HandlePoolSpawn full");
+    CHECK(HandlePoolCount(&hp) == HN, "HandlePoolCount full");
+
+    // Free a few, including both sides of the 64-bit word boundary
+    CHECK(HandlePoolFree(&hp, hs[3]),  "HandlePoolFree live handle");
+    CHECK(!HandlePoolFree(&hp, hs[3]), "HandlePoolFree stale handle fails");
+    HandlePoolFreeIndex(&hp, 63);
+    HandlePoolFreeIndex(&hp, 64);
+    CHECK(HandlePoolCount(&hp) == HN - 3, "HandlePoolCount after frees");
+    CHECK(HandlePoolResolve(&hp, hs[3]) == -1,  "HandlePoolResolve stale → -1");
+    CHECK(HandlePoolResolve(&hp, hs[10]) == 10, "HandlePoolResolve live");
+    CHECK(HandlePoolResolve(&hp, POOL_HANDLE_NONE) == -1, "HandlePoolResolve NONE");
+
+    // LIFO reuse: last freed slot comes back first, with a new generation
+    PoolHandle r = HandlePoolSpawn(&hp);
+    CHECK(PoolHandleIndex(r) == 64, "HandlePoolSpawn reuses last freed");
+    CHECK(PoolHandleGen(r) != PoolHandleGen(hs[64]), "Reused slot bumps generation");
+    CHECK(!HandlePoolValid(&hp, hs[64]), "Old handle to reused slot is stale");
+    CHECK(HandlePoolHandleOf(&hp, 64) == r, "HandlePoolHandleOf matches spawn");
+    CHECK(HandlePoolHandleOf(&hp, 3) == POOL_HANDLE_NONE, "HandlePoolHandleOf free slot");
+
+    // FOREACH visits exactly the live slots, ascending
+    int visited = 0, prev = -1;
+    bool ascending = true, sawFreed = false;
+    HANDLE_POOL_FOREACH(&hp, i) {
+        if (i <= prev) ascending = false;
+        if (i == 3 || i == 63) sawFreed = true;
+        prev = i;
+        visited++;
+    }
+    CHECK(visited == HandlePoolCount(&hp), "HANDLE_POOL_FOREACH visits count");
+    CHECK(ascending && !sawFreed,          "HANDLE_POOL_FOREACH skips freed");
+
+    // Freeing the current slot mid-iteration is safe
+    HANDLE_POOL_FOREACH(&hp, i) HandlePoolFreeIndex(&hp, i);
+    CHECK(HandlePoolCount(&hp) == 0, "Free-all during FOREACH empties pool");
+    int none = 0;
+    HANDLE_POOL_FOREACH(&hp, i) none++;
+    CHECK(none == 0, "HANDLE_POOL_FOREACH on empty pool");
+
+    // Reset keeps handles stale
+    HandlePoolReset(&hp);
+    PoolHandle z = HandlePoolSpawn(&hp);
+    CHECK(PoolHandleIndex(z) == 0 && z != hs[0], "HandlePoolReset: fresh handle for slot 0");
 }
 // File-scope context for test_blocked (lifted from nested function — Clang/c99
 // does not support GNU nested functions).
@@ -189,6 +271,8 @@ static bool test_blocked(Vector3 p, float r, void *u) {
         && fabsf(p.z - w.center.z) < (w.half.z + r)
         && fabsf(p.y - w.center.y) < (w.half.y + r);
 }
+// SpatialHashQueryNearest filter: id 0 is the (-10,-10) lattice corner.
+static bool test_is_corner(int id, void *u) { (void)u; return id == 0; }
 
 static void test_collide(void) {
     AABB a = { .center = {0, 0, 0}, .half = {1, 1, 1} };
@@ -211,6 +295,61 @@ static void test_collide(void) {
     CHECK(SphereOverlap(q1, q2), "Sphere overlap");
     CHECK(!SphereOverlap(q1, q3), "Sphere miss");
 
+    // Capsules
+    Capsule cap = { .a = {0, 0, 0}, .b = {0, 4, 0}, .radius = 0.5f };
+    CHECK(NEAR(ClosestPointOnSegment((Vector3){3, 2, 0}, cap.a, cap.b).y, 2.0f, 1e-5f), "ClosestPointOnSegment interior");
+    CHECK(NEAR(ClosestPointOnSegment((Vector3){0, 9, 0}, cap.a, cap.b).y, 4.0f, 1e-5f), "ClosestPointOnSegment clamps");
+    CHECK(CapsuleVsSphere(cap, (Sphere){ {0.9f, 3, 0}, 0.5f }),  "CapsuleVsSphere side hit");
+    CHECK(!CapsuleVsSphere(cap, (Sphere){ {0, 5.1f, 0}, 0.5f }), "CapsuleVsSphere past cap");
+    CHECK(CapsuleVsCapsule(cap, (Capsule){ {-2, 1, 0.8f}, {2, 1, 0.8f}, 0.4f }), "CapsuleVsCapsule crossing hit");
+    CHECK(!CapsuleVsCapsule(cap, (Capsule){ {-2, 1, 1.0f}, {2, 1, 1.0f}, 0.4f }), "CapsuleVsCapsule crossing miss");
+    CHECK(CapsuleVsCapsule(cap, (Capsule){ {0.8f, -1, 0}, {0.8f, 6, 0}, 0.4f }), "CapsuleVsCapsule parallel");
+    CHECK(CapsuleVsAABB(cap, (AABB){ {1.2f, 2, 0}, {0.75f, 0.1f, 0.1f} }), "CapsuleVsAABB side hit");
+    CHECK(!CapsuleVsAABB(cap, (AABB){ {1.2f, 2, 0}, {0.65f, 0.1f, 0.1f} }), "CapsuleVsAABB side miss");
+    CHECK(CapsuleVsAABB((Capsule){ {-3, 3, 0}, {3, -3, 0}, 0.1f }, a), "CapsuleVsAABB segment through box");
+
+    // Batch kernels agree with the pairwise tests. 37 shapes: not a
+    // multiple of any lane width, so the scalar tail runs too.
+    enum { BN = 37 };
+    float bx[BN], by[BN], bz[BN], br[BN], bhx[BN], bhy[BN], bhz[BN];
+    SetRandomSeed(7);
+    for (int i = 0; i < BN; i++) {
+        bx[i] = RandF(-3, 3); by[i] = RandF(-3, 3); bz[i] = RandF(-3, 3);
+        br[i] = RandF(0.1f, 1.0f);
+        bhx[i] = RandF(0.1f, 1.0f); bhy[i] = RandF(0.1f, 1.0f); bhz[i] = RandF(0.1f, 1.0f);
+    }
+    SphereSoA ssoa = { bx, by, bz, br, BN };
+    AABBSoA   bsoa = { bx, by, bz, bhx, bhy, bhz, BN };
+    uint64_t bm[COLLIDE_MASK_WORDS(BN)];
+    Sphere bq = { {0.3f, -0.2f, 0.1f}, 1.2f };
+    AABB   bqb = { {0.3f, -0.2f, 0.1f}, {1.0f, 0.6f, 1.4f} };
+    bool agree[4] = { true, true, true, true };
+    int expect[4] = {0}, got[4];
+    got[0] = SphereOverlapBatch(bq, &ssoa, bm);
+    for (int i = 0; i < BN; i++) {
+        bool e = SphereOverlap(bq, (Sphere){ {bx[i], by[i], bz[i]}, br[i] });
+        expect[0] += e;  if (CollideMaskTest(bm, i) != e) agree[0] = false;
+    }
+    got[1] = AABBOverlapBatch(bqb, &bsoa, bm);
+    for (int i = 0; i < BN; i++) {
+        bool e = AABBOverlap(bqb, (AABB){ {bx[i], by[i], bz[i]}, {bhx[i], bhy[i], bhz[i]} });
+        expect[1] += e;  if (CollideMaskTest(bm, i) != e) agree[1] = false;
+    }
+    got[2] = SphereVsAABBBatch(bq, &bsoa, bm);
+    for (int i = 0; i < BN; i++) {
+        bool e = AABBvsSphere((AABB){ {bx[i], by[i], bz[i]}, {bhx[i], bhy[i], bhz[i]} }, bq);
+        expect[2] += e;  if (CollideMaskTest(bm, i) != e) agree[2] = false;
+    }
+    got[3] = CapsuleVsSphereBatch(cap, &ssoa, bm);
+    for (int i = 0; i < BN; i++) {
+        bool e = CapsuleVsSphere(cap, (Sphere){ {bx[i], by[i], bz[i]}, br[i] });
+        expect[3] += e;  if (CollideMaskTest(bm, i) != e) agree[3] = false;
+    }
+    CHECK(agree[0] && got[0] == expect[0] && expect[0] > 0 && expect[0] < BN, "SphereOverlapBatch matches SphereOverlap");
+    CHECK(agree[1] && got[1] == expect[1] && expect[1] > 0 && expect[1] < BN, "AABBOverlapBatch matches AABBOverlap");
+    CHECK(agree[2] && got[2] == expect[2] && expect[2] > 0 && expect[2] < BN, "SphereVsAABBBatch matches AABBvsSphere");
+    CHECK(agree[3] && got[3] == expect[3] && expect[3] > 0 && expect[3] < BN, "CapsuleVsSphereBatch matches CapsuleVsSphere");
+
     // GroundSnap — falls, lands on floor, grounded flips true
     Vector3 pos = {0, 5.0f, 0};
     float velY = 0.0f;
@@ -231,6 +370,85 @@ static void test_collide(void) {
     pp = (Vector3){0, 0, 0};
     SlideXZ(&pp, (Vector3){0, 0, 5.0f}, 0.4f, test_blocked, &s_collide_ctx);
     CHECK(NEAR(pp.z, 5.0f, 1e-5f),     "SlideXZ free on Z");
+
+    // Swept sphere: time of impact and contact normal
+    SweepHit hit;
+    CHECK(SweepSphereAABB((Vector3){0, 0, 0}, (Vector3){4, 0, 0}, 0.5f, wall, &hit)
+          && NEAR(hit.t, 0.25f, 1e-5f) && hit.normal.x == -1.0f, "SweepSphereAABB TOI + normal");
+    CHECK(!SweepSphereAABB((Vector3){0, 0, 0}, (Vector3){1, 0, 0}, 0.5f, wall, NULL), "SweepSphereAABB short of wall");
+    CHECK(!SweepSphereAABB((Vector3){0, 0, 2}, (Vector3){4, 0, 0}, 0.5f, wall, NULL), "SweepSphereAABB passes beside");
+    AABB unit = { .center = {0, 0, 0}, .half = {1, 1, 1} };
+    CHECK(!SweepSphereAABB((Vector3){0.9f, 0, 0}, (Vector3){0.5f, 0, 0}, 0.0f, unit, NULL)
+          && SweepSphereAABB((Vector3){0.9f, 0, 0}, (Vector3){-0.5f, 0, 0}, 0.0f, unit, &hit)
+          && hit.t == 0.0f && hit.normal.x == 1.0f, "SweepSphereAABB from inside: nearest face out");
+    Sphere post = { .center = {3, 0, 0}, .radius = 0.5f };
+    CHECK(SweepSphereSphere((Vector3){0, 0, 0}, (Vector3){4, 0, 0}, 0.5f, post, &hit)
+          && NEAR(hit.t, 0.5f, 1e-5f) && NEAR(hit.normal.x, -1.0f, 1e-5f), "SweepSphereSphere TOI + normal");
+    CHECK(!SweepSphereSphere((Vector3){0, 0, 0}, (Vector3){-4, 0, 0}, 0.5f, post, NULL), "SweepSphereSphere moving away");
+
+    // SlideSweptXZ: a huge step stops at the wall in one call (no tunnelling)
+    // and keeps the tangential part of the motion
+    pp = (Vector3){0, 0, 0};
+    Vector3 sn;
+    CHECK(SlideSweptXZ(&pp, (Vector3){100.0f, 0, 0.5f}, 0.4f, &wall, 1, NULL, 0, &sn), "SlideSweptXZ touches");
+    CHECK(NEAR(pp.x, 1.1f, 1e-3f) && pp.x < 1.1f && sn.x == -1.0f, "SlideSweptXZ stops at wall face");
+    CHECK(NEAR(pp.z, 0.5f, 1e-3f), "SlideSweptXZ slides tangentially");
+    pp = (Vector3){2.7f, 0, 0};   // embedded (spawned or pushed in): walks out
+    CHECK(!SlideSweptXZ(&pp, (Vector3){1.0f, 0, 0}, 0.4f, &wall, 1, NULL, 0, NULL)
+          && NEAR(pp.x, 3.7f, 1e-5f), "SlideSweptXZ escapes an overlap");
+    pp = (Vector3){0, 0, 0};
+    CHECK(!SlideSweptXZ(&pp, (Vector3){0, 0, 5.0f}, 0.4f, &wall, 1, NULL, 0, NULL)
+          && NEAR(pp.z, 5.0f, 1e-5f), "SlideSweptXZ free on Z");
+    // Into a corner between a wall and a post: both contacts resolved
+    Sphere corner = { .center = {0.5f, 0, 1.2f}, .radius = 0.5f };
+    pp = (Vector3){0, 0, 0};
+    SlideSweptXZ(&pp, (Vector3){3.0f, 0, 1.0f}, 0.4f, &wall, 1, &corner, 1, NULL);
+    CHECK(pp.x < 1.1f && NEAR(pp.x, 1.1f, 1e-3f) && Vector3Distance(pp, corner.center) >= 0.9f,
+          "SlideSweptXZ wedges between wall and post");
+
+    // Spatial hash: 20x20 lattice, 1 unit apart, centred on the origin.
+    // 8 buckets forces many cells to share chains.
+    static int shHeads[8];
+    static SpatialHashEntry shEntries[400];
+    SpatialHash sh;
+    CHECK(!SpatialHashInit(&sh, shHeads, 6, shEntries, 400, 2.0f), "SpatialHashInit rejects non-pow2");
+    CHECK(SpatialHashInit(&sh, shHeads, 8, shEntries, 400, 2.0f), "SpatialHashInit");
+    for (int i = 0; i < 400; i++)
+        SpatialHashInsert(&sh, i, (Vector3){(float)(i % 20) - 10.0f, 0, (float)(i / 20) - 10.0f});
+    CHECK(sh.count == 400, "SpatialHashInsert counts");
+
+    int ids[400];
+    int n = SpatialHashQueryRadius(&sh, (Vector3){0, 0, 0}, 1.5f, ids, 400);
+    CHECK(n == 9, "SpatialHashQueryRadius finds 3x3 neighbourhood");
+    bool dup = false;
+    for (int i = 0; i < n; i++) for (int j = i + 1; j < n; j++) if (ids[i] == ids[j]) dup = true;
+    CHECK(!dup, "SpatialHashQueryRadius has no duplicates under bucket aliasing");
+    CHECK(SpatialHashQueryRadius(&sh, (Vector3){0, 0, 0}, 1.5f, ids, 4) == 4, "SpatialHashQueryRadius caps output");
+
+    AABB box = { .center = {-9.5f, 0, -10.0f}, .half = {1.5f, 5.0f, 0.5f} };
+    n = SpatialHashQueryAABB(&sh, box, ids, 400);
+    CHECK(n == 3, "SpatialHashQueryAABB clips to XZ box");
+
+    float d2[3];
+    n = SpatialHashQueryNearest(&sh, (Vector3){0.1f, 0, 0.2f}, 100.0f, 3, NULL, NULL, ids, d2);
+    CHECK(n == 3 && ids[0] == 10 * 20 + 10 && d2[0] <= d2[1] && d2[1] <= d2[2],
+          "SpatialHashQueryNearest sorted nearest first");
+    n = SpatialHashQueryNearest(&sh, (Vector3){0.1f, 0, 0.2f}, 100.0f, 1, test_is_corner, NULL, ids, NULL);
+    CHECK(n == 1 && ids[0] == 0, "SpatialHashQueryNearest applies filter");
+    CHECK(SpatialHashQueryNearest(&sh, (Vector3){50, 0, 50}, 5.0f, 1, NULL, NULL, ids, NULL) == 0,
+          "SpatialHashQueryNearest respects maxRadius");
+
+    // Incremental updates: move across cells, remove, re-query
+    SpatialHashMove(&sh, 0, (Vector3){0.25f, 0, 0.25f});
+    n = SpatialHashQueryRadius(&sh, (Vector3){0.25f, 0, 0.25f}, 0.1f, ids, 400);
+    CHECK(n == 1 && ids[0] == 0, "SpatialHashMove relinks across cells");
+    SpatialHashRemove(&sh, 0);
+    CHECK(!SpatialHashContains(&sh, 0) && sh.count == 399, "SpatialHashRemove");
+    CHECK(SpatialHashQueryRadius(&sh, (Vector3){0.25f, 0, 0.25f}, 0.1f, ids, 400) == 0,
+          "SpatialHashRemove drops from queries");
+    SpatialHashClear(&sh);
+    CHECK(sh.count == 0 && SpatialHashQueryRadius(&sh, (Vector3){0, 0, 0}, 50.0f, ids, 400) == 0,
+          "SpatialHashClear empties");
 }
 static void test_camera(void) {
     // CamFPS: yaw=0 → forward is -Z. yaw=PI/2 → forward is +X.
@@ -268,6 +486,79 @@ static void test_camera(void) {
     c = CamThirdPersonToCamera3D(&tp);
     CHECK(c.position.z > tp.dist * 0.9f,     "CamThirdPerson behind target +Z");
 }
+
+static void test_frustum(void) {
+    // Looking down -Z, 60° vertical, 2:1: edges at y = ±tan(30°)·d, x = ±2·tan(30°)·d
+    Camera3D cam = { { 0, 0, 0 }, { 0, 0, -1 }, { 0, 1, 0 }, 60.0f, CAMERA_PERSPECTIVE };
+    Frustum f = CameraFrustum(cam, 2.0f, 0.1f, 100.0f);
+    bool unit = true;
+    for (int i = 0; i < 6; i++) unit = unit && NEAR(Vector3Length(f.planes[i].normal), 1.0f, 1e-4f);
+    CHECK(unit, "frustum planes normalized");
+    float ex = 2.0f * tanf(30.0f * DEG2RAD) * 10.0f, ey = tanf(30.0f * DEG2RAD) * 10.0f;
+    CHECK(FrustumSphere(&f, (Vector3){ 0, 0, -10 }, 0.5f) && !FrustumSphere(&f, (Vector3){ 0, 0, 10 }, 0.5f),
+          "sphere ahead in, behind out");
+    CHECK(!FrustumSphere(&f, (Vector3){ 0, 0, -200 }, 1.0f) && FrustumSphere(&f, (Vector3){ 0, 0, -100.3f }, 0.5f),
+          "far plane: past out, straddling in");
+    CHECK(FrustumSphere(&f, (Vector3){ ex - 0.2f, 0, -10 }, 0.0f) && !FrustumSphere(&f, (Vector3){ ex + 0.5f, 0, -10 }, 0.1f)
+          && FrustumSphere(&f, (Vector3){ ex + 0.5f, 0, -10 }, 1.0f), "side planes follow the aspect");
+    CHECK(!FrustumSphere(&f, (Vector3){ 0, ey + 0.5f, -10 }, 0.1f) && FrustumSphere(&f, (Vector3){ 0, ey - 0.2f, -10 }, 0.0f),
+          "top plane follows fovy");
+    CHECK(FrustumAABB(&f, (BoundingBox){ { -1, -1, -11 }, { 1, 1, -9 } })
+          && !FrustumAABB(&f, (BoundingBox){ { -40, -1, -11 }, { -30, 1, -9 } })
+          && FrustumAABB(&f, (BoundingBox){ { -500, -500, -500 }, { 500, 500, 500 } }), "boxes in, out, enclosing");
+    Camera3D ortho = { { 0, 0, 0 }, { 0, 0, -1 }, { 0, 1, 0 }, 10.0f, CAMERA_ORTHOGRAPHIC };
+    Frustum fo = CameraFrustumDefault(ortho, 1.0f);
+    CHECK(FrustumSphere(&fo, (Vector3){ 4.9f, 0, -50 }, 0.0f) && !FrustumSphere(&fo, (Vector3){ 5.2f, 0, -50 }, 0.1f),
+          "orthographic: fovy is the view height");
+
+    // Batches agree with the scalar tests (301: exercises the SIMD tail)
+    enum { N = 301 };
+    static float x[N], y[N], z[N], r[N], hx[N], hy[N], hz[N];
+    for (int i = 0; i < N; i++) {
+        x[i] = sinf(i * 1.7f) * 40.0f; y[i] = cosf(i * 0.9f) * 15.0f; z[i] = sinf(i * 0.37f) * 60.0f - 20.0f;
+        r[i] = 0.2f + (i % 7) * 0.5f;
+        hx[i] = r[i]; hy[i] = 0.5f * r[i]; hz[i] = 2.0f * r[i];
+    }
+    SphereSoA spheres = { x, y, z, r, N };
+    AABBSoA boxes = { x, y, z, hx, hy, hz, N };
+    uint64_t mask[COLLIDE_MASK_WORDS(N)];
+    int hits = FrustumSphereBatch(&f, &spheres, mask), want = 0;
+    bool agree = true;
+    for (int i = 0; i < N; i++) {
+        bool in = FrustumSphere(&f, (Vector3){ x[i], y[i], z[i] }, r[i]);
+        want += in;
+        agree = agree && in == CollideMaskTest(mask, i);
+    }
+    CHECK(agree && hits == want && hits > 0 && hits < N, "FrustumSphereBatch matches FrustumSphere");
+    hits = FrustumAABBBatch(&f, &boxes, mask);
+    want = 0; agree = true;
+    for (int i = 0; i < N; i++) {
+        Vector3 c = { x[i], y[i], z[i] }, h = { hx[i], hy[i], hz[i] };
+        bool in = FrustumAABB(&f, (BoundingBox){ Vector3Subtract(c, h), Vector3Add(c, h) });
+        want += in;
+        agree = agree && in == CollideMaskTest(mask, i);
+    }
+    CHECK(agree && hits == want && hits > 0 && hits < N, "FrustumAABBBatch matches FrustumAABB");
+
+    // Visibility list: ids of the visible, in order, with counts
+    VisibleList vis;
+    CHECK(InitVisibleList(&vis, N + 1), "InitVisibleList");
+    VisibleListBegin(&vis, &f);
+    int batchHits = FrustumSphereBatch(&f, &spheres, mask);
+    CHECK(VisibleListAddSpheres(&vis, 1000, &spheres) == batchHits && vis.count == batchHits && vis.tested == N,
+          "VisibleListAddSpheres");
+    bool ordered = true;
+    for (int i = 0; i < vis.count; i++)
+        ordered = ordered && CollideMaskTest(mask, vis.ids[i] - 1000) && (i == 0 || vis.ids[i] > vis.ids[i - 1]);
+    CHECK(ordered, "visible ids offset by firstId, in order");
+    CHECK(VisibleListAddSphere(&vis, 7, (Vector3){ 0, 0, -10 }, 1.0f) && !VisibleListAddSphere(&vis, 8, (Vector3){ 0, 0, 10 }, 1.0f)
+          && vis.ids[vis.count - 1] == 7 && vis.tested == N + 2, "VisibleListAddSphere");
+    vis.cap = 2;
+    VisibleListBegin(&vis, &f);
+    VisibleListAddSpheres(&vis, 0, &spheres);
+    CHECK(vis.count == 2 && vis.overflow == batchHits - 2, "past cap: dropped and counted");
+    FreeVisibleList(&vis);
+}
 static void test_fx(void) {
     // 3D particle pool spawn / update / decay
     Particle3D p3[16] = {0};
@@ -287,6 +578,73 @@ static void test_fx(void) {
     for (int s = 0; s < 60; s++) UpdateParticles2D(p2, 16, 1.0f / 30.0f, (Vector2){0, 200.0f});
     CHECK(POOL_COUNT_ACTIVE(p2, 16) == 0, "UpdateParticles2D decays");
 
+    // SoA particle store: tail append, dense live range, swap-remove
+    ParticleSoA ps;
+    CHECK(InitParticlesSoA(&ps, 20), "InitParticlesSoA allocates");
+    CHECK(ps.capacity == 24, "InitParticlesSoA rounds capacity to lanes");
+    SpawnParticleBurstSoA(&ps, (Vector3){0, 0, 0}, 8, 1.0f, 2.0f, 0.5f, 0.5f, 0.1f, 0.1f);
+    CHECK(ps.count == 8, "SpawnParticleBurstSoA appends count");
+    SpawnParticleBurstSoA(&ps, (Vector3){0, 0, 0}, 100, 1.0f, 2.0f, 0.5f, 0.5f, 0.1f, 0.1f);
+    CHECK(ps.count == ps.capacity, "SpawnParticleBurstSoA stops at capacity");
+    for (int s = 0; s < 60; s++) UpdateParticlesSoA(&ps, 1.0f / 30.0f, (Vector3){0, -10.0f, 0});
+    CHECK(ps.count == 0, "UpdateParticlesSoA decays to zero");
+
+    // Mixed lifetimes: short-lived ones are removed, long-lived stay dense
+    for (int i = 0; i < 10; i++)
+        PushParticleSoA(&ps, (Vector3){(float)i, 0, 0}, (Vector3){0, 0, 0},
+                        (i % 2) ? 0.05f : 5.0f, 0.1f, RED);
+    UpdateParticlesSoA(&ps, 0.1f, (Vector3){0, 0, 0});
+    CHECK(ps.count == 5, "UpdateParticlesSoA swap-removes dead");
+    bool allEven = true;
+    for (int i = 0; i < ps.count; i++)
+        if (((int)ps.px[i]) % 2 != 0 || ps.life[i] <= 0.0f) allEven = false;
+    CHECK(allEven, "Survivors are the long-lived particles");
+
+    // Kernel matches scalar semi-implicit Euler
+    ClearParticlesSoA(&ps);
+    PushParticleSoA(&ps, (Vector3){1, 2, 3}, (Vector3){4, 5, 6}, 10.0f, 0.1f, RED);
+    UpdateParticlesSoA(&ps, 0.5f, (Vector3){0, -10.0f, 0});
+    CHECK(NEAR(ps.vy[0], 0.0f, 1e-5f), "SoA velocity integrated first");
+    CHECK(NEAR(ps.px[0], 3.0f, 1e-5f) && NEAR(ps.py[0], 2.0f, 1e-5f) && NEAR(ps.pz[0], 6.0f, 1e-5f),
+          "SoA position uses updated velocity");
+    CHECK(NEAR(ps.life[0], 9.5f, 1e-5f), "SoA life decremented");
+
+    // 2D spawn stays in the XY plane
+    ClearParticlesSoA(&ps);
+    SpawnParticleBurstSoA2D(&ps, (Vector2){5, 5}, RED, 6, 10.0f, 20.0f, 0.5f, 0.5f, 2.0f, 4.0f);
+    UpdateParticlesSoA(&ps, 1.0f / 30.0f, (Vector3){0, 200.0f, 0});
+    CHECK(ps.count == 6 && ps.pz[0] == 0.0f && ps.vz[5] == 0.0f, "SpawnParticleBurstSoA2D stays 2D");
+
+    // Batched renderer: one quad per live particle, fade baked into colors
+    ParticleBatch batch;
+    CHECK(InitParticleBatch(&batch, 4), "InitParticleBatch allocates");
+    Vector3 right, up;
+    ParticleBillboardAxes((Camera3D){ .position = {0, 0, 10}, .target = {0, 0, 0},
+                                      .up = {0, 1, 0}, .fovy = 60 }, &right, &up);
+    CHECK(NEAR(right.x, 1.0f, 1e-5f) && NEAR(up.y, 1.0f, 1e-5f), "ParticleBillboardAxes faces camera");
+
+    Particle3D bp[3] = {0};
+    bp[0] = (Particle3D){ .pos = {1, 2, 3}, .life = 0.5f, .maxLife = 1.0f, .size = 2.0f,
+                          .color = {255, 0, 0, 200}, .active = true };
+    bp[2] = bp[0];
+    BatchParticles3D(&batch, bp, 3, right, up);
+    CHECK(batch.quadCount == 2, "BatchParticles3D skips inactive");
+    CHECK(NEAR(batch.positions[0], 0.0f, 1e-5f) && NEAR(batch.positions[1], 1.0f, 1e-5f)
+          && NEAR(batch.positions[6], 2.0f, 1e-5f) && NEAR(batch.positions[7], 3.0f, 1e-5f),
+          "BatchParticles3D half-size scales with life");
+    CHECK(batch.colors[3] == 100 && batch.colors[15] == 100, "BatchParticles3D fades alpha");
+
+    ClearParticleBatch(&batch);
+    for (int i = 0; i < 6; i++)
+        PushParticleSoA(&ps, (Vector3){0, 0, 0}, (Vector3){0, 0, 0}, 1.0f, 1.0f, WHITE);
+    BatchParticlesSoA2D(&batch, &ps);
+    CHECK(batch.quadCount == 4, "ParticleBatch clamps to capacity");
+    FreeParticleBatch(&batch);
+    CHECK(batch.quadCapacity == 0 && batch.positions == NULL, "FreeParticleBatch resets batch");
+
+    FreeParticlesSoA(&ps);
+    CHECK(ps.capacity == 0 && ps.count == 0, "FreeParticlesSoA resets store");
+
     // ScreenShake
     ScreenShake sh = {0};
     ShakeTrigger(&sh, 0.5f);
@@ -373,15 +731,1209 @@ static void test_vehicle(void) {
     for (int i = 0; i < 60; i++) VehicleUpdate(&u, full, 1.0f / 60.0f);
     CHECK(NEAR(u.pos.y, 3.14f, 1e-5f), "pos.y still untouched after mixed input");
 }
+static void test_loop(void) {
+    FixedStep loop = FixedStepInit(60.0f, 4);
+    CHECK(NEAR(loop.dt, 1.0f / 60.0f, 1e-7f), "FixedStepInit tick length");
+
+    // 144 Hz frames into a 60 Hz sim: 0 or 1 ticks per frame, 60 per second
+    int total = 0, maxPerFrame = 0;
+    for (int f = 0; f < 144; f++) {
+        int n = FixedStepAdvance(&loop, 1.0f / 144.0f);
+        total += n;
+        if (n > maxPerFrame) maxPerFrame = n;
+        CHECK(loop.alpha >= 0.0f && loop.alpha < 1.0f, "FixedStep alpha in [0, 1)");
+    }
+    CHECK(total >= 59 && total <= 60 && maxPerFrame == 1, "FixedStep 144 Hz render -> 60 ticks/s");
+    CHECK(loop.tick == (uint64_t)total, "FixedStep tick counter");
+
+    // Half a tick left over -> alpha 0.5
+    loop = FixedStepInit(60.0f, 4);
+    CHECK(FixedStepAdvance(&loop, 2.5f / 60.0f) == 2 && NEAR(loop.alpha, 0.5f, 1e-4f),
+          "FixedStep carries remainder as alpha");
+
+    // A 1 s hitch runs only maxSteps ticks and drops the backlog
+    CHECK(FixedStepAdvance(&loop, 1.0f) == 4, "FixedStep caps catch-up ticks");
+    CHECK(FixedStepAdvance(&loop, 0.0f) == 0, "FixedStep drops backlog after cap");
+
+    // PressLatch: a press survives zero-tick frames and is taken once
+    PressLatch latch = {0};
+    PressLatchPoll(&latch, 3, true);
+    PressLatchPoll(&latch, 3, false);
+    CHECK(PressLatchTake(&latch, 3), "PressLatch keeps press until taken");
+    CHECK(!PressLatchTake(&latch, 3), "PressLatch press taken once");
+    PressLatchPoll(&latch, 5, true);
+    PressLatchClear(&latch);
+    CHECK(!PressLatchTake(&latch, 5), "PressLatchClear drops untaken presses");
+}
+
+static void test_rng(void) {
+    // xoshiro128** reference: state {1,2,3,4} -> rotl(2*5, 7)*9
+    Rng ref = {{ 1, 2, 3, 4 }};
+    CHECK(RngNext(&ref) == 11520u, "RngNext matches xoshiro128** reference");
+
+    // Same seed -> same sequence; different streams -> different sequences
+    Rng a = RngSeed(42), b = RngSeed(42);
+    bool same = true;
+    for (int i = 0; i < 1000; i++) same &= RngNext(&a) == RngNext(&b);
+    CHECK(same, "RngSeed deterministic");
+    Rng s1 = RngStream(42, RNG_STREAM_FX), s2 = RngStream(42, RNG_STREAM_AI);
+    int equal = 0;
+    for (int i = 0; i < 1000; i++) equal += RngNext(&s1) == RngNext(&s2);
+    CHECK(equal < 3, "RngStream ids give independent sequences");
+
+    // Drawing from one stream does not move another
+    Rng w1 = RngStream(7, RNG_STREAM_WORLD), fx = RngStream(7, RNG_STREAM_FX);
+    for (int i = 0; i < 500; i++) RngNext(&fx);
+    Rng w2 = RngStream(7, RNG_STREAM_WORLD);
+    CHECK(RngNext(&w1) == RngNext(&w2), "streams do not share state");
+
+    // RngInt: inclusive, hits both ends, swapped bounds ok
+    Rng r = RngSeed(1);
+    bool inRange = true, lo = false, hi = false;
+    for (int i = 0; i < 10000; i++) {
+        int k = RngInt(&r, -3, 3);
+        inRange &= k >= -3 && k <= 3;
+        lo |= k == -3; hi |= k == 3;
+    }
+    CHECK(inRange && lo && hi, "RngInt inclusive range");
+    CHECK(RngInt(&r, 5, 5) == 5, "RngInt single value");
+    int k = RngInt(&r, 9, 2);
+    CHECK(k >= 2 && k <= 9, "RngInt swapped bounds");
+
+    // RngFloat01 in [0, 1) with a sane mean
+    double sum = 0.0;
+    bool unit = true;
+    for (int i = 0; i < 10000; i++) {
+        float f = RngFloat01(&r);
+        unit &= f >= 0.0f && f < 1.0f;
+        sum += f;
+    }
+    CHECK(unit && NEAR((float)(sum / 10000.0), 0.5f, 0.02f), "RngFloat01 range and mean");
+    CHECK(NEAR(Vector3Length(RngOnUnitSphere(&r)), 1.0f, 1e-5f), "RngOnUnitSphere unit length");
+    CHECK(Vector3Length(RngInUnitSphere(&r)) <= 1.0f + 1e-5f, "RngInUnitSphere inside");
+
+    // Wide fill: in range, deterministic, odd tail, lane 0 = xoshiro128+ on the stream
+    enum { N = 4 * RNG_LANES + 3 };
+    float out1[N], out2[N + 1];
+    out2[N] = -99.0f;   // guard: the tail must not write past n
+    RngWide wa = RngWideStream(9, RNG_STREAM_FX), wb = RngWideStream(9, RNG_STREAM_FX);
+    RngWideFillFloats(&wa, out1, N, -2.0f, 2.0f);
+    RngWideFillFloats(&wb, out2, N, -2.0f, 2.0f);
+    bool wideOk = out2[N] == -99.0f;
+    for (int i = 0; i < N; i++) wideOk &= out1[i] == out2[i] && out1[i] >= -2.0f && out1[i] < 2.0f;
+    CHECK(wideOk, "RngWideFillFloats deterministic, in range, tail bounded");
+    Rng lane0 = RngStream(9, RNG_STREAM_FX);
+    float first = -2.0f + (float)((lane0.s[0] + lane0.s[3]) >> 8) * (1.0f / 16777216.0f) * 4.0f;
+    CHECK(NEAR(out1[0], first, 1e-6f), "RngWide lane 0 is the scalar stream");
+}
+
+static void test_noise(void) {
+    // Polynomial sin/cos against libm, including large time-like arguments
+    float worst = 0.0f;
+    for (int i = -20000; i <= 20000; i++) {
+        float x = (float)i * 0.0137f;
+        float s, c;
+        NoiseSinCos(x, &s, &c);
+        float e = fmaxf(fabsf(s - sinf(x)), fabsf(c - cosf(x)));
+        if (e > worst) worst = e;
+    }
+    CHECK(worst < 2e-6f, "NoiseSinCos matches sinf/cosf");
+    CHECK(fabsf(NoiseSin(1000.0f) - sinf(1000.0f)) < 1e-4f, "NoiseSin large argument");
+
+    // Gradient noise: zero on lattice points, bounded, derivative matches finite differences
+    CHECK(NoiseGradient2D(3.0f, -7.0f, 5, NULL, NULL) == 0.0f, "gradient noise zero at lattice");
+    bool bounded = true, derivOk = true;
+    for (int i = 0; i < 500; i++) {
+        float x = (float)i * 0.173f - 40.0f, z = (float)i * 0.291f - 70.0f, dx, dz;
+        float n = NoiseGradient2D(x, z, 5, &dx, &dz);
+        float v = NoiseValue2D(x, z, 5, NULL, NULL);
+        bounded &= fabsf(n) <= 1.5f && fabsf(v) <= 1.0f;
+        const float e = 1e-3f;
+        float fdx = (NoiseGradient2D(x + e, z, 5, NULL, NULL) - NoiseGradient2D(x - e, z, 5, NULL, NULL)) / (2 * e);
+        float fdz = (NoiseGradient2D(x, z + e, 5, NULL, NULL) - NoiseGradient2D(x, z - e, 5, NULL, NULL)) / (2 * e);
+        derivOk &= NEAR(dx, fdx, 0.02f) && NEAR(dz, fdz, 0.02f);
+    }
+    CHECK(bounded, "value/gradient noise bounded");
+    CHECK(derivOk, "gradient noise analytic derivative");
+    float vdx, vdz;
+    NoiseValue2D(1.3f, 2.6f, 9, &vdx, &vdz);
+    float vfd = (NoiseValue2D(1.301f, 2.6f, 9, NULL, NULL) - NoiseValue2D(1.299f, 2.6f, 9, NULL, NULL)) / 0.002f;
+    CHECK(NEAR(vdx, vfd, 0.02f), "value noise analytic derivative");
+
+    // Heightfield reproduces a hand-written sum of sines
+    Heightfield hf = {
+        .waves = { { .kx = 0.02f, .amp = 8.0f }, { .kz = 0.015f, .phase = PI / 2, .amp = 6.0f },
+                   { .kx = 0.05f, .kz = 0.03f, .amp = 3.0f } },
+        .waveCount = 3, .clampFloor = true,
+    };
+    bool sameAsRef = true;
+    for (int i = 0; i < 200; i++) {
+        float x = (float)i * 13.7f - 900.0f, z = (float)i * -9.1f + 400.0f;
+        float ref = sinf(x * 0.02f) * 8.0f + cosf(z * 0.015f) * 6.0f + sinf(x * 0.05f + z * 0.03f) * 3.0f;
+        if (ref < 0) ref = 0;
+        sameAsRef &= NEAR(HeightfieldSample(&hf, x, z), ref, 1e-4f);
+    }
+    CHECK(sameAsRef, "HeightfieldSample matches scalar formula");
+
+    // Rows and point batches agree with per-point samples, odd tails included;
+    // add time-animated waves and an fBm layer so every term is covered.
+    hf.waves[3] = (HeightWave){ .kx = 0.15f, .omega = 2.0f, .amp = 0.5f };
+    hf.waveCount = 4;
+    hf.time = 37.5f;
+    hf.noiseAmp = 2.0f; hf.noiseFreq = 0.03f; hf.noiseOctaves = 3; hf.noiseSeed = 11;
+    enum { N = 3 * NOISE_LANES + 1 };
+    float row[N + 1], rdx[N], rdz[N], xs[N], zs[N], pts[N];
+    row[N] = -99.0f;
+    HeightfieldRowD(&hf, -123.0f, 2.5f, 41.0f, N, row, rdx, rdz);
+    bool rowOk = row[N] == -99.0f;
+    for (int i = 0; i < N; i++) {
+        float gx, gz, x = -123.0f + (float)i * 2.5f;
+        float h = HeightfieldSampleD(&hf, x, 41.0f, &gx, &gz);
+        rowOk &= NEAR(row[i], h, 1e-4f) && NEAR(rdx[i], gx, 1e-4f) && NEAR(rdz[i], gz, 1e-4f);
+        xs[i] = x * 0.7f; zs[i] = (float)i * -3.3f;
+    }
+    CHECK(rowOk, "HeightfieldRowD matches HeightfieldSampleD");
+    HeightfieldPoints(&hf, xs, zs, N, pts);
+    bool ptsOk = true;
+    for (int i = 0; i < N; i++) ptsOk &= NEAR(pts[i], HeightfieldSample(&hf, xs[i], zs[i]), 1e-4f);
+    CHECK(ptsOk, "HeightfieldPoints matches HeightfieldSample");
+    float grid[3 * 5];
+    HeightfieldGrid(&hf, 10.0f, 20.0f, 4.0f, 5, 3, grid);
+    CHECK(NEAR(grid[2 * 5 + 3], HeightfieldSample(&hf, 22.0f, 28.0f), 1e-4f), "HeightfieldGrid row-major");
+
+    // Analytic gradient vs central differences; flat where the floor clamps
+    bool gradOk = true;
+    for (int i = 0; i < 100; i++) {
+        float x = (float)i * 7.3f - 300.0f, z = (float)i * 4.1f - 150.0f, gx, gz;
+        float h = HeightfieldSampleD(&hf, x, z, &gx, &gz);
+        const float e = 0.01f;
+        float fx = (HeightfieldSample(&hf, x + e, z) - HeightfieldSample(&hf, x - e, z)) / (2 * e);
+        float fz = (HeightfieldSample(&hf, x, z + e) - HeightfieldSample(&hf, x, z - e)) / (2 * e);
+        if (h > 0.1f) gradOk &= NEAR(gx, fx, 0.02f) && NEAR(gz, fz, 0.02f);
+        else if (h == 0.0f) gradOk &= gx == 0.0f && gz == 0.0f;
+    }
+    CHECK(gradOk, "Heightfield analytic gradient");
+    Vector3 nrm = HeightfieldNormal(&hf, 5.0f, 5.0f);
+    CHECK(NEAR(Vector3Length(nrm), 1.0f, 1e-5f) && nrm.y > 0.0f, "HeightfieldNormal unit, upward");
+}
+
+typedef struct {
+    int *out;
+    int sum;            // atomic
+    int maxThread;      // atomic
+} JobsTestCtx;
+
+static void jobs_square(void *ctx, int begin, int end) {
+    JobsTestCtx *c = (JobsTestCtx *)ctx;
+    for (int i = begin; i < end; i++) c->out[i] = i * i;
+    int t = JobsThreadIndex();
+    int seen = __atomic_load_n(&c->maxThread, __ATOMIC_RELAXED);
+    while (t > seen && !__atomic_compare_exchange_n(&c->maxThread, &seen, t, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+}
+
+static void jobs_add(void *ctx, int begin, int end) {
+    JobsTestCtx *c = (JobsTestCtx *)ctx;
+    int s = 0;
+    for (int i = begin; i < end; i++) s += c->out[i];
+    __atomic_add_fetch(&c->sum, s, __ATOMIC_RELAXED);
+}
+
+// Nested: each chunk runs its own ParallelFor from inside a job
+static void jobs_nested(void *ctx, int begin, int end) {
+    JobsTestCtx *c = (JobsTestCtx *)ctx;
+    for (int i = begin; i < end; i++) {
+        JobsTestCtx inner = { c->out + i * 64, 0, 0 };
+        ParallelFor(64, 4, jobs_square, &inner);
+    }
+}
+
+static void test_jobs(void) {
+    enum { N = 40000, TINY = 5000 };
+    static int out[N];
+    int workers = JobsInit(3);
+    CHECK(workers == 4 && JobsWorkerCount() == 4, "JobsInit starts workers plus the caller");
+    CHECK(JobsThreadIndex() == 0, "caller is worker 0");
+
+    // ParallelFor writes every item exactly once, odd grain, tail chunk
+    JobsTestCtx c = { out, 0, 0 };
+    memset(out, 0xff, sizeof(out));
+    ParallelFor(N, 7, jobs_square, &c);
+    bool all = true;
+    for (int i = 0; i < N; i++) all &= out[i] == i * i;
+    CHECK(all, "ParallelFor covers [0, count)");
+    CHECK(c.maxThread < workers, "JobsThreadIndex in range");
+
+    // Thousands of one-item jobs on one counter
+    for (int i = 0; i < TINY; i++) out[i] = i;
+    JobCounter counter = {0};
+    for (int i = 0; i < TINY; i++) JobSubmit(jobs_add, &c, i, i + 1, &counter);
+    JobWait(&counter);
+    CHECK(c.sum == TINY * (TINY - 1) / 2 && counter.pending == 0, "tiny jobs all ran once");
+
+    // Dependency: the sum job starts only after every square job is done
+    JobCounter squares = {0}, total = {0};
+    c.sum = 0;
+    memset(out, 0, sizeof(int) * 1000);
+    for (int b = 0; b < 1000; b += 10) JobSubmit(jobs_square, &c, b, b + 10, &squares);
+    JobSubmitAfter(&squares, jobs_add, &c, 0, 1000, &total);
+    JobWait(&total);
+    CHECK(c.sum == 332833500, "JobSubmitAfter runs after its dependency");
+
+    // ParallelFor from inside jobs does not deadlock
+    memset(out, 0, sizeof(int) * 64 * 64);
+    ParallelFor(64, 1, jobs_nested, &c);
+    all = true;
+    for (int i = 0; i < 64 * 64; i++) all &= out[i] == (i % 64) * (i % 64);
+    CHECK(all, "nested ParallelFor");
+
+    // After shutdown everything runs inline
+    JobsShutdown();
+    CHECK(JobsWorkerCount() == 1, "JobsShutdown");
+    c.sum = 0;
+    for (int i = 0; i < 100; i++) out[i] = 1;
+    ParallelFor(100, 3, jobs_add, &c);
+    CHECK(c.sum == 100, "ParallelFor inline without workers");
+}
+
+static void test_arena(void) {
+    static unsigned char buf[256];
+    Arena a;
+    ArenaInit(&a, buf, sizeof(buf));
+
+    // Alignment and bump
+    char *p1 = ArenaAlloc(&a, 3);
+    float *p2 = ARENA_NEW(&a, float, 4);
+    CHECK(p1 && p2 && ((uintptr_t)p1 % ARENA_ALIGN) == 0 && ((uintptr_t)p2 % ARENA_ALIGN) == 0,
+          "ArenaAlloc aligns every allocation");
+    CHECK((unsigned char *)p2 - (unsigned char *)p1 == ARENA_ALIGN && a.used == ARENA_ALIGN + 16,
+          "ArenaAlloc bumps by the rounded size");
+
+    // Out of space: NULL, counted, nothing consumed
+    size_t before = a.used;
+    CHECK(ArenaAlloc(&a, 1000) == NULL && a.failed == 1 && a.used == before, "ArenaAlloc refuses overflow");
+    CHECK(ArenaAlloc(&a, sizeof(buf) - before) != NULL && a.used == sizeof(buf), "ArenaAlloc fills exactly");
+    CHECK(ArenaAlloc(&a, 1) == NULL && a.failed == 2, "full arena refuses");
+
+    // Mark / pop, with poisoning of the released bytes
+    ArenaClear(&a);
+    CHECK(a.used == 0 && a.lastCycleHigh == sizeof(buf) && a.cycleHigh == 0, "ArenaClear rolls the cycle peak");
+    int *keep = ARENA_NEW(&a, int, 4);
+    ArenaMark m = ArenaGetMark(&a);
+    unsigned char *tmp = ArenaAllocZero(&a, 64);
+    CHECK(tmp && tmp[0] == 0 && tmp[63] == 0, "ArenaAllocZero");
+    ArenaPopTo(m);
+    CHECK(a.used == m.used && ARENA_NEW(&a, int, 4) == (int *)tmp, "ArenaPopTo rewinds to the mark");
+#if ARENA_POISON
+    CHECK(tmp[16] == ARENA_POISON_BYTE && tmp[63] == ARENA_POISON_BYTE, "released bytes poisoned");
+#endif
+    CHECK(keep && a.cycleHigh == 16 + 64 && a.highWater == sizeof(buf), "cycle and all-time peaks");
+
+    char *s = ArenaPrintf(&a, "%s-%d", "wave", 12);
+    CHECK(s && strcmp(s, "wave-12") == 0, "ArenaPrintf");
+    char *big = ArenaPrintf(&a, "%0300d", 1);
+    CHECK(big == NULL && strcmp(s, "wave-12") == 0, "ArenaPrintf that does not fit returns NULL");
+
+    // Frame arena and nested scratch scopes
+    CHECK(FrameArenaInit(4096) && frameArena.size == 4096, "FrameArenaInit");
+    const char *f1 = FrameFormat("kills %d", 3);
+    ArenaMark outer = ScratchBegin();
+    int *o = FRAME_NEW(int, 10);
+    ArenaMark inner = ScratchBegin();
+    int *in = FRAME_NEW(int, 100);
+    ScratchEnd(inner);
+    CHECK(o && in && frameArena.used == inner.used, "inner ScratchEnd keeps the outer scope");
+    ScratchEnd(outer);
+    CHECK(frameArena.used == outer.used && f1 && strcmp(f1, "kills 3") == 0, "outer ScratchEnd keeps earlier frame data");
+    size_t peak = frameArena.cycleHigh;
+    FrameArenaReset();
+    CHECK(frameArena.used == 0 && frameArena.lastCycleHigh == peak, "FrameArenaReset");
+    ArenaDestroy(&frameArena);
+    CHECK(frameArena.base == NULL && FrameAlloc(8) != NULL && frameArena.size == FRAME_ARENA_DEFAULT_SIZE,
+          "FrameArena creates itself on first use");
+    ArenaDestroy(&frameArena);
+}
+
+// Every triangle of a one-part mesh faces away from centre, and agrees with
+// the stored vertex normals.
+static bool mesh_faces_out(const Mesh *m, Vector3 centre) {
+    for (int t = 0; t < m->triangleCount; t++) {
+        Vector3 v[3], n = { 0 };
+        for (int k = 0; k < 3; k++) {
+            int i = m->indices[t*3 + k];
+            v[k] = (Vector3){ m->vertices[i*3], m->vertices[i*3+1], m->vertices[i*3+2] };
+            n = Vector3Add(n, (Vector3){ m->normals[i*3], m->normals[i*3+1], m->normals[i*3+2] });
+        }
+        Vector3 face = Vector3CrossProduct(Vector3Subtract(v[1], v[0]), Vector3Subtract(v[2], v[0]));
+        Vector3 mid = Vector3Scale(Vector3Add(Vector3Add(v[0], v[1]), v[2]), 1.0f / 3.0f);
+        if (Vector3DotProduct(face, Vector3Subtract(mid, centre)) <= 0.0f) return false;
+        if (Vector3DotProduct(face, n) <= 0.0f) return false;
+    }
+    return true;
+}
+
+// Triangles of m lying wholly inside [lo, hi]
+static int mesh_tris_in(const Mesh *m, Vector3 lo, Vector3 hi) {
+    int count = 0;
+    for (int t = 0; t < m->triangleCount; t++) {
+        bool in = true;
+        for (int k = 0; k < 3 && in; k++) {
+            const float *v = &m->vertices[m->indices[t*3 + k] * 3];
+            in = v[0] >= lo.x && v[0] <= hi.x && v[1] >= lo.y && v[1] <= hi.y && v[2] >= lo.z && v[2] <= hi.z;
+        }
+        count += in;
+    }
+    return count;
+}
+
+static void free_mesh(Mesh m) {
+    RL_FREE(m.vertices); RL_FREE(m.normals); RL_FREE(m.colors); RL_FREE(m.indices);
+}
+
+static void test_prefab(void) {
+    BoundingBox b;
+    Part cube = CUBE(1, 2, 3,  2, 4, 6, COL(200, 100, 50, 255));
+    Mesh m = CompileObject3D(&cube, 1, &b);
+    CHECK(m.vertexCount == 24 && m.triangleCount == 12, "cube: 24 verts, 12 single-sided tris");
+    CHECK(NEAR(b.min.x, 0, 1e-5f) && NEAR(b.min.y, 0, 1e-5f) && NEAR(b.min.z, 0, 1e-5f)
+          && NEAR(b.max.x, 2, 1e-5f) && NEAR(b.max.y, 4, 1e-5f) && NEAR(b.max.z, 6, 1e-5f), "cube bounds");
+    CHECK(mesh_faces_out(&m, cube.offset), "cube winds CCW outward");
+    int lit = 0, dark = 0;
+    for (int v = 0; v < m.vertexCount; v++) {
+        lit  += m.colors[v*4] == 200;
+        dark += m.colors[v*4] == 140;
+    }
+    CHECK(lit == 8 && dark == 16, "cube front/back lit, other faces darkened as DrawCubeRotY");
+    free_mesh(m);
+
+    Part sphere = SPHERE(0, 1, 0, 0.5f, COL(230, 41, 55, 255));
+    m = CompileObject3D(&sphere, 1, &b);
+    int pv, pi;
+    PartMeshCounts(&sphere, PART_DETAIL_FULL, &pv, &pi);
+    CHECK(m.vertexCount == pv && m.triangleCount * 3 == pi, "sphere counts");
+    CHECK(NEAR(b.min.y, 0.5f, 1e-5f) && NEAR(b.max.y, 1.5f, 1e-5f) && NEAR(b.max.x, 0.5f, 1e-5f), "sphere bounds");
+    CHECK(mesh_faces_out(&m, sphere.offset), "sphere winds CCW outward");
+    free_mesh(m);
+
+    Part cyl = CYL(0, 0, 0, 0.5f, 2, COL(130, 130, 130, 255)), cone = CONE(0, 0, 0, 0.5f, 2, 0, COL(130, 130, 130, 255));
+    m = CompileObject3D(&cyl, 1, &b);
+    CHECK(m.triangleCount == PREFAB3D_CYL_SIDES * 4 && NEAR(b.max.y, 2, 1e-5f), "cylinder: sides plus two caps");
+    CHECK(mesh_faces_out(&m, (Vector3){ 0, 1, 0 }), "cylinder winds CCW outward");
+    free_mesh(m);
+    m = CompileObject3D(&cone, 1, &b);
+    CHECK(m.triangleCount == PREFAB3D_CYL_SIDES * 3, "pointed cone skips the top cap");
+    free_mesh(m);
+
+    // A whole prefab is one mesh: counts add up, bounds cover every part
+    Part car[] = PREFAB_CAR(COL(0, 121, 241, 255));
+    int n = (int)(sizeof(car) / sizeof(car[0])), verts = 0, indices = 0;
+    for (int i = 0; i < n; i++) { PartMeshCounts(&car[i], PART_DETAIL_FULL, &pv, &pi); verts += pv; indices += pi; }
+    m = CompileObject3D(car, n, &b);
+    CHECK(m.vertexCount == verts && m.triangleCount * 3 == indices, "prefab compiles to one mesh");
+    CHECK(NEAR(b.min.z, -1.0f, 1e-5f) && NEAR(b.max.z, 1.0f, 1e-5f) && NEAR(b.min.y, 0.0f, 1e-5f)
+          && NEAR(b.max.y, 0.85f, 1e-5f), "prefab bounds");
+    free_mesh(m);
+
+    // Cache: same key or path, same prefab
+    Prefab3D *a = GetPrefab3D("car", car, n);
+    CHECK(a && GetPrefab3D("car", car, 1) == a && prefab3DCount == 1, "GetPrefab3D caches by key");
+    const char *path = "util-tests-prefab.obj3d";
+    SaveObject3D(path, car, n);
+    Prefab3D *f = LoadPrefab3D(path);
+    remove(path);
+    CHECK(f && f != a && LoadPrefab3D(path) == f && f->lods[0].vertexCount == verts, "LoadPrefab3D caches by path");
+    CHECK(LoadPrefab3D("no-such-file.obj3d") == NULL, "LoadPrefab3D missing file");
+
+    // Placement matches DrawPart: offset rotated by RotateY, then moved
+    Vector3 pos = { 5, 0, -2 }, off = { 0.5f, 0.3f, 0.8f };
+    Vector3 want = Vector3Add(pos, RotateY(off, 0.7f));
+    Vector3 got = Vector3Transform(off, Prefab3DTransform(pos, 0.7f, (Vector3){ 1, 1, 1 }));
+    CHECK(NEAR(got.x, want.x, 1e-5f) && NEAR(got.y, want.y, 1e-5f) && NEAR(got.z, want.z, 1e-5f),
+          "Prefab3DTransform matches RotateY placement");
+    // Levels of detail: coarser tessellation, small parts dropped, then a box
+    CHECK(a->lods[1].triangleCount * 5 < a->lods[0].triangleCount, "LOD 1 cuts triangles 5x or more");
+    CHECK(a->lods[2].triangleCount == 12, "LOD 2 is a box proxy");
+    PartMeshDetail coarse = PART_DETAIL_COARSE;
+    coarse.minPartSize = 0.5f;   // the 0.3 wheels go, the cubes stay
+    m = CompileObject3DDetail(car, n, coarse, NULL);
+    CHECK(m.vertexCount == 3 * 24, "minPartSize drops small parts");
+    free_mesh(m);
+    Part huge = CUBE(0, 0, 0, 10, 10, 10, COL(255, 0, 0, 255)), tiny = CUBE(0, 0, 0, 1, 1, 1, COL(0, 0, 255, 255));
+    Part two[] = { huge, tiny };
+    Color avg = Object3DAverageColor(two, 2);
+    CHECK(avg.r > 250 && avg.b < 5, "average color weighted by part size");
+
+    // Screen size and selection with hysteresis
+    Camera3D cam = { { 0, 0, 0 }, { 0, 0, 1 }, { 0, 1, 0 }, 60.0f, CAMERA_PERSPECTIVE };
+    float nearSize = PrefabScreenSize(a, cam, (Vector3){ 0, 0, 5 }, 1.0f);
+    float farSize = PrefabScreenSize(a, cam, (Vector3){ 0, 0, 500 }, 1.0f);
+    CHECK(nearSize > 0.1f && farSize < 0.01f && NEAR(PrefabScreenSize(a, cam, (Vector3){ 0, 0, 500 }, 2.0f), 2.0f * farSize, 1e-3f),
+          "PrefabScreenSize falls with distance, grows with scale");
+    CHECK(SelectPrefabLOD(nearSize, 2) == 0 && SelectPrefabLOD(farSize, 0) == 2, "SelectPrefabLOD extremes");
+    CHECK(SelectPrefabLOD(PREFAB3D_LOD1_SIZE * 0.95f, 0) == 0 && SelectPrefabLOD(PREFAB3D_LOD1_SIZE * 0.95f, 1) == 1,
+          "SelectPrefabLOD holds its level inside the hysteresis band");
+    CHECK(SelectPrefabLOD(PREFAB3D_LOD1_SIZE * 0.7f, 0) == 1 && SelectPrefabLOD(PREFAB3D_LOD1_SIZE * 1.3f, 1) == 0,
+          "SelectPrefabLOD switches past the band");
+
+    // Batch: one group per (prefab, tint), however many instances
+    PrefabBatch batch;
+    CHECK(InitPrefabBatch(&batch, 300), "InitPrefabBatch");
+    for (int i = 0; i < 300; i++)
+        AddPrefabInstance(&batch, (i % 3) ? a : f, (Vector3){ (float)i, 0, 0 }, 0, (Vector3){ 1, 1, 1 },
+                          (i % 2) ? WHITE : GRAY);
+    CHECK(!AddPrefabInstance(&batch, a, pos, 0, (Vector3){ 1, 1, 1 }, WHITE) && batch.count == 300, "full batch refuses");
+    CHECK(GroupPrefabBatch(&batch) == 4, "instances grouped by prefab and tint");
+    float xs = 0.0f;
+    int runs = 0;
+    for (int i = 0; i < batch.count; i++) {
+        xs += batch.items[i].transform.m12;
+        if (i > 0 && !PrefabInstanceSameGroup_(&batch.items[i], &batch.items[i - 1])) runs++;
+    }
+    CHECK(runs == 3 && NEAR(xs, 299.0f * 300.0f / 2.0f, 0.5f), "groups contiguous, no instance lost");
+    ClearPrefabBatch(&batch);
+    for (int i = 0; i < 30; i++) AddPrefabInstanceLOD(&batch, a, i % 3, pos, 0, (Vector3){ 1, 1, 1 }, WHITE);
+    CHECK(GroupPrefabBatch(&batch) == 3, "levels of one prefab batch separately");
+    ClearPrefabBatch(&batch);
+    CHECK(batch.count == 0 && !AddPrefabInstance(&batch, NULL, pos, 0, (Vector3){ 1, 1, 1 }, WHITE), "ClearPrefabBatch");
+    FreePrefabBatch(&batch);
+
+    UnloadPrefabs3D();
+    CHECK(prefab3DCount == 0, "UnloadPrefabs3D");
+}
+
+static void test_bounds(void) {
+    // 3D: box over the parts as drawn, sphere about its center
+    Part parts[] = {
+        CUBE(0, 0.5f, 0,  2, 1, 2,  COL(200, 100, 50, 255)),
+        SPHERE(0, 2, 0,  0.5f,  COL(230, 41, 55, 255)),
+        CYL(3, 0, 0,  0.5f, 1,  COL(130, 130, 130, 255)),
+    };
+    Object3DBounds b = ComputeObject3DBounds(parts, 3);
+    CHECK(NEAR(b.box.min.x, -1, 1e-5f) && NEAR(b.box.min.y, 0, 1e-5f) && NEAR(b.box.min.z, -1, 1e-5f)
+          && NEAR(b.box.max.x, 3.5f, 1e-5f) && NEAR(b.box.max.y, 2.5f, 1e-5f) && NEAR(b.box.max.z, 1, 1e-5f),
+          "Object3D box: cube centered, sphere by radius, cylinder standing on its offset");
+    // Surface points: cube corners, the sphere's far side, the cylinder's rims
+    float reach = 0.0f;
+    for (int i = 0; i < 8; i++) {
+        Vector3 c = { (i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : 0.0f, (i & 4) ? 1.0f : -1.0f };
+        reach = fmaxf(reach, Vector3Distance(c, b.center));
+        float a = i * PI / 4;
+        Vector3 rim = { 3 + 0.5f * cosf(a), (float)(i & 1), 0.5f * sinf(a) };
+        reach = fmaxf(reach, Vector3Distance(rim, b.center));
+    }
+    Vector3 away = Vector3Normalize(Vector3Subtract(parts[1].offset, b.center));
+    reach = fmaxf(reach, Vector3Distance(Vector3Add(parts[1].offset, Vector3Scale(away, 0.5f)), b.center));
+    CHECK(reach <= b.radius + 1e-4f && reach > b.radius - 0.05f, "Object3D sphere holds every part, and tightly");
+    Part cone = CONE(0, 0, 0, 0.2f, 1, 0.6f, COL(0, 0, 0, 255));
+    BoundingBox cb = PartBox(&cone);
+    CHECK(NEAR(cb.min.x, -0.6f, 1e-5f) && NEAR(cb.max.y, 1, 1e-5f), "cone box uses its wider end");
+    CHECK(ComputeObject3DBounds(parts, 0).radius == 0.0f, "no parts, zero bounds");
+    Prefab3D *pf = GetPrefab3D("bounds", parts, 3);
+    CHECK(pf && memcmp(&pf->extent, &b, sizeof(b)) == 0, "Prefab3D keeps the parts' bounds");
+    UnloadPrefabs3D();
+
+    // 2D: box, circle, and the bottom billboards anchor on
+    Sprite2DPart spr[] = {
+        SRECT(0, 0, 10, 20, COL(200, 40, 40, 255)),
+        SCIRCLE(10, 0, 4, COL(255, 220, 180, 255)),
+        SLINE(-10, 12, 0, 12, 2, COL(0, 0, 0, 255)),
+    };
+    Sprite2DBounds sb = ComputeSprite2DBounds(spr, 3);
+    CHECK(NEAR(sb.box.x, -11, 1e-5f) && NEAR(sb.box.y, -10, 1e-5f) && NEAR(sb.box.width, 25, 1e-5f)
+          && NEAR(sb.box.height, 23, 1e-5f), "Sprite2D box, lines by half their thickness");
+    CHECK(NEAR(sb.center.x, 1.5f, 1e-5f) && NEAR(sb.radius, sqrtf(11.5f * 11.5f + 10.5f * 10.5f) + 1, 1e-4f),
+          "Sprite2D circle reaches the farthest line end");
+    CHECK(NEAR(Sprite2DBoundsBottom(&sb), 13, 1e-5f), "bottom below the origin");
+    Sprite2DPart tri = STRIANGLE(0, -10, 5, -2, -5, -2, COL(0, 0, 0, 255));
+    sb = ComputeSprite2DBounds(&tri, 1);
+    CHECK(NEAR(sb.box.height, 8, 1e-5f) && Sprite2DBoundsBottom(&sb) == 0.0f, "sprite above the origin: bottom 0");
+
+    // Puppet keyframes: sub-sprites posed (offsets rotated, scaled, moved), hidden parts skipped
+    static PuppetRig rig;
+    static PuppetAnim anim;
+    rig = (PuppetRig){ .partCount = 2 };
+    rig.parts[0].parts[0] = (Sprite2DPart)SRECT(0, 0, 4, 2, COL(0, 0, 0, 255));
+    rig.parts[1].parts[0] = (Sprite2DPart)SCIRCLE(2, 0, 1, COL(0, 0, 0, 255));
+    rig.parts[0].partCount = rig.parts[1].partCount = 1;
+    anim = (PuppetAnim){ .frameCount = 2 };
+    anim.frames[0].poses[0] = (PartPose){ 10, -5, 0, 2, true };
+    anim.frames[0].poses[1] = (PartPose){ 0, 0, 90, 1, true };
+    anim.frames[1].poses[0] = (PartPose){ 0, 0, 0, 1, false };
+    anim.frames[1].poses[1] = (PartPose){ 0, 0, 0, 1, true };
+    ComputePuppetAnimBounds(&anim, &rig);
+    Rectangle k0 = anim.frames[0].bounds.box, k1 = anim.frames[1].bounds.box;
+    CHECK(NEAR(k0.x, -1, 1e-4f) && NEAR(k0.y, -7, 1e-4f) && NEAR(k0.width, 15, 1e-4f) && NEAR(k0.height, 10, 1e-4f),
+          "keyframe bounds follow pose offset, scale and rotation");
+    CHECK(NEAR(k1.x, 1, 1e-4f) && NEAR(k1.width, 2, 1e-4f), "keyframe bounds skip hidden parts");
+    PuppetState ps = { 0 };
+    PuppetForcePlay(&ps, &rig, &anim, true);
+    Rectangle sr = PuppetBounds(&ps, 100, 50, 2);
+    CHECK(NEAR(sr.x, 72, 1e-3f) && NEAR(sr.y, 36, 1e-3f) && NEAR(sr.width, 30, 1e-3f) && NEAR(sr.height, 20, 1e-3f),
+          "PuppetBounds: placed, scaled and mirrored as drawn");
+}
+
+static const ProfileScopeStat *find_scope(const ProfileFrameStats *f, const char *name) {
+    for (int i = 0; i < f->count; i++)
+        if (strcmp(f->scopes[i].name, name) == 0) return &f->scopes[i];
+    return NULL;
+}
+
+static void write_text(const char *path, const char *text) {
+    FILE *fp = fopen(path, "w");
+    if (fp) { fputs(text, fp); fclose(fp); }
+}
+
+static bool same_part(const Part *a, const Part *b) {
+    return a->type == b->type && a->wireframe == b->wireframe
+        && memcmp(&a->offset, &b->offset, sizeof(Vector3)) == 0 && memcmp(&a->size, &b->size, sizeof(Vector3)) == 0
+        && memcmp(&a->color, &b->color, sizeof(Color)) == 0;
+}
+
+static bool same_pose(const PartPose *a, const PartPose *b) {
+    return a->x == b->x && a->y == b->y && a->rot == b->rot && a->scale == b->scale && a->visible == b->visible;
+}
+
+static void test_pack(void) {
+    // Text sources: an object, a fighter frame, a two-part rig and its animation
+    const char *objPath = "util-tests-pack.obj3d", *sprPath = "util-tests-pack.spr2d";
+    const char *rigPath = "util-tests-pack.rig2d", *animPath = "util-tests-pack.anim2d";
+    const char *packPath = "util-tests.pack";
+    Part car[] = PREFAB_CAR(COL(0, 121, 241, 255));
+    int carCount = (int)(sizeof(car) / sizeof(car[0]));
+    SaveObject3D(objPath, car, carCount);
+    write_text(sprPath, "# frame\nrect -4 -8 8 16  200 40 40 255\ncircle 0 -12 3.5  255 220 180 255\n"
+                        "tri 0 0 4 4 -4 4  10 20 30 255\nline 0 0 6 -2 1.5  0 0 0 255\n"
+                        "hitbox 10 -6 8 4\nhurtbox 0 -8 10 18\nhurtbox 0 -14 6 6\nduration 0.08\n");
+    write_text(rigPath, "part body util-tests-pack.spr2d\npart head util-tests-pack.spr2d\n");
+    write_text(animPath, "loop true\nframe 0.15\n  body 0 -4\n  head 1 -20 rot 10\n  hurtbox 0 -8 10 18\n"
+                         "frame 0.2\n  head 2 -21 scale 1.5\n  body 0 -3 hide\n  hitbox 10 -6 8 4\n");
+
+    static Part objText[32], objPack[32];
+    static SpriteFrame frameText, framePack;
+    static PuppetRig rigText, rigPack;
+    static PuppetAnim animText, animPack;
+    int objCount = LoadObject3D(objPath, objText, 32);
+    LoadSpriteFrame(sprPath, &frameText);
+    LoadPuppetRig(rigPath, &rigText);
+    LoadPuppetAnim(animPath, &animText, &rigText);
+    CHECK(objCount == carCount && frameText.partCount == 4 && rigText.partCount == 2 && animText.frameCount == 2,
+          "text sources load");
+
+    // Compile them into a pack, then drop the text files: loads must come from the pack
+    PackBuilder builder = { 0 };
+    PackBuffer blob = { 0 };
+    WriteObject3DBinary(&blob, objText, objCount);
+    CHECK(PackBuilderAdd(&builder, objPath, PACK_OBJ3D, blob.data, blob.size), "PackBuilderAdd");
+    blob.size = 0;
+    WriteSpriteFrameBinary(&blob, &frameText);
+    PackBuilderAdd(&builder, sprPath, PACK_SPR2D, blob.data, blob.size);
+    blob.size = 0;
+    WritePuppetRigBinary(&blob, &rigText);
+    PackBuilderAdd(&builder, rigPath, PACK_RIG2D, blob.data, blob.size);
+    blob.size = 0;
+    WritePuppetAnimBinary(&blob, &animText, &rigText);
+    PackBuilderAdd(&builder, animPath, PACK_ANIM2D, blob.data, blob.size);
+    CHECK(!PackBuilderAdd(&builder, sprPath, PACK_SPR2D, blob.data, blob.size), "duplicate path refused");
+    CHECK(PackBuilderSave(&builder, packPath), "PackBuilderSave");
+    PackBufferFree(&blob);
+    PackBuilderFree(&builder);
+    remove(objPath); remove(sprPath); remove(rigPath); remove(animPath);
+
+    CHECK(!PackMount(objPath) && !PackMount("no-such.pack"), "PackMount rejects missing/non-pack files");
+    CHECK(PackMount(packPath) && packMounted.count == 4, "PackMount");
+    uint32_t size = 0;
+    const void *found = PackLookup("./util-tests-pack.rig2d", PACK_RIG2D, &size);
+    CHECK(found && ((uintptr_t)found % PACK_ALIGN) == 0 && size > 0, "PackLookup: aligned, ./ ignored");
+    CHECK(!PackLookup(rigPath, PACK_ANIM2D, NULL) && !PackLookup("util-tests-none.obj3d", PACK_OBJ3D, NULL),
+          "PackLookup wrong type / missing path");
+
+    bool same = LoadObject3D(objPath, objPack, 32) == objCount;
+    for (int i = 0; same && i < objCount; i++) same = same_part(&objText[i], &objPack[i]);
+    CHECK(same, "obj3d from pack matches text");
+
+    Sprite2DPart sprParts[8];
+    CHECK(LoadSprite2D(sprPath, sprParts, 8) == 4 && LoadSprite2D(sprPath, sprParts, 2) == 2, "LoadSprite2D from pack");
+    CHECK(LoadSpriteFrame(sprPath, &framePack) == 7 && framePack.duration == frameText.duration
+          && framePack.hitboxCount == 1 && framePack.hurtboxCount == 2
+          && memcmp(framePack.hurtboxes, frameText.hurtboxes, 2 * sizeof(SpriteBox)) == 0
+          && memcmp(framePack.hitboxes, frameText.hitboxes, sizeof(SpriteBox)) == 0
+          && memcmp(framePack.parts, frameText.parts, 4 * sizeof(Sprite2DPart)) == 0, "spr2d frame from pack matches text");
+    CHECK(frameText.bounds.box.width > 0 && memcmp(&framePack.bounds, &frameText.bounds, sizeof(Sprite2DBounds)) == 0,
+          "frame bounds filled in by both loaders");
+
+    CHECK(LoadPuppetRig(rigPath, &rigPack) == 2 && strcmp(rigPack.parts[1].name, "head") == 0
+          && rigPack.parts[1].partCount == 4
+          && memcmp(rigPack.parts[1].parts, rigText.parts[1].parts, 4 * sizeof(Sprite2DPart)) == 0, "rig2d from pack");
+
+    same = LoadPuppetAnim(animPath, &animPack, &rigPack) == 2 && animPack.loop
+        && strcmp(animPack.name, animText.name) == 0;
+    for (int f = 0; same && f < 2; f++) {
+        PuppetKeyframe *a = &animText.frames[f], *b = &animPack.frames[f];
+        same = a->duration == b->duration && a->hitboxCount == b->hitboxCount && a->hurtboxCount == b->hurtboxCount
+            && same_pose(&a->poses[0], &b->poses[0]) && same_pose(&a->poses[1], &b->poses[1])
+            && memcmp(&a->bounds, &b->bounds, sizeof(Sprite2DBounds)) == 0;
+    }
+    CHECK(same, "anim2d from pack matches text");
+    CHECK(!animPack.frames[1].poses[0].visible && animPack.frames[1].poses[1].scale == 1.5f, "anim2d deltas resolved");
+
+    // Poses bind by name: a rig with the parts swapped gets them swapped
+    PuppetRig swapped = rigPack;
+    swapped.parts[0] = rigPack.parts[1];
+    swapped.parts[1] = rigPack.parts[0];
+    LoadPuppetAnim(animPath, &animPack, &swapped);
+    CHECK(same_pose(&animPack.frames[1].poses[0], &animText.frames[1].poses[1]), "anim2d poses bind by part name");
+
+    // Unmounted: back to the (now missing) text files
+    PackUnmount();
+    CHECK(LoadObject3D(objPath, objPack, 32) == 0 && LoadPuppetRig(rigPath, &rigPack) == 0, "PackUnmount");
+    remove(packPath);
+
+    // LZ blocks: runs shrink, noise does not fit, both round-trip
+    static unsigned char raw[4096], lz[4096 + 64], back[4096];
+    for (int i = 0; i < 4096; i++) raw[i] = (unsigned char)(i < 3000 ? (i / 700) : (i * 7) % 13);
+    int lzSize = PackLZCompress(raw, 4096, lz, sizeof(lz));
+    CHECK(lzSize > 0 && lzSize < 200 && PackLZDecompress(lz, lzSize, back, 4096) == 4096
+          && memcmp(raw, back, 4096) == 0, "LZ round trip, runs compress");
+    unsigned int seed = 12345;
+    for (int i = 0; i < 4096; i++) raw[i] = (unsigned char)((seed = seed * 1103515245u + 12345u) >> 24);
+    CHECK(PackLZCompress(raw, 4096, lz, 4095) == 0, "incompressible data does not fit");
+    lzSize = PackLZCompress(raw, 4096, lz, sizeof(lz));
+    CHECK(lzSize > 4096 && PackLZDecompress(lz, lzSize, back, 4096) == 4096 && memcmp(raw, back, 4096) == 0,
+          "LZ round trip, noise");
+    unsigned char bad[] = { 0x10, 'a', 0x40, 0x00 };   // match reaching 64 bytes before the start
+    CHECK(PackLZDecompress(bad, sizeof(bad), back, 4096) == -1
+          && PackLZDecompress(lz, 1, back, 4096) == -1, "malformed LZ rejected");
+}
+
+// Swap in reloads until AssetsUpdate reports some, or about two seconds pass.
+static int wait_for_reload(void) {
+    int swapped = 0;
+    for (int tries = 0; tries < 400 && swapped == 0; tries++) {
+        swapped = AssetsUpdate();
+#ifndef ASSETS_SERIAL
+        if (swapped == 0) poll(NULL, 0, 5);
+#endif
+    }
+    return swapped;
+}
+
+static void test_assets(void) {
+    const char *sprPath = "util-tests-assets.spr2d", *rigPath = "util-tests-assets.rig2d";
+    const char *animPath = "util-tests-assets.anim2d";
+    const char *frame0 = "util-tests-assets-walk_0.spr2d", *frame1 = "util-tests-assets-walk_1.spr2d";
+    write_text(sprPath, "rect -4 -8 8 16  200 40 40 255\ncircle 0 -12 3.5  255 220 180 255\n");
+    write_text(rigPath, "part body util-tests-assets.spr2d\npart head util-tests-assets.spr2d\n");
+    write_text(animPath, "frame 0.1\n  body 0 -4\n  head 1 -20 rot 10\n");
+    write_text(frame0, "rect -4 -8 8 16  200 40 40 255\nhurtbox 0 0 8 16\nduration 0.2\n");
+    remove(frame1);
+
+    bool threaded = AssetsInit();
+    Sprite2DAsset *spr = AssetSprite2D(sprPath);
+    PuppetRig *rig = AssetPuppetRig(rigPath);
+    PuppetAnim *anim = AssetPuppetAnim(animPath, rigPath);
+    SpriteAnim *walk = AssetSpriteAnim("util-tests-assets-walk", true);
+    CHECK(spr && rig && anim && walk && AssetSprite2D(sprPath) == spr && assetRegistry.count == 4, "Asset* registers once per path");
+    AssetsWaitLoaded();
+    CHECK(walk->frameCount == 1 && walk->loop && walk->frames[0].duration == 0.2f, "sprite anim frames");
+    CHECK(spr->count == 2 && rig->partCount == 2 && anim->frameCount == 1 && AssetVersion(rig) == 1, "AssetsWaitLoaded");
+    CHECK(anim->frames[0].poses[1].rot == 10.0f && anim->frames[0].poses[0].y == -4.0f, "anim bound to rig");
+
+    if (threaded) {
+        // Rig edit: rig and anim re-parse together (the anim's poses follow part names)
+        write_text(rigPath, "# reordered\npart head util-tests-assets.spr2d\npart body util-tests-assets.spr2d\n");
+        int swapped = wait_for_reload();
+        if (swapped == 1) swapped += wait_for_reload();   // published in two batches: allowed, but report it
+        CHECK(swapped == 2 && strcmp(rig->parts[0].name, "head") == 0, "rig edit reloads rig and anim");
+        CHECK(anim->frames[0].poses[0].rot == 10.0f && anim->frames[0].poses[1].y == -4.0f, "reloaded anim follows new rig order");
+
+        // Sub-sprite edit: the sprite and everything built from it
+        write_text(sprPath, "rect -4 -8 8 16  200 40 40 255\n");
+        swapped = wait_for_reload();
+        CHECK(swapped == 3 && spr->count == 1 && rig->parts[1].partCount == 1, "sub-sprite edit reloads dependents");
+        CHECK(AssetVersion(spr) == 2 && assetRegistry.reloads == 5, "versions and reload count");
+
+        // A new frame file extends the sprite anim
+        write_text(frame1, "circle 0 -12 3.5  255 220 180 255\n");
+        swapped = wait_for_reload();
+        CHECK(swapped == 1 && walk->frameCount == 2 && walk->loop, "new frame reloads sprite anim");
+    }
+    AssetsShutdown();
+    CHECK(assetRegistry.count == 0, "AssetsShutdown");
+    remove(sprPath); remove(rigPath); remove(animPath); remove(frame0); remove(frame1);
+}
+
+// Map over defs: 0 empty, 1 floor, 2 wall h2, 3 wall h1, 4 pit, 5 water, 6 ramp north h1
+static Map3D g_map;
+static TileDef g_mapDefs[7];
+
+#define CHUNK(cx, cz) (g_map.chunks[(cz) * g_map.chunksX + (cx)])
+
+static void load_test_map(const char *layout, int w, int h) {
+    TileDef defs[7] = {
+        { TILE_EMPTY, 0, BLACK, BLACK },        { TILE_FLOOR, 0, GREEN, GREEN },
+        { TILE_WALL, 2, GRAY, DARKGRAY },       { TILE_WALL, 1, GRAY, DARKGRAY },
+        { TILE_PIT, 0, BLACK, BLACK },          { TILE_WATER, 0, BLUE, BLUE },
+        { TILE_RAMP_N, 1, BEIGE, BROWN },
+    };
+    memcpy(g_mapDefs, defs, sizeof(defs));
+    Map3DLoad(&g_map, layout, w, h, 1.0f, g_mapDefs, 7);
+}
+
+static void test_map3d(void) {
+    int water;
+    load_test_map("0000" "0220" "0000", 4, 3);
+    Mesh m = Map3DBuildChunkMesh(&g_map, 0, 0, &water);
+    CHECK(m.triangleCount == 16 && m.vertexCount == 32 && water == 0, "two walls: 2 tops + 6 sides, shared face gone");
+    CHECK(mesh_faces_out(&m, (Vector3){ 2, 1, 1.5f }), "walls wind CCW outward");
+    free_mesh(m);
+
+    load_test_map("23", 2, 1);
+    m = Map3DBuildChunkMesh(&g_map, 0, 0, NULL);
+    float lowest = 9;
+    for (int v = 0; v < m.vertexCount; v++)
+        if (m.vertices[v*3] == 1.0f && m.normals[v*3] > 0.5f) lowest = fminf(lowest, m.vertices[v*3+1]);
+    CHECK(m.triangleCount == 18 && NEAR(lowest, 1, 1e-6f), "taller wall's side starts at its neighbour's top");
+    free_mesh(m);
+
+    load_test_map("44", 2, 1);
+    m = Map3DBuildChunkMesh(&g_map, 0, 0, NULL);
+    bool inward = true;
+    for (int t = 0; t < m.triangleCount; t++) {
+        int i = m.indices[t*3];
+        Vector3 p = { m.vertices[i*3], 0, m.vertices[i*3+2] }, n = { m.normals[i*3], 0, m.normals[i*3+2] };
+        if (Vector3LengthSqr(n) > 0) inward = inward && Vector3DotProduct(n, Vector3Subtract((Vector3){ 1, 0, 0.5f }, p)) > 0;
+    }
+    CHECK(m.triangleCount == 16 && inward, "pits: 2 floors + 6 inward walls");
+    free_mesh(m);
+
+    load_test_map("6", 1, 1);
+    m = Map3DBuildChunkMesh(&g_map, 0, 0, NULL);
+    bool solid = true;
+    for (int t = 0; t < m.triangleCount; t++) {
+        Vector3 v[3];
+        for (int k = 0; k < 3; k++) {
+            int i = m.indices[t*3 + k];
+            v[k] = (Vector3){ m.vertices[i*3], m.vertices[i*3+1], m.vertices[i*3+2] };
+        }
+        solid = solid && Vector3LengthSqr(Vector3CrossProduct(Vector3Subtract(v[1], v[0]), Vector3Subtract(v[2], v[0]))) > 1e-8f;
+    }
+    CHECK(m.triangleCount == 6 && m.vertexCount == 14 && solid, "ramp: slope, high side, two triangles, none degenerate");
+    free_mesh(m);
+
+    load_test_map("55" "51", 2, 2);
+    m = Map3DBuildChunkMesh(&g_map, 0, 0, &water);
+    CHECK(m.triangleCount == 2 && water == 3, "water left to the live layer");
+    free_mesh(m);
+
+    // Edits rebake only the chunks they touch
+    char layout[40 * 40];
+    memset(layout, '1', sizeof(layout));
+    layout[0] = '0';
+    load_test_map(layout, 40, 40);
+    Map3DBake(&g_map);
+    int built = 0;
+    for (int cz = 0; cz < 3; cz++) for (int cx = 0; cx < 3; cx++) built += CHUNK(cx, cz)->built;
+    CHECK(built == 9 && CHUNK(0, 0)->mesh.vertexCount == 255 * 4 && CHUNK(2, 2)->mesh.vertexCount == 64 * 4,
+          "40x40 bakes to 3x3 chunks, edge chunks partial");
+    Map3DSet(&g_map, 20, 20, 2);
+    CHECK(!CHUNK(1, 1)->built && CHUNK(1, 0)->built && CHUNK(0, 1)->built, "interior edit: one chunk");
+    Map3DBake(&g_map);
+    CHECK(CHUNK(1, 1)->mesh.vertexCount == 256 * 4 + 16, "wall replaces a floor: top + 4 sides");
+    Map3DSet(&g_map, 16, 5, 2);
+    CHECK(!CHUNK(1, 0)->built && !CHUNK(0, 0)->built && CHUNK(1, 1)->built, "edge edit: both chunks");
+    Map3DBake(&g_map);
+    Map3DSet(&g_map, 15, 5, 2);
+    Map3DBake(&g_map);
+    CHECK(CHUNK(0, 0)->mesh.vertexCount == 254 * 4 + 16 && CHUNK(1, 0)->mesh.vertexCount == 255 * 4 + 16,
+          "walls across a chunk edge lose the shared faces");
+    Map3DSet(&g_map, 15, 5, 2);
+    CHECK(CHUNK(0, 0)->built, "setting the same tile is not an edit");
+    CHUNK(2, 2)->built = false;   // stale, but not queued
+    Map3DBake(&g_map);
+    CHECK(!CHUNK(2, 2)->built && g_map.dirtyCount == 0, "bake looks only at queued chunks");
+    Map3DInvalidate(&g_map);
+    Map3DBake(&g_map);
+    CHECK(CHUNK(2, 2)->built && CHUNK(1, 1)->built, "Map3DInvalidate rebakes them all");
+
+    // Sparse storage: a blank 4096x4096 map is its chunk directory, painting
+    // allocates one chunk at a time
+    CHECK(InitMap3D(&g_map, 4096, 4096, 1.0f, g_mapDefs, 7) && g_map.chunkCount == 0
+          && Map3DMemoryUsed(&g_map) == 256 * 256 * sizeof(Map3DChunk *), "blank large map allocates no tiles");
+    Map3DSet(&g_map, 4095, 4095, 2);
+    Map3DSet(&g_map, 2000, 1000, 3);
+    Map3DSet(&g_map, 2001, 1000, 3);
+    CHECK(g_map.chunkCount == 2 && Map3DMemoryUsed(&g_map) == 256 * 256 * sizeof(Map3DChunk *) + 2 * sizeof(Map3DChunk),
+          "memory follows the painted chunks");
+    CHECK(Map3DGet(&g_map, 4095, 4095)->type == TILE_WALL && Map3DTile(&g_map, 2001, 1000) == 3
+          && Map3DTile(&g_map, 2002, 1000) == 0 && Map3DTile(&g_map, 4096, 0) == 0 && Map3DTile(&g_map, -1, 5) == 0,
+          "Map3DGet/Map3DTile through the chunks");
+    CHECK(NEAR(Map3DHeightAt(&g_map, (Vector3){ 2000.5f, 0, 1000.5f }), 1, 1e-6f)
+          && Map3DSolid(&g_map, (Vector3){ 4095.5f, 0, 4095.5f }, 0.2f) && !Map3DSolid(&g_map, (Vector3){ 100, 0, 100 }, 0.2f),
+          "height and collision on a large map");
+    CHECK(!Map3DSet(&g_map, 4096, 0, 1) && !Map3DSet(&g_map, 0, 0, MAP3D_MAX_DEFS) && g_map.chunkCount == 2,
+          "Map3DSet rejects off-map tiles and bad ids");
+    Map3DBake(&g_map);
+    CHECK(g_map.chunkCount == 2 && CHUNK(125, 62)->mesh.triangleCount == 16 && g_map.background.mesh.vertexCount == 0,
+          "bake touches only painted chunks when defs[0] is empty");
+
+    // A visible defs[0] is one shared background mesh; chunks the edge cuts get their own
+    TileDef floorFirst[2] = { { TILE_FLOOR, 0, GREEN, GREEN }, { TILE_WALL, 2, GRAY, DARKGRAY } };
+    InitMap3D(&g_map, 20, 20, 1.0f, floorFirst, 2);
+    Map3DBake(&g_map);
+    CHECK(g_map.background.mesh.triangleCount == 512 && g_map.chunkCount == 3 && CHUNK(0, 0)->mesh.vertexCount == 0
+          && CHUNK(1, 0)->mesh.triangleCount == 128 && CHUNK(1, 1)->mesh.triangleCount == 32,
+          "background mesh for unpainted chunks");
+
+    // ...but a defs[0] with sides can't share it on the map's edge or beside
+    // painted chunks: those get blank filler chunks that bake their own sides
+    TileDef wallFirst[2] = { { TILE_WALL, 2, GRAY, DARKGRAY }, { TILE_FLOOR, 0, GREEN, GREEN } };
+    InitMap3D(&g_map, 32, 32, 1.0f, wallFirst, 2);
+    Map3DSet(&g_map, 16, 5, 1);
+    Map3DBake(&g_map);
+    CHECK(g_map.chunkCount == 4 && CHUNK(0, 0)->filler && !CHUNK(1, 0)->filler
+          && mesh_tris_in(&CHUNK(0, 0)->mesh, (Vector3){ 16, 0, 5 }, (Vector3){ 16, 2, 6 }) == 2
+          && mesh_tris_in(&CHUNK(0, 0)->mesh, (Vector3){ 0, 0, 0 }, (Vector3){ 0, 2, 16 }) == 32,
+          "defs[0] walls face painted floor and the map edge");
+    InitMap3D(&g_map, 64, 64, 1.0f, wallFirst, 2);
+    Map3DSet(&g_map, 24, 24, 1);
+    Map3DBake(&g_map);
+    CHECK(g_map.chunkCount == 15 && CHUNK(2, 1)->filler && CHUNK(1, 2)->filler && CHUNK(2, 2) == &map3DUnpainted_
+          && mesh_tris_in(&CHUNK(1, 1)->mesh, (Vector3){ 24, 0, 24 }, (Vector3){ 25, 0, 25 }) == 2,
+          "fillers only beside painted chunks, not beside fillers");
+
+    // Text round trip keeps the sparse store sparse
+    const char *path = "util-tests.m3d";
+    InitMap3D(&g_map, 300, 200, 2.0f, g_mapDefs, 7);
+    Map3DSet(&g_map, 299, 199, 6);
+    Map3DSet(&g_map, 17, 3, 5);
+    bool saved = SaveMap3D(path, &g_map);
+    UnloadMap3D(&g_map);
+    CHECK(saved && LoadMap3DFile(path, &g_map, g_mapDefs, 7) && g_map.width == 300 && g_map.height == 200
+          && g_map.chunkCount == 2 && Map3DTile(&g_map, 299, 199) == 6 && Map3DTile(&g_map, 17, 3) == 5,
+          "SaveMap3D/LoadMap3DFile past 64x64");
+    remove(path);
+
+    // Binary round trip: a run-filled chunk goes LZ, a noisy one raw
+    const char *bin = "util-tests.m3db";
+    InitMap3D(&g_map, 300, 200, 2.0f, g_mapDefs, 7);
+    for (int z = 0; z < 16; z++) for (int x = 0; x < 16; x++) Map3DSet(&g_map, 32 + x, 16 + z, 1 + (z >= 8));
+    unsigned int seed = 99;
+    for (int z = 0; z < 16; z++)
+        for (int x = 0; x < 16; x++) Map3DSet(&g_map, 160 + x, 96 + z, (int)((seed = seed * 1103515245u + 12345u) >> 16) % 7);
+    Map3DSet(&g_map, 299, 199, 6);
+    Map3DSet(&g_map, 5, 5, 2);
+    Map3DSet(&g_map, 5, 5, 0);   // painted back to blank: not stored
+    static unsigned char expect[300 * 200];
+    for (int z = 0; z < 200; z++) for (int x = 0; x < 300; x++) expect[z * 300 + x] = (unsigned char)Map3DTile(&g_map, x, z);
+    bool same = SaveMap3DBinary(bin, &g_map, true);
+    UnloadMap3D(&g_map);
+    CHECK(same && LoadMap3DBinary(bin, &g_map) && g_map.width == 300 && g_map.height == 200 && g_map.numDefs == 7
+          && g_map.tileSize == 2.0f && g_map.chunkCount == 3 && g_map.file == NULL
+          && g_map.defs[2].height == 2.0f && memcmp(&g_map.defs[6], &g_mapDefs[6], sizeof(TileDef)) == 0,
+          "LoadMap3DBinary: size, defs, only painted chunks");
+    for (int t = 0; same && t < 300 * 200; t++) same = Map3DTile(&g_map, t % 300, t / 300) == expect[t];
+    CHECK(same, "binary round trip keeps every tile");
+    Map3DFileHeader hdr;
+    FILE *f = fopen(bin, "rb");
+    same = f && fread(&hdr, sizeof(hdr), 1, f) == 1;
+    if (f) fseek(f, 0, SEEK_END);
+    long fileSize = f ? ftell(f) : 0;
+    if (f) fclose(f);
+    Map3DFileChunk ents[19 * 13];
+    f = fopen(bin, "rb");
+    same = same && f && fseek(f, (long)hdr.dirOffset, SEEK_SET) == 0 && fread(ents, sizeof(ents), 1, f) == 1;
+    if (f) fclose(f);
+    CHECK(same && ents[1 * 19 + 2].codec == MAP3D_CODEC_LZ && ents[1 * 19 + 2].size < 64
+          && ents[6 * 19 + 10].codec == MAP3D_CODEC_RAW && ents[0].offset == 0
+          && fileSize == (long)(hdr.dirOffset + sizeof(ents)), "chunk directory: LZ where it pays, blanks absent");
+
+    // Open streams lazily: nothing read until the camera is near
+    UnloadMap3D(&g_map);
+    CHECK(OpenMap3D(&g_map, bin) && g_map.file != NULL && g_map.chunkCount == 0
+          && Map3DTile(&g_map, 32, 16) == 0, "OpenMap3D reads no chunks");
+    Vector3 near = { 40 * 2.0f, 0, 20 * 2.0f };
+    CHECK(Map3DStream(&g_map, near, 40.0f, 8) == 1 && g_map.chunkCount == 1 && Map3DTile(&g_map, 32, 16) == 1
+          && Map3DTile(&g_map, 32, 31) == 2 && Map3DTile(&g_map, 160, 96) == 0, "Map3DStream reads the near chunk");
+    CHECK(Map3DStream(&g_map, near, 40.0f, 8) == 0, "streamed chunks are not read twice");
+    Map3DSet(&g_map, 170, 100, 5);
+    CHECK(g_map.chunkCount == 2 && Map3DTile(&g_map, 160, 96) == expect[96 * 300 + 160]
+          && Map3DTile(&g_map, 170, 100) == 5, "Map3DSet reads an unread chunk before painting it");
+    Vector3 far = { 590, 0, 390 };
+    CHECK(Map3DStream(&g_map, far, 10.0f, 8) == 1 && g_map.chunkCount == 2 && Map3DTile(&g_map, 32, 16) == 0
+          && Map3DTile(&g_map, 170, 100) == 5 && Map3DTile(&g_map, 299, 199) == 6,
+          "far unedited chunks dropped, edited ones kept");
+
+    // Saving over the open file keeps unread chunks
+    expect[100 * 300 + 170] = 5;
+    same = SaveMap3DBinary(bin, &g_map, false);
+    UnloadMap3D(&g_map);
+    same = same && LoadMap3DBinary(bin, &g_map);
+    for (int t = 0; same && t < 300 * 200; t++) same = Map3DTile(&g_map, t % 300, t / 300) == expect[t];
+    CHECK(same, "save while streaming, raw chunks");
+    UnloadMap3D(&g_map);
+
+    // Damage is rejected or read as blank, never past the file
+    f = fopen(bin, "r+b");
+    if (f) { fseek(f, 0, SEEK_SET); fputc('X', f); fclose(f); }
+    CHECK(!OpenMap3D(&g_map, bin) && g_map.chunks == NULL, "bad magic rejected");
+    hdr.dirOffset = (uint64_t)fileSize + 8;
+    f = fopen(bin, "wb");
+    if (f) { fwrite(&hdr, sizeof(hdr), 1, f); fclose(f); }
+    CHECK(!OpenMap3D(&g_map, bin) && !LoadMap3DBinary("util-tests-missing.m3db", &g_map), "directory past the end rejected");
+    remove(bin);
+
+    // Streaming a map with a visible defs[0]: chunks the edge cuts become
+    // fillers (the file is not read for them) and stay put, frame after frame
+    InitMap3D(&g_map, 40, 40, 1.0f, floorFirst, 2);
+    Map3DSet(&g_map, 38, 38, 1);
+    Map3DSet(&g_map, 20, 20, 1);
+    same = SaveMap3DBinary(bin, &g_map, true) && OpenMap3D(&g_map, bin);
+    Vector3 corner = { 1, 0, 1 };
+    Map3DStream(&g_map, corner, 4.0f, 8);
+    Map3DBake(&g_map);
+    Map3DChunk *cut = CHUNK(2, 2);
+    int rebuilt = 0;
+    for (int frame = 0; frame < 6; frame++) {
+        rebuilt += Map3DStream(&g_map, corner, 4.0f, 8);
+        for (int i = 0; i < 9; i++) rebuilt += g_map.chunks[i] != &map3DUnpainted_ && !g_map.chunks[i]->built;
+        Map3DBake(&g_map);
+    }
+    CHECK(same && cut->filler && CHUNK(2, 2) == cut && g_map.chunkCount == 5 && rebuilt == 0
+          && Map3DTile(&g_map, 38, 38) == 0, "cut chunks are baked once while streaming, not re-read");
+    Vector3 across = { 38, 0, 38 };
+    CHECK(Map3DStream(&g_map, across, 4.0f, 8) == 1 && CHUNK(2, 2) == cut && !cut->filler
+          && Map3DTile(&g_map, 38, 38) == 1, "streaming reads a file chunk into its filler");
+    Map3DBake(&g_map);
+    Map3DStream(&g_map, corner, 4.0f, 8);
+    Map3DBake(&g_map);
+    cut = CHUNK(2, 2);
+    rebuilt = 0;
+    for (int frame = 0; frame < 6; frame++) {
+        rebuilt += Map3DStream(&g_map, corner, 4.0f, 8);
+        for (int i = 0; i < 9; i++) rebuilt += g_map.chunks[i] != &map3DUnpainted_ && !g_map.chunks[i]->built;
+        Map3DBake(&g_map);
+    }
+    CHECK(cut->filler && CHUNK(2, 2) == cut && Map3DTile(&g_map, 38, 38) == 0 && rebuilt == 0,
+          "dropped cut chunk settles as a filler");
+    same = SaveMap3DBinary(bin, &g_map, true);
+    UnloadMap3D(&g_map);
+    CHECK(same && LoadMap3DBinary(bin, &g_map) && Map3DTile(&g_map, 38, 38) == 1 && Map3DTile(&g_map, 20, 20) == 1,
+          "saving keeps a filler's unread file tiles");
+    UnloadMap3D(&g_map);
+    remove(bin);
+
+    // Quadtree culling: one floor tile per chunk along row 8, eye in chunk 8
+    // looking +X. Chunks behind, and the empty rest of the map, never show.
+    VisibleList vis;
+    InitVisibleList(&vis, 256);
+    InitMap3D(&g_map, 256, 256, 1.0f, g_mapDefs, 7);
+    for (int cx = 0; cx < 16; cx++) Map3DSet(&g_map, cx * 16 + 3, 8 * 16 + 8, 1);
+    Camera3D eye = { { 136, 1, 136 }, { 200, 1, 136 }, { 0, 1, 0 }, 45.0f, CAMERA_PERSPECTIVE };
+    Frustum view = CameraFrustumDefault(eye, 1.0f);
+    same = Map3DCull(&g_map, &vis, &view, eye.position) == 8;
+    for (int i = 0; same && i < 8; i++) same = vis.ids[i] == 8 * 16 + 8 + i;
+    CHECK(same && g_map.tree[g_map.treeOffset[g_map.treeLevels - 1]] == 0.0f, "Map3DCull: chunks ahead, front to back");
+    CHECK(vis.tested < 64, "empty and off-screen subtrees skipped whole");
+    eye.target = (Vector3){ 72, 1, 136 };
+    view = CameraFrustumDefault(eye, 1.0f);
+    same = Map3DCull(&g_map, &vis, &view, eye.position) == 9;
+    for (int i = 0; same && i < 9; i++) same = vis.ids[i] == 8 * 16 + 8 - i;
+    CHECK(same, "turned round: the other way, still nearest first");
+
+    // Node boxes reach the tallest wall: looking up, a floor-only chunk is
+    // culled while a 40-high wall farther on still shows, and edits update it
+    TileDef tall[3] = { { TILE_EMPTY, 0, BLACK, BLACK }, { TILE_FLOOR, 0, GREEN, GREEN }, { TILE_WALL, 40, GRAY, GRAY } };
+    InitMap3D(&g_map, 256, 256, 1.0f, tall, 3);
+    Map3DSet(&g_map, 168, 136, 1);   // chunk (10, 8)
+    Map3DSet(&g_map, 200, 136, 2);   // chunk (12, 8)
+    eye = (Camera3D){ { 128, 1, 136 }, { 160, 30, 136 }, { 0, 1, 0 }, 45.0f, CAMERA_PERSPECTIVE };
+    view = CameraFrustumDefault(eye, 1.0f);
+    CHECK(Map3DCull(&g_map, &vis, &view, eye.position) == 1 && vis.ids[0] == 8 * 16 + 12, "tall wall seen, floor below view culled");
+    Map3DSet(&g_map, 200, 136, 1);
+    Map3DSet(&g_map, 168, 136, 2);
+    CHECK(Map3DCull(&g_map, &vis, &view, eye.position) == 1 && vis.ids[0] == 8 * 16 + 10, "edits move the tree's heights");
+    FreeVisibleList(&vis);
+    UnloadMap3D(&g_map);
+    CHECK(g_map.chunks == NULL && g_map.chunkCount == 0, "UnloadMap3D leaves the map zeroed");
+}
+
+// Solid test by definition, for checking Map3DRaycast against sampling
+static bool map_solid_at(Vector3 p) {
+    if (p.x < 0 || p.z < 0 || p.x >= g_map.width || p.z >= g_map.height) return false;
+    int tx = (int)p.x, tz = (int)p.z;
+    TileDef *td = Map3DGet(&g_map, tx, tz);
+    float fx = p.x - tx, fz = p.z - tz, h = td->height, top;
+    switch (td->type) {
+        case TILE_FLOOR: case TILE_WATER: top = 0; break;
+        case TILE_WALL: case TILE_PLATFORM: top = h; break;
+        case TILE_RAMP_N: top = h * (1 - fz); break;
+        case TILE_RAMP_S: top = h * fz; break;
+        case TILE_RAMP_E: top = h * fx; break;
+        case TILE_RAMP_W: top = h * (1 - fx); break;
+        case TILE_PIT: top = -1; break;
+        default: return false;
+    }
+    return p.y < top;
+}
+
+static void test_raycast(void) {
+    load_test_map("22111111"
+                  "11121164"
+                  "00000555", 8, 3);
+    Map3DHit h = Map3DRaycast(&g_map, (Vector3){ 0.5f, 1, 1.5f }, (Vector3){ 2, 0, 0 }, 50);
+    CHECK(h.hit && h.tx == 3 && h.tz == 1 && NEAR(h.distance, 2.5f, 1e-5f) && NEAR(h.point.x, 3, 1e-5f)
+          && h.normal.x == -1 && h.normal.y == 0, "ray into a wall's side");
+    CHECK(!Map3DRaycast(&g_map, (Vector3){ 0.5f, 1, 1.5f }, (Vector3){ 1, 0, 0 }, 2).hit, "maxDist stops short");
+    CHECK(!Map3DRaycast(&g_map, (Vector3){ 2.5f, 2.5f, 1.5f }, (Vector3){ 1, 0, 0 }, 50).hit, "over the wall, off the map");
+    h = Map3DRaycast(&g_map, (Vector3){ 3.5f, 5, 1.5f }, (Vector3){ 0, -1, 0 }, 50);
+    CHECK(h.hit && h.tx == 3 && NEAR(h.distance, 3, 1e-5f) && h.normal.y == 1, "wall top");
+    h = Map3DRaycast(&g_map, (Vector3){ 6.5f, 5, 1.5f }, (Vector3){ 0, -1, 0 }, 50);
+    CHECK(h.hit && h.tx == 6 && NEAR(h.point.y, 0.5f, 1e-5f) && NEAR(h.normal.z, 0.70710678f, 1e-5f)
+          && NEAR(h.normal.y, 0.70710678f, 1e-5f), "ramp N: high on its north edge, normal tilts south");
+    h = Map3DRaycast(&g_map, (Vector3){ 7.5f, -0.5f, 1.5f }, (Vector3){ -1, 0, 0 }, 50);
+    CHECK(h.hit && h.tx == 6 && NEAR(h.distance, 0.5f, 1e-5f) && h.normal.x == 1, "pit wall from inside the pit");
+    h = Map3DRaycast(&g_map, (Vector3){ 7.5f, 3, 1.5f }, (Vector3){ 0, -1, 0 }, 50);
+    CHECK(h.hit && NEAR(h.point.y, -1, 1e-5f), "pit floor");
+    h = Map3DRaycast(&g_map, (Vector3){ 6.5f, 3, 2.5f }, (Vector3){ 0, -1, 0 }, 50);
+    CHECK(h.hit && h.tz == 2 && NEAR(h.point.y, 0, 1e-5f), "water stops rays at its surface");
+    CHECK(!Map3DRaycast(&g_map, (Vector3){ 1.5f, 3, 2.5f }, (Vector3){ 0, -1, 0 }, 50).hit, "empty tiles are open");
+    h = Map3DRaycast(&g_map, (Vector3){ -5, 1, 0.5f }, (Vector3){ 1, 0, 0 }, 50);
+    CHECK(h.hit && h.tx == 0 && h.tz == 0 && NEAR(h.distance, 5, 1e-5f) && h.normal.x == -1, "ray from off the map");
+    h = Map3DRaycast(&g_map, (Vector3){ 3.5f, 1, 1.5f }, (Vector3){ 1, 0, 0 }, 50);
+    CHECK(h.hit && h.distance == 0 && h.normal.x == -1, "starting inside a wall");
+    CHECK(!Map3DLineOfSight(&g_map, (Vector3){ 4.5f, 1, 1.5f }, (Vector3){ 1.5f, 1, 1.5f })
+          && Map3DLineOfSight(&g_map, (Vector3){ 4.5f, 2.5f, 1.5f }, (Vector3){ 1.5f, 2.5f, 1.5f })
+          && Map3DLineOfSight(&g_map, (Vector3){ 5.5f, 0.5f, 1.5f }, (Vector3){ 5.5f, 0.5f, 0.2f }), "line of sight");
+
+    // Any direction: first hit agrees with stepping the ray in tiny steps
+    unsigned int seed = 7;
+    int agree = 0, tried = 0;
+    for (int r = 0; r < 300; r++) {
+        float v[6];
+        for (int k = 0; k < 6; k++) v[k] = (float)((seed = seed * 1103515245u + 12345u) >> 8) / 16777216.0f;
+        Vector3 o = { -1 + v[0] * 10, -1.2f + v[1] * 4, -1 + v[2] * 5 };
+        Vector3 d = Vector3Normalize((Vector3){ v[3] - 0.5f, v[4] - 0.7f, v[5] - 0.5f });
+        if (map_solid_at(o)) continue;
+        tried++;
+        float t = 0;
+        while (t < 12 && !map_solid_at(Vector3Add(o, Vector3Scale(d, t)))) t += 0.0005f;
+        h = Map3DRaycast(&g_map, o, d, 12);
+        agree += t >= 12 ? !h.hit || h.distance > 11.99f : h.hit && fabsf(h.distance - t) < 0.002f;
+    }
+    CHECK(tried > 200 && agree == tried, "DDA matches brute-force sampling");
+
+    // Batched: a vision fan, same answers as one at a time
+    Ray fan[16];
+    Map3DHit hits[16];
+    for (int i = 0; i < 16; i++) {
+        float a = PI * (float)i / 15.0f;
+        fan[i] = (Ray){ { 4.5f, 0.5f, 1.5f }, { -cosf(a), -0.05f, -sinf(a) } };
+    }
+    int count = Map3DRaycastBatch(&g_map, fan, 16, 20, hits);
+    bool same = true;
+    int hitCount = 0;
+    for (int i = 0; i < 16; i++) {
+        Map3DHit one = Map3DRaycast(&g_map, fan[i].position, fan[i].direction, 20);
+        same = same && one.hit == hits[i].hit && one.distance == hits[i].distance
+            && one.tx == hits[i].tx && one.tz == hits[i].tz && Vector3Equals(one.normal, hits[i].normal);
+        hitCount += one.hit;
+    }
+    CHECK(same && count == hitCount && count > 0 && hits[0].tx == 3, "Map3DRaycastBatch");
+
+    // Movement stands where rays land: Map3DHeightAt follows the drawn slopes
+    TileDef slopes[6] = { { TILE_FLOOR, 0, GREEN, GREEN }, { TILE_RAMP_N, 2, BEIGE, BROWN }, { TILE_RAMP_S, 2, BEIGE, BROWN },
+                          { TILE_RAMP_E, 2, BEIGE, BROWN }, { TILE_RAMP_W, 2, BEIGE, BROWN }, { TILE_PIT, 0, BLACK, BLACK } };
+    Map3DLoad(&g_map, "12345", 5, 1, 2.0f, slopes, 6);
+    same = NEAR(Map3DHeightAt(&g_map, (Vector3){ 1, 0, 0.1f }), 1.9f, 1e-5f);   // ramp N: high on z0
+    for (int i = 0; i < 50; i++) {
+        Vector3 p = { 0.1f + i * 0.2f, 10, 0.3f + (i % 7) * 0.25f };
+        h = Map3DRaycast(&g_map, p, (Vector3){ 0, -1, 0 }, 20);
+        same = same && h.hit && NEAR(h.point.y, Map3DHeightAt(&g_map, p), 1e-4f);
+    }
+    CHECK(same, "Map3DHeightAt agrees with the raycast on ramps and pits");
+    UnloadMap3D(&g_map);
+}
+
+static void test_profiler(void) {
+    // Frame 0, 2000 ns: outer [100,1000] holds a twice ([200,500], [600,700]);
+    // b [1100,1300] sits beside it.
+    g_profNs = 0;
+    ProfileFrameBegin();
+    g_profNs = 100;
+    {
+        PROFILE_SCOPE("outer");
+        for (int i = 0; i < 2; i++) {
+            g_profNs = i ? 600 : 200;
+            PROFILE_SCOPE("a");
+            g_profNs = i ? 700 : 500;
+        }
+        g_profNs = 1000;
+    }
+    g_profNs = 1100;
+    PROFILE_BEGIN("b");
+    g_profNs = 1300;
+    PROFILE_END();
+    g_profNs = 2000;
+    ProfileFrameEnd();
+
+    const ProfileFrameStats *f = &profiler.last;
+    CHECK(f->frameNs == 2000 && f->index == 0 && !f->truncated, "ProfileFrameEnd frame time");
+    const ProfileScopeStat *outer = find_scope(f, "outer"), *a = find_scope(f, "a");
+    const ProfileScopeStat *b = find_scope(f, "b"), *frame = find_scope(f, "frame");
+    CHECK(outer && outer->totalNs == 900 && outer->selfNs == 500 && outer->calls == 1, "profile outer self excludes children");
+    CHECK(a && a->totalNs == 400 && a->selfNs == 400 && a->calls == 2, "profile repeated scope accumulates");
+    CHECK(b && b->totalNs == 200, "profile explicit begin/end");
+    CHECK(frame && frame->selfNs == 900, "profile frame self is the unscoped time");
+
+    int order[PROFILE_MAX_SCOPES];
+    int n = ProfileTopScopes_(f, order, 3);
+    CHECK(n == 3 && f->scopes[order[0]].name == frame->name && f->scopes[order[1]].name == outer->name
+          && f->scopes[order[2]].name == a->name, "ProfileTopScopes_ by self time");
+
+    // Frame 1 is shorter: the worst capture stays on frame 0
+    g_profNs = 3000;
+    ProfileFrameBegin();
+    g_profNs = 3100;
+    { PROFILE_SCOPE("b"); g_profNs = 3200; }
+    g_profNs = 3500;
+    ProfileFrameEnd();
+    CHECK(profiler.last.index == 1 && profiler.last.frameNs == 500, "second frame folded");
+    CHECK(profiler.worst.index == 0 && profiler.worst.frameNs == 2000, "worst frame kept");
+
+    // Trace of the last frame only: its frame and b, nothing from frame 0
+    const char *path = "util-tests-trace.json";
+    CHECK(ProfileWriteChromeTrace(path, 1), "ProfileWriteChromeTrace opens file");
+    char buf[4096] = {0};
+    FILE *fp = fopen(path, "r");
+    if (fp) { fread(buf, 1, sizeof(buf) - 1, fp); fclose(fp); }
+    remove(path);
+    int events = 0;
+    for (const char *q = buf; (q = strstr(q, "\"ph\":\"X\"")) != NULL; q++) events++;
+    CHECK(events == 2, "chrome trace holds the last frame's scopes");
+    CHECK(strstr(buf, "\"name\":\"b\"") && !strstr(buf, "\"name\":\"outer\""), "chrome trace window");
+    CHECK(strstr(buf, "\"ts\":0.100,\"dur\":0.100"), "chrome trace microseconds from window start");
+}
 
 int main(void) {
     test_math();
     test_pool();
     test_collide();
     test_camera();
+    test_frustum();
     test_fx();
     test_vehicle();
-    // input/hud/debug: include-only, no standalone tests (window-dependent)
+    test_loop();
+    test_rng();
+    test_noise();
+    test_jobs();
+    test_arena();
+    test_prefab();
+    test_bounds();
+    test_pack();
+    test_assets();
+    test_map3d();
+    test_raycast();
+    test_profiler();
+    // input/hud and the debug.h overlays: include-only (window-dependent)
     printf("\n%s (%d failure%s)\n", g_fails ? "FAILED" : "ALL PASSED",
            g_fails, g_fails == 1 ? "" : "s");
     return g_fails ? 1 : 0;